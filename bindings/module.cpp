@@ -7,18 +7,24 @@
 #include <nanobind/stl/unique_ptr.h>
 #include <nanobind/stl/vector.h>
 
+#include <cmath>
 #include <spdlog/spdlog.h>
 
 #include "action/action_registry.hpp"
+#include "live_statistics.hpp"
 #include "logging.hpp"
 #include "metadata/context.hpp"
 #include "metadata/table.hpp"
+#include "metrics_export.hpp"
 #include "py_action.hpp"
 #include "querygen/config.hpp"
 #include "random.hpp"
+#include "sql_variant/connection_manager.hpp"
 #include "sql_variant/generic.hpp"
 #include "sql_variant/mysql.hpp"
 #include "sql_variant/postgresql.hpp"
+#include "sql_variant/sim.hpp"
+#include "sql_variant/watchdog.hpp"
 #include "statistics.hpp"
 #include "workload.hpp"
 
@@ -42,6 +48,12 @@ connect_mysql(std::string host, uint16_t port, std::string dbname,
   return std::make_unique<LoggedSQL>(std::move(sql), log_name);
 }
 
+static std::unique_ptr<LoggedSQL>
+connect_sim(std::shared_ptr<SimServer> server, std::string log_name) {
+  auto sql = std::make_unique<sql_variant::Simulated>(std::move(server));
+  return std::make_unique<LoggedSQL>(std::move(sql), log_name);
+}
+
 static action::ActionType parse_action_type(std::string const &action_type) {
   if (action_type == "ddl") {
     return action::ActionType::ddl;
@@ -62,6 +74,8 @@ static const char *error_class_name(ErrorClass c) {
     return "failedTxn";
   case ErrorClass::serverGone:
     return "serverGone";
+  case ErrorClass::timeout:
+    return "timeout";
   case ErrorClass::other:
     return "other";
   }
@@ -225,7 +239,44 @@ NB_MODULE(_stormweaver, m) {
           },
           nb::arg("query"), nb::arg("params") = nb::none())
       .def("reconnect", &LoggedSQL::reconnect,
-           nb::call_guard<nb::gil_scoped_release>());
+           nb::call_guard<nb::gil_scoped_release>())
+      .def(
+          "set_watchdog",
+          [](LoggedSQL &self, std::shared_ptr<StatementWatchdog> watchdog,
+             std::uint64_t timeout_ms) {
+            self.setWatchdog(std::move(watchdog),
+                             std::chrono::milliseconds(timeout_ms));
+          },
+          nb::arg("watchdog").none(), nb::arg("timeout_ms") = 0);
+
+  nb::class_<StatementWatchdog>(m, "StatementWatchdog")
+      .def(nb::init<>())
+      .def_prop_ro("cancels", &StatementWatchdog::cancels);
+
+  nb::class_<ConnectionManager>(m, "ConnectionManager")
+      .def(
+          "__init__",
+          [](ConnectionManager *self, std::size_t spares,
+             std::uint64_t patience_ms, std::uint64_t backoff_initial_ms,
+             std::uint64_t backoff_max_ms) {
+            new (self) ConnectionManager(
+                spares, std::chrono::milliseconds(patience_ms),
+                {.initial = std::chrono::milliseconds(backoff_initial_ms),
+                 .max = std::chrono::milliseconds(backoff_max_ms)});
+          },
+          nb::arg("spares") = 0, nb::arg("patience_ms") = 60000,
+          nb::arg("backoff_initial_ms") = 50, nb::arg("backoff_max_ms") = 2000)
+      .def_prop_ro("idle", &ConnectionManager::idle)
+      .def_prop_ro("outages", &ConnectionManager::outages)
+      .def_prop_ro("failed_attempts", &ConnectionManager::failedAttempts)
+      .def_prop_ro("last_downtime_seconds",
+                   [](ConnectionManager const &self) {
+                     return std::chrono::duration<double>(self.lastDowntime())
+                         .count();
+                   })
+      .def_prop_ro("last_restore_seconds", [](ConnectionManager const &self) {
+        return std::chrono::duration<double>(self.lastRestore()).count();
+      });
 
   m.def("connect_pg", &connect_pg, nb::arg("host") = "localhost",
         nb::arg("port") = 5432, nb::arg("dbname") = "postgres",
@@ -237,6 +288,52 @@ NB_MODULE(_stormweaver, m) {
         nb::arg("user") = "root", nb::arg("password") = "",
         nb::arg("socket") = "", nb::arg("log_name") = "python");
 
+  nb::class_<SimParams>(m, "SimParams")
+      .def(nb::init<>())
+      .def_prop_rw(
+          "flavor",
+          [](SimParams const &p) {
+            return p.flavor_ == flavor::mysql ? std::string("mysql")
+                                              : std::string("postgres");
+          },
+          [](SimParams &p, std::string const &v) {
+            if (v == "postgres") {
+              p.flavor_ = flavor::postgres;
+            } else if (v == "mysql") {
+              p.flavor_ = flavor::mysql;
+            } else {
+              throw std::invalid_argument("flavor: postgres|mysql");
+            }
+          })
+      .def_rw("version", &SimParams::version)
+      .def_rw("seed", &SimParams::seed)
+      .def_prop_rw(
+          "latency_median_us",
+          [](SimParams const &p) {
+            return std::chrono::duration_cast<std::chrono::microseconds>(
+                       p.latency_median)
+                .count();
+          },
+          [](SimParams &p, std::int64_t us) {
+            p.latency_median = std::chrono::microseconds(us);
+          })
+      .def_rw("latency_sigma", &SimParams::latency_sigma)
+      .def_rw("sleep", &SimParams::sleep)
+      .def_rw("error_rate", &SimParams::error_rate)
+      .def_rw("conflict_rate", &SimParams::conflict_rate)
+      .def_rw("server_gone_rate", &SimParams::server_gone_rate)
+      .def_rw("down_connects", &SimParams::down_connects)
+      .def_rw("select_rows", &SimParams::select_rows)
+      .def_rw("select_fields", &SimParams::select_fields)
+      .def_rw("affected_rows", &SimParams::affected_rows);
+
+  nb::class_<SimServer>(m, "SimServer")
+      .def(nb::init<SimParams>(), nb::arg("params") = SimParams{})
+      .def("crash", &SimServer::crash);
+
+  m.def("connect_sim", &connect_sim, nb::arg("server"),
+        nb::arg("log_name") = "python");
+
   // --- Metadata ---
 
   nb::class_<metadata::TableRegistry>(m, "Metadata")
@@ -268,11 +365,60 @@ NB_MODULE(_stormweaver, m) {
         return names;
       });
 
+  nb::class_<metadata::TurnScheduler>(m, "TurnScheduler")
+      .def(
+          "__init__",
+          [](metadata::TurnScheduler *self, std::uint64_t seed,
+             std::size_t participants, std::uint64_t stall_ms) {
+            new (self) metadata::TurnScheduler(
+                seed, participants, std::chrono::milliseconds(stall_ms));
+          },
+          nb::arg("seed"), nb::arg("participants"),
+          nb::arg("stall_ms") = 10000)
+      .def("cancel", &metadata::TurnScheduler::cancel)
+      .def_prop_ro("participants", &metadata::TurnScheduler::participants)
+      .def_prop_ro("turns", &metadata::TurnScheduler::turns)
+      .def_prop_ro("stalls", &metadata::TurnScheduler::stalls)
+      .def_prop_ro("waited_seconds", [](metadata::TurnScheduler const &self) {
+        return std::chrono::duration<double>(self.waited()).count();
+      });
+
+  nb::class_<Phase>(m, "Phase")
+      .def(
+          "__init__",
+          [](Phase *self, double seconds, std::size_t workers, double rate) {
+            new (self) Phase{.duration = std::chrono::milliseconds(
+                                 std::llround(seconds * 1000)),
+                             .workers = workers,
+                             .rate = rate};
+          },
+          nb::arg("seconds"), nb::arg("workers"), nb::arg("rate") = 0)
+      .def_prop_ro("seconds",
+                   [](Phase const &self) {
+                     return std::chrono::duration<double>(self.duration)
+                         .count();
+                   })
+      .def_ro("workers", &Phase::workers)
+      .def_ro("rate", &Phase::rate);
+
+  nb::class_<StartBarrier>(m, "StartBarrier")
+      .def(nb::init<std::size_t>(), nb::arg("participants"))
+      .def("cancel", &StartBarrier::cancel)
+      .def_prop_ro("participants", &StartBarrier::participants);
+
+  nb::class_<PhaseProfile>(m, "PhaseProfile")
+      .def(nb::init<std::vector<Phase>>(), nb::arg("phases"))
+      .def_prop_ro("phases", &PhaseProfile::phases);
+
   // --- Random ---
 
   nb::class_<ps_random>(m, "Random")
       .def(nb::init<>())
       .def(nb::init<std::uint64_t>())
+      .def("jump", &ps_random::jump)
+      .def("long_jump", &ps_random::long_jump)
+      .def("checkpoint", &ps_random::checkpoint)
+      .def("restore", &ps_random::restore)
       .def(
           "number",
           [](ps_random &self, std::size_t min, std::size_t max) {
@@ -321,6 +467,9 @@ NB_MODULE(_stormweaver, m) {
           },
           nb::arg("name"), nb::arg("sql"), nb::arg("weight"),
           nb::arg("action_type") = "other")
+      .def("load_grammar", &action::ActionRegistry::loadGrammar,
+           nb::arg("path"), nb::arg("weight") = 1,
+           nb::arg("prefix") = "grammar_")
       .def("use", &action::ActionRegistry::use)
       .def(
           "register_python",
@@ -364,13 +513,65 @@ NB_MODULE(_stormweaver, m) {
       .def_rw("for_update", &action::LockWeights::for_update)
       .def_rw("for_share", &action::LockWeights::for_share);
 
+  nb::class_<action::KeyDistribution>(m, "KeyDistribution")
+      .def(nb::init<>())
+      .def_prop_rw(
+          "kind",
+          [](action::KeyDistribution const &d) {
+            using Kind = action::KeyDistribution::Kind;
+            switch (d.kind) {
+            case Kind::zipfian:
+              return "zipfian";
+            case Kind::hotspot:
+              return "hotspot";
+            case Kind::latest:
+              return "latest";
+            case Kind::uniform:
+              break;
+            }
+            return "uniform";
+          },
+          [](action::KeyDistribution &d, std::string const &v) {
+            using Kind = action::KeyDistribution::Kind;
+            if (v == "uniform") {
+              d.kind = Kind::uniform;
+            } else if (v == "zipfian") {
+              d.kind = Kind::zipfian;
+            } else if (v == "hotspot") {
+              d.kind = Kind::hotspot;
+            } else if (v == "latest") {
+              d.kind = Kind::latest;
+            } else {
+              throw std::invalid_argument(
+                  "kind: uniform|zipfian|hotspot|latest");
+            }
+          })
+      .def_rw("theta", &action::KeyDistribution::theta)
+      .def_rw("hot_fraction", &action::KeyDistribution::hot_fraction)
+      .def_rw("hot_probability", &action::KeyDistribution::hot_probability);
+
+  nb::class_<action::KeyReservoir>(m, "KeyReservoir")
+      .def(nb::init<std::size_t>(), nb::arg("capacity") = 10000)
+      .def_prop_ro("capacity", &action::KeyReservoir::capacity)
+      .def("size", &action::KeyReservoir::size)
+      .def("forget", &action::KeyReservoir::forget);
+
   nb::class_<action::DmlConfig>(m, "DmlConfig")
       .def(nb::init<>())
       .def_rw("delete_min", &action::DmlConfig::deleteMin)
       .def_rw("delete_max", &action::DmlConfig::deleteMax)
       .def_rw("update_min", &action::DmlConfig::updateMin)
       .def_rw("update_max", &action::DmlConfig::updateMax)
-      .def_rw("lock_weights", &action::DmlConfig::lockWeights);
+      .def_rw("lock_weights", &action::DmlConfig::lockWeights)
+      .def_rw("pk_reservoir_prob", &action::DmlConfig::pkReservoirProb)
+      .def_rw("fk_scan_prob", &action::DmlConfig::fkScanProb)
+      .def_rw("bulk_load_rows", &action::DmlConfig::bulkLoadRows)
+      .def_rw("delete_access", &action::DmlConfig::deleteAccess)
+      .def_rw("update_access", &action::DmlConfig::updateAccess)
+      .def_rw("delete_selected_access",
+              &action::DmlConfig::deleteSelectedAccess)
+      .def_rw("update_selected_access",
+              &action::DmlConfig::updateSelectedAccess);
 
   nb::class_<action::IsolationWeights>(m, "IsolationWeights")
       .def(nb::init<>())
@@ -536,7 +737,19 @@ NB_MODULE(_stormweaver, m) {
       .def_rw("dml_predicate_prob",
               &querygen::QueryGenConfig::dml_predicate_prob)
       .def_rw("dml_pk_select_prob",
-              &querygen::QueryGenConfig::dml_pk_select_prob);
+              &querygen::QueryGenConfig::dml_pk_select_prob)
+      .def_rw("max_estimated_rows",
+              &querygen::QueryGenConfig::max_estimated_rows)
+      .def_rw("estimate_refresh_seconds",
+              &querygen::QueryGenConfig::estimate_refresh_seconds)
+      .def_rw("plan_sample_prob", &querygen::QueryGenConfig::plan_sample_prob)
+      .def_rw("plan_skip_seen", &querygen::QueryGenConfig::plan_skip_seen);
+
+  nb::class_<action::OracleConfig>(m, "OracleConfig")
+      .def(nb::init<>())
+      .def_rw("tlp_weight", &action::OracleConfig::tlp_weight)
+      .def_rw("norec_weight", &action::OracleConfig::norec_weight)
+      .def_rw("max_connections", &action::OracleConfig::max_connections);
 
   nb::class_<action::AllConfig>(m, "AllConfig")
       .def(nb::init<>())
@@ -544,6 +757,7 @@ NB_MODULE(_stormweaver, m) {
       .def_rw("dml", &action::AllConfig::dml)
       .def_rw("transaction", &action::AllConfig::transaction)
       .def_rw("querygen", &action::AllConfig::querygen)
+      .def_rw("oracle", &action::AllConfig::oracle)
       .def_rw("variables", &action::AllConfig::variables);
 
   nb::class_<WorkloadParams>(m, "WorkloadParams")
@@ -553,15 +767,60 @@ NB_MODULE(_stormweaver, m) {
       .def_rw("repeat_times", &WorkloadParams::repeat_times)
       .def_rw("number_of_workers", &WorkloadParams::number_of_workers)
       .def_rw("max_reconnect_attempts", &WorkloadParams::max_reconnect_attempts)
-      .def_rw("seed", &WorkloadParams::seed);
+      .def_rw("seed", &WorkloadParams::seed)
+      .def_prop_rw(
+          "rng_stream",
+          [](WorkloadParams const &p) {
+            return static_cast<int>(p.rng_stream);
+          },
+          [](WorkloadParams &p, int v) {
+            if (v != static_cast<int>(RngStream::mt19937) &&
+                v != static_cast<int>(RngStream::xoshiro)) {
+              throw std::invalid_argument("rng_stream: 1 (mt19937) or 2 "
+                                          "(xoshiro)");
+            }
+            p.rng_stream = static_cast<RngStream>(v);
+          })
+      .def_rw("checkpoint_interval", &WorkloadParams::checkpoint_interval)
+      .def_rw("resume_from", &WorkloadParams::resume_from)
+      .def_rw("max_actions", &WorkloadParams::max_actions)
+      .def_rw("plan_dir", &WorkloadParams::plan_dir)
+      .def_rw("target_rate", &WorkloadParams::target_rate)
+      .def_rw("statement_timeout_ms", &WorkloadParams::statement_timeout_ms);
+
+  nb::class_<action::RunState>(m, "RunState")
+      .def(nb::init<>())
+      .def_rw("keys", &action::RunState::keys)
+      .def_prop_ro("distinct_plans", [](action::RunState const &s) {
+        return s.plan_coverage->distinctPlans();
+      });
+
+  // copies share every object: copy one per cycle to give that cycle its
+  // own turns, barrier and phases
+  nb::class_<RunContext>(m, "RunContext")
+      .def(nb::init<>())
+      .def("__copy__", [](RunContext const &self) { return self; })
+      .def_rw("turn_scheduler", &RunContext::turns)
+      .def_rw("watchdog", &RunContext::watchdog)
+      .def_rw("connection_manager", &RunContext::connection_manager)
+      .def_rw("start_barrier", &RunContext::start_barrier)
+      .def_rw("phases", &RunContext::phases)
+      .def_rw("intervals", &RunContext::intervals)
+      .def_rw("actions", &RunContext::actions);
 
   // --- Statistics ---
   // worker threads mutate their own stats while running - read only after join
 
+  // significant digits of the latency histograms built from now on
+  m.def("set_latency_precision",
+        &statistics::LatencyHistogram::setDefaultDigits, nb::arg("digits"));
+
   nb::class_<statistics::TimingStatistics>(m, "TimingStatistics")
       .def("avg_ms", &statistics::TimingStatistics::getAverageMs)
       .def("min_ms", &statistics::TimingStatistics::getMinMs)
       .def("max_ms", &statistics::TimingStatistics::getMaxMs)
+      .def("percentile_ms", &statistics::TimingStatistics::getPercentileMs,
+           nb::arg("percentile"))
       .def_ro("count", &statistics::TimingStatistics::count)
       .def("has_data", &statistics::TimingStatistics::hasData)
       .def("histogram", [](statistics::TimingStatistics const &self) {
@@ -582,13 +841,14 @@ NB_MODULE(_stormweaver, m) {
       .def_ro("execution_timing",
               &statistics::ActionStatistics::executionTiming)
       .def_ro("sql_timing", &statistics::ActionStatistics::sqlTiming)
-      .def_ro("action_error_names",
-              &statistics::ActionStatistics::actionErrorNames)
-      .def_ro("sql_error_codes", &statistics::ActionStatistics::sqlErrorCodes)
+      .def_prop_ro("action_error_names",
+                   &statistics::ActionStatistics::actionErrorNames)
+      .def_prop_ro("sql_error_codes",
+                   &statistics::ActionStatistics::sqlErrorCodes)
       .def("success_rate", &statistics::ActionStatistics::getSuccessRate)
       .def("row_histograms", [](statistics::ActionStatistics const &self) {
         std::map<std::string, std::vector<std::uint64_t>> out;
-        for (auto const &[kind, hist] : self.rowHistograms) {
+        for (auto const &[kind, hist] : self.rowHistograms()) {
           out[kind] = std::vector<std::uint64_t>(hist.buckets.begin(),
                                                  hist.buckets.end());
         }
@@ -617,6 +877,8 @@ NB_MODULE(_stormweaver, m) {
       });
 
   nb::class_<statistics::WorkerStatistics>(m, "WorkerStatistics")
+      .def(nb::init<>())
+      .def("merge", &statistics::WorkerStatistics::merge, nb::arg("other"))
       .def("report", &statistics::WorkerStatistics::report)
       .def("report_summary", &statistics::WorkerStatistics::reportSummary)
       .def("report_detailed", &statistics::WorkerStatistics::reportDetailed)
@@ -670,9 +932,101 @@ NB_MODULE(_stormweaver, m) {
              }
              return it->second;
            })
-      .def("transaction_stats", [](statistics::WorkerStatistics const &self) {
-        return self.txnStats;
-      });
+      .def("transaction_stats",
+           [](statistics::WorkerStatistics const &self) {
+             return self.txnStats;
+           })
+      .def("reconnect_timing", [](statistics::WorkerStatistics const &self) {
+        return self.reconnectTiming;
+      })
+      .def("duration_seconds",
+           &statistics::WorkerStatistics::getTotalDurationSeconds)
+      .def("actions_per_sec",
+           &statistics::WorkerStatistics::getActionsPerSecond);
+
+  nb::class_<statistics::WorkloadStatistics>(m, "WorkloadStatistics")
+      .def(nb::init<>())
+      .def("add", &statistics::WorkloadStatistics::add, nb::arg("cycle"),
+           nb::arg("worker"))
+      .def("merge", &statistics::WorkloadStatistics::merge, nb::arg("other"))
+      .def("reset", &statistics::WorkloadStatistics::reset)
+      .def("total", &statistics::WorkloadStatistics::total,
+           nb::rv_policy::reference_internal)
+      .def("execution_timing",
+           &statistics::WorkloadStatistics::executionTiming,
+           nb::rv_policy::reference_internal)
+      .def_prop_ro("worker_count", &statistics::WorkloadStatistics::workerCount)
+      .def_prop_ro("cycle_count", &statistics::WorkloadStatistics::cycleCount)
+      .def("duration_seconds",
+           &statistics::WorkloadStatistics::getTotalDurationSeconds)
+      .def("actions_per_sec",
+           &statistics::WorkloadStatistics::getActionsPerSecond)
+      .def("report", &statistics::WorkloadStatistics::report)
+      .def("report_summary", &statistics::WorkloadStatistics::reportSummary);
+
+  // live statistics: copies of merged intervals, safe while workers run
+  nb::class_<statistics::IntervalStats>(m, "IntervalStats")
+      .def_ro("interval", &statistics::IntervalStats::interval)
+      .def_ro("workers", &statistics::IntervalStats::workers)
+      .def_ro("successes", &statistics::IntervalStats::successes)
+      .def_ro("action_failures", &statistics::IntervalStats::actionFailures)
+      .def_ro("sql_failures", &statistics::IntervalStats::sqlFailures)
+      .def_ro("conflicts", &statistics::IntervalStats::conflicts)
+      .def_ro("other_failures", &statistics::IntervalStats::otherFailures)
+      .def_ro("reconnects", &statistics::IntervalStats::reconnects)
+      .def("actions", &statistics::IntervalStats::actions)
+      .def("failures", &statistics::IntervalStats::failures)
+      .def("percentile_ms", &statistics::IntervalStats::percentileMs,
+           nb::arg("percentile"));
+
+  nb::class_<statistics::IntervalCollector>(m, "IntervalCollector")
+      .def(
+          "__init__",
+          [](statistics::IntervalCollector *self, std::size_t interval_ms,
+             std::size_t keep) {
+            new (self) statistics::IntervalCollector(
+                std::chrono::milliseconds(interval_ms), keep);
+          },
+          nb::arg("interval_ms") = 1000, nb::arg("keep") = 3600)
+      .def_prop_ro("interval_ms",
+                   [](statistics::IntervalCollector const &self) {
+                     return self.interval().count();
+                   })
+      .def("collect", &statistics::IntervalCollector::collect)
+      .def("latest", &statistics::IntervalCollector::latest,
+           nb::arg("count"));
+
+  // Prometheus textfile and/or OpenMetrics 127.0.0.1 listener over a
+  // collector's totals; its thread never calls into python
+  nb::class_<statistics::MetricsExporter>(m, "MetricsExporter")
+      .def(
+          "__init__",
+          [](statistics::MetricsExporter *self,
+             std::shared_ptr<statistics::IntervalCollector> collector,
+             std::string textfile, std::optional<std::uint16_t> port,
+             std::size_t period_ms) {
+            new (self) statistics::MetricsExporter(
+                std::move(collector),
+                {.textfile = std::move(textfile),
+                 .port = port,
+                 .period = std::chrono::milliseconds(period_ms)});
+          },
+          nb::arg("collector"), nb::arg("textfile") = "",
+          nb::arg("port") = nb::none(), nb::arg("period_ms") = 5000)
+      .def_prop_ro("port", &statistics::MetricsExporter::port)
+      // a scrape's OpenMetrics; the textfile's Prometheus text when
+      // textfile_format is set
+      .def(
+          "render",
+          [](statistics::MetricsExporter const &self, bool textfile_format) {
+            return self.render(textfile_format
+                                   ? statistics::MetricsFormat::prometheus
+                                   : statistics::MetricsFormat::openMetrics);
+          },
+          nb::arg("textfile_format") = false)
+      .def("stop", &statistics::MetricsExporter::stop,
+           nb::call_guard<nb::gil_scoped_release>());
+  m.def("statements_in_flight", &statistics::StatementInFlight::count);
 
   // --- Workers ---
 
@@ -680,19 +1034,47 @@ NB_MODULE(_stormweaver, m) {
 
   nb::class_<Worker>(m, "Worker")
       .def(nb::init<std::string const &, sql_connector_t const &,
-                    WorkloadParams const &, metadata_ptr>())
+                    WorkloadParams const &, metadata_ptr,
+                    RunContext const &>(),
+           nb::arg("name"), nb::arg("sql_connector"), nb::arg("params"),
+           nb::arg("metadata"), nb::arg("context") = RunContext{})
       .def("create_random_tables", &Worker::create_random_tables)
+      // a large load runs for minutes; nothing in it calls back into python
+      .def("bulk_load", &Worker::bulk_load, nb::arg("table"), nb::arg("rows"),
+           nb::call_guard<nb::gil_scoped_release>())
       .def("discover_existing_schema", &Worker::discover_existing_schema)
       .def("reset_metadata", &Worker::reset_metadata)
       .def("validate_metadata", &Worker::validate_metadata)
       .def("calculate_database_checksums",
            &Worker::calculate_database_checksums)
-      .def("reconnect", &Worker::reconnect);
+      .def("reconnect", &Worker::reconnect)
+      .def("rng_checkpoint", &Worker::rng_checkpoint)
+      .def_prop_ro("action_count", &Worker::action_count)
+      // callable while the worker runs, from any thread
+      .def("pause", &Worker::pause)
+      .def("resume", &Worker::resume)
+      // cancelling can open a connection (KILL QUERY)
+      .def("stop", &Worker::stop, nb::call_guard<nb::gil_scoped_release>())
+      .def("set_rate", &Worker::set_rate, nb::arg("actions_per_second"))
+      .def_prop_ro("state", [](Worker const &self) {
+        switch (self.state()) {
+        case WorkerControl::State::paused:
+          return "paused";
+        case WorkerControl::State::stopped:
+          return "stopped";
+        case WorkerControl::State::running:
+          break;
+        }
+        return "running";
+      });
 
   nb::class_<RandomWorker, Worker>(m, "RandomWorker")
       .def(nb::init<std::string const &, sql_connector_t const &,
                     WorkloadParams const &, metadata_ptr,
-                    action::ActionRegistry const &>())
+                    action::ActionRegistry const &, RunContext const &>(),
+           nb::arg("name"), nb::arg("sql_connector"), nb::arg("params"),
+           nb::arg("metadata"), nb::arg("actions"),
+           nb::arg("context") = RunContext{})
       // blocking (or thread-starting) calls must release the thread state:
       // free-threaded cyclic GC stops the world by waiting on all attached
       // threads, and an attached thread parked in pthread_join would
@@ -703,6 +1085,24 @@ NB_MODULE(_stormweaver, m) {
            nb::call_guard<nb::gil_scoped_release>())
       .def("possible_actions", &RandomWorker::possibleActions,
            nb::rv_policy::reference_internal)
+      .def("set_weight", &RandomWorker::set_weight, nb::arg("action"),
+           nb::arg("weight"))
       .def("statistics", &RandomWorker::statistics,
+           nb::rv_policy::reference_internal)
+      .def("phase_statistics", &RandomWorker::phase_statistics,
+           nb::rv_policy::reference_internal);
+
+  nb::class_<PlanWorker, Worker>(m, "PlanWorker")
+      .def(nb::init<std::string const &, sql_connector_t const &,
+                    WorkloadParams const &, std::string const &,
+                    RunContext const &>(),
+           nb::arg("name"), nb::arg("sql_connector"), nb::arg("params"),
+           nb::arg("plan_path"), nb::arg("context") = RunContext{})
+      .def("run_thread", &PlanWorker::run_thread,
+           nb::call_guard<nb::gil_scoped_release>())
+      .def("join", &PlanWorker::join,
+           nb::call_guard<nb::gil_scoped_release>())
+      .def_prop_ro("plan_size", &PlanWorker::plan_size)
+      .def("statistics", &PlanWorker::statistics,
            nb::rv_policy::reference_internal);
 }
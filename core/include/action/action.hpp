@@ -40,4 +40,18 @@ private:
   std::string message;
 };
 
+// an action that looked and chose not to run: neither a success nor a
+// failure, the worker records no outcome for it
+class ActionSkipped : public std::exception {
+public:
+  explicit ActionSkipped(std::string reason) : reason(std::move(reason)) {}
+
+  [[nodiscard]] const char *what() const noexcept override {
+    return reason.c_str();
+  }
+
+private:
+  std::string reason;
+};
+
 } // namespace action
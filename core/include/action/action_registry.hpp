@@ -2,6 +2,7 @@
 #pragma once
 
 #include "action/all.hpp"
+#include "action/run_state.hpp"
 #include "sql_variant/generic.hpp"
 
 #include <cstdint>
@@ -16,6 +17,7 @@ class ActionRegistry;
 struct BuildContext {
   AllConfig const &config;
   ActionRegistry const &registry; // registry the factory was picked from
+  RunState const &state;
 };
 
 using action_build_t =
@@ -29,6 +31,8 @@ struct ActionFactory {
   // false: statement refuses to run in a transaction block (ALTER SYSTEM),
   // transaction composites skip it
   bool txn_safe = true;
+  // `name` in statistics::NameTable, set by ActionRegistry::insert
+  statistics::NameId stats_id = statistics::NameTable::none;
 };
 
 class ActionRegistry {
@@ -48,6 +52,9 @@ public:
 
   ActionFactory &getReference(std::string const &name);
 
+  // throws ActionException for an unknown name
+  void setWeight(std::string const &name, std::size_t weight);
+
   void makeCustomSqlAction(std::string const &name, std::string const &sql,
                            std::size_t weight,
                            ActionType type = ActionType::other);
@@ -56,6 +63,12 @@ public:
                                 std::size_t weight,
                                 ActionType type = ActionType::other);
 
+  // registers every rule of a pstress grammar file as `<prefix><line>`,
+  // weight `weight` per occurrence; returns the number of actions added.
+  // Throws std::invalid_argument when the file can't be read
+  std::size_t loadGrammar(std::string const &path, std::size_t weight = 1,
+                          std::string const &prefix = "grammar_");
+
   void use(ActionRegistry const &other);
 
   std::size_t size() const;
@@ -5,6 +5,7 @@
 #include "action/custom.hpp"
 #include "action/ddl.hpp"
 #include "action/dml.hpp"
+#include "action/oracle.hpp"
 #include "action/transaction_config.hpp"
 #include "action/variable.hpp"
 #include "querygen/config.hpp"
@@ -17,6 +18,7 @@ struct AllConfig {
   CustomConfig custom;
   TransactionConfig transaction;
   querygen::QueryGenConfig querygen;
+  OracleConfig oracle;
   VariableConfig variables;
 };
 
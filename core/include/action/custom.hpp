@@ -1,9 +1,10 @@
-
 #pragma once
 
 #include "action/action.hpp"
+#include "action/key_reservoir.hpp"
+#include "action/sql_template.hpp"
 
-#include <boost/container/flat_set.hpp>
+#include <memory>
 
 namespace action {
 
@@ -11,23 +12,19 @@ struct CustomConfig {};
 
 class CustomSql : public Action {
 public:
-  // Parameters stored as a string so we can implement dynamic dictionaries
-  // later
-  using inject_t = boost::container::flat_set<std::string>;
-
-  CustomSql(CustomConfig const &config, std::string sqlStatement,
-            const inject_t &injectParameters);
+  // the template is compiled once, at registration, and shared by every
+  // action built from it; `keys` serves {pk:...} placeholders
+  CustomSql(CustomConfig const &config,
+            std::shared_ptr<SqlTemplate const> sqlTemplate,
+            std::shared_ptr<KeyReservoir> keys = nullptr);
 
   void execute(metadata::Context &metaCtx, ps_random &rand,
                sql_variant::LoggedSQL *connection) const override;
 
 private:
   // CustomConfig config;
-  std::string sqlStatement;
-  inject_t injectParameters;
-
-  static std::string doInject(metadata::Context &metaCtx, ps_random &rand,
-                              std::string const &injectionPoint);
+  std::shared_ptr<SqlTemplate const> sqlTemplate;
+  std::shared_ptr<KeyReservoir> keys;
 };
 
 }; // namespace action
@@ -2,10 +2,12 @@
 #pragma once
 
 #include "action/action.hpp"
+#include "action/key_reservoir.hpp"
 #include "bitflags.hpp"
 
 #include <cstdint>
 #include <functional>
+#include <memory>
 
 namespace action {
 
@@ -40,13 +42,15 @@ private:
 
 class DropTable : public Action {
 public:
-  DropTable(DdlConfig config);
+  // keys: reservoir to drop the table's keys from, if any
+  DropTable(DdlConfig config, std::shared_ptr<KeyReservoir> keys = nullptr);
 
   void execute(metadata::Context &metaCtx, ps_random &rand,
                sql_variant::LoggedSQL *connection) const override;
 
 private:
   DdlConfig config;
+  std::shared_ptr<KeyReservoir> keys;
 };
 
 enum class AlterSubcommand : std::uint8_t {
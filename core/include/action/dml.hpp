@@ -2,9 +2,12 @@
 #pragma once
 
 #include "action/action.hpp"
+#include "action/key_reservoir.hpp"
+#include "action/run_state.hpp"
 #include "querygen/config.hpp"
 
 #include <functional>
+#include <memory>
 
 namespace action {
 
@@ -20,6 +23,21 @@ struct DmlConfig {
   std::size_t updateMin = 1;
   std::size_t updateMax = 10;
   LockWeights lockWeights;
+  // percent of key-targeted deletes/updates that pick their rows from
+  // RunState::keys instead of ORDER BY random() LIMIT n; they fall back to
+  // the scan while nothing is known for the table. 0 also stops recording
+  // inserted keys
+  std::size_t pkReservoirProb = 90;
+  // percent of FK values still drawn by the ORDER BY random() subquery
+  // instead of from the parent's reservoir keys
+  std::size_t fkScanProb = 0;
+  // rows per bulk_load action
+  std::size_t bulkLoadRows = 10000;
+  // which reservoir keys each key-targeted action goes for
+  KeyDistribution deleteAccess;         // delete_some_data
+  KeyDistribution updateAccess;         // update_one_row
+  KeyDistribution deleteSelectedAccess; // delete_selected
+  KeyDistribution updateSelectedAccess; // update_selected
 };
 
 using TableLocator = std::function<metadata::table_cptr()>;
@@ -27,7 +45,7 @@ using TableLocator = std::function<metadata::table_cptr()>;
 class UpdateOneRow : public Action {
 public:
   UpdateOneRow(DmlConfig const &config,
-               querygen::QueryGenConfig const &qgConfig);
+               querygen::QueryGenConfig const &qgConfig, RunState state);
 
   void execute(metadata::Context &metaCtx, ps_random &rand,
                sql_variant::LoggedSQL *connection) const override;
@@ -35,11 +53,13 @@ public:
 private:
   DmlConfig config;
   querygen::QueryGenConfig qgConfig;
+  RunState state;
 };
 
 class DeleteData : public Action {
 public:
-  DeleteData(DmlConfig const &config, querygen::QueryGenConfig const &qgConfig);
+  DeleteData(DmlConfig const &config, querygen::QueryGenConfig const &qgConfig,
+             RunState state);
 
   void execute(metadata::Context &metaCtx, ps_random &rand,
                sql_variant::LoggedSQL *connection) const override;
@@ -47,6 +67,7 @@ public:
 private:
   DmlConfig config;
   querygen::QueryGenConfig qgConfig;
+  RunState state;
 };
 
 /* SELECT random pks first, modify them in a second statement. Relies on
@@ -55,7 +76,7 @@ private:
 class SelectThenDelete : public Action {
 public:
   SelectThenDelete(DmlConfig const &config,
-                   querygen::QueryGenConfig const &qgConfig);
+                   querygen::QueryGenConfig const &qgConfig, RunState state);
 
   void execute(metadata::Context &metaCtx, ps_random &rand,
                sql_variant::LoggedSQL *connection) const override;
@@ -63,12 +84,13 @@ public:
 private:
   DmlConfig config;
   querygen::QueryGenConfig qgConfig;
+  RunState state;
 };
 
 class SelectThenUpdate : public Action {
 public:
   SelectThenUpdate(DmlConfig const &config,
-                   querygen::QueryGenConfig const &qgConfig);
+                   querygen::QueryGenConfig const &qgConfig, RunState state);
 
   void execute(metadata::Context &metaCtx, ps_random &rand,
                sql_variant::LoggedSQL *connection) const override;
@@ -76,30 +98,56 @@ public:
 private:
   DmlConfig config;
   querygen::QueryGenConfig qgConfig;
+  RunState state;
 };
 
 // executes one randomly generated standalone SELECT
 class SelectQuery : public Action {
 public:
-  SelectQuery(querygen::QueryGenConfig const &config);
+  SelectQuery(querygen::QueryGenConfig const &config, RunState state);
 
   void execute(metadata::Context &metaCtx, ps_random &rand,
                sql_variant::LoggedSQL *connection) const override;
 
 private:
   querygen::QueryGenConfig config;
+  RunState state;
 };
 
 class InsertData : public Action {
 public:
-  InsertData(DmlConfig const &config, std::size_t rows, TableLocator locator);
-  InsertData(DmlConfig const &config, std::size_t rows);
+  InsertData(DmlConfig const &config, RunState state, std::size_t rows,
+             TableLocator locator);
+  InsertData(DmlConfig const &config, RunState state, std::size_t rows);
 
   void execute(metadata::Context &metaCtx, ps_random &rand,
                sql_variant::LoggedSQL *connection) const override;
 
 private:
   DmlConfig config;
+  RunState state;
+  TableLocator locator;
+  std::size_t rows;
+};
+
+/* Streams generated rows into one table in a single COPY FROM STDIN /
+   LOAD DATA LOCAL INFILE statement. Same values as InsertData, except
+   FKs: a reservoir key as a literal (or NULL), since neither statement
+   takes subqueries. A stale key fails the whole COPY on the FK check;
+   LOAD DATA LOCAL implies IGNORE and only skips that row, as it does
+   duplicate keys. */
+class BulkLoad : public Action {
+public:
+  BulkLoad(DmlConfig const &config, RunState state, std::size_t rows,
+           TableLocator locator);
+  BulkLoad(DmlConfig const &config, RunState state, std::size_t rows);
+
+  void execute(metadata::Context &metaCtx, ps_random &rand,
+               sql_variant::LoggedSQL *connection) const override;
+
+private:
+  DmlConfig config;
+  RunState state;
   TableLocator locator;
   std::size_t rows;
 };
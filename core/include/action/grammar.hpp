@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "action/action_registry.hpp"
+#include "action/sql_template.hpp"
+
+namespace action {
+
+/* pstress grammar files: one statement per line, # and -- lines are
+   comments. Placeholders are bare words outside quotes:
+     T1, T2, ...          distinct random tables
+     T1_INT_1, T2_VARCHAR_3, ...
+                          the m-th column of that type of table n
+     T1_INT_1_VALUE       a literal for that column (not in pstress)
+   Types: INT INTEGER BIGINT SMALLINT TINYINT; FLOAT DOUBLE REAL DECIMAL
+   NUMERIC; CHAR VARCHAR TEXT; BOOL BOOLEAN; BLOB BYTEA BINARY VARBINARY.
+   Repeating a line repeats its weight, like pstress picking lines
+   uniformly. */
+struct GrammarRule {
+  std::size_t line; // first occurrence, 1-based
+  std::string text;
+  std::size_t occurrences = 1;
+  ActionType type = ActionType::other;
+  SqlTemplate compiled;
+};
+
+// words that aren't placeholders are SQL, so every line compiles
+[[nodiscard]] std::vector<GrammarRule> parse_grammar(std::string_view text);
+
+// one rule line to a template; placeholders inside quotes stay text
+[[nodiscard]] SqlTemplate compile_pstress_rule(std::string_view line);
+
+} // namespace action
@@ -3,10 +3,15 @@
 #include "action/action.hpp"
 #include "sql_variant/generic.hpp"
 
+#include <chrono>
 #include <tuple>
 
 namespace action {
 
+// generated SELECTs (select_query, oracle_check) can explode; past this
+// they fail instead of holding the worker
+inline constexpr std::chrono::milliseconds runaway_query_cap{10000};
+
 // Throws ActionException("empty-metadata") when there are no tables.
 metadata::table_cptr find_random_table(metadata::Context const &metaCtx,
                                        ps_random &rand);
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <span>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "metadata/catalog.hpp"
+#include "random.hpp"
+
+namespace action {
+
+// which known keys an action goes for
+struct KeyDistribution {
+  enum class Kind : std::uint8_t {
+    uniform,
+    // a few keys take most accesses: counters, popular items
+    zipfian,
+    // hot_fraction of the keys take hot_probability of the accesses
+    hotspot,
+    // zipfian over insertion recency: queue heads, recent orders
+    latest,
+  };
+
+  Kind kind = Kind::uniform;
+  double theta = 0.99; // zipfian/latest skew, > 0
+  double hot_fraction = 0.2;
+  double hot_probability = 0.8;
+};
+
+/* Primary keys known to exist, per table, shared by every worker of a
+   workload. Filled from insert results, thinned by deletes and by keys
+   that turned out to be gone. Lets DML target rows by key instead of
+   ORDER BY random() LIMIT n, which scans and sorts the whole table.
+
+   Never exact: rows also disappear through rollbacks, predicate deletes
+   and dropped partitions, so a drawn key can miss. A miss costs one
+   no-op statement, and the caller reports it with remove().
+
+   Ordered workers (metadata/turns.hpp) hold their turn around every call,
+   as for catalog access: what a draw returns depends on what the other
+   workers added before it. */
+class KeyReservoir {
+public:
+  using Key = std::int64_t;
+
+  // keys kept per table; past that, reservoir sampling keeps a uniform
+  // subset of every key added so far
+  explicit KeyReservoir(std::size_t capacity = 10000);
+
+  void add(metadata::ObjectId table, std::span<Key const> keys);
+  void remove(metadata::ObjectId table, std::span<Key const> keys);
+  // table dropped
+  void forget(metadata::ObjectId table);
+
+  // up to `count` distinct keys of `table`, picked by `dist`. Always
+  // takes `count` draws from `rand`, so the worker's stream doesn't depend
+  // on what other workers put in here; empty when nothing is known for
+  // the table
+  [[nodiscard]] std::vector<Key> sample(metadata::ObjectId table,
+                                        std::size_t count, ps_random &rand,
+                                        KeyDistribution const &dist = {}) const;
+
+  [[nodiscard]] std::size_t size(metadata::ObjectId table) const;
+
+  // true for the one caller that should scan `table` for keys now: the
+  // first, and then once per `interval`. A parent that stays empty is
+  // scanned now and then, not by every statement that wants its keys
+  [[nodiscard]] bool claimSeed(metadata::ObjectId table,
+                               std::chrono::steady_clock::duration interval);
+
+  [[nodiscard]] std::size_t capacity() const { return capacity_; }
+
+private:
+  struct Slot {
+    explicit Slot(std::uint64_t seed) : rng(seed) {}
+
+    std::mutex mutex;
+    std::vector<Key> keys;
+    std::unordered_map<Key, std::size_t> positions;
+    std::uint64_t seen = 0;
+    // replacement draws; private so they never touch a worker's stream
+    xoshiro256pp rng;
+    // newest last, for KeyDistribution::latest; includes keys the sample
+    // above didn't keep
+    std::deque<Key> recent;
+    std::unordered_set<Key> recentSet;
+  };
+
+  // keys remembered for KeyDistribution::latest, per table
+  static constexpr std::size_t recentCapacity = 1024;
+
+  [[nodiscard]] std::shared_ptr<Slot> find(metadata::ObjectId table) const;
+
+  std::size_t capacity_;
+  mutable std::shared_mutex mutex_;
+  std::unordered_map<metadata::ObjectId, std::shared_ptr<Slot>> slots_;
+  // last claimSeed() per table, under mutex_
+  std::unordered_map<metadata::ObjectId, std::chrono::steady_clock::time_point>
+      seededAt_;
+};
+
+} // namespace action
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "action/action.hpp"
+#include "action/run_state.hpp"
+#include "querygen/config.hpp"
+
+namespace action {
+
+struct OracleConfig {
+  // relative weights when picking the oracle for one check
+  std::size_t tlp_weight = 1;
+  std::size_t norec_weight = 1;
+  // side connections the variants run on concurrently, sharing the
+  // snapshot of the worker's own transaction. 0 = run every variant on
+  // the worker's connection, one after another (always the case on
+  // mysql, which can't share snapshots)
+  std::size_t max_connections = 3;
+};
+
+/* Generates one standalone SELECT and checks it with a metamorphic
+   oracle (TLP or NoREC): all variants read one REPEATABLE READ snapshot,
+   results are compared as row-hash multisets. A disagreement is an
+   ActionException("oracle-mismatch") carrying every variant's SQL.
+   Manages its own transactions, so never runs inside another one. */
+class OracleCheck : public Action {
+public:
+  OracleCheck(OracleConfig const &config,
+              querygen::QueryGenConfig const &qgConfig, RunState state);
+
+  void execute(metadata::Context &metaCtx, ps_random &rand,
+               sql_variant::LoggedSQL *connection) const override;
+
+private:
+  OracleConfig config;
+  querygen::QueryGenConfig qgConfig;
+  RunState state;
+};
+
+} // namespace action
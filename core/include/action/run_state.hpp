@@ -0,0 +1,44 @@
+#pragma once
+
+#include "action/key_reservoir.hpp"
+#include "action/statement_cache.hpp"
+#include "querygen/generator.hpp"
+#include "sql_variant/connection_pool.hpp"
+
+#include <memory>
+
+namespace action {
+
+/* What the actions of one run learn and hold while it goes on, next to
+   the knobs in AllConfig. Copies share every object; the Workload owns
+   the original, one per endpoint, and each worker takes forWorker(). */
+struct RunState {
+  // keys the server handed out, for key-targeted DML and FK values
+  std::shared_ptr<KeyReservoir> keys = std::make_shared<KeyReservoir>();
+  // per-table row counts bounding generated joins
+  std::shared_ptr<querygen::RowEstimates> row_estimates =
+      std::make_shared<querygen::RowEstimates>();
+  // plan shapes seen by select_query's sampling
+  std::shared_ptr<querygen::PlanCoverage> plan_coverage =
+      std::make_shared<querygen::PlanCoverage>();
+  // side connections for oracle_check; every worker hands it its connector
+  std::shared_ptr<sql_variant::ConnectionPool> connections =
+      std::make_shared<sql_variant::ConnectionPool>();
+  // not locked, so never shared between workers
+  std::shared_ptr<StatementCache> statements =
+      std::make_shared<StatementCache>();
+
+  [[nodiscard]] querygen::Feedback feedback() const {
+    return {.row_estimates = row_estimates.get(),
+            .plan_coverage = plan_coverage.get()};
+  }
+
+  // the same state with a statement cache of its own
+  [[nodiscard]] RunState forWorker() const {
+    auto copy = *this;
+    copy.statements = std::make_shared<StatementCache>();
+    return copy;
+  }
+};
+
+} // namespace action
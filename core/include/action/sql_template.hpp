@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "action/key_reservoir.hpp"
+#include "metadata/context.hpp"
+#include "random.hpp"
+#include "sql_dialect/dialect.hpp"
+
+namespace action {
+
+/* A SQL statement with typed holes, parsed once. Rendering resolves the
+   holes against the catalog (tables first, then columns, in the order
+   they were declared) and appends everything in one pass.
+
+   Text syntax, compile():
+     {table} {table2} {table3} ...  random tables, all distinct
+     {col:table}                    any column of that table
+     {int_col:table2} {str_col:...} {real_col:...} {bool_col:...}
+     {bin_col:...}                  a column of that type
+     {int_col2:table}               a second, different INT column
+     {value:int_col:table}          a literal fitting that column
+     {pk:table}                     a primary key known to exist
+     {int} {string}                 a random integer / quoted string
+     {{                             a literal {
+   The same placeholder twice means the same table or column. Braces
+   inside '...' string literals ('{a,b}', JSON) and around anything that
+   isn't a name stay literal. */
+class SqlTemplate {
+public:
+  enum class ColumnKind : std::uint8_t {
+    any,
+    integer, // INT
+    real,    // REAL
+    text,    // CHAR, VARCHAR, TEXT
+    boolean, // BOOL
+    binary,  // BYTEA
+  };
+
+  // throws std::invalid_argument on an unknown placeholder
+  [[nodiscard]] static SqlTemplate compile(std::string_view text);
+
+  // a template that is its text, braces and all
+  [[nodiscard]] static SqlTemplate literal(std::string_view text);
+
+  // building blocks for other front ends (grammar files). Table slots are
+  // 0-based; a column is (table slot, kind, ordinal), ordinals of the same
+  // table and kind pick different columns
+  void addLiteral(std::string_view text);
+  void addTable(std::size_t slot);
+  void addColumn(std::size_t slot, ColumnKind kind, std::size_t ordinal);
+  void addValue(std::size_t slot, ColumnKind kind, std::size_t ordinal);
+  void addPk(std::size_t slot);
+  void addInteger();
+  void addString();
+
+  // throws ActionException when the catalog can't fill the holes
+  // ("empty-metadata", "not-enough-tables", "no-matching-column",
+  // "no-single-column-pk" for {pk} on a table without one)
+  [[nodiscard]] std::string render(metadata::Context const &metaCtx,
+                                   ps_random &rand,
+                                   sql_dialect::Dialect const &dialect,
+                                   KeyReservoir const *keys) const;
+
+  [[nodiscard]] std::size_t tableSlots() const { return tableSlots_; }
+
+private:
+  struct ColumnRef {
+    std::size_t slot;
+    ColumnKind kind;
+    std::size_t ordinal;
+
+    bool operator==(ColumnRef const &) const = default;
+  };
+
+  struct Segment {
+    enum class Kind : std::uint8_t {
+      literal,
+      table,
+      column,
+      value,
+      pk,
+      integer,
+      string
+    };
+    Kind kind;
+    std::string text;    // literal
+    std::size_t ref = 0; // table slot, or index into columns_
+  };
+
+  std::size_t columnIndex(ColumnRef ref);
+
+  std::vector<Segment> segments_;
+  std::vector<ColumnRef> columns_;
+  std::size_t tableSlots_ = 0;
+  // rendered size without the holes; the buffer starts there
+  std::size_t literalSize_ = 0;
+};
+
+} // namespace action
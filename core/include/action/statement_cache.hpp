@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "metadata/table.hpp"
+
+namespace action {
+
+// the table-shaped parts of the DML statements, built once per table
+// version; an execution only appends values
+struct TableStatements {
+  // the record they were built from; keeps the column pointers valid
+  metadata::table_cptr source;
+
+  // everything but auto_increment columns, in table order
+  std::vector<metadata::Column const *> valueColumns;
+  std::vector<std::string> valueNames;
+  // "INSERT INTO t (a, b) VALUES "
+  std::string insertPrefix;
+  // "UPDATE t SET " and "a = " per value column
+  std::string updatePrefix;
+  std::vector<std::string> assignments;
+
+  // multi-row SET: value columns minus pk and partition key, which would
+  // collapse every matched row into one key
+  std::vector<metadata::Column const *> bulkSetColumns;
+  std::vector<std::string> bulkSetAssignments;
+};
+
+/* Per-worker, not locked. Keyed by table id and matched on the exact
+   record: catalog records are immutable, so an ALTER or RENAME publishes
+   a new one and the next lookup rebuilds. Comparing the version alone
+   isn't enough, transaction overlays copy a record without bumping it. */
+class StatementCache {
+public:
+  [[nodiscard]] TableStatements const &
+  forTable(metadata::table_cptr const &table);
+
+  [[nodiscard]] std::size_t size() const { return entries_.size(); }
+
+private:
+  // dropped tables are never looked up again; past this, start over
+  static constexpr std::size_t maxEntries = 512;
+
+  std::unordered_map<metadata::ObjectId, TableStatements> entries_;
+};
+
+} // namespace action
@@ -11,13 +11,15 @@ namespace action {
    discards them. */
 class TransactionAction : public Action {
 public:
-  TransactionAction(AllConfig config, ActionRegistry const &pool);
+  TransactionAction(AllConfig config, ActionRegistry const &pool,
+                    RunState state);
 
   void execute(metadata::Context &metaCtx, ps_random &rand,
                sql_variant::LoggedSQL *connection) const override;
 
 private:
   AllConfig allConfig;
+  RunState state;
   ActionRegistry poolAll;   // everything except transaction-typed actions
   ActionRegistry poolNoDdl; // additionally without DDL (mysql exclude mode)
 };
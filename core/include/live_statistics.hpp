@@ -0,0 +1,243 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "statistics.hpp"
+
+/* Statistics readable while the workload runs. WorkerStatistics belongs
+   to its worker thread until join(); next to it, each worker publishes
+   what it did per interval (1s by default) into a SeqlockRing, and an
+   IntervalCollector thread merges the rings of all workers into one time
+   series that any thread can read. */
+namespace statistics {
+
+enum class ActionOutcome : std::uint8_t {
+  success,
+  actionFailure,
+  sqlFailure,
+  conflict,
+  otherFailure
+};
+
+// one action's outcomes within an IntervalStats
+struct ActionCounts {
+  NameId action = NameTable::none;
+  // no padding: SeqlockRing copies values word by word
+  std::uint32_t unused = 0;
+  std::uint64_t successes = 0;
+  // conflicts not included
+  std::uint64_t failures = 0;
+  std::uint64_t conflicts = 0;
+};
+
+// what one worker, or all of them merged, did in one interval: actions
+// that started in it, by outcome, and how long they took. Trivially
+// copyable, it crosses threads through a SeqlockRing
+struct IntervalStats {
+  // LatencyHistogram's layout at 1 significant digit, fixed size: up to
+  // ~134s, slower actions land in the last bucket
+  static constexpr unsigned latencySubBits = 4;
+  static constexpr std::size_t latencyBuckets = 384;
+  // distinct actions counted one by one, in first-seen order; any more
+  // go to otherActions
+  static constexpr std::size_t actionSlots = 64;
+
+  // number of the interval since the collector's epoch
+  std::uint64_t interval = 0;
+  // merged: how many worker intervals went into it
+  std::uint64_t workers = 0;
+  std::uint64_t successes = 0;
+  std::uint64_t actionFailures = 0;
+  std::uint64_t sqlFailures = 0;
+  std::uint64_t conflicts = 0;
+  std::uint64_t otherFailures = 0;
+  std::uint64_t reconnects = 0;
+  std::uint64_t committed = 0;
+  std::uint64_t rolledBackIntentional = 0;
+  std::uint64_t rolledBackError = 0;
+  // sum of the action latencies
+  std::uint64_t latencyMicros = 0;
+  std::array<std::uint32_t, latencyBuckets> latency{};
+  std::array<ActionCounts, actionSlots> byAction{};
+  ActionCounts otherActions{};
+
+  // `action` none: counted in the totals only
+  void recordAction(ActionOutcome outcome, std::chrono::nanoseconds took,
+                    NameId action = NameTable::none);
+  void recordTransaction(const TransactionOutcome &outcome);
+  void merge(const IntervalStats &other);
+  [[nodiscard]] std::uint64_t actions() const;
+  [[nodiscard]] std::uint64_t failures() const;
+  // action latency percentile (0-100) to within ~6%; 0 when empty
+  [[nodiscard]] double percentileMs(double percentile) const;
+};
+
+/* Single writer, any number of readers, no locks: the writer never waits
+   and a reader copies a value out or learns it was overwritten meanwhile.
+   The last N values published are readable. Values are stored as atomic
+   words, so a torn read is caught by the version check, never a data
+   race. */
+template <typename T, std::size_t N> class SeqlockRing {
+  static_assert(std::is_trivially_copyable_v<T>);
+  static_assert(sizeof(T) % sizeof(std::uint64_t) == 0);
+
+public:
+  // writer thread only
+  void publish(const T &value) {
+    auto const seq = published_.load(std::memory_order_relaxed);
+    auto &slot = slots_[seq % N];
+    slot.version.store((2 * seq) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    auto const words = std::bit_cast<Words>(value);
+    for (std::size_t i = 0; i < words.size(); ++i) {
+      slot.words[i].store(words[i], std::memory_order_relaxed);
+    }
+    slot.version.store((2 * seq) + 2, std::memory_order_release);
+    published_.store(seq + 1, std::memory_order_release);
+  }
+
+  [[nodiscard]] static constexpr std::size_t capacity() { return N; }
+
+  // values published so far; the next one gets this number
+  [[nodiscard]] std::uint64_t published() const {
+    return published_.load(std::memory_order_acquire);
+  }
+
+  // value number `seq`; nullopt when not published yet or overwritten
+  [[nodiscard]] std::optional<T> read(std::uint64_t seq) const {
+    auto const &slot = slots_[seq % N];
+    auto const version = slot.version.load(std::memory_order_acquire);
+    if (version != (2 * seq) + 2) {
+      return std::nullopt;
+    }
+    Words words;
+    for (std::size_t i = 0; i < words.size(); ++i) {
+      words[i] = slot.words[i].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.version.load(std::memory_order_relaxed) != version) {
+      return std::nullopt;
+    }
+    return std::bit_cast<T>(words);
+  }
+
+private:
+  using Words = std::array<std::uint64_t, sizeof(T) / sizeof(std::uint64_t)>;
+
+  struct Slot {
+    // 2n + 1 while value n is written, 2n + 2 once it is complete
+    std::atomic<std::uint64_t> version{0};
+    std::array<std::atomic<std::uint64_t>, sizeof(T) / sizeof(std::uint64_t)>
+        words{};
+  };
+
+  std::array<Slot, N> slots_;
+  std::atomic<std::uint64_t> published_{0};
+};
+
+// every interval a collector read, summed: counters since it started,
+// for exporters. The latency buckets are 64-bit here, they would wrap in
+// `counts` over a long run
+struct IntervalTotals {
+  // its latency buckets stay empty
+  IntervalStats counts;
+  std::array<std::uint64_t, IntervalStats::latencyBuckets> latency{};
+
+  void add(const IntervalStats &stats);
+};
+
+/* Statements sent and not answered yet, over all connections of the
+   process; LoggedSQL holds one of these around each. */
+class StatementInFlight {
+public:
+  StatementInFlight() { count_.fetch_add(1, std::memory_order_relaxed); }
+  ~StatementInFlight() { count_.fetch_sub(1, std::memory_order_relaxed); }
+  StatementInFlight(StatementInFlight const &) = delete;
+  StatementInFlight &operator=(StatementInFlight const &) = delete;
+  StatementInFlight(StatementInFlight &&) = delete;
+  StatementInFlight &operator=(StatementInFlight &&) = delete;
+
+  [[nodiscard]] static std::int64_t count() {
+    return count_.load(std::memory_order_relaxed);
+  }
+
+private:
+  static inline std::atomic<std::int64_t> count_{0};
+};
+
+// a worker's last 16 intervals; the collector reads every half interval
+using IntervalRing = SeqlockRing<IntervalStats, 16>;
+
+/* Merges the interval rings of every attached worker into one time series,
+   from its own thread, every half interval. Workers number their
+   intervals from the collector's epoch, so intervals of different workers
+   line up. A ring whose worker is gone is read one last time and
+   dropped. */
+class IntervalCollector {
+public:
+  using clock = std::chrono::steady_clock;
+
+  // keeps the last `keep` merged intervals; throws std::invalid_argument
+  // for a zero interval
+  explicit IntervalCollector(
+      std::chrono::milliseconds interval = std::chrono::seconds(1),
+      std::size_t keep = 3600);
+  ~IntervalCollector();
+
+  IntervalCollector(IntervalCollector const &) = delete;
+  IntervalCollector &operator=(IntervalCollector const &) = delete;
+  IntervalCollector(IntervalCollector &&) = delete;
+  IntervalCollector &operator=(IntervalCollector &&) = delete;
+
+  // a ring for one worker to publish into
+  [[nodiscard]] std::shared_ptr<IntervalRing> attach();
+
+  [[nodiscard]] std::chrono::milliseconds interval() const {
+    return interval_;
+  }
+  // the interval `at` falls in
+  [[nodiscard]] std::uint64_t intervalAt(clock::time_point at) const;
+
+  // reads the rings now rather than at the next tick
+  void collect();
+  // the last `count` merged intervals, oldest first. A worker publishes
+  // an interval once it is past it, so the newest may still grow
+  [[nodiscard]] std::vector<IntervalStats> latest(std::size_t count) const;
+  [[nodiscard]] IntervalTotals totals() const;
+
+private:
+  struct Source {
+    std::shared_ptr<IntervalRing> ring;
+    // the next value to read
+    std::uint64_t next = 0;
+    bool done = false;
+  };
+
+  void run();
+
+  std::chrono::milliseconds interval_;
+  std::size_t keep_;
+  clock::time_point epoch_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<Source> sources_;
+  std::map<std::uint64_t, IntervalStats> merged_;
+  IntervalTotals totals_;
+  bool stopping_ = false;
+  std::thread thread_;
+};
+
+} // namespace statistics
@@ -13,6 +13,7 @@
 #include <vector>
 
 #include "metadata/table.hpp"
+#include "metadata/turns.hpp"
 #include "random.hpp"
 
 /*
@@ -35,6 +36,10 @@
   capture by value; a [&] capture dangles at COMMIT replay.
 
   A TxnBuffer belongs to one worker; nothing here locks.
+
+  With Turns attached, every catalog operation made through a Context
+  waits for the worker's turn (metadata/turns.hpp): workers then see the
+  catalog change in a seed-determined order.
 */
 
 namespace metadata {
@@ -213,10 +218,11 @@ private:
    Mirrors the Catalog API so action bodies keep their shape. */
 template <CatalogObject T> class CatalogView {
 public:
-  CatalogView(Catalog<T> &catalog, TxnBuffer<T> *txn)
-      : catalog_(&catalog), txn_(txn) {}
+  CatalogView(Catalog<T> &catalog, TxnBuffer<T> *txn, Turns turns = {})
+      : catalog_(&catalog), txn_(txn), turns_(turns) {}
 
   [[nodiscard]] object_cptr<T> byId(ObjectId id) const {
+    TurnScope const turn(turns_);
     if (txn_ != nullptr) {
       if (txn_->erasedContains(id)) {
         return nullptr;
@@ -229,6 +235,7 @@ public:
   }
 
   [[nodiscard]] object_cptr<T> byName(std::string_view name) const {
+    TurnScope const turn(turns_);
     if (txn_ == nullptr) {
       return catalog_->byName(name);
     }
@@ -245,6 +252,7 @@ public:
   }
 
   object_cptr<T> randomPick(ps_random &rand) const {
+    TurnScope const turn(turns_);
     if (txn_ == nullptr) {
       return catalog_->randomPick(rand);
     }
@@ -256,6 +264,7 @@ public:
   }
 
   [[nodiscard]] std::size_t size() const {
+    TurnScope const turn(turns_);
     if (txn_ == nullptr) {
       return catalog_->size();
     }
@@ -263,6 +272,7 @@ public:
   }
 
   [[nodiscard]] std::vector<object_cptr<T>> snapshotAll() const {
+    TurnScope const turn(turns_);
     if (txn_ == nullptr) {
       return catalog_->snapshotAll();
     }
@@ -279,6 +289,7 @@ public:
   }
 
   bool insert(T &&obj) {
+    TurnScope const turn(turns_);
     if (txn_ == nullptr) {
       return catalog_->insert(std::move(obj));
     }
@@ -290,6 +301,7 @@ public:
   }
 
   bool update(ObjectId id, TxnBuffer<T>::delta_fn delta) {
+    TurnScope const turn(turns_);
     if (txn_ == nullptr) {
       return catalog_->update(id, std::move(delta));
     }
@@ -297,26 +309,33 @@ public:
   }
 
   bool erase(ObjectId id) {
+    TurnScope const turn(turns_);
     if (txn_ == nullptr) {
       return catalog_->erase(id);
     }
     return txn_->erase(id, *catalog_);
   }
 
+  // for shared state kept next to the catalog (the key reservoir), which
+  // must wait for the turn as well
+  [[nodiscard]] Turns turns() const { return turns_; }
+
 private:
   Catalog<T> *catalog_;
   TxnBuffer<T> *txn_;
+  Turns turns_;
 };
 
 class Context {
 public:
   explicit Context(TableRegistry &reg) : reg_(&reg) {}
-  Context(TableRegistry &reg, TxnBuffer<Table> *txn) : reg_(&reg), txn_(txn) {}
+  Context(TableRegistry &reg, TxnBuffer<Table> *txn, Turns turns = {})
+      : reg_(&reg), txn_(txn), turns_(turns) {}
 
   // single-kind today: txn_ is Table-typed; a second catalog kind needs
   // per-kind buffers
   template <typename T> [[nodiscard]] CatalogView<T> get() const {
-    return CatalogView<T>(reg_->get<T>(), txn_);
+    return CatalogView<T>(reg_->get<T>(), txn_, turns_);
   }
 
   // a TxnBuffer is attached iff a server-side transaction is open;
@@ -324,13 +343,21 @@ public:
   // sub-actions with the unbuffered context)
   [[nodiscard]] bool inTransaction() const { return txn_ != nullptr; }
 
-  ObjectId nextId() { return reg_->nextId(); }
+  ObjectId nextId() {
+    TurnScope const turn(turns_);
+    return reg_->nextId();
+  }
 
   TableRegistry &registry() { return *reg_; }
 
+  // for contexts derived from this one, and for direct catalog access
+  // (TxnBuffer replay) that must wait for the turn like a view would
+  [[nodiscard]] Turns turns() const { return turns_; }
+
 private:
   TableRegistry *reg_;
   TxnBuffer<Table> *txn_ = nullptr;
+  Turns turns_;
 };
 
 } // namespace metadata
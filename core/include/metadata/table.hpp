@@ -102,6 +102,9 @@ struct Table : ObjectBase {
   boost::container::small_vector<Index, limits::optimized_index_count> indexes;
 
   [[nodiscard]] bool hasReferenceTo(ObjectId target) const;
+  // the primary key column; nullptr without a primary key or with a
+  // composite one
+  [[nodiscard]] Column const *primaryKey() const;
   // true if any reference was removed
   bool removeReferencesTo(ObjectId target);
 };
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "random.hpp"
+
+namespace metadata {
+
+/* Orders catalog access across workers by a seeded logical clock, so a
+   multi-worker run makes the same metadata decisions every time. Every
+   worker has a clock; a catalog operation runs only while its worker's
+   clock is the lowest of the workers still running (ties: lower slot),
+   and each operation advances the clock by a seeded step in
+   [1, participants]. SQL runs outside turns, concurrently.
+
+   A worker busy with SQL holds back everyone whose clock is higher. If
+   that wait is circular (the busy worker waits on a row lock held by a
+   waiting one), the waiter gives up after `stall` and goes out of order.
+   stalls() counts those; a run with stalls stops replaying from there. */
+class TurnScheduler {
+public:
+  TurnScheduler(std::uint64_t seed, std::size_t participants,
+                std::chrono::milliseconds stall = std::chrono::seconds(10));
+
+  // slots go out in call order, which must itself be deterministic (the
+  // order workers start in). No turn is granted before every participant
+  // enrolled. Throws std::logic_error past `participants`
+  std::size_t enroll();
+
+  // reentrant for the holder
+  void acquire(std::size_t slot);
+  void release(std::size_t slot);
+
+  // the worker is done: it stops holding back the others
+  void retire(std::size_t slot);
+
+  // stop ordering, every acquire() returns at once: for error paths where
+  // an enrolled worker will never run
+  void cancel();
+
+  [[nodiscard]] std::size_t participants() const { return participants_; }
+  [[nodiscard]] std::uint64_t turns() const;
+  [[nodiscard]] std::uint64_t stalls() const;
+  // summed over workers: what the ordering cost in throughput
+  [[nodiscard]] std::chrono::nanoseconds waited() const;
+
+private:
+  static constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+
+  struct Slot {
+    std::uint64_t clock = 0;
+    bool active = true;
+    xoshiro256pp rng;
+  };
+
+  // mutex held
+  [[nodiscard]] bool mayRun(std::size_t slot) const;
+  void take(std::size_t slot);
+
+  std::uint64_t seed_;
+  std::size_t participants_;
+  std::chrono::milliseconds stall_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<Slot> slots_;
+  std::size_t holder_ = none;
+  std::size_t depth_ = 0;
+  bool cancelled_ = false;
+  std::uint64_t turns_ = 0;
+  std::uint64_t stalls_ = 0;
+  std::chrono::nanoseconds waited_{0};
+};
+
+// a worker's place in a TurnScheduler; the default orders nothing
+struct Turns {
+  TurnScheduler *scheduler = nullptr;
+  std::size_t slot = 0;
+};
+
+// a worker's enrollment in a TurnScheduler: retires the slot when
+// destroyed. Move-only; a moved-from enrollment holds no slot, so
+// relocating its worker doesn't retire the slot from under it
+class TurnSlot {
+public:
+  TurnSlot() = default;
+  explicit TurnSlot(TurnScheduler &scheduler)
+      : turns_{.scheduler = &scheduler, .slot = scheduler.enroll()} {}
+  ~TurnSlot() { retire(); }
+
+  TurnSlot(TurnSlot const &) = delete;
+  TurnSlot &operator=(TurnSlot const &) = delete;
+  TurnSlot(TurnSlot &&other) noexcept
+      : turns_(std::exchange(other.turns_, {})) {}
+  TurnSlot &operator=(TurnSlot &&other) noexcept {
+    if (this != &other) {
+      retire();
+      turns_ = std::exchange(other.turns_, {});
+    }
+    return *this;
+  }
+
+  [[nodiscard]] Turns turns() const { return turns_; }
+
+  // the worker is done; a no-op without a slot
+  void retire() {
+    if (turns_.scheduler != nullptr) {
+      turns_.scheduler->retire(turns_.slot);
+    }
+  }
+
+private:
+  Turns turns_;
+};
+
+// holds the worker's turn while alive
+class TurnScope {
+public:
+  explicit TurnScope(Turns turns) : turns_(turns) {
+    if (turns_.scheduler != nullptr) {
+      turns_.scheduler->acquire(turns_.slot);
+    }
+  }
+  ~TurnScope() {
+    if (turns_.scheduler != nullptr) {
+      turns_.scheduler->release(turns_.slot);
+    }
+  }
+
+  TurnScope(TurnScope const &) = delete;
+  TurnScope &operator=(TurnScope const &) = delete;
+  TurnScope(TurnScope &&) = delete;
+  TurnScope &operator=(TurnScope &&) = delete;
+
+private:
+  Turns turns_;
+};
+
+} // namespace metadata
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include "live_statistics.hpp"
+
+namespace statistics {
+
+enum class MetricsFormat : std::uint8_t {
+  // application/openmetrics-text 1.0.0: counter families named without
+  // _total, a UNIT line, "# EOF" at the end
+  openMetrics,
+  // Prometheus text 0.0.4, which node_exporter's textfile collector
+  // parses: families named as their samples, no UNIT, no EOF
+  prometheus,
+};
+
+// what a collector read so far: actions by outcome and by action,
+// transactions, reconnects, the action latency histogram and the
+// statements in flight
+[[nodiscard]] std::string renderMetrics(const IntervalTotals &totals,
+                                        std::int64_t inFlight,
+                                        MetricsFormat format);
+
+/* Exposes the live statistics of a workload to Prometheus-style scrapers
+   without any service next to it: a Prometheus textfile for
+   node_exporter's textfile collector, rewritten every period, and/or a
+   minimal HTTP listener on 127.0.0.1 answering GET /metrics with
+   OpenMetrics. Both come from the IntervalCollector's
+   totals, so they lag the workers by up to one interval. One thread,
+   which only waits on the listener and the textfile period. */
+class MetricsExporter {
+public:
+  struct Options {
+    // replaced through a rename, so a reader never sees half of it; empty
+    // for none. node_exporter wants the .prom extension
+    std::string textfile;
+    // 0 picks a free port, see port(); nullopt for no listener
+    std::optional<std::uint16_t> port;
+    std::chrono::milliseconds period = std::chrono::seconds(5);
+  };
+
+  // throws std::invalid_argument without a textfile or port, or for a
+  // zero period; std::runtime_error when the port can't be listened on
+  MetricsExporter(std::shared_ptr<IntervalCollector> collector,
+                  Options options);
+  ~MetricsExporter();
+
+  MetricsExporter(MetricsExporter const &) = delete;
+  MetricsExporter &operator=(MetricsExporter const &) = delete;
+  MetricsExporter(MetricsExporter &&) = delete;
+  MetricsExporter &operator=(MetricsExporter &&) = delete;
+
+  // the port listened on, 0 without a listener
+  [[nodiscard]] std::uint16_t port() const { return port_; }
+  // what a scrape (openMetrics) or the textfile (prometheus) gets now
+  [[nodiscard]] std::string
+  render(MetricsFormat format = MetricsFormat::openMetrics) const;
+  // ends the thread and writes the textfile a last time; the destructor
+  // does the same
+  void stop();
+
+private:
+  void run();
+  void writeTextfile() const;
+  void serve(int client) const;
+
+  std::shared_ptr<IntervalCollector> collector_;
+  Options options_;
+  int listener_ = -1;
+  std::uint16_t port_ = 0;
+  // stop() writes into [1] to wake the thread from poll()
+  std::array<int, 2> wake_{-1, -1};
+  std::thread thread_;
+};
+
+} // namespace statistics
@@ -22,6 +22,16 @@ struct QueryGenConfig {
   // legacy pk-subquery / randomRowsSelect forms
   std::size_t dml_predicate_prob = 30;
   std::size_t dml_pk_select_prob = 30;
+  // cap on the estimated row count of a join tree / set op, from the
+  // server's row estimates; 0 = unbounded. Estimates drift with the data,
+  // so byte-identical replay needs 0 here
+  std::size_t max_estimated_rows = 1000000;
+  std::size_t estimate_refresh_seconds = 30;
+  // percent of select_query runs that EXPLAIN first and feed the plan
+  // shape back into the feature probabilities above; 0 = off
+  std::size_t plan_sample_prob = 0;
+  // sampled queries whose plan shape is already known are not executed
+  bool plan_skip_seen = false;
 };
 
 } // namespace querygen
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_set>
+
+namespace querygen {
+
+// generator features whose probability the coverage loop may bias
+enum class Feature : std::uint8_t {
+  join,
+  subquery,
+  aggregate,
+  cte,
+  setop,
+  window,
+  orderBy,
+  limit,
+  correlation,
+};
+inline constexpr std::size_t featureCount = 9;
+using FeatureSet = std::bitset<featureCount>;
+using FeatureBias = std::array<double, featureCount>;
+
+/* Plan shapes seen so far (hashes of EXPLAIN JSON with costs, row counts
+   and expressions stripped), shared by every worker of a workload.
+   Each sample also scores the features the query used; features that
+   recently led to new shapes get their probability scaled up, the rest
+   down. Scores decay, so the bias follows what is still productive. */
+class PlanCoverage {
+public:
+  // true when `shape` was not seen before
+  bool record(std::uint64_t shape, FeatureSet used);
+
+  // per-feature probability multipliers, 1.0 until enough samples exist
+  [[nodiscard]] FeatureBias bias() const;
+
+  [[nodiscard]] std::size_t distinctPlans() const;
+  [[nodiscard]] std::size_t samples() const;
+
+private:
+  struct Score {
+    double samples = 0;
+    double novel = 0;
+  };
+
+  mutable std::shared_mutex mutex_;
+  std::unordered_set<std::uint64_t> seen_;
+  std::array<Score, featureCount> scores_{};
+  Score total_;
+  std::size_t samples_ = 0;
+};
+
+// nullopt when the text isn't an EXPLAIN FORMAT=JSON document. Works for
+// both the pg and the mysql layout: only node/access kinds and the tree
+// structure contribute, never numbers or expression text
+[[nodiscard]] std::optional<std::uint64_t>
+planShapeHash(std::string_view explainJson);
+
+} // namespace querygen
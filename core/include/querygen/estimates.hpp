@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "metadata/catalog.hpp"
+
+namespace sql_variant {
+class LoggedSQL;
+}
+
+namespace querygen {
+
+/* Per-table row-count estimates taken from the server's own statistics
+   (pg_class.reltuples, information_schema.TABLES.TABLE_ROWS), shared by
+   every worker of a workload. One worker refreshes at a time; the others
+   keep reading the previous map. Estimates only bound the shape of
+   generated queries, they never have to be exact. */
+class RowEstimates {
+public:
+  using clock = std::chrono::steady_clock;
+  using Map = std::unordered_map<std::string, double, metadata::StringHash,
+                                 std::equal_to<>>;
+
+  // nullopt when the table is unknown or the server has no estimate yet
+  [[nodiscard]] std::optional<double> rows(std::string_view table) const;
+
+  // false until the first successful refresh
+  [[nodiscard]] bool loaded() const;
+
+  void replace(Map estimates, clock::time_point at = clock::now());
+
+  // the last attempt is older than `interval`
+  [[nodiscard]] bool stale(std::chrono::seconds interval) const;
+
+  // claims the one refresh in flight when stale: true for the caller that
+  // should refresh() now and then endRefresh(). The others, false, keep
+  // reading the previous map and need no connection for it
+  [[nodiscard]] bool tryBeginRefresh(std::chrono::seconds interval);
+  // re-reads the estimates; a failed attempt keeps the previous map until
+  // the next one. Never throws
+  void refresh(sql_variant::LoggedSQL &conn);
+  void endRefresh();
+
+private:
+  mutable std::shared_mutex mutex_;
+  std::shared_ptr<Map const> map_;
+  clock::time_point attemptedAt_{};
+  std::atomic<bool> refreshing_{false};
+};
+
+} // namespace querygen
@@ -2,23 +2,37 @@
 
 #include "metadata/context.hpp"
 #include "querygen/config.hpp"
+#include "querygen/coverage.hpp"
+#include "querygen/estimates.hpp"
 #include "querygen/ir.hpp"
 #include "random.hpp"
 #include "sql_variant/generic.hpp"
 
 #include <optional>
 #include <string_view>
+#include <unordered_map>
 
 namespace querygen {
 
 enum class Purpose : std::uint8_t { standalone, pkSelect, predicate };
 
+// what earlier queries of the run learned; nullptr = not known
+struct Feedback {
+  RowEstimates const *row_estimates = nullptr;
+  PlanCoverage const *plan_coverage = nullptr;
+};
+
 /* One-shot: construct, call generate()/generatePredicate() once. Draws
-   all randomness up front from the caller's stream; no server IO. */
+   all randomness up front from the caller's stream; no server IO.
+   Join trees and set ops are cut short once their estimated row count
+   (feedback.row_estimates, refreshed by the caller) passes
+   cfg.max_estimated_rows. Feature probabilities are scaled by the plan
+   coverage bias (feedback.plan_coverage) when plan sampling is on. */
 class Generator {
 public:
   Generator(metadata::Context const &ctx, ps_random &rand,
-            QueryGenConfig const &cfg, sql_variant::ServerInfo const &server);
+            QueryGenConfig const &cfg, sql_variant::ServerInfo const &server,
+            Feedback feedback = {});
 
   // nullopt when the catalog has no usable tables
   std::optional<QuerySpec> generate(Purpose purpose,
@@ -38,6 +52,9 @@ public:
   Expr generatePredicate(metadata::table_cptr target,
                          std::string_view qualifier);
 
+  // features rolled in so far, for PlanCoverage::record
+  [[nodiscard]] FeatureSet features() const { return used_; }
+
 private:
   struct ScopeEntry {
     std::string alias;
@@ -61,9 +78,13 @@ private:
 
   QuerySpec genQuery(Purpose purpose, metadata::table_cptr target,
                      Scope const &outer, std::size_t subqDepth,
-                     bool allowExtras); // Task 7
+                     bool allowExtras, double *estimatedRows = nullptr);
+
+  // >= 1, so it can divide; CTEs use their body's estimate
+  [[nodiscard]] double rowsOf(metadata::Table const &table) const;
 
   bool roll(std::size_t percent);
+  bool rollFeature(Feature f, std::size_t percent);
   std::string freshAlias();
 
   // ctx_/server_ kept for later stages (snapshot refresh, feature gates)
@@ -71,8 +92,15 @@ private:
   ps_random &rand_;
   QueryGenConfig const &cfg_;
   [[maybe_unused]] sql_variant::ServerInfo server_;
+  Feedback feedback_;
   std::vector<metadata::table_cptr> tables_; // snapshotAll, id-sorted
   std::size_t aliasCounter_ = 0;
+  // false until the shared estimates were loaded at least once: with
+  // nothing to go on, queries are not bounded at all
+  bool bounded_ = false;
+  std::unordered_map<std::string, double> cteRows_;
+  FeatureBias bias_{};
+  FeatureSet used_;
 };
 
 } // namespace querygen
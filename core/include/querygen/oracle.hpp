@@ -2,23 +2,64 @@
 
 #include "querygen/ir.hpp"
 
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace querygen {
 
-// result rows of one variant execution; exact shape decided when the
-// first oracle lands (phase 2)
-struct QueryResult;
+/* Result rows of one variant execution as an order-insensitive multiset:
+   row hash -> multiplicity. Comparing two results is linear in the row
+   count, with no sorting and no copies of the row data. */
+struct QueryResult {
+  std::unordered_map<std::uint64_t, std::size_t> rows;
+  std::size_t rowCount = 0;
+
+  void addRow(std::span<std::optional<std::string_view> const> fields);
+  // multiset union, for partitioned variants
+  void merge(QueryResult const &other);
+
+  bool operator==(QueryResult const &) const = default;
+};
 
 /* Metamorphic oracle: derive variant queries from a base query, then
    judge the combined results. Implementations (TLP, NoREC) are pure
    IR transforms - QuerySpec is a value type precisely for this. */
 struct Oracle {
   virtual ~Oracle() = default;
+  [[nodiscard]] virtual std::string_view name() const = 0;
+  // empty when the oracle doesn't apply to `base`
   [[nodiscard]] virtual std::vector<QuerySpec>
   variants(QuerySpec const &base) const = 0;
+  // results in variants() order
   [[nodiscard]] virtual bool
   verdict(std::vector<QueryResult> const &results) const = 0;
 };
 
+/* Ternary logic partitioning: the base query without its WHERE must
+   return exactly the rows of WHERE p, WHERE NOT p and WHERE p IS NULL
+   together. Variants: [unfiltered, p, NOT p, p IS NULL]. */
+struct TlpOracle : Oracle {
+  [[nodiscard]] std::string_view name() const override { return "tlp"; }
+  [[nodiscard]] std::vector<QuerySpec>
+  variants(QuerySpec const &base) const override;
+  [[nodiscard]] bool
+  verdict(std::vector<QueryResult> const &results) const override;
+};
+
+/* Non-optimizing reference engine construction: COUNT(*) ... WHERE p,
+   which the optimizer may rewrite freely, against counting the rows
+   where CASE WHEN p THEN 1 ELSE 0 END is 1 - p evaluated as a plain
+   expression. Variants: [optimized, unoptimized]. */
+struct NoRecOracle : Oracle {
+  [[nodiscard]] std::string_view name() const override { return "norec"; }
+  [[nodiscard]] std::vector<QuerySpec>
+  variants(QuerySpec const &base) const override;
+  [[nodiscard]] bool
+  verdict(std::vector<QueryResult> const &results) const override;
+};
+
 } // namespace querygen
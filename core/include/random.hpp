@@ -1,25 +1,102 @@
-
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
 #include <cstdint>
+#include <limits>
+#include <optional>
 #include <random>
+#include <span>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+/* What a seed expands to. A recorded (seed, stream) pair replays the same
+   draws on every build that still has the stream; new streams get a new
+   id instead of changing an old one. */
+enum class RngStream : std::uint8_t {
+  // std::mt19937_64 with the std distributions. The distributions are
+  // implementation-defined: replays only on the same standard library
+  mt19937 = 1,
+  // xoshiro256++ with portable bounded draws: identical everywhere
+  xoshiro = 2,
+};
+
+inline constexpr RngStream default_rng_stream = RngStream::xoshiro;
+
+// xoshiro256++ (Blackman, Vigna), state expanded from the seed by
+// splitmix64
+class xoshiro256pp {
+public:
+  using result_type = std::uint64_t;
+
+  explicit xoshiro256pp(std::uint64_t seed);
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  result_type operator()() {
+    auto const result = std::rotl(s[0] + s[3], 23) + s[0];
+    auto const t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = std::rotl(s[3], 45);
+    return result;
+  }
+
+  // advance by 2^128 (jump) or 2^192 (long_jump) draws: non-overlapping
+  // substreams of one seed
+  void jump();
+  void long_jump();
+
+  bool operator==(xoshiro256pp const &) const = default;
+
+  [[nodiscard]] std::array<std::uint64_t, 4> const &state() const {
+    return s;
+  }
+  void setState(std::array<std::uint64_t, 4> const &state) { s = state; }
+
+private:
+  void jumpWith(std::array<std::uint64_t, 4> const &poly);
+
+  std::array<std::uint64_t, 4> s;
+};
 
 class ps_random {
 public:
   ps_random();
-  explicit ps_random(std::uint64_t fixed_seed);
+  explicit ps_random(std::uint64_t fixed_seed,
+                     RngStream stream = default_rng_stream);
 
   std::string random_string(std::size_t min_length, std::size_t max_length);
+  // raw bytes, eight per draw
+  void fill_bytes(std::span<std::byte> out);
 
   template <typename T> T random_number(T min, T max) {
+    if (legacy) {
+      if constexpr (std::is_floating_point_v<T>) {
+        std::uniform_real_distribution<> len_dist(min, max);
+        return len_dist(*legacy);
+      } else {
+        std::uniform_int_distribution<std::size_t> len_dist(min, max);
+        return len_dist(*legacy);
+      }
+    }
     if constexpr (std::is_floating_point_v<T>) {
-      std::uniform_real_distribution<> len_dist(min, max);
-      return len_dist(rng);
+      // 53 random mantissa bits, [0, 1)
+      auto const unit = static_cast<double>(fast() >> 11) * 0x1.0p-53;
+      return static_cast<T>(min + ((max - min) * unit));
     } else {
-      std::uniform_int_distribution<std::size_t> len_dist(min, max);
-      return len_dist(rng);
+      auto const lo = as_u64(min);
+      return static_cast<T>(lo + bounded(as_u64(max) - lo));
     }
   }
 
@@ -31,10 +108,62 @@ public:
   bool random_bool() { return random_number<bool>(false, true); }
 
   template <typename T> void shuffle(T &container) {
-    std::ranges::shuffle(container, rng);
+    if (legacy) {
+      std::ranges::shuffle(container, *legacy);
+      return;
+    }
+    // Fisher-Yates on bounded(): std::shuffle's draws are unspecified
+    auto first = std::ranges::begin(container);
+    auto const n = static_cast<std::uint64_t>(std::ranges::size(container));
+    for (std::uint64_t i = n; i > 1; --i) {
+      auto const j = bounded(i - 1);
+      std::ranges::iter_swap(first + (i - 1), first + j);
+    }
   }
 
+  // xoshiro stream only, throw std::logic_error on mt19937
+  void jump();
+  void long_jump();
+
+  [[nodiscard]] RngStream stream() const {
+    return legacy ? RngStream::mt19937 : RngStream::xoshiro;
+  }
+
+  // printable stream position ("xoshiro:..." / "mt19937:..."): restore()
+  // on a ps_random of any seed continues with exactly the draws this one
+  // would make next, stream included
+  [[nodiscard]] std::string checkpoint() const;
+  // throws std::invalid_argument on anything checkpoint() can't produce
+  void restore(std::string_view checkpoint);
+
 private:
+  template <typename T> static std::uint64_t as_u64(T v) {
+    if constexpr (std::is_signed_v<T>) {
+      return static_cast<std::uint64_t>(static_cast<std::int64_t>(v));
+    } else {
+      return static_cast<std::uint64_t>(v);
+    }
+  }
+
+  // uniform in [0, range]; Lemire's multiply-shift with rejection
+  std::uint64_t bounded(std::uint64_t range) {
+    if (range == std::numeric_limits<std::uint64_t>::max()) {
+      return fast();
+    }
+    __extension__ using u128 = unsigned __int128;
+    auto const n = range + 1;
+    auto m = static_cast<u128>(fast()) * n;
+    if (static_cast<std::uint64_t>(m) < n) {
+      auto const threshold = (0 - n) % n;
+      while (static_cast<std::uint64_t>(m) < threshold) {
+        m = static_cast<u128>(fast()) * n;
+      }
+    }
+    return static_cast<std::uint64_t>(m >> 64);
+  }
+
   std::uint64_t seed;
-  std::mt19937_64 rng;
+  xoshiro256pp fast;
+  // engaged for RngStream::mt19937 only: 2.5KB of state nobody else needs
+  std::optional<std::mt19937_64> legacy;
 };
@@ -5,6 +5,7 @@
 #include "sql_variant/generic.hpp"
 
 #include <cstdint>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -69,6 +70,19 @@ public:
   randomRowsSelect(std::string_view tableName, std::string_view columnName,
                    std::size_t limit, LockClause lock) const = 0;
 
+  // appended to an INSERT to get the generated keys back as rows; "" when
+  // the server reports them otherwise (QueryResult::insertId)
+  [[nodiscard]] virtual std::string
+  insertReturning(std::string_view columnName) const = 0;
+
+  // (table name, estimated rows) for every table of the current schema,
+  // straight from the server's statistics; negative = never analyzed
+  [[nodiscard]] virtual std::string rowEstimatesQuery() const = 0;
+
+  // EXPLAIN of an already-rendered query; one row, JSON plan in column 0
+  [[nodiscard]] virtual std::string
+  explainJson(std::string_view query) const = 0;
+
   // capabilities
   [[nodiscard]] virtual bool partitionsInlineInCreate() const = 0;
   [[nodiscard]] virtual bool supportsFkOnPartitionedTables() const = 0;
@@ -96,6 +110,14 @@ public:
   [[nodiscard]] virtual std::vector<std::string>
   beginStatements(IsolationLevel level) const = 0;
 
+  // statement returning an id other sessions adopt with importSnapshot()
+  // to read the exact data this transaction reads; nullopt = the server
+  // can't share snapshots between sessions
+  [[nodiscard]] virtual std::optional<std::string> exportSnapshot() const = 0;
+  // first statement after BEGIN ISOLATION LEVEL REPEATABLE READ
+  [[nodiscard]] virtual std::string
+  importSnapshot(std::string_view snapshotId) const = 0;
+
   // rendered concatenation of two already-rendered scalar expressions
   [[nodiscard]] virtual std::string concatExpr(std::string_view lhs,
                                                std::string_view rhs) const = 0;
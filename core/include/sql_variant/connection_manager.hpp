@@ -0,0 +1,116 @@
+#pragma once
+
+#include "sql_variant/generic.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "random.hpp"
+
+namespace sql_variant {
+
+// probe delays: doubling from `initial` up to `max`, each jittered down
+// by up to half
+struct ReconnectBackoff {
+  std::chrono::milliseconds initial{50};
+  std::chrono::milliseconds max{2000};
+};
+
+/* Brings the workers of one endpoint back after the server restarts.
+   Shared by a workload's workers like ConnectionPool.
+
+   The first worker to find the server gone probes it with jittered
+   exponential backoff while the others wait for the outcome. Once a probe
+   gets through, the waiting workers connect in parallel. `spares`
+   connections, opened with the first connector registered, are kept
+   ready on the side (logging as sql-conn-spare-N until handed out), so
+   workers that notice the outage later skip the connect. A connection is
+   only handed out after a `SELECT 1` went through on it. */
+class ConnectionManager {
+public:
+  using connector_t = std::function<std::unique_ptr<LoggedSQL>()>;
+
+  // connect() waits up to `patience` for the server
+  explicit ConnectionManager(
+      std::size_t spares = 0,
+      std::chrono::milliseconds patience = std::chrono::seconds(60),
+      ReconnectBackoff backoff = {});
+  ~ConnectionManager();
+
+  ConnectionManager(ConnectionManager const &) = delete;
+  ConnectionManager &operator=(ConnectionManager const &) = delete;
+  ConnectionManager(ConnectionManager &&) = delete;
+  ConnectionManager &operator=(ConnectionManager &&) = delete;
+
+  // for the spares; first connector wins, workers of one workload all
+  // connect alike
+  void setConnector(connector_t connector);
+
+  // a working connection: a spare, switched to the `logName` log, or one
+  // opened with `connector` on the calling thread. Throws
+  // SqlException("server-not-ready") when the server doesn't take one
+  // within `patience`
+  [[nodiscard]] std::unique_ptr<LoggedSQL>
+  connect(connector_t const &connector, std::string const &logName);
+
+  [[nodiscard]] std::size_t idle() const;
+  // outages seen: a connection attempt failed while none was known
+  [[nodiscard]] std::uint64_t outages() const;
+  // connection attempts that failed, probes included
+  [[nodiscard]] std::uint64_t failedAttempts() const;
+  // the last outage: first failed attempt to the probe that got through
+  [[nodiscard]] std::chrono::nanoseconds lastDowntime() const;
+  // the last outage: probe through to the last worker that was waiting
+  // for it connected again. The time to full load after a restart
+  [[nodiscard]] std::chrono::nanoseconds lastRestore() const;
+
+private:
+  using clock = std::chrono::steady_clock;
+
+  // connects and checks the connection; nullptr when either fails. Never
+  // under the mutex
+  [[nodiscard]] static std::unique_ptr<LoggedSQL>
+  open(connector_t const &connector, std::string const &logName = {});
+  // mutex held: a failed attempt
+  void failed();
+  // mutex held: a probe got through
+  void up();
+  // mutex held: a caller got its connection
+  void served();
+  [[nodiscard]] std::chrono::milliseconds jittered(std::size_t round);
+  void fill();
+
+  std::size_t spares_;
+  std::chrono::milliseconds patience_;
+  ReconnectBackoff backoff_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  connector_t connector_;
+  std::vector<std::unique_ptr<LoggedSQL>> idle_;
+  bool down_ = false;
+  bool probing_ = false;
+  bool stopping_ = false;
+  // timing only, never SQL: free to be unseeded
+  xoshiro256pp jitter_;
+
+  std::uint64_t sparesOpened_ = 0;
+  std::size_t waiting_ = 0;
+  // waiters at the moment the probe got through, not yet served
+  std::size_t restoring_ = 0;
+  clock::time_point downSince_;
+  clock::time_point upAgain_;
+  std::uint64_t outages_ = 0;
+  std::uint64_t failedAttempts_ = 0;
+  std::chrono::nanoseconds lastDowntime_{0};
+  std::chrono::nanoseconds lastRestore_{0};
+
+  std::thread filler_;
+};
+
+} // namespace sql_variant
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "sql_variant/generic.hpp"
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace sql_variant {
+
+/* Spare connections shared by every worker of a workload, for actions
+   that need more than the worker's own one. Opened lazily with the
+   connector of the first worker that registers one, each under its own
+   log (sql-conn-pool-N), and kept open between uses. */
+class ConnectionPool {
+public:
+  using connector_t = std::function<std::unique_ptr<LoggedSQL>()>;
+
+  // first connector wins; workers of one workload all connect alike
+  void setConnector(connector_t connector);
+
+  // up to `count` live connections: idle ones that fail a probe are
+  // dropped and replaced. Fewer when no connector is set or opening a new
+  // one fails
+  std::vector<std::unique_ptr<LoggedSQL>> acquire(std::size_t count);
+
+  // hand back after use; connections the server dropped are not wanted
+  void release(std::unique_ptr<LoggedSQL> conn);
+
+  [[nodiscard]] std::size_t idle() const;
+
+private:
+  mutable std::mutex mutex_;
+  connector_t connector_;
+  std::vector<std::unique_ptr<LoggedSQL>> idle_;
+  std::size_t opened_ = 0;
+};
+
+} // namespace sql_variant
@@ -4,9 +4,11 @@
 #include <chrono>
 #include <cstdint>
 #include <exception>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <spdlog/spdlog.h>
+#include <stop_token>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -99,6 +101,7 @@ enum class ErrorClass : std::uint8_t {
   conflict,  // serialization failure / deadlock: expected under concurrency
   failedTxn, // pg 25P02: statement in an already-aborted transaction
   serverGone,
+  timeout, // cancelled by the StatementWatchdog at its deadline
   other
 };
 
@@ -183,6 +186,12 @@ struct QueryResult {
   std::chrono::nanoseconds executionTime;
   ErrorInfo errorInfo;
   std::uint64_t affectedRows = 0;
+  // first auto_increment value of an INSERT (mysql_insert_id); 0 = none.
+  // pg reports generated keys through RETURNING instead
+  std::uint64_t insertId = 0;
+  // the gap between the keys of one multi-row INSERT: insertId,
+  // insertId + insertIdStep, ... (auto_increment_increment)
+  std::uint64_t insertIdStep = 1;
 
   std::unique_ptr<QuerySpecificResult> data;
 
@@ -201,6 +210,18 @@ struct QueryResult {
   }
 };
 
+/* Rows for bulkLoad(), one call per row: writes the row into `line` in
+   COPY text format (fields separated by tabs, \N for NULL, backslash
+   escapes, no trailing newline) and returns true, or returns false at the
+   end. `line` arrives empty. Both pg COPY and mysql LOAD DATA read this
+   format with their default options. */
+using RowSource = std::function<bool(std::string &line)>;
+
+// appends field `index` of a row to a RowSource line: separator, escapes,
+// \N for nullopt
+void appendCopyField(std::string &line, std::size_t index,
+                     std::optional<std::string_view> value);
+
 class GenericSQL {
 public:
   GenericSQL() = default;
@@ -221,6 +242,16 @@ public:
   executeParams(std::string const &query,
                 std::vector<Param> const &params) const = 0;
 
+  // streams `rows` into `table` in one statement, without a file on
+  // either side: COPY FROM STDIN on pg, LOAD DATA LOCAL INFILE on mysql.
+  // affectedRows = rows loaded. COPY fails whole on the first bad row;
+  // LOAD DATA LOCAL implies IGNORE, skipping duplicates and rows failing
+  // a check, so affectedRows can be short of the rows sent. The default
+  // fails with "bulk-unsupported"
+  [[nodiscard]] virtual QueryResult
+  bulkLoad(std::string const &table, std::vector<std::string> const &columns,
+           RowSource const &rows) const;
+
   [[nodiscard]] virtual std::string serverInfoString() const = 0;
 
   [[nodiscard]] ServerInfo serverInfo() const;
@@ -229,16 +260,41 @@ public:
 
   virtual void reconnect() = 0;
 
+  // asks the server to stop this connection's statement in flight, which
+  // then fails as usual. Called from another thread than the one running
+  // the statement, never concurrently with reconnect(). Best effort: a
+  // statement that starts right after isn't affected. The default does
+  // nothing
+  virtual void cancelQuery() const;
+
 protected:
   ServerInfo serverInfo_;
 };
 
+/* Sees every statement a LoggedSQL sends, in order, before its result
+   is known: failed statements are part of the stream too. Used to record
+   workload plans. */
+class StatementSink {
+public:
+  virtual ~StatementSink();
+
+  // params == nullptr: sent with executeQuery
+  virtual void statement(std::string const &query,
+                         std::vector<Param> const *params) = 0;
+
+  // the rows the server read, after the load
+  virtual void bulkLoad(std::string const &table,
+                        std::vector<std::string> const &columns,
+                        std::vector<std::string> const &rows) = 0;
+};
+
 class LoggedSQL;
+class StatementWatchdog;
 
 // restores the connection's previous action name on destruction
 class ActionNameScope {
 public:
-  ActionNameScope(LoggedSQL &conn, std::string name);
+  ActionNameScope(LoggedSQL &conn, statistics::NameId name);
   ~ActionNameScope();
   ActionNameScope(ActionNameScope const &) = delete;
   ActionNameScope &operator=(ActionNameScope const &) = delete;
@@ -247,7 +303,23 @@ public:
 
 private:
   LoggedSQL &conn;
-  std::string prev;
+  statistics::NameId prev;
+};
+
+// tightens the statement time limit of a watched connection while alive;
+// no-op on an unwatched one
+class StatementCap {
+public:
+  StatementCap(LoggedSQL &conn, std::chrono::milliseconds limit);
+  ~StatementCap();
+  StatementCap(StatementCap const &) = delete;
+  StatementCap &operator=(StatementCap const &) = delete;
+  StatementCap(StatementCap &&) = delete;
+  StatementCap &operator=(StatementCap &&) = delete;
+
+private:
+  LoggedSQL &conn;
+  std::chrono::milliseconds prev;
 };
 
 class LoggedSQL {
@@ -262,6 +334,10 @@ public:
   executeParams(std::string const &query,
                 std::vector<Param> const &params) const;
 
+  [[nodiscard]] QueryResult bulkLoad(std::string const &table,
+                                     std::vector<std::string> const &columns,
+                                     RowSource const &rows) const;
+
   // throws SqlException on any failure; empty params = plain executeQuery
   // (multi-statement capable), non-empty = single-statement executeParams
   QueryResult safeQuery(std::string const &query,
@@ -273,6 +349,25 @@ public:
 
   void reconnect();
 
+  // see GenericSQL::cancelQuery; safe while another thread executes
+  void cancelQuery() const;
+
+  // while stop is requested on `token`, statements fail with
+  // "worker-stopped" instead of being sent. ROLLBACK still goes out, so
+  // the action a stop cuts short leaves no transaction open. Default:
+  // never
+  void setStopToken(std::stop_token token);
+
+  // every statement runs under `watchdog`, which cancels it after
+  // `timeout` (0: only within a StatementCap). nullptr = unwatched
+  void setWatchdog(std::shared_ptr<StatementWatchdog> watchdog,
+                   std::chrono::milliseconds timeout);
+  [[nodiscard]] bool watched() const { return watchdog != nullptr; }
+
+  // switches to the sql-conn-<logName> log; connections built by the same
+  // connector share a log otherwise, and file loggers aren't thread-safe
+  void renameLog(std::string const &logName);
+
   std::chrono::nanoseconds getAccumulatedSqlTime() const;
   void resetAccumulatedSqlTime();
 
@@ -280,29 +375,49 @@ public:
   // callers detect whether an opaque operation actually sent SQL
   std::uint64_t getQueryCount() const;
 
-  void setCurrentAction(std::string name);
+  // by interned name on the worker's hot path, see statistics::NameTable
+  void setCurrentAction(statistics::NameId name);
+  void setCurrentAction(std::string_view name);
   [[nodiscard]] std::string const &currentAction() const;
-  [[nodiscard]] ActionNameScope scopedActionName(std::string name);
+  [[nodiscard]] ActionNameScope scopedActionName(statistics::NameId name);
+  [[nodiscard]] ActionNameScope scopedActionName(std::string_view name);
 
   void recordTransactionOutcome(statistics::TransactionOutcome const &outcome);
 
-  // return-and-clear; the worker drains after every action
-  std::vector<statistics::RowObservation> drainRowObservations();
-  std::vector<statistics::TransactionOutcome> drainTransactionOutcomes();
+  // moves them into `into`, which is cleared first; the worker drains
+  // after every action, into the same vector, so neither side allocates
+  // once both have grown
+  void drainRowObservations(std::vector<statistics::RowObservation> &into);
+  void
+  drainTransactionOutcomes(std::vector<statistics::TransactionOutcome> &into);
   // drop anything accumulated outside the worker loop (setup queries)
   void clearObservations();
 
+  // nullptr = off; the sink stays with this connection across reconnect()
+  void setStatementSink(std::shared_ptr<StatementSink> sink);
+
 private:
+  friend class StatementCap;
+  friend class ActionNameScope;
+
   void observeResult(std::string const &query, QueryResult const &res) const;
+  // around each statement; nullopt when there is nothing to watch
+  [[nodiscard]] std::optional<std::uint64_t> watch() const;
+  void unwatch(std::optional<std::uint64_t> ticket, QueryResult &res) const;
 
   std::unique_ptr<GenericSQL> sql;
   std::shared_ptr<spdlog::logger> logger;
   mutable std::chrono::nanoseconds accumulatedSqlTime{0};
   mutable std::uint64_t queryCount{0};
 
-  std::string currentAction_;
+  statistics::NameId currentAction_ = statistics::NameTable::none;
   mutable std::vector<statistics::RowObservation> rowObservations;
   std::vector<statistics::TransactionOutcome> txnOutcomes;
+  std::shared_ptr<StatementSink> sink;
+  std::stop_token stopToken;
+  std::shared_ptr<StatementWatchdog> watchdog;
+  std::chrono::milliseconds statementTimeout{0};
+  std::chrono::milliseconds cap{0};
 };
 
 } // namespace sql_variant
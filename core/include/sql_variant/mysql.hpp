@@ -25,6 +25,10 @@ public:
   executeParams(std::string const &query,
                 std::vector<Param> const &params) const override;
 
+  [[nodiscard]] QueryResult
+  bulkLoad(std::string const &table, std::vector<std::string> const &columns,
+           RowSource const &rows) const override;
+
   [[nodiscard]] std::string serverInfoString() const override;
 
   [[nodiscard]] std::string hostInfo() const override;
@@ -33,9 +37,19 @@ public:
 
   void reconnect() override {} // TODO
 
+  // KILL QUERY on a connection of its own
+  void cancelQuery() const override;
+
 private:
+  ServerParams params;
   MYSQL *connection;
+  // server-side id of `connection`, for KILL QUERY
+  unsigned long threadId = 0;
+  // @@auto_increment_increment as of connect (PXC sets it to the cluster
+  // size); a later SET on this session isn't seen
+  std::uint64_t insertIdStep = 1;
 
   [[nodiscard]] ServerInfo calculateServerInfo() const;
+  [[nodiscard]] std::uint64_t readInsertIdStep() const;
 };
 } // namespace sql_variant
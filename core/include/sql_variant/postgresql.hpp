@@ -26,6 +26,10 @@ public:
   executeParams(std::string const &query,
                 std::vector<Param> const &params) const override;
 
+  [[nodiscard]] QueryResult
+  bulkLoad(std::string const &table, std::vector<std::string> const &columns,
+           RowSource const &rows) const override;
+
   [[nodiscard]] std::string serverInfoString() const override;
 
   [[nodiscard]] std::string hostInfo() const override;
@@ -34,6 +38,9 @@ public:
 
   void reconnect() override;
 
+  // PQcancel through pqxx
+  void cancelQuery() const override;
+
 private:
   ServerParams params;
   std::unique_ptr<pqxx::connection> connection;
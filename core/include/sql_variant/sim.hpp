@@ -0,0 +1,117 @@
+#pragma once
+
+#include "random.hpp"
+#include "sql_variant/generic.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+namespace sql_variant {
+
+struct SimParams {
+  // what the harness believes it talks to: picks dialect, error codes
+  flavor flavor_ = flavor::postgres;
+  std::uint64_t version = 170000;
+
+  std::uint64_t seed = 0;
+
+  // per-statement latency, lognormal around the median; 0 = instant
+  std::chrono::nanoseconds latency_median{0};
+  double latency_sigma = 0.5;
+  // false: latency is only reported as execution time, nothing sleeps
+  bool sleep = true;
+
+  // per-statement probabilities
+  double error_rate = 0;
+  double conflict_rate = 0;
+  // the whole server goes away: every open connection fails with
+  // serverGone, and the next down_connects connection attempts (by any
+  // connection) are refused
+  double server_gone_rate = 0;
+  std::size_t down_connects = 3;
+
+  // shape of SELECT / WITH results; other statements report affected_rows
+  std::size_t select_rows = 1;
+  std::size_t select_fields = 1;
+  std::uint64_t affected_rows = 1;
+};
+
+/* The state every connection of one simulated server shares: outages and
+   connection numbering. Outages are counted in connection attempts, not
+   wall time, so a given seed replays the same reconnect storm. */
+class SimServer {
+public:
+  explicit SimServer(SimParams params);
+
+  [[nodiscard]] SimParams const &params() const { return params_; }
+
+  // seed for the next connection's stream: params.seed mixed with the
+  // connection ordinal
+  std::uint64_t nextConnectionSeed();
+
+  // incarnation the new connection belongs to; throws SqlException
+  // ("sim-connection-refused") during an outage
+  std::uint64_t connect();
+  void crash();
+  [[nodiscard]] bool alive(std::uint64_t incarnation) const;
+
+  // first of `count` fresh auto_increment values
+  std::uint64_t allocateIds(std::uint64_t count);
+
+private:
+  SimParams params_;
+  std::atomic<std::uint64_t> connections_{0};
+  std::atomic<std::uint64_t> nextInsertId_{1};
+
+  mutable std::mutex mutex_;
+  std::uint64_t incarnation_ = 1;
+  std::size_t refuseConnects_ = 0;
+};
+
+/* GenericSQL without a server: parses nothing, returns synthetic results
+   shaped by the SimServer's params, with injected latency, errors,
+   conflicts and outages drawn from a per-connection seeded stream.
+   Connecting during an outage throws, as the real drivers do. */
+class Simulated : public GenericSQL {
+public:
+  explicit Simulated(std::shared_ptr<SimServer> server);
+
+  void logError(std::ostream &ostream) const override;
+
+  [[nodiscard]] QueryResult
+  executeQuery(std::string const &query) const override;
+
+  [[nodiscard]] QueryResult
+  executeParams(std::string const &query,
+                std::vector<Param> const &params) const override;
+
+  [[nodiscard]] QueryResult
+  bulkLoad(std::string const &table, std::vector<std::string> const &columns,
+           RowSource const &rows) const override;
+
+  [[nodiscard]] std::string serverInfoString() const override;
+
+  [[nodiscard]] std::string hostInfo() const override;
+
+  // keeps the old, dead connection when refused
+  void reconnect() override;
+
+  // cuts the latency sleep of the statement in flight short; it fails
+  // like a cancelled one (57014 / 1317)
+  void cancelQuery() const override;
+
+private:
+  std::shared_ptr<SimServer> server;
+  std::uint64_t incarnation;
+  // the xoshiro stream: the same draws on every standard library
+  mutable ps_random rng;
+
+  mutable std::mutex cancelMutex;
+  mutable std::condition_variable cancelCv;
+  mutable bool sleeping = false;
+  mutable bool cancelled = false;
+};
+
+} // namespace sql_variant
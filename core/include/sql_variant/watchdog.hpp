@@ -0,0 +1,61 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace sql_variant {
+
+class GenericSQL;
+
+/* Bounds statement latency without SET statement_timeout round trips. One
+   thread per workload watches the statements in flight on every connection
+   that registered one, and cancels a statement at the protocol level
+   (GenericSQL::cancelQuery: PQcancel, KILL QUERY) once its deadline passes.
+   The server then fails it like any other cancelled statement. */
+class StatementWatchdog {
+public:
+  using clock = std::chrono::steady_clock;
+
+  StatementWatchdog();
+  ~StatementWatchdog();
+
+  StatementWatchdog(StatementWatchdog const &) = delete;
+  StatementWatchdog &operator=(StatementWatchdog const &) = delete;
+  StatementWatchdog(StatementWatchdog &&) = delete;
+  StatementWatchdog &operator=(StatementWatchdog &&) = delete;
+
+  // the statement about to go out on `conn` must end by `deadline`. `conn`
+  // must stay alive until disarm()
+  [[nodiscard]] std::uint64_t arm(GenericSQL const &conn,
+                                  clock::time_point deadline);
+
+  // the statement ended. True if the watchdog cancelled it; waits for a
+  // cancel in progress, so none lands on the next statement
+  bool disarm(std::uint64_t ticket);
+
+  [[nodiscard]] std::uint64_t cancels() const;
+
+private:
+  struct Watch {
+    GenericSQL const *conn;
+    clock::time_point deadline;
+    bool fired = false;
+    bool cancelling = false;
+  };
+
+  void run();
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::map<std::uint64_t, Watch> watches_;
+  std::uint64_t nextTicket_ = 0;
+  std::uint64_t cancels_ = 0;
+  bool stopping_ = false;
+  std::thread thread_;
+};
+
+} // namespace sql_variant
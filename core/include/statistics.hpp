@@ -5,15 +5,42 @@
 #include <cstdint>
 #include <map>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace statistics {
 
+/* Process-wide ids for action names and error names/codes, so recording
+   indexes flat arrays instead of hashing and copying strings. A name is
+   interned once, when the registry is built or when it is first seen,
+   and keeps its id for the life of the process. Thread-safe. */
+using NameId = std::uint32_t;
+
+class NameTable {
+public:
+  // the empty name, also what a connection outside any action reports
+  static constexpr NameId none = 0;
+
+  [[nodiscard]] static NameId intern(std::string_view name);
+  // throws std::out_of_range for an id intern() never returned
+  [[nodiscard]] static std::string const &name(NameId id);
+};
+
+// what a statement did to rows, see RowObservation
+enum class RowKind : std::uint8_t { select, insert, update, del, dml };
+inline constexpr std::size_t rowKindCount = 5;
+
+// "select", "insert", "update", "delete", "dml"
+[[nodiscard]] std::string_view rowKindName(RowKind kind);
+
 struct RowHistogram {
   // buckets: 0, 1, 2-10, 11-100, 101-1000, 1000+
   std::array<uint64_t, 6> buckets{};
 
   void record(uint64_t rows);
+  void merge(const RowHistogram &other);
   [[nodiscard]] uint64_t total() const;
   [[nodiscard]] bool hasData() const;
   void reset();
@@ -24,20 +51,71 @@ struct TimingHistogram {
   std::array<uint64_t, 7> buckets{};
 
   void record(std::chrono::nanoseconds duration);
+  void merge(const TimingHistogram &other);
   void reset();
 };
 
+/* HDR-style log-linear latency histogram in microseconds: exact below
+   2^subBits us, above that 2^subBits linear buckets per power of two, so
+   a bucket is never wider than 2^-subBits of the values in it. `digits`
+   significant decimal digits pick subBits: 1 -> 4, 2 -> 7 (<1%), 3 -> 10
+   (<0.1%). Buckets are allocated up to the largest value seen, a few KB
+   for millisecond latencies at 2 digits. Histograms of the same precision
+   merge exactly. */
+class LatencyHistogram {
+public:
+  static constexpr unsigned maxDigits = 3;
+
+  // throws std::invalid_argument outside 1..maxDigits
+  explicit LatencyHistogram(unsigned digits = defaultDigits());
+
+  // what histograms built without an explicit precision use; set before
+  // the workers start
+  static void setDefaultDigits(unsigned digits);
+  [[nodiscard]] static unsigned defaultDigits();
+
+  void record(std::chrono::nanoseconds duration);
+  // throws std::invalid_argument when the precisions differ
+  void merge(const LatencyHistogram &other);
+  // the highest value equivalent to the one `percentile` (0-100) percent
+  // of the recorded values are at or below; 0 when empty
+  [[nodiscard]] std::chrono::nanoseconds
+  valueAtPercentile(double percentile) const;
+  [[nodiscard]] uint64_t count() const { return count_; }
+  [[nodiscard]] unsigned digits() const { return digits_; }
+  void reset();
+
+  // the bucket layout, shared with fixed-size histograms of the same
+  // shape (IntervalStats)
+  [[nodiscard]] static std::size_t bucketOf(uint64_t micros,
+                                            unsigned subBits);
+  [[nodiscard]] static uint64_t highestIn(std::size_t bucket,
+                                          unsigned subBits);
+
+private:
+  unsigned digits_;
+  unsigned subBits_;
+  uint64_t count_ = 0;
+  std::vector<uint64_t> counts_;
+};
+
 struct TimingStatistics {
   std::chrono::nanoseconds totalTime{0};
   std::chrono::nanoseconds minTime{std::chrono::nanoseconds::max()};
   std::chrono::nanoseconds maxTime{0};
   uint64_t count = 0;
   TimingHistogram histogram;
+  LatencyHistogram latency;
 
   void record(std::chrono::nanoseconds duration);
+  // exact: same precision on both sides, see LatencyHistogram
+  void merge(const TimingStatistics &other);
   [[nodiscard]] double getAverageMs() const;
   [[nodiscard]] double getMinMs() const;
   [[nodiscard]] double getMaxMs() const;
+  // percentile in 0-100, within the histogram's precision and never
+  // outside [min, max]
+  [[nodiscard]] double getPercentileMs(double percentile) const;
   void reset();
   [[nodiscard]] bool hasData() const;
 };
@@ -60,10 +138,10 @@ struct TransactionOutcome {
 };
 
 // one record per successful query, produced by LoggedSQL, drained by the
-// worker into ActionStatistics::rowHistograms
+// worker into ActionStatistics::rows
 struct RowObservation {
-  std::string action;
-  std::string kind; // "select", "insert", "update", "delete", "dml"
+  NameId action = NameTable::none;
+  RowKind kind = RowKind::select;
   uint64_t rows = 0;
 };
 
@@ -78,11 +156,15 @@ struct TransactionStatistics {
   RowHistogram subActionsPerTxn;
 
   void record(const TransactionOutcome &outcome);
+  void merge(const TransactionStatistics &other);
   [[nodiscard]] uint64_t total() const;
   [[nodiscard]] bool hasData() const;
   void reset();
 };
 
+// errors by interned name, in first-seen order: an action sees a handful
+using ErrorCounts = std::vector<std::pair<NameId, uint64_t>>;
+
 struct ActionStatistics {
   uint64_t successCount = 0;
   uint64_t actionFailureCount = 0;
@@ -90,9 +172,10 @@ struct ActionStatistics {
   uint64_t otherFailureCount = 0;
   uint64_t sqlConflictCount = 0;
 
-  std::map<std::string, uint64_t> actionErrorNames;
-  std::map<std::string, uint64_t> sqlErrorCodes;
-  std::map<std::string, RowHistogram> rowHistograms;
+  ErrorCounts actionErrors;
+  ErrorCounts sqlErrors;
+  // indexed by RowKind
+  std::array<RowHistogram, rowKindCount> rows{};
 
   TimingStatistics executionTiming;
   TimingStatistics sqlTiming;
@@ -106,51 +189,109 @@ struct ActionStatistics {
   void start();
   void
   recordSuccess(std::chrono::nanoseconds sqlTime = std::chrono::nanoseconds{0});
+  void recordActionFailure(
+      NameId errorName,
+      std::chrono::nanoseconds sqlTime = std::chrono::nanoseconds{0});
   void recordActionFailure(
       const std::string &errorName,
       std::chrono::nanoseconds sqlTime = std::chrono::nanoseconds{0});
+  void recordSqlFailure(
+      NameId errorCode,
+      std::chrono::nanoseconds sqlTime = std::chrono::nanoseconds{0});
   void recordSqlFailure(
       const std::string &errorCode,
       std::chrono::nanoseconds sqlTime = std::chrono::nanoseconds{0});
   void recordOtherFailure(
       std::chrono::nanoseconds sqlTime = std::chrono::nanoseconds{0});
+  void recordConflict(
+      NameId errorCode,
+      std::chrono::nanoseconds sqlTime = std::chrono::nanoseconds{0});
   void recordConflict(
       const std::string &errorCode,
       std::chrono::nanoseconds sqlTime = std::chrono::nanoseconds{0});
-  void recordRows(const std::string &kind, uint64_t rows);
+  void recordRows(RowKind kind, uint64_t rows);
+  // counters, errors, row histograms and timings; not startTime
+  void merge(const ActionStatistics &other);
   [[nodiscard]] uint64_t getTotalCount() const;
   [[nodiscard]] uint64_t getTotalFailureCount() const;
   [[nodiscard]] double getSuccessRate() const;
 
+  // by name, for reports and bindings: built on every call
+  [[nodiscard]] std::map<std::string, uint64_t> actionErrorNames() const;
+  [[nodiscard]] std::map<std::string, uint64_t> sqlErrorCodes() const;
+  // the kinds that saw statements
+  [[nodiscard]] std::map<std::string, RowHistogram> rowHistograms() const;
+  [[nodiscard]] RowHistogram const &rowHistogram(RowKind kind) const {
+    return rows[static_cast<std::size_t>(kind)];
+  }
+
   void reset();
   [[nodiscard]] bool hasData() const;
 };
 
+/* The worker thread records by interned action name: after the first
+   action of a kind, that is an index into a flat array, no hashing and no
+   allocation. The by-string overloads intern on every call, for tests and
+   cold paths. */
 struct WorkerStatistics {
   std::unordered_map<std::string, ActionStatistics> actionStats;
   TransactionStatistics txnStats;
+  // lost connection to working connection again, once per reconnect
+  TimingStatistics reconnectTiming;
   std::chrono::steady_clock::time_point startTime;
   std::chrono::steady_clock::time_point endTime;
 
+  WorkerStatistics() = default;
+  WorkerStatistics(const WorkerStatistics &other);
+  WorkerStatistics(WorkerStatistics &&other) noexcept = default;
+  WorkerStatistics &operator=(const WorkerStatistics &other);
+  WorkerStatistics &operator=(WorkerStatistics &&other) noexcept = default;
+  ~WorkerStatistics() = default;
+
+  // the entry of actionStats for `actionName`
+  ActionStatistics &action(NameId actionName);
+
+  void startAction(NameId actionName);
   void startAction(const std::string &actionName);
   void
+  recordSuccess(NameId actionName,
+                std::chrono::nanoseconds sqlTime = std::chrono::nanoseconds{0});
+  void
   recordSuccess(const std::string &actionName,
                 std::chrono::nanoseconds sqlTime = std::chrono::nanoseconds{0});
+  void recordActionFailure(
+      NameId actionName, NameId errorName,
+      std::chrono::nanoseconds sqlTime = std::chrono::nanoseconds{0});
   void recordActionFailure(
       const std::string &actionName, const std::string &errorName,
       std::chrono::nanoseconds sqlTime = std::chrono::nanoseconds{0});
+  void recordSqlFailure(
+      NameId actionName, NameId errorCode,
+      std::chrono::nanoseconds sqlTime = std::chrono::nanoseconds{0});
   void recordSqlFailure(
       const std::string &actionName, const std::string &errorCode,
       std::chrono::nanoseconds sqlTime = std::chrono::nanoseconds{0});
+  void recordOtherFailure(
+      NameId actionName,
+      std::chrono::nanoseconds sqlTime = std::chrono::nanoseconds{0});
   void recordOtherFailure(
       const std::string &actionName,
       std::chrono::nanoseconds sqlTime = std::chrono::nanoseconds{0});
+  void recordConflict(
+      NameId actionName, NameId errorCode,
+      std::chrono::nanoseconds sqlTime = std::chrono::nanoseconds{0});
   void recordConflict(
       const std::string &actionName, const std::string &errorCode,
       std::chrono::nanoseconds sqlTime = std::chrono::nanoseconds{0});
-  void recordRows(const std::string &actionName, const std::string &kind,
+  void recordRows(NameId actionName, RowKind kind, uint64_t rows);
+  void recordRows(const std::string &actionName, RowKind kind,
                   uint64_t rows);
   void recordTransaction(const TransactionOutcome &outcome);
+  void recordReconnect(std::chrono::nanoseconds downtime);
+  // adds `other` action by action; the time span becomes the one covering
+  // both, which is the run time for workers of the same cycle. Throws
+  // std::invalid_argument when the latency precisions differ
+  void merge(const WorkerStatistics &other);
   void start();
   void stop();
   void reset();
@@ -165,6 +306,52 @@ struct WorkerStatistics {
   double getActionsPerSecond() const;
 
   bool hasData() const;
+
+private:
+  // NameId -> entry of actionStats, whose nodes never move; filled on
+  // first use. A copy starts over, its entries are elsewhere
+  std::vector<ActionStatistics *> byId_;
+};
+
+/* Every worker of every cycle added into one WorkerStatistics, for the
+   report of a whole workload. Workers of a cycle run side by side, the
+   cycles one after the other: the duration is the sum of the cycles'
+   spans, and actions per second are over that. */
+class WorkloadStatistics {
+public:
+  // throws std::invalid_argument when the latency precisions differ
+  void add(std::size_t cycle, const WorkerStatistics &worker);
+  // another run's aggregate; spans of the same cycle number are joined
+  void merge(const WorkloadStatistics &other);
+  void reset();
+
+  // all actions of all workers, by action name
+  [[nodiscard]] WorkerStatistics const &total() const { return total_; }
+  // execution time of every action, whichever it was
+  [[nodiscard]] TimingStatistics const &executionTiming() const {
+    return executionTiming_;
+  }
+  [[nodiscard]] std::size_t workerCount() const { return workers_; }
+  [[nodiscard]] std::size_t cycleCount() const { return cycles_.size(); }
+  [[nodiscard]] double getTotalDurationSeconds() const;
+  [[nodiscard]] double getActionsPerSecond() const;
+
+  [[nodiscard]] std::string report() const;
+  [[nodiscard]] std::string reportSummary() const;
+
+private:
+  struct Span {
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point end;
+  };
+
+  // widens the span of `cycle` to cover `span`
+  void cover(std::size_t cycle, Span span);
+
+  WorkerStatistics total_;
+  TimingStatistics executionTiming_;
+  std::size_t workers_ = 0;
+  std::map<std::size_t, Span> cycles_;
 };
 
 } // namespace statistics
@@ -1,14 +1,28 @@
 
 #pragma once
 
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
+#include <mutex>
+#include <optional>
+#include <stop_token>
 #include <thread>
+#include <utility>
+#include <vector>
 
 #include "action/action_registry.hpp"
 #include "checksum.hpp"
+#include "live_statistics.hpp"
 #include "metadata/table.hpp"
+#include "metadata/turns.hpp"
+#include "random.hpp"
+#include "sql_variant/connection_manager.hpp"
 #include "sql_variant/generic.hpp"
+#include "sql_variant/watchdog.hpp"
 #include "statistics.hpp"
+#include "workload_phases.hpp"
+#include "workload_plan.hpp"
 
 using logged_sql_ptr = std::unique_ptr<sql_variant::LoggedSQL>;
 
@@ -23,6 +37,111 @@ struct WorkloadParams {
   // 0 = entropy seed (default, current behavior), nonzero = deterministic
   // per-worker stream derived from (seed, worker name)
   std::uint64_t seed = 0;
+  // what a nonzero seed expands to; RngStream::mt19937 replays seeds
+  // recorded before the xoshiro stream existed
+  RngStream rng_stream = default_rng_stream;
+  // every this many actions a RandomWorker appends its position to
+  // worker-<name>.rng.jsonl in the log dir; 0 = off
+  std::size_t checkpoint_interval = 0;
+  // one line of such a file: the worker continues from that position
+  // instead of starting from the seed
+  std::string resume_from;
+  // a RandomWorker stops after this many actions even with time left;
+  // 0 = only the duration counts
+  std::size_t max_actions = 0;
+  // nonempty: every RandomWorker records the statements it sends to
+  // <plan_dir>/<worker name>.plan.jsonl, for PlanWorker playback
+  std::string plan_dir;
+  // actions per second, per worker; 0 = as fast as they go. Changeable
+  // while running, see Worker::set_rate
+  double target_rate = 0;
+  // with RunContext::watchdog: deadline for any statement, 0 = only the
+  // caps
+  std::size_t statement_timeout_ms = 0;
+};
+
+/* The objects the workers of one run share, next to the knobs in
+   WorkloadParams. Copies share them too; every member may be nullptr
+   except `actions`. */
+struct RunContext {
+  // enrolls the RandomWorkers in construction order: their catalog access
+  // then follows a seeded logical clock and replays across runs
+  std::shared_ptr<metadata::TurnScheduler> turns;
+  // cancels statements past their deadline on every worker connection,
+  // side connections included; also what select_query and oracle_check
+  // use for their 10s cap instead of SET statement_timeout. nullptr = the
+  // SET round trips
+  std::shared_ptr<sql_variant::StatementWatchdog> watchdog;
+  // for the workers of one endpoint: reconnects go through it, with one
+  // readiness probe and backoff for all of them instead of a fixed 1s
+  // sleep each. nullptr = every worker on its own
+  std::shared_ptr<sql_variant::ConnectionManager> connection_manager;
+  // for the workers of one cycle: their first actions go out together
+  std::shared_ptr<StartBarrier> start_barrier;
+  // enrolls the RandomWorkers of one cycle in construction order: the
+  // cycle runs through its phases, each setting how many workers run and
+  // at what rate
+  std::shared_ptr<PhaseProfile> phases;
+  // each RandomWorker publishes what it did per interval, and the
+  // collector merges that into a time series readable while the run goes
+  std::shared_ptr<statistics::IntervalCollector> intervals;
+  // what the actions learn and hold, one per endpoint
+  action::RunState actions;
+
+  // the same context with per-worker action state, see RunState
+  [[nodiscard]] RunContext forWorker() const {
+    auto copy = *this;
+    copy.actions = actions.forWorker();
+    return copy;
+  }
+};
+
+/* Mid-run control of one worker, from any thread. The worker consults it
+   between actions: a pause lets the running action finish and holds the
+   next one, a stop ends the run for good. Rate and weight changes take
+   effect from the next action. */
+class WorkerControl {
+public:
+  enum class State : std::uint8_t { running, paused, stopped };
+
+  explicit WorkerControl(double rate = 0);
+
+  void pause();
+  void resume();
+  void stop();
+  [[nodiscard]] State state() const;
+  [[nodiscard]] std::stop_token stopToken() const {
+    return stopSource.get_token();
+  }
+
+  // actions per second, 0 = unlimited; throws std::invalid_argument when
+  // negative
+  void setRate(double actionsPerSecond);
+  [[nodiscard]] double rate() const;
+
+  void setWeight(std::string name, std::size_t weight);
+
+  // worker side, before each action: waits while paused and until the
+  // next action is due at the current rate. False once stopped or at
+  // `deadline`
+  bool admit(std::chrono::steady_clock::time_point deadline);
+  // worker side: holds the worker until `until`. False once stopped
+  bool idleUntil(std::chrono::steady_clock::time_point until);
+  // weight changes since the last call, oldest first
+  std::vector<std::pair<std::string, std::size_t>> takeWeights();
+
+  // held by the worker while it replaces its connection, and by a stop
+  // while it cancels the statement in flight
+  std::mutex connectionMutex;
+
+private:
+  mutable std::mutex mutex;
+  std::condition_variable cv;
+  std::stop_source stopSource;
+  bool paused = false;
+  double rate_;
+  std::chrono::steady_clock::time_point nextDue;
+  std::vector<std::pair<std::string, std::size_t>> weights;
 };
 
 class Worker {
@@ -31,7 +150,8 @@ public:
       std::function<std::unique_ptr<sql_variant::LoggedSQL>()>;
 
   Worker(std::string const &name, sql_connector_t const &sql_connector,
-         WorkloadParams config, metadata_ptr metadata);
+         WorkloadParams config, metadata_ptr metadata,
+         RunContext const &run = {});
 
   Worker(Worker &&) = default;
 
@@ -39,6 +159,11 @@ public:
 
   void create_random_tables(std::size_t count);
 
+  // streams `rows` generated rows into the named table in one statement
+  // (COPY FROM STDIN / LOAD DATA LOCAL INFILE); throws std::invalid_argument
+  // for a table the metadata doesn't know, SqlException when the load fails
+  void bulk_load(std::string const &table, std::size_t rows);
+
   void discover_existing_schema();
 
   void reset_metadata();
@@ -51,14 +176,64 @@ public:
 
   void reconnect();
 
+  // the current position as a resume_from line; only consistent while no
+  // worker thread runs
+  [[nodiscard]] std::string rng_checkpoint() const;
+
+  [[nodiscard]] std::uint64_t action_count() const { return actionCount; }
+
+  // mid-run control, safe from any thread; see WorkerControl
+  void pause();
+  void resume();
+  // ends the run: no new action starts, statements are no longer sent
+  // and the one in flight is cancelled. Final, the worker won't run again
+  void stop();
+  // actions per second, 0 = unlimited
+  void set_rate(double actions_per_second);
+  [[nodiscard]] WorkerControl::State state() const;
+
 protected:
+  // worker thread, before the first action: statements stop going out
+  // once stop() is called
+  void armStop();
+  // worker thread, after the last action: the connection is usable again
+  // (checksums, validation)
+  void disarmStop();
+  // worker thread, before the first action: waits at run.start_barrier
+  // for the rest of the cycle. Returns when the run starts
+  std::chrono::steady_clock::time_point awaitStart();
+  // worker thread, after a lost connection: reconnects and returns how
+  // long the worker was without one. nullopt = give up: the attempts are
+  // used up (per outage with a connection manager, per run without) or
+  // the server didn't come back
+  std::optional<std::chrono::nanoseconds>
+  recoverConnection(std::size_t &attempts);
+  // worker thread, after each action and before the connection is
+  // replaced: moves the rows and transactions sql_conn observed into
+  // `stats`, the transactions into `live` too when given
+  void drainObservations(statistics::WorkerStatistics &stats,
+                         statistics::IntervalStats *live = nullptr);
+
   std::string name;
   sql_connector_t sql_connector;
   logged_sql_ptr sql_conn;
   WorkloadParams config;
+  // this worker's view: shared objects, its own statement cache
+  RunContext run;
   metadata_ptr metadata;
   ps_random rand;
+  // actions drawn so far, carried over by checkpoints
+  std::uint64_t actionCount = 0;
   std::shared_ptr<spdlog::logger> logger;
+  // plan_dir recording; reinstalled on every new connection
+  std::shared_ptr<plan::PlanRecorder> recorder;
+  // shared: the control outlives moves of the worker
+  std::shared_ptr<WorkerControl> control;
+  // worker thread only: between armStop() and disarmStop()
+  bool stopArmed = false;
+  // drainObservations() buffers: drained into, never reallocated once grown
+  std::vector<statistics::RowObservation> observed;
+  std::vector<statistics::TransactionOutcome> outcomes;
 };
 
 class RandomWorker : public Worker {
@@ -66,7 +241,7 @@ public:
   RandomWorker(std::string const &name,
                Worker::sql_connector_t const &sql_connector,
                WorkloadParams const &config, metadata_ptr metadata,
-               action::ActionRegistry actions);
+               action::ActionRegistry actions, RunContext const &run = {});
 
   RandomWorker(RandomWorker &&) = default;
 
@@ -78,19 +253,85 @@ public:
 
   action::ActionRegistry &possibleActions();
 
+  // applied before the next action; throws std::invalid_argument for an
+  // action this worker doesn't have
+  void set_weight(std::string const &action, std::size_t weight);
+
   const statistics::WorkerStatistics &statistics() const;
 
+  // with run.phases: the statistics as they stood at the end of each
+  // phase, cumulative. Complete after join()
+  [[nodiscard]] std::vector<statistics::WorkerStatistics> const &
+  phase_statistics() const {
+    return phaseStats;
+  }
+
 protected:
+  // worker thread, before each action: closes the phases that ended,
+  // applies the current one's rate and idles while it has no room for
+  // this worker. False once the profile is over or the worker stopped
+  bool followPhases(std::chrono::steady_clock::time_point deadline);
+  // worker thread: snapshots for the phases before `current`
+  void closePhases(std::size_t current);
+  // worker thread, before each action: publishes the interval in progress
+  // once `now` is past it
+  void advanceInterval(std::chrono::steady_clock::time_point now);
+  // worker thread: publishes the interval in progress if anything happened
+  void publishInterval();
+
   action::ActionRegistry actions;
   std::thread thread;
   statistics::WorkerStatistics stats;
+  // this worker's slot in run.turns
+  metadata::TurnSlot turns;
+  // this worker's slot in run.phases, and the phase it last ran in
+  std::size_t phaseSlot = 0;
+  std::optional<std::size_t> phase;
+  std::vector<statistics::WorkerStatistics> phaseStats;
+  // with run.intervals: where this worker publishes, and the interval
+  // it is filling
+  std::shared_ptr<statistics::IntervalRing> liveRing;
+  statistics::IntervalStats liveInterval;
+};
+
+/* Plays a recorded plan (see workload_plan.hpp) back: the recorded
+   statements in order, as fast as the connection takes them. The plan is
+   parsed when the worker is built, and playback draws nothing and keeps
+   no metadata. A failed statement ends its action; an open transaction
+   is rolled back before the next one. */
+class PlanWorker : public Worker {
+public:
+  // throws std::invalid_argument when the plan can't be read
+  PlanWorker(std::string const &name,
+             Worker::sql_connector_t const &sql_connector,
+             WorkloadParams const &config, std::string const &plan_path,
+             RunContext const &run = {});
+
+  PlanWorker(PlanWorker &&) = default;
+
+  ~PlanWorker() override;
+
+  // plays until the plan ends or the duration is up, whichever is first
+  void run_thread(std::size_t duration_in_seconds);
+
+  void join();
+
+  [[nodiscard]] std::size_t plan_size() const { return plan.actions.size(); }
+
+  const statistics::WorkerStatistics &statistics() const;
+
+protected:
+  plan::Plan plan;
+  std::thread thread;
+  statistics::WorkerStatistics stats;
 };
 
 class Workload {
 public:
   Workload(WorkloadParams const &params,
            Worker::sql_connector_t const &sql_connector,
-           const metadata_ptr &metadata, action::ActionRegistry const &actions);
+           const metadata_ptr &metadata, action::ActionRegistry const &actions,
+           RunContext run = {});
 
   void run();
 
@@ -102,9 +343,17 @@ public:
 
   void reconnect_workers();
 
+  void pause();
+  void resume();
+  void stop();
+
+  // what the workers share
+  [[nodiscard]] RunContext const &context() const { return runContext; }
+
 private:
   std::size_t duration_in_seconds;
   std::size_t repeat_times;
+  RunContext runContext;
   std::vector<RandomWorker> workers;
   action::ActionRegistry actions;
 };
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <vector>
+
+/* Shaping one workload cycle over time: a start barrier so every worker's
+   first action goes out together, and a phase profile that steps the
+   number of active workers and their rate through a ramp or a spike.
+   Both are shared by the workers of one cycle, like a TurnScheduler. */
+
+// one step of a profile: the first `workers` workers of the cycle run,
+// each at most `rate` actions per second (0 = unlimited), for `duration`
+struct Phase {
+  std::chrono::milliseconds duration;
+  std::size_t workers;
+  double rate = 0;
+};
+
+// releases the workers of one cycle together once all of them arrived
+class StartBarrier {
+public:
+  using clock = std::chrono::steady_clock;
+
+  // throws std::invalid_argument for 0 participants
+  explicit StartBarrier(std::size_t participants);
+
+  // worker thread, before the first action: waits for the others. Returns
+  // the release time; early (now) when `stop` is requested or the barrier
+  // was cancelled
+  clock::time_point arriveAndWait(std::stop_token const &stop);
+
+  // release everyone at once: for error paths where a participant will
+  // never arrive
+  void cancel();
+
+  [[nodiscard]] std::size_t participants() const { return participants_; }
+
+private:
+  std::size_t participants_;
+  std::mutex mutex_;
+  std::condition_variable_any cv_;
+  std::size_t arrived_ = 0;
+  std::optional<clock::time_point> released_;
+};
+
+/* The phases of one cycle, back to back from the moment the first worker
+   begins. Workers take slots in the order they are built; in a phase with
+   `workers` = n, slots n and up idle until a phase that has room for them.
+   The cycle ends with the last phase. */
+class PhaseProfile {
+public:
+  using clock = std::chrono::steady_clock;
+
+  // throws std::invalid_argument for no phases, a phase without duration
+  // or a negative rate
+  explicit PhaseProfile(std::vector<Phase> phases);
+
+  // slots go out in call order
+  std::size_t enroll();
+
+  // phase 0 starts at `at`; the first call wins
+  void begin(clock::time_point at);
+
+  // the phase running at `now`, size() once the profile is over; 0 before
+  // begin()
+  [[nodiscard]] std::size_t phaseAt(clock::time_point now) const;
+  // when `phase` ends; only after begin()
+  [[nodiscard]] clock::time_point phaseEnd(std::size_t phase) const;
+
+  [[nodiscard]] Phase const &phase(std::size_t idx) const {
+    return phases_.at(idx);
+  }
+  [[nodiscard]] std::size_t size() const { return phases_.size(); }
+  [[nodiscard]] std::vector<Phase> const &phases() const { return phases_; }
+
+private:
+  std::vector<Phase> phases_;
+  // offsets of each phase's end from the start
+  std::vector<std::chrono::milliseconds> ends_;
+  mutable std::mutex mutex_;
+  std::size_t enrolled_ = 0;
+  std::optional<clock::time_point> start_;
+};
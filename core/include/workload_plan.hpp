@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "action/action_registry.hpp"
+#include "sql_variant/generic.hpp"
+
+/* Workload plans: one worker's statement stream, generated once (against
+   a simulated or scratch server) and played back any number of times.
+   Playback sends the recorded statements as they are, so generator cost
+   stays out of the measurement and two server builds see the same
+   stream.
+
+   File format, JSON lines:
+     {"plan":1,"worker":"worker-1-1","seed":42}
+     {"action":"insert_some_data","type":"dml","stmts":[...]}
+   A statement is {"sql":...} with optional "params" (null, a string, or
+   {"hex":...} for binary values) and "txn" ("begin" / "end"); a bulk
+   load is {"bulk":<table>,"columns":[...],"rows":[...]} with rows in COPY
+   text format. Statements sent outside any action (table setup) form
+   actions with an empty name. Text that isn't UTF-8 is written with
+   U+FFFD in place of the bad bytes. */
+namespace plan {
+
+constexpr std::uint64_t formatVersion = 1;
+
+// what a statement does to the connection's transaction
+enum class TxnEffect : std::uint8_t { none, begin, end };
+
+// BEGIN / START TRANSACTION begin, COMMIT / ROLLBACK end; ROLLBACK TO
+// SAVEPOINT stays inside
+[[nodiscard]] TxnEffect txn_effect(std::string_view query);
+
+struct Statement {
+  enum class Kind : std::uint8_t { query, params, bulk };
+
+  Kind kind = Kind::query;
+  std::string sql; // the table for bulk loads
+  std::vector<sql_variant::Param> params;
+  TxnEffect txn = TxnEffect::none;
+  std::vector<std::string> columns;
+  std::vector<std::string> rows;
+};
+
+struct Action {
+  std::string name;
+  action::ActionType type = action::ActionType::other;
+  std::vector<Statement> statements;
+};
+
+struct Plan {
+  std::string worker;
+  std::uint64_t seed = 0;
+  std::vector<Action> actions;
+};
+
+// throws std::invalid_argument for an unreadable or malformed file, or one
+// written by a newer format
+[[nodiscard]] Plan read_plan(std::string const &path);
+
+/* Writes a plan while the worker generates it. The worker brackets each
+   action with beginAction() / endAction(); each action is one line,
+   written when it ends. Not thread-safe: one recorder per worker. */
+class PlanRecorder : public sql_variant::StatementSink {
+public:
+  // throws std::invalid_argument when the file can't be created
+  PlanRecorder(std::string const &path, std::string const &worker,
+               std::uint64_t seed);
+  ~PlanRecorder() override;
+
+  PlanRecorder(PlanRecorder const &) = delete;
+  PlanRecorder &operator=(PlanRecorder const &) = delete;
+
+  void beginAction(std::string const &name, action::ActionType type);
+  void endAction();
+
+  void statement(std::string const &query,
+                 std::vector<sql_variant::Param> const *params) override;
+  void bulkLoad(std::string const &table,
+                std::vector<std::string> const &columns,
+                std::vector<std::string> const &rows) override;
+
+  // writes out setup statements and pushes everything to the file
+  void flush();
+
+  [[nodiscard]] std::uint64_t actionsWritten() const { return written_; }
+
+private:
+  void writeCurrent();
+
+  std::ofstream out_;
+  Action current_;
+  std::uint64_t written_ = 0;
+};
+
+} // namespace plan
@@ -1,10 +1,15 @@
 
 #include <algorithm>
+#include <fstream>
 #include <numeric>
+#include <sstream>
+#include <stdexcept>
 #include <utility>
 
 #include "action/action_registry.hpp"
 #include "action/dml.hpp"
+#include "action/grammar.hpp"
+#include "action/oracle.hpp"
 #include "action/transaction.hpp"
 #include "action/variable.hpp"
 
@@ -40,7 +45,7 @@ ActionRegistry initializeDefaultRegisty() {
                 std::unique_ptr<RepeatAction<InsertData>>>>(
                 std::move(ctx), std::move(createTable),
                 std::make_unique<RepeatAction<InsertData>>(
-                    InsertData(config.dml, 1000,
+                    InsertData(config.dml, bctx.state, 1000,
                                [c = ctx.get()]() { return c->ptr; }),
                     1));
           },
@@ -64,7 +69,7 @@ ActionRegistry initializeDefaultRegisty() {
                 std::unique_ptr<RepeatAction<InsertData>>>>(
                 std::move(ctx), std::move(createTable),
                 std::make_unique<RepeatAction<InsertData>>(
-                    InsertData(config.dml, 1000,
+                    InsertData(config.dml, bctx.state, 1000,
                                [c = ctx.get()]() { return c->ptr; }),
                     1));
           },
@@ -75,7 +80,7 @@ ActionRegistry initializeDefaultRegisty() {
                           .builder =
                               [](BuildContext const &bctx) {
                                 return std::make_unique<DropTable>(
-                                    bctx.config.ddl);
+                                    bctx.config.ddl, bctx.state.keys);
                               },
                           .weight = 100,
                           .type = ActionType::ddl};
@@ -139,7 +144,7 @@ ActionRegistry initializeDefaultRegisty() {
                                .builder =
                                    [](BuildContext const &bctx) {
                                      return std::make_unique<InsertData>(
-                                         bctx.config.dml, 10);
+                                         bctx.config.dml, bctx.state, 10);
                                    },
                                .weight = 1000,
                                .type = ActionType::dml};
@@ -148,7 +153,8 @@ ActionRegistry initializeDefaultRegisty() {
                                .builder =
                                    [](BuildContext const &bctx) {
                                      return std::make_unique<DeleteData>(
-                                         bctx.config.dml, bctx.config.querygen);
+                                         bctx.config.dml, bctx.config.querygen,
+                                         bctx.state);
                                    },
                                .weight = 1000,
                                .type = ActionType::dml};
@@ -157,7 +163,8 @@ ActionRegistry initializeDefaultRegisty() {
                              .builder =
                                  [](BuildContext const &bctx) {
                                    return std::make_unique<UpdateOneRow>(
-                                       bctx.config.dml, bctx.config.querygen);
+                                       bctx.config.dml, bctx.config.querygen,
+                                       bctx.state);
                                  },
                              .weight = 1000,
                              .type = ActionType::dml};
@@ -166,7 +173,8 @@ ActionRegistry initializeDefaultRegisty() {
                                .builder =
                                    [](BuildContext const &bctx) {
                                      return std::make_unique<SelectThenDelete>(
-                                         bctx.config.dml, bctx.config.querygen);
+                                         bctx.config.dml, bctx.config.querygen,
+                                         bctx.state);
                                    },
                                .weight = 1000,
                                .type = ActionType::dml};
@@ -175,7 +183,8 @@ ActionRegistry initializeDefaultRegisty() {
                                .builder =
                                    [](BuildContext const &bctx) {
                                      return std::make_unique<SelectThenUpdate>(
-                                         bctx.config.dml, bctx.config.querygen);
+                                         bctx.config.dml, bctx.config.querygen,
+                                         bctx.state);
                                    },
                                .weight = 1000,
                                .type = ActionType::dml};
@@ -184,7 +193,7 @@ ActionRegistry initializeDefaultRegisty() {
                             .builder =
                                 [](BuildContext const &bctx) {
                                   return std::make_unique<SelectQuery>(
-                                      bctx.config.querygen);
+                                      bctx.config.querygen, bctx.state);
                                 },
                             .weight = 1000,
                             .type = ActionType::dml};
@@ -193,7 +202,7 @@ ActionRegistry initializeDefaultRegisty() {
                             .builder =
                                 [](BuildContext const &bctx) {
                                   return std::make_unique<TransactionAction>(
-                                      bctx.config, bctx.registry);
+                                      bctx.config, bctx.registry, bctx.state);
                                 },
                             .weight = 100,
                             .type = ActionType::transaction};
@@ -248,9 +257,35 @@ ActionRegistry initializeDefaultRegisty() {
                                      .type = ActionType::other,
                                      .txn_safe = false};
 
+  // dormant like the variable actions: checks cost several queries each
+  ActionFactory oracleCheck{.name = "oracle_check",
+                            .builder =
+                                [](BuildContext const &bctx) {
+                                  return std::make_unique<OracleCheck>(
+                                      bctx.config.oracle, bctx.config.querygen,
+                                      bctx.state);
+                                },
+                            .weight = 0,
+                            .type = ActionType::dml,
+                            .txn_safe = false};
+
+  // dormant too: one load is dml.bulkLoadRows rows in a single statement
+  ActionFactory bulkLoad{.name = "bulk_load",
+                         .builder =
+                             [](BuildContext const &bctx) {
+                               auto const &dml = bctx.config.dml;
+                               return std::make_unique<BulkLoad>(
+                                   dml, bctx.state, dml.bulkLoadRows);
+                             },
+                         .weight = 0,
+                         .type = ActionType::dml,
+                         .txn_safe = false};
+
   ar.insert(setSessionVariable);
   ar.insert(setGlobalVariable);
   ar.insert(reloadGlobalVariable);
+  ar.insert(oracleCheck);
+  ar.insert(bulkLoad);
 
   return ar;
 }
@@ -295,7 +330,9 @@ std::size_t ActionRegistry::insert(ActionFactory const &action) {
         fmt::format("Action {} already exists in this registy", action.name));
   }
 
-  factories.push_back(action);
+  auto &inserted = factories.emplace_back(action);
+  // interned once here, the workers record under the id
+  inserted.stats_id = statistics::NameTable::intern(inserted.name);
   return factories.size() - 1;
 }
 
@@ -340,6 +377,19 @@ ActionFactory &ActionRegistry::getReference(std::string const &name) {
   return *it;
 }
 
+void ActionRegistry::setWeight(std::string const &name, std::size_t weight) {
+  std::unique_lock<std::mutex> lk(mutex);
+
+  auto it = std::ranges::find_if(factories,
+                                 [&](auto const &f) { return f.name == name; });
+  if (it == factories.end()) {
+    throw ActionException(
+        "action-not-found",
+        fmt::format("Action {} does not exists in this registy", name));
+  }
+  it->weight = weight;
+}
+
 std::size_t ActionRegistry::size() const {
   std::unique_lock<std::mutex> lk(mutex);
 
@@ -384,12 +434,13 @@ ActionFactory ActionRegistry::lookupByWeightOffset(std::size_t offset) const {
 void ActionRegistry::makeCustomSqlAction(std::string const &name,
                                          std::string const &sql,
                                          std::size_t weight, ActionType type) {
+  auto const compiled =
+      std::make_shared<SqlTemplate const>(SqlTemplate::literal(sql));
   insert(ActionFactory{.name = name,
                        .builder =
-                           [sql](BuildContext const &bctx) {
+                           [compiled](BuildContext const &bctx) {
                              return std::make_unique<CustomSql>(
-                                 bctx.config.custom, sql,
-                                 CustomSql::inject_t{});
+                                 bctx.config.custom, compiled);
                            },
                        .weight = weight,
                        .type = type});
@@ -399,17 +450,56 @@ void ActionRegistry::makeCustomTableSqlAction(std::string const &name,
                                               std::string const &sql,
                                               std::size_t weight,
                                               ActionType type) {
+  // compiled here: a bad placeholder fails the registration, not every run
+  auto const compiled =
+      std::make_shared<SqlTemplate const>(SqlTemplate::compile(sql));
   insert(ActionFactory{.name = name,
                        .builder =
-                           [sql](BuildContext const &bctx) {
+                           [compiled](BuildContext const &bctx) {
                              return std::make_unique<CustomSql>(
-                                 bctx.config.custom, sql,
-                                 CustomSql::inject_t{"table"});
+                                 bctx.config.custom, compiled, bctx.state.keys);
                            },
                        .weight = weight,
                        .type = type});
 }
 
+std::size_t ActionRegistry::loadGrammar(std::string const &path,
+                                        std::size_t weight,
+                                        std::string const &prefix) {
+  std::ifstream in(path);
+  if (!in) {
+    throw std::invalid_argument(
+        fmt::format("cannot read grammar file {}", path));
+  }
+  std::stringstream text;
+  text << in.rdbuf();
+
+  auto rules = parse_grammar(text.str());
+  // all or nothing: a clash must not leave half a grammar registered
+  for (auto const &rule : rules) {
+    auto const name = fmt::format("{}{}", prefix, rule.line);
+    if (has(name)) {
+      throw ActionException(
+          "action-already-exists",
+          fmt::format("Action {} already exists in this registy", name));
+    }
+  }
+  for (auto &rule : rules) {
+    auto const compiled =
+        std::make_shared<SqlTemplate const>(std::move(rule.compiled));
+    insert(ActionFactory{.name = fmt::format("{}{}", prefix, rule.line),
+                         .builder =
+                             [compiled](BuildContext const &bctx) {
+                               return std::make_unique<CustomSql>(
+                                   bctx.config.custom, compiled,
+                                   bctx.state.keys);
+                             },
+                         .weight = weight * rule.occurrences,
+                         .type = rule.type});
+  }
+  return rules.size();
+}
+
 ActionRegistry &default_registry(sql_variant::flavor flav) {
   // pg and mysql sets are identical today: every default action renders
   // through the dialect layer. Flavor-specific actions get registered on
@@ -199,7 +199,8 @@ void CreateTable::execute(Context &metaCtx, ps_random &rand,
   }
 }
 
-DropTable::DropTable(DdlConfig config) : config(std::move(config)) {}
+DropTable::DropTable(DdlConfig config, std::shared_ptr<KeyReservoir> keys)
+    : config(std::move(config)), keys(std::move(keys)) {}
 
 void DropTable::execute(Context &metaCtx, ps_random &rand,
                         sql_variant::LoggedSQL *connection) const {
@@ -240,6 +241,10 @@ void DropTable::execute(Context &metaCtx, ps_random &rand,
   }
 
   tables.erase(snap->id);
+  if (keys != nullptr) {
+    metadata::TurnScope const turn(tables.turns());
+    keys->forget(snap->id);
+  }
 
   // Best effort: remove foreign key references to the dropped table
   const auto droppedId = snap->id;
@@ -5,8 +5,12 @@
 #include "querygen/render.hpp"
 #include "sql_dialect/dialect.hpp"
 
+#include <algorithm>
+#include <charconv>
+#include <chrono>
 #include <fmt/format.h>
 #include <fmt/ranges.h>
+#include <iterator>
 #include <optional>
 #include <rfl.hpp>
 #include <spdlog/spdlog.h>
@@ -18,22 +22,29 @@ using namespace action;
 
 namespace {
 
+std::string partition_key_value(std::optional<RangePartitioning> const &rp,
+                                ps_random &rand) {
+  // Query will fail, but at least we don't crash
+  if (rp->ranges.empty()) {
+    return "0";
+  }
+
+  // random_number is inclusive on both ends
+  std::size_t num = rand.random_number(
+      static_cast<std::size_t>(0), (rp->rangeSize * rp->ranges.size()) - 1);
+  std::size_t range = num / rp->rangeSize;
+  return std::to_string((rp->ranges[range].rangebase * rp->rangeSize) +
+                        (num % rp->rangeSize));
+}
+
 std::string generate_value(metadata::Column const &col, ps_random &rand,
                            std::optional<RangePartitioning> const &rp,
                            metadata::CatalogView<metadata::Table> const &tables,
-                           sql_dialect::Dialect const &dialect) {
+                           sql_dialect::Dialect const &dialect,
+                           action::DmlConfig const &config,
+                           KeyReservoir *keys) {
   if (col.partition_key) {
-    // Query will fail, but at least we don't crash
-    if (rp->ranges.empty()) {
-      return "0";
-    }
-
-    // random_number is inclusive on both ends
-    std::size_t num = rand.random_number(
-        static_cast<std::size_t>(0), (rp->rangeSize * rp->ranges.size()) - 1);
-    std::size_t range = num / rp->rangeSize;
-    return std::to_string((rp->ranges[range].rangebase * rp->rangeSize) +
-                          (num % rp->rangeSize));
+    return partition_key_value(rp, rand);
   }
   if (col.foreign_key_references) {
     auto target = tables.byId(col.foreign_key_references.id);
@@ -41,6 +52,18 @@ std::string generate_value(metadata::Column const &col, ps_random &rand,
       return "NULL"; // referenced table dropped meanwhile; tolerated drift
     }
     // TODO: column name is hardcoded
+    if (config.pkReservoirProb > 0 && keys != nullptr &&
+        (config.fkScanProb == 0 ||
+         rand.random_number<std::size_t>(1, 100) > config.fkScanProb)) {
+      metadata::TurnScope const turn(tables.turns());
+      auto const key = keys->sample(target->id, 1, rand);
+      if (!key.empty()) {
+        // a pk probe, not a literal: a parent row deleted meanwhile gives
+        // NULL instead of failing the whole statement on the FK check
+        return fmt::format("(SELECT id FROM {} WHERE id = {})", target->name,
+                           key.front());
+      }
+    }
     return dialect.randomRowSubquery(target->name, "id", 1);
   }
 
@@ -62,6 +85,47 @@ std::string generate_value(metadata::Column const &col, ps_random &rand,
   return "";
 }
 
+// generate_value for BulkLoad: the bare value, nullopt = NULL
+std::optional<std::string>
+generate_raw_value(metadata::Column const &col, ps_random &rand,
+                   std::optional<RangePartitioning> const &rp,
+                   metadata::CatalogView<metadata::Table> const &tables,
+                   action::DmlConfig const &config, KeyReservoir *keys) {
+  if (col.partition_key) {
+    return partition_key_value(rp, rand);
+  }
+  if (col.foreign_key_references) {
+    auto target = tables.byId(col.foreign_key_references.id);
+    if (target == nullptr || config.pkReservoirProb == 0 ||
+        keys == nullptr) {
+      return std::nullopt;
+    }
+    metadata::TurnScope const turn(tables.turns());
+    auto const key = keys->sample(target->id, 1, rand);
+    if (key.empty()) {
+      return std::nullopt;
+    }
+    return std::to_string(key.front());
+  }
+
+  switch (col.type) {
+  case metadata::ColumnType::INT:
+    return std::to_string(rand.random_number(1, 1000000));
+  case metadata::ColumnType::REAL:
+    return std::to_string(rand.random_number(1.0, 1000000.0));
+  case metadata::ColumnType::VARCHAR:
+  case metadata::ColumnType::CHAR:
+    return rand.random_string(0, col.length);
+  case metadata::ColumnType::BYTEA:
+  case metadata::ColumnType::TEXT:
+    return rand.random_string(50, 1000);
+  case metadata::ColumnType::BOOL:
+    // pg reads 1/0 as booleans; mysql's BOOL is a TINYINT
+    return rand.random_number(0, 1) == 1 ? "1" : "0";
+  }
+  return std::nullopt;
+}
+
 sql_dialect::LockClause pick_lock(ps_random &rand,
                                   action::LockWeights const &w) {
   const std::size_t total = w.none + w.for_update + w.for_share;
@@ -79,6 +143,44 @@ sql_dialect::LockClause pick_lock(ps_random &rand,
   return sql_dialect::LockClause::forShare;
 }
 
+std::optional<KeyReservoir::Key> parse_key(std::string_view text) {
+  KeyReservoir::Key key = 0;
+  auto const [ptr, ec] =
+      std::from_chars(text.data(), text.data() + text.size(), key);
+  if (ec != std::errc{} || ptr != text.data() + text.size()) {
+    return std::nullopt;
+  }
+  return key;
+}
+
+std::vector<KeyReservoir::Key>
+parse_keys(std::vector<std::string> const &texts) {
+  std::vector<KeyReservoir::Key> keys;
+  keys.reserve(texts.size());
+  for (auto const &text : texts) {
+    if (auto key = parse_key(text)) {
+      keys.push_back(*key);
+    }
+  }
+  return keys;
+}
+
+// reservoir keys for a key-targeted statement; empty = use the scan form.
+// The draws depend on the config only, never on what the reservoir holds
+std::vector<KeyReservoir::Key> pick_keys(action::DmlConfig const &config,
+                                         KeyReservoir *keys,
+                                         KeyDistribution const &access,
+                                         metadata::Table const &table,
+                                         std::size_t count, ps_random &rand,
+                                         metadata::Turns turns) {
+  if (config.pkReservoirProb == 0 || keys == nullptr ||
+      rand.random_number<std::size_t>(1, 100) > config.pkReservoirProb) {
+    return {};
+  }
+  metadata::TurnScope const turn(turns);
+  return keys->sample(table.id, count, rand, access);
+}
+
 std::vector<std::string> fetch_ids(sql_variant::LoggedSQL *connection,
                                    std::string const &selectSql) {
   auto res = connection->executeQuery(selectSql);
@@ -98,6 +200,70 @@ std::vector<std::string> fetch_ids(sql_variant::LoggedSQL *connection,
   return ids;
 }
 
+// how often a parent with no known keys is scanned again; an empty one
+// would otherwise be scanned by every statement that wants its keys
+constexpr std::chrono::seconds fkSeedInterval{30};
+
+// FK values come from the parent's reservoir keys. A parent with none
+// known yet (created before the workload, or only filled by other
+// processes) gets one sampling scan here instead of one per generated row
+void seed_fk_keys(action::DmlConfig const &config, KeyReservoir *keys,
+                  metadata::Table const &table,
+                  metadata::CatalogView<metadata::Table> const &tables,
+                  sql_variant::LoggedSQL *connection,
+                  sql_dialect::Dialect const &dialect) {
+  // at 100 every FK value is a scan subquery: the keys would go unused
+  if (config.pkReservoirProb == 0 || config.fkScanProb >= 100 ||
+      keys == nullptr) {
+    return;
+  }
+  for (auto const &col : table.columns) {
+    if (!col.foreign_key_references) {
+      continue;
+    }
+    auto target = tables.byId(col.foreign_key_references.id);
+    if (target == nullptr) {
+      continue;
+    }
+    {
+      metadata::TurnScope const turn(tables.turns());
+      if (keys->size(target->id) > 0 ||
+          !keys->claimSeed(target->id, fkSeedInterval)) {
+        continue;
+      }
+    }
+    auto const count = std::min<std::size_t>(keys->capacity(), 1000);
+    auto const ids = fetch_ids(
+        connection, dialect.randomRowsSelect(target->name, "id", count,
+                                             sql_dialect::LockClause::none));
+    metadata::TurnScope const turn(tables.turns());
+    keys->add(target->id, parse_keys(ids));
+  }
+}
+
+// EXPLAINs the query and records its plan shape; true when the shape is
+// new. nullopt when the EXPLAIN failed or returned no JSON plan - the
+// query itself will most likely fail the same way
+std::optional<bool> sample_plan(sql_variant::LoggedSQL *connection,
+                                sql_dialect::Dialect const &dialect,
+                                std::string_view sql,
+                                querygen::PlanCoverage &coverage,
+                                querygen::FeatureSet used) {
+  auto res = connection->executeQuery(dialect.explainJson(sql));
+  if (!res.success() || res.data == nullptr || res.data->numRows() == 0) {
+    return std::nullopt;
+  }
+  auto const row = res.data->nextRow();
+  if (row.rowData.empty() || !row.rowData[0]) {
+    return std::nullopt;
+  }
+  auto const shape = querygen::planShapeHash(*row.rowData[0]);
+  if (!shape) {
+    return std::nullopt;
+  }
+  return coverage.record(*shape, used);
+}
+
 // opens a transaction (arming the guard) only when not already in one;
 // inside an enclosing transaction rollback is its owner's job
 void maybe_begin_own_trx(metadata::Context const &metaCtx,
@@ -125,12 +291,14 @@ void maybe_commit_own_trx(std::optional<action::TxGuard> &guard,
 }
 }; // namespace
 
-InsertData::InsertData(DmlConfig const &config, std::size_t rows)
-    : config(config), rows(rows) {}
+InsertData::InsertData(DmlConfig const &config, RunState state,
+                       std::size_t rows)
+    : config(config), state(std::move(state)), rows(rows) {}
 
-InsertData::InsertData(DmlConfig const &config, std::size_t rows,
-                       TableLocator locator)
-    : config(config), locator(std::move(locator)), rows(rows) {}
+InsertData::InsertData(DmlConfig const &config, RunState state,
+                       std::size_t rows, TableLocator locator)
+    : config(config), state(std::move(state)), locator(std::move(locator)),
+      rows(rows) {}
 
 void InsertData::execute(Context &metaCtx, ps_random &rand,
                          sql_variant::LoggedSQL *connection) const {
@@ -143,52 +311,164 @@ void InsertData::execute(Context &metaCtx, ps_random &rand,
   if (table == nullptr) {
     return; // locator target vanished (e.g. created table already dropped)
   }
+  seed_fk_keys(config, state.keys.get(), *table, tables, connection, dialect);
 
-  std::stringstream sql;
-  sql << "INSERT INTO ";
-  sql << table->name;
-  sql << " (";
+  auto const &stmts = state.statements->forTable(table);
 
-  bool first = true;
-  for (auto const &f : table->columns) {
-    if (!f.auto_increment) {
-      if (!first) {
-        sql << ", ";
+  // inserted keys feed the reservoir: generated by the server (auto
+  // increment) or by us (partition key)
+  bool const recordKeys = config.pkReservoirProb > 0 && state.keys != nullptr;
+  auto const &pk = table->columns[0];
+  std::vector<KeyReservoir::Key> keys;
+
+  std::string sql = stmts.insertPrefix;
+  for (std::size_t idx = 0; idx < rows; ++idx) {
+    sql += idx == 0 ? "(" : ", (";
+    for (std::size_t i = 0; i < stmts.valueColumns.size(); ++i) {
+      auto const &f = *stmts.valueColumns[i];
+      if (i != 0) {
+        sql += ", ";
       }
-      sql << f.name;
-      first = false;
+      auto value = generate_value(f, rand, table->partitioning, tables,
+                                  dialect, config, state.keys.get());
+      if (recordKeys && f.primary_key) {
+        if (auto key = parse_key(value)) {
+          keys.push_back(*key);
+        }
+      }
+      sql += value;
     }
+    sql += ")";
   }
 
-  sql << " ) VALUES ";
-  for (std::size_t idx = 0; idx < rows; ++idx) {
-    if (idx != 0) {
-      sql << ", ";
-    }
-    sql << "(";
+  bool const returning = recordKeys && pk.primary_key && pk.auto_increment;
+  if (returning) {
+    sql += dialect.insertReturning(pk.name);
+  }
+  sql += ";";
 
-    first = true;
-    for (auto const &f : table->columns) {
-      if (!f.auto_increment) {
-        if (!first) {
-          sql << ", ";
+  auto res = connection->executeQuery(sql);
+  res.maybeThrow();
+
+  if (returning) {
+    if (res.insertId != 0) {
+      // mysql: one range, auto_increment_increment apart; insertId has
+      // the offset in it already
+      for (std::uint64_t i = 0; i < res.affectedRows; ++i) {
+        keys.push_back(static_cast<KeyReservoir::Key>(
+            res.insertId + (i * res.insertIdStep)));
+      }
+    } else if (res.data != nullptr) {
+      auto const n = res.data->numRows();
+      for (std::size_t i = 0; i < n; ++i) {
+        auto const row = res.data->nextRow();
+        if (!row.rowData.empty() && row.rowData[0]) {
+          if (auto key = parse_key(*row.rowData[0])) {
+            keys.push_back(*key);
+          }
         }
-        sql << generate_value(f, rand, table->partitioning, tables, dialect);
-        first = false;
       }
     }
-
-    sql << ")";
   }
+  if (recordKeys) {
+    metadata::TurnScope const turn(metaCtx.turns());
+    state.keys->add(table->id, keys);
+  }
+}
 
-  sql << ";";
+BulkLoad::BulkLoad(DmlConfig const &config, RunState state, std::size_t rows)
+    : config(config), state(std::move(state)), rows(rows) {}
 
-  connection->executeQuery(sql.str()).maybeThrow();
+BulkLoad::BulkLoad(DmlConfig const &config, RunState state, std::size_t rows,
+                   TableLocator locator)
+    : config(config), state(std::move(state)), locator(std::move(locator)),
+      rows(rows) {}
+
+void BulkLoad::execute(Context &metaCtx, ps_random &rand,
+                       sql_variant::LoggedSQL *connection) const {
+  auto const serverInfo = connection->serverInfo();
+  auto const &dialect = sql_dialect::dialect_for(serverInfo);
+
+  auto const tables = metaCtx.get<Table>();
+
+  table_cptr table = locator ? locator() : find_random_table(metaCtx, rand);
+  if (table == nullptr || rows == 0) {
+    return;
+  }
+  seed_fk_keys(config, state.keys.get(), *table, tables, connection, dialect);
+
+  auto const &stmts = state.statements->forTable(table);
+
+  // loaded keys feed the reservoir, as for InsertData: generated by us
+  // when the pk is a loaded column, else by the server
+  bool const recordKeys = config.pkReservoirProb > 0 && state.keys != nullptr;
+  auto const *pk = table->primaryKey();
+  auto const pkField = pk == nullptr
+                           ? stmts.valueColumns.size()
+                           : static_cast<std::size_t>(
+                                 std::ranges::find(stmts.valueColumns, pk) -
+                                 stmts.valueColumns.begin());
+  bool const ownKeys = recordKeys && pkField < stmts.valueColumns.size();
+  std::vector<KeyReservoir::Key> keys;
+
+  std::size_t produced = 0;
+  auto const nextRow = [&](std::string &line) {
+    if (produced == rows) {
+      return false;
+    }
+    ++produced;
+    for (std::size_t i = 0; i < stmts.valueColumns.size(); ++i) {
+      auto const value = generate_raw_value(
+          *stmts.valueColumns[i], rand, table->partitioning, tables, config,
+          state.keys.get());
+      if (ownKeys && i == pkField && value) {
+        if (auto key = parse_key(*value)) {
+          keys.push_back(*key);
+        }
+      }
+      sql_variant::appendCopyField(line, i, value);
+    }
+    return true;
+  };
+
+  auto res = connection->bulkLoad(table->name, stmts.valueNames, nextRow);
+  // a load the server cut short still spends every row's draws, so the
+  // stream after it doesn't depend on where the server stopped reading
+  std::string rest;
+  while (nextRow(rest)) {
+    rest.clear();
+  }
+  res.maybeThrow();
+
+  if (!recordKeys || pk == nullptr) {
+    return;
+  }
+  if (!ownKeys && res.insertId != 0) {
+    // mysql: the range LOAD DATA took, auto_increment_increment apart
+    for (std::uint64_t i = 0; i < res.affectedRows; ++i) {
+      keys.push_back(static_cast<KeyReservoir::Key>(
+          res.insertId + (i * res.insertIdStep)));
+    }
+  } else if (!ownKeys) {
+    // COPY reports no keys: the newest ones are the loaded ones, as long
+    // as keys grow and nobody else inserted meanwhile. Oldest first, as
+    // add() expects for `latest`
+    auto const count =
+        std::min<std::size_t>(state.keys->capacity(), res.affectedRows);
+    keys = parse_keys(fetch_ids(
+        connection,
+        fmt::format("SELECT {} FROM {} ORDER BY {} DESC LIMIT {};", pk->name,
+                    table->name, pk->name, count)));
+    std::ranges::reverse(keys);
+  }
+  metadata::TurnScope const turn(metaCtx.turns());
+  state.keys->add(table->id, keys);
 }
 
 DeleteData::DeleteData(DmlConfig const &config,
-                       querygen::QueryGenConfig const &qgConfig)
-    : config(config), qgConfig(qgConfig) {}
+                       querygen::QueryGenConfig const &qgConfig,
+                       RunState state)
+    : config(config), qgConfig(qgConfig), state(std::move(state)) {}
 
 void DeleteData::execute(Context &metaCtx, ps_random &rand,
                          sql_variant::LoggedSQL *connection) const {
@@ -201,7 +481,8 @@ void DeleteData::execute(Context &metaCtx, ps_random &rand,
   auto const useGenerated =
       rand.random_number<std::size_t>(1, 100) <= qgConfig.dml_predicate_prob;
   if (useGenerated) {
-    querygen::Generator gen(metaCtx, rand, qgConfig, serverInfo);
+    querygen::Generator gen(metaCtx, rand, qgConfig, serverInfo,
+                            state.feedback());
     auto pred = gen.generatePredicate(table, tableName);
     connection
         ->executeQuery(fmt::format("DELETE FROM {} WHERE {};", tableName,
@@ -216,6 +497,20 @@ void DeleteData::execute(Context &metaCtx, ps_random &rand,
   // TODO: add other types of deletes, e.g. not based on primary key
   auto const rows = rand.random_number(config.deleteMin, config.deleteMax);
 
+  auto const keys =
+      pick_keys(config, state.keys.get(), config.deleteAccess, *table, rows,
+                rand, metaCtx.turns());
+  if (!keys.empty()) {
+    connection
+        ->executeQuery(fmt::format("DELETE FROM {} WHERE {} IN ({});",
+                                   tableName, pkName, fmt::join(keys, ", ")))
+        .maybeThrow();
+    // deleted now or already gone before: either way not a target anymore
+    metadata::TurnScope const turn(metaCtx.turns());
+    state.keys->remove(table->id, keys);
+    return;
+  }
+
   connection
       ->executeQuery(
           fmt::format("DELETE FROM {} WHERE {} IN {};", tableName, pkName,
@@ -224,8 +519,9 @@ void DeleteData::execute(Context &metaCtx, ps_random &rand,
 }
 
 SelectThenDelete::SelectThenDelete(DmlConfig const &config,
-                                   querygen::QueryGenConfig const &qgConfig)
-    : config(config), qgConfig(qgConfig) {}
+                                   querygen::QueryGenConfig const &qgConfig,
+                                   RunState state)
+    : config(config), qgConfig(qgConfig), state(std::move(state)) {}
 
 void SelectThenDelete::execute(Context &metaCtx, ps_random &rand,
                                sql_variant::LoggedSQL *connection) const {
@@ -242,10 +538,19 @@ void SelectThenDelete::execute(Context &metaCtx, ps_random &rand,
   auto const rows = rand.random_number(config.deleteMin, config.deleteMax);
   auto const lock = pick_lock(rand, config.lockWeights);
   std::string selectSql;
+  std::vector<KeyReservoir::Key> keys;
   if (rand.random_number<std::size_t>(1, 100) <= qgConfig.dml_pk_select_prob) {
-    querygen::Generator gen(metaCtx, rand, qgConfig, serverInfo);
+    querygen::Generator gen(metaCtx, rand, qgConfig, serverInfo,
+                            state.feedback());
     auto spec = gen.generatePkSelect(table, {.limit = rows, .lock = lock});
     selectSql = querygen::render(*spec, dialect);
+  } else if (keys = pick_keys(config, state.keys.get(),
+                               config.deleteSelectedAccess, *table, rows, rand,
+                               metaCtx.turns());
+             !keys.empty()) {
+    selectSql = fmt::format("SELECT {} FROM {} WHERE {} IN ({}){};", pkName,
+                            tableName, pkName, fmt::join(keys, ", "),
+                            sql_dialect::lockClauseSuffix(lock));
   } else {
     selectSql = dialect.randomRowsSelect(tableName, pkName, rows, lock);
   }
@@ -260,13 +565,20 @@ void SelectThenDelete::execute(Context &metaCtx, ps_random &rand,
                                    tableName, pkName, fmt::join(ids, ", ")))
         .maybeThrow();
   }
+  if (state.keys != nullptr) {
+    // sampled keys the SELECT didn't return were already gone
+    metadata::TurnScope const turn(metaCtx.turns());
+    state.keys->remove(table->id, keys);
+    state.keys->remove(table->id, parse_keys(ids));
+  }
 
   maybe_commit_own_trx(guard, connection);
 }
 
 UpdateOneRow::UpdateOneRow(DmlConfig const &config,
-                           querygen::QueryGenConfig const &qgConfig)
-    : config(config), qgConfig(qgConfig) {}
+                           querygen::QueryGenConfig const &qgConfig,
+                           RunState state)
+    : config(config), qgConfig(qgConfig), state(std::move(state)) {}
 
 void UpdateOneRow::execute(Context &metaCtx, ps_random &rand,
                            sql_variant::LoggedSQL *connection) const {
@@ -276,6 +588,7 @@ void UpdateOneRow::execute(Context &metaCtx, ps_random &rand,
   auto const tables = metaCtx.get<Table>();
 
   table_cptr table = find_random_table(metaCtx, rand);
+  seed_fk_keys(config, state.keys.get(), *table, tables, connection, dialect);
 
   auto const &tableName = table->name;
   // TODO: assumes we have a single column primary key as the first column.
@@ -285,41 +598,60 @@ void UpdateOneRow::execute(Context &metaCtx, ps_random &rand,
   auto const useGenerated =
       rand.random_number<std::size_t>(1, 100) <= qgConfig.dml_predicate_prob;
 
-  std::stringstream sql;
-  sql << "UPDATE ";
-  sql << tableName;
-  sql << " SET ";
+  auto const &stmts = state.statements->forTable(table);
+  std::string sql = stmts.updatePrefix;
 
-  bool first = true;
-  for (auto const &f : table->columns) {
-    if (!f.auto_increment) {
-      if (!first) {
-        sql << ", ";
-      }
-      sql << f.name;
-      sql << " = ";
-      sql << generate_value(f, rand, table->partitioning, tables, dialect);
-      first = false;
+  // partition-key pks are rewritten too: the row moves to a new key
+  std::optional<KeyReservoir::Key> newKey;
+  for (std::size_t i = 0; i < stmts.valueColumns.size(); ++i) {
+    auto const &f = *stmts.valueColumns[i];
+    if (i != 0) {
+      sql += ", ";
     }
+    sql += stmts.assignments[i];
+    auto value =
+        generate_value(f, rand, table->partitioning, tables, dialect, config,
+                       state.keys.get());
+    if (f.primary_key) {
+      newKey = parse_key(value);
+    }
+    sql += value;
   }
 
+  std::vector<KeyReservoir::Key> keys;
   if (useGenerated) {
     // generated predicate may hit many rows - that is the point
-    querygen::Generator gen(metaCtx, rand, qgConfig, serverInfo);
+    querygen::Generator gen(metaCtx, rand, qgConfig, serverInfo,
+                            state.feedback());
     auto pred = gen.generatePredicate(table, tableName);
-    sql << fmt::format(" WHERE {}", querygen::render(pred, dialect));
+    sql += fmt::format(" WHERE {}", querygen::render(pred, dialect));
+  } else if (keys = pick_keys(config, state.keys.get(), config.updateAccess,
+                               *table, 1, rand, metaCtx.turns());
+             !keys.empty()) {
+    sql += fmt::format(" WHERE {} = {}", pkName, keys.front());
   } else {
-    sql << fmt::format(" WHERE {} IN {}", pkName,
+    sql += fmt::format(" WHERE {} IN {}", pkName,
                        dialect.randomRowSubquery(tableName, pkName, 1));
   }
-  sql << ";";
+  sql += ";";
 
-  connection->executeQuery(sql.str()).maybeThrow();
+  auto res = connection->executeQuery(sql);
+  res.maybeThrow();
+
+  metadata::TurnScope const turn(metaCtx.turns());
+  if (!keys.empty() && (res.affectedRows == 0 || newKey)) {
+    // missed (row gone), or moved to newKey
+    state.keys->remove(table->id, keys);
+  }
+  if (!keys.empty() && res.affectedRows != 0 && newKey) {
+    state.keys->add(table->id, std::span(&*newKey, 1));
+  }
 }
 
 SelectThenUpdate::SelectThenUpdate(DmlConfig const &config,
-                                   querygen::QueryGenConfig const &qgConfig)
-    : config(config), qgConfig(qgConfig) {}
+                                   querygen::QueryGenConfig const &qgConfig,
+                                   RunState state)
+    : config(config), qgConfig(qgConfig), state(std::move(state)) {}
 
 void SelectThenUpdate::execute(Context &metaCtx, ps_random &rand,
                                sql_variant::LoggedSQL *connection) const {
@@ -329,6 +661,7 @@ void SelectThenUpdate::execute(Context &metaCtx, ps_random &rand,
   auto const tables = metaCtx.get<Table>();
 
   table_cptr table = find_random_table(metaCtx, rand);
+  seed_fk_keys(config, state.keys.get(), *table, tables, connection, dialect);
 
   auto const &tableName = table->name;
   // TODO: assumes we have a single column primary key as the first column.
@@ -338,40 +671,52 @@ void SelectThenUpdate::execute(Context &metaCtx, ps_random &rand,
   auto const rows = rand.random_number(config.updateMin, config.updateMax);
   auto const lock = pick_lock(rand, config.lockWeights);
   std::string selectSql;
+  std::vector<KeyReservoir::Key> keys;
   if (rand.random_number<std::size_t>(1, 100) <= qgConfig.dml_pk_select_prob) {
-    querygen::Generator gen(metaCtx, rand, qgConfig, serverInfo);
+    querygen::Generator gen(metaCtx, rand, qgConfig, serverInfo,
+                            state.feedback());
     auto spec = gen.generatePkSelect(table, {.limit = rows, .lock = lock});
     selectSql = querygen::render(*spec, dialect);
+  } else if (keys = pick_keys(config, state.keys.get(),
+                               config.updateSelectedAccess, *table, rows, rand,
+                               metaCtx.turns());
+             !keys.empty()) {
+    selectSql = fmt::format("SELECT {} FROM {} WHERE {} IN ({}){};", pkName,
+                            tableName, pkName, fmt::join(keys, ", "),
+                            sql_dialect::lockClauseSuffix(lock));
   } else {
     selectSql = dialect.randomRowsSelect(tableName, pkName, rows, lock);
   }
 
-  std::stringstream setClause;
-  bool first = true;
-  for (auto const &f : table->columns) {
-    // pk/partition-key columns get a single constant value; setting them
-    // on a multi-row update collapses every matched row into one key
-    if (!f.auto_increment && !f.primary_key && !f.partition_key) {
-      if (!first) {
-        setClause << ", ";
-      }
-      setClause << f.name;
-      setClause << " = ";
-      setClause << generate_value(f, rand, table->partitioning, tables,
-                                  dialect);
-      first = false;
+  auto const &stmts = state.statements->forTable(table);
+  std::string setClause;
+  for (std::size_t i = 0; i < stmts.bulkSetColumns.size(); ++i) {
+    if (i != 0) {
+      setClause += ", ";
     }
+    setClause += stmts.bulkSetAssignments[i];
+    setClause +=
+        generate_value(*stmts.bulkSetColumns[i], rand, table->partitioning,
+                       tables, dialect, config, state.keys.get());
   }
 
   std::optional<TxGuard> guard;
   maybe_begin_own_trx(metaCtx, connection, dialect, guard);
 
   auto const ids = fetch_ids(connection, selectSql);
-  // !first: table may have no updatable columns left (empty SET)
-  if (!ids.empty() && !first) {
+  if (ids.size() < keys.size()) {
+    auto found = parse_keys(ids);
+    std::ranges::sort(found);
+    std::vector<KeyReservoir::Key> missing;
+    std::ranges::set_difference(keys, found, std::back_inserter(missing));
+    metadata::TurnScope const turn(metaCtx.turns());
+    state.keys->remove(table->id, missing);
+  }
+  // table may have no updatable columns left (empty SET)
+  if (!ids.empty() && !setClause.empty()) {
     connection
-        ->executeQuery(fmt::format("UPDATE {} SET {} WHERE {} IN ({});",
-                                   tableName, setClause.str(), pkName,
+        ->executeQuery(fmt::format("{}{} WHERE {} IN ({});",
+                                   stmts.updatePrefix, setClause, pkName,
                                    fmt::join(ids, ", ")))
         .maybeThrow();
   }
@@ -379,32 +724,78 @@ void SelectThenUpdate::execute(Context &metaCtx, ps_random &rand,
   maybe_commit_own_trx(guard, connection);
 }
 
-SelectQuery::SelectQuery(querygen::QueryGenConfig const &config)
-    : config(config) {}
+SelectQuery::SelectQuery(querygen::QueryGenConfig const &config,
+                         RunState state)
+    : config(config), state(std::move(state)) {}
 
 void SelectQuery::execute(Context &metaCtx, ps_random &rand,
                           sql_variant::LoggedSQL *connection) const {
   auto const serverInfo = connection->serverInfo();
   auto const &dialect = sql_dialect::dialect_for(serverInfo);
 
-  querygen::Generator gen(metaCtx, rand, config, serverInfo);
+  // shared across workers; one of them re-reads the estimates now and
+  // then, on a side connection: the catalog query is neither this action's
+  // SQL nor part of its plan, and the worker's stop doesn't concern it
+  std::chrono::seconds const refresh(config.estimate_refresh_seconds);
+  // a connection is taken only by the worker that won the refresh
+  if (config.max_estimated_rows > 0 && state.row_estimates != nullptr &&
+      state.row_estimates->tryBeginRefresh(refresh)) {
+    auto side = state.connections != nullptr
+                    ? state.connections->acquire(1)
+                    : std::vector<std::unique_ptr<sql_variant::LoggedSQL>>{};
+    if (!side.empty()) {
+      state.row_estimates->refresh(*side.front());
+      state.connections->release(std::move(side.front()));
+    } else if (!metaCtx.inTransaction()) {
+      // no pool: this connection, under a name of its own. Not inside a
+      // transaction: a failing catalog query would poison it
+      auto const scope = connection->scopedActionName("row_estimates");
+      state.row_estimates->refresh(*connection);
+    }
+    state.row_estimates->endRefresh();
+  }
+
+  querygen::Generator gen(metaCtx, rand, config, serverInfo, state.feedback());
   auto spec = gen.generate(querygen::Purpose::standalone, nullptr);
   if (!spec) {
     throw ActionException("empty-metadata", "No tables to select from");
   }
 
+  auto const sql = querygen::render(*spec, dialect);
+  if (config.plan_sample_prob > 0 && state.plan_coverage != nullptr &&
+      rand.random_number<std::size_t>(1, 100) <= config.plan_sample_prob) {
+    auto const novel = sample_plan(connection, dialect, sql,
+                                   *state.plan_coverage, gen.features());
+    if (novel == true) {
+      spdlog::debug("select_query: new plan shape ({} distinct)",
+                    state.plan_coverage->distinctPlans());
+    } else if (novel == false && config.plan_skip_seen &&
+               !metaCtx.inTransaction()) {
+      // nothing new to learn from running it. A transaction's statement
+      // runs regardless: its outcome is the transaction's
+      throw ActionSkipped("plan shape seen before");
+    }
+  }
+
   // random join trees can explode; a timeout turns a runaway query into a
-  // regular action failure. reset is best-effort: inside a poisoned pg
-  // transaction it fails, but the rollback reverts the SET anyway
-  bool const isMysql = serverInfo.is_mysql_like();
-  connection
-      ->executeQuery(isMysql ? "SET SESSION max_execution_time = 10000;"
-                             : "SET statement_timeout = 10000;")
-      .maybeThrow();
-  auto res = connection->executeQuery(querygen::render(*spec, dialect));
-  std::ignore =
-      connection->executeQuery(isMysql ? "SET SESSION max_execution_time = 0;"
-                                       : "SET statement_timeout = 0;");
+  // regular action failure. A watched connection gets it for free;
+  // otherwise SET it around the query. That reset is best-effort: inside a
+  // poisoned pg transaction it fails, but the rollback reverts the SET
+  sql_variant::QueryResult res;
+  if (connection->watched()) {
+    sql_variant::StatementCap const cap(*connection, runaway_query_cap);
+    res = connection->executeQuery(sql);
+  } else {
+    bool const isMysql = serverInfo.is_mysql_like();
+    connection
+        ->executeQuery(isMysql ? "SET SESSION max_execution_time = 10000;"
+                               : "SET statement_timeout = 10000;")
+        .maybeThrow();
+    res = connection->executeQuery(sql);
+    std::ignore = connection->executeQuery(
+        isMysql ? "SET SESSION max_execution_time = 0;"
+                : "SET statement_timeout = 0;");
+  }
   res.maybeThrow();
   if (res.data != nullptr) {
     spdlog::debug("select_query returned {} rows", res.data->numRows());
@@ -0,0 +1,210 @@
+#include "action/grammar.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <fmt/format.h>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace action {
+
+namespace {
+
+using ColumnKind = SqlTemplate::ColumnKind;
+
+bool is_word_char(char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) != 0 || c == '_';
+}
+
+// "1" -> 1; nullopt for anything else, 0 included
+std::optional<std::size_t> parse_index(std::string_view text) {
+  std::size_t n = 0;
+  auto const [ptr, ec] =
+      std::from_chars(text.data(), text.data() + text.size(), n);
+  if (text.empty() || ec != std::errc{} || ptr != text.data() + text.size() ||
+      n == 0) {
+    return std::nullopt;
+  }
+  return n;
+}
+
+std::optional<ColumnKind> parse_type(std::string_view text) {
+  constexpr std::array<std::pair<std::string_view, ColumnKind>, 19> types{{
+      {"INT", ColumnKind::integer},     {"INTEGER", ColumnKind::integer},
+      {"BIGINT", ColumnKind::integer},  {"SMALLINT", ColumnKind::integer},
+      {"TINYINT", ColumnKind::integer}, {"FLOAT", ColumnKind::real},
+      {"DOUBLE", ColumnKind::real},     {"REAL", ColumnKind::real},
+      {"DECIMAL", ColumnKind::real},    {"NUMERIC", ColumnKind::real},
+      {"CHAR", ColumnKind::text},       {"VARCHAR", ColumnKind::text},
+      {"TEXT", ColumnKind::text},       {"BOOL", ColumnKind::boolean},
+      {"BOOLEAN", ColumnKind::boolean}, {"BLOB", ColumnKind::binary},
+      {"BYTEA", ColumnKind::binary},    {"BINARY", ColumnKind::binary},
+      {"VARBINARY", ColumnKind::binary},
+  }};
+  for (auto const &[name, kind] : types) {
+    if (name == text) {
+      return kind;
+    }
+  }
+  return std::nullopt;
+}
+
+struct Placeholder {
+  std::size_t slot;
+  std::optional<ColumnKind> kind; // nullopt: the table itself
+  std::size_t ordinal = 0;
+  bool value = false;
+};
+
+// T<n>[_<TYPE>_<m>[_VALUE]]; nullopt when `word` is plain SQL
+std::optional<Placeholder> parse_placeholder(std::string_view word) {
+  if (word.size() < 2 || word[0] != 'T') {
+    return std::nullopt;
+  }
+  auto const tableEnd = word.find('_');
+  auto const table = parse_index(word.substr(1, tableEnd - 1));
+  if (!table) {
+    return std::nullopt;
+  }
+  if (tableEnd == std::string_view::npos) {
+    return Placeholder{.slot = *table - 1, .kind = std::nullopt};
+  }
+  auto rest = word.substr(tableEnd + 1);
+  bool const value = rest.ends_with("_VALUE");
+  if (value) {
+    rest.remove_suffix(std::string_view("_VALUE").size());
+  }
+  auto const typeEnd = rest.rfind('_');
+  if (typeEnd == std::string_view::npos) {
+    return std::nullopt;
+  }
+  auto const kind = parse_type(rest.substr(0, typeEnd));
+  auto const ordinal = parse_index(rest.substr(typeEnd + 1));
+  if (!kind || !ordinal) {
+    return std::nullopt;
+  }
+  return Placeholder{.slot = *table - 1,
+                     .kind = kind,
+                     .ordinal = *ordinal - 1,
+                     .value = value};
+}
+
+void add_placeholder(SqlTemplate &out, Placeholder const &p) {
+  if (!p.kind) {
+    out.addTable(p.slot);
+  } else if (p.value) {
+    out.addValue(p.slot, *p.kind, p.ordinal);
+  } else {
+    out.addColumn(p.slot, *p.kind, p.ordinal);
+  }
+}
+
+ActionType classify(std::string_view line) {
+  auto const start = std::ranges::find_if(
+      line, [](char c) { return std::isalpha(static_cast<unsigned char>(c)); });
+  auto const end = std::find_if(start, line.end(), [](char c) {
+    return std::isalpha(static_cast<unsigned char>(c)) == 0;
+  });
+  std::string keyword(start, end);
+  std::ranges::transform(keyword, keyword.begin(), [](char c) {
+    return static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+  });
+  constexpr std::array<std::string_view, 6> ddl{
+      "CREATE", "ALTER", "DROP", "TRUNCATE", "RENAME", "OPTIMIZE"};
+  constexpr std::array<std::string_view, 6> dml{
+      "SELECT", "INSERT", "UPDATE", "DELETE", "REPLACE", "WITH"};
+  if (std::ranges::find(ddl, keyword) != ddl.end()) {
+    return ActionType::ddl;
+  }
+  if (std::ranges::find(dml, keyword) != dml.end()) {
+    return ActionType::dml;
+  }
+  return ActionType::other;
+}
+
+std::string_view trim(std::string_view text) {
+  auto const isSpace = [](char c) {
+    return std::isspace(static_cast<unsigned char>(c)) != 0;
+  };
+  while (!text.empty() && isSpace(text.front())) {
+    text.remove_prefix(1);
+  }
+  while (!text.empty() && isSpace(text.back())) {
+    text.remove_suffix(1);
+  }
+  return text;
+}
+
+} // namespace
+
+SqlTemplate compile_pstress_rule(std::string_view line) {
+  SqlTemplate out;
+  std::size_t start = 0; // of the pending literal
+  std::size_t i = 0;
+  char quote = 0;
+  while (i < line.size()) {
+    char const c = line[i];
+    if (quote != 0) {
+      if (c == '\\' && quote != '`') {
+        ++i; // skip the escaped character
+      } else if (c == quote) {
+        quote = 0;
+      }
+      ++i;
+      continue;
+    }
+    if (c == '\'' || c == '"' || c == '`') {
+      quote = c;
+      ++i;
+      continue;
+    }
+    if (!is_word_char(c)) {
+      ++i;
+      continue;
+    }
+    auto const wordEnd = std::find_if_not(line.begin() + i, line.end(),
+                                          is_word_char) -
+                         line.begin();
+    auto const word = line.substr(i, wordEnd - i);
+    if (auto const placeholder = parse_placeholder(word)) {
+      out.addLiteral(line.substr(start, i - start));
+      add_placeholder(out, *placeholder);
+      start = wordEnd;
+    }
+    i = wordEnd;
+  }
+  out.addLiteral(line.substr(start));
+  return out;
+}
+
+std::vector<GrammarRule> parse_grammar(std::string_view text) {
+  std::vector<GrammarRule> rules;
+  std::unordered_map<std::string_view, std::size_t> seen;
+  std::size_t lineNo = 0;
+  while (!text.empty()) {
+    ++lineNo;
+    auto const eol = text.find('\n');
+    auto const line = trim(text.substr(0, eol));
+    text.remove_prefix(eol == std::string_view::npos ? text.size() : eol + 1);
+    if (line.empty() || line.starts_with('#') || line.starts_with("--")) {
+      continue;
+    }
+    if (auto it = seen.find(line); it != seen.end()) {
+      ++rules[it->second].occurrences;
+      continue;
+    }
+    auto compiled = compile_pstress_rule(line);
+    seen.emplace(line, rules.size());
+    rules.push_back({.line = lineNo,
+                     .text = std::string(line),
+                     .occurrences = 1,
+                     .type = classify(line),
+                     .compiled = std::move(compiled)});
+  }
+  return rules;
+}
+
+} // namespace action
@@ -0,0 +1,234 @@
+#include "action/key_reservoir.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace action {
+
+namespace {
+
+/* Zipf over [1, n] by rejection-inversion (Hörmann, Derflinger 1996):
+   constant time for any n, no zeta table to rebuild as n grows. */
+class ZipfSampler {
+public:
+  ZipfSampler(std::uint64_t n, double exponent)
+      : n(static_cast<double>(n)), s(exponent),
+        hIntegralX1(hIntegral(1.5) - 1.0), hIntegralN(hIntegral(this->n + 0.5)),
+        threshold(2.0 - hIntegralInverse(hIntegral(2.5) - h(2.0))) {}
+
+  template <typename Uniform> std::uint64_t operator()(Uniform &&uniform) {
+    while (true) {
+      auto const u = hIntegralN + (uniform() * (hIntegralX1 - hIntegralN));
+      auto const x = hIntegralInverse(u);
+      auto const k = std::clamp(std::floor(x + 0.5), 1.0, n);
+      if (k - x <= threshold || u >= hIntegral(k + 0.5) - h(k)) {
+        return static_cast<std::uint64_t>(k);
+      }
+    }
+  }
+
+private:
+  // log1p(x)/x and expm1(x)/x, with their series near 0
+  static double helper1(double x) {
+    if (std::abs(x) > 1e-8) {
+      return std::log1p(x) / x;
+    }
+    return 1.0 - (x * (0.5 - (x * ((1.0 / 3.0) - (0.25 * x)))));
+  }
+  static double helper2(double x) {
+    if (std::abs(x) > 1e-8) {
+      return std::expm1(x) / x;
+    }
+    return 1.0 + (x * 0.5 * (1.0 + (x * (1.0 / 3.0) * (1.0 + (0.25 * x)))));
+  }
+
+  [[nodiscard]] double h(double x) const { return std::exp(-s * std::log(x)); }
+  [[nodiscard]] double hIntegral(double x) const {
+    auto const logX = std::log(x);
+    return helper2((1.0 - s) * logX) * logX;
+  }
+  [[nodiscard]] double hIntegralInverse(double x) const {
+    auto const t = std::max(x * (1.0 - s), -1.0);
+    return std::exp(helper1(t) * x);
+  }
+
+  double n;
+  double s;
+  double hIntegralX1;
+  double hIntegralN;
+  double threshold;
+};
+
+// index in [0, size) for one worker draw. Skewed kinds may need several
+// uniforms: they come from a generator seeded by the draw, so the worker
+// still spends exactly one draw per key
+std::size_t pick_index(std::uint64_t draw, std::size_t size,
+                       KeyDistribution const &dist) {
+  using Kind = KeyDistribution::Kind;
+  if (dist.kind == Kind::uniform || size == 1 ||
+      ((dist.kind == Kind::zipfian || dist.kind == Kind::latest) &&
+       dist.theta <= 0)) {
+    return draw % size;
+  }
+  xoshiro256pp local(draw);
+  auto uniform = [&local] {
+    return static_cast<double>(local() >> 11) * 0x1.0p-53;
+  };
+  if (dist.kind == Kind::hotspot) {
+    auto const hot = std::clamp<std::size_t>(
+        static_cast<std::size_t>(dist.hot_fraction * static_cast<double>(size)),
+        1, size);
+    if (hot == size || uniform() < dist.hot_probability) {
+      return local() % hot;
+    }
+    return hot + (local() % (size - hot));
+  }
+  return ZipfSampler(size, dist.theta)(uniform) - 1;
+}
+
+} // namespace
+
+KeyReservoir::KeyReservoir(std::size_t capacity) : capacity_(capacity) {}
+
+std::shared_ptr<KeyReservoir::Slot>
+KeyReservoir::find(metadata::ObjectId table) const {
+  std::shared_lock lock(mutex_);
+  auto it = slots_.find(table);
+  return it == slots_.end() ? nullptr : it->second;
+}
+
+void KeyReservoir::add(metadata::ObjectId table, std::span<Key const> keys) {
+  if (keys.empty() || capacity_ == 0) {
+    return;
+  }
+  auto slot = find(table);
+  if (slot == nullptr) {
+    std::unique_lock lock(mutex_);
+    auto &entry = slots_[table];
+    if (entry == nullptr) {
+      entry = std::make_shared<Slot>(table);
+    }
+    slot = entry;
+  }
+
+  std::unique_lock lock(slot->mutex);
+  for (auto const key : keys) {
+    if (slot->recentSet.insert(key).second) {
+      slot->recent.push_back(key);
+      if (slot->recent.size() > recentCapacity) {
+        slot->recentSet.erase(slot->recent.front());
+        slot->recent.pop_front();
+      }
+    }
+    if (slot->positions.contains(key)) {
+      continue;
+    }
+    ++slot->seen;
+    if (slot->keys.size() < capacity_) {
+      slot->positions.emplace(key, slot->keys.size());
+      slot->keys.push_back(key);
+      continue;
+    }
+    // algorithm R: the new key replaces a random one with capacity/seen
+    auto const pick = slot->rng() % slot->seen;
+    if (pick < capacity_) {
+      slot->positions.erase(slot->keys[pick]);
+      slot->keys[pick] = key;
+      slot->positions.emplace(key, pick);
+    }
+  }
+}
+
+void KeyReservoir::remove(metadata::ObjectId table, std::span<Key const> keys) {
+  auto slot = find(table);
+  if (slot == nullptr) {
+    return;
+  }
+  std::unique_lock lock(slot->mutex);
+  for (auto const key : keys) {
+    if (slot->recentSet.erase(key) != 0) {
+      std::erase(slot->recent, key);
+    }
+    auto it = slot->positions.find(key);
+    if (it == slot->positions.end()) {
+      continue;
+    }
+    auto const pos = it->second;
+    slot->positions.erase(it);
+    if (pos + 1 != slot->keys.size()) {
+      slot->keys[pos] = slot->keys.back();
+      slot->positions[slot->keys[pos]] = pos;
+    }
+    slot->keys.pop_back();
+  }
+}
+
+void KeyReservoir::forget(metadata::ObjectId table) {
+  std::unique_lock lock(mutex_);
+  slots_.erase(table);
+  seededAt_.erase(table);
+}
+
+bool KeyReservoir::claimSeed(metadata::ObjectId table,
+                             std::chrono::steady_clock::duration interval) {
+  auto const now = std::chrono::steady_clock::now();
+  std::unique_lock lock(mutex_);
+  auto [it, first] = seededAt_.try_emplace(table, now);
+  if (!first && now - it->second < interval) {
+    return false;
+  }
+  it->second = now;
+  return true;
+}
+
+std::vector<KeyReservoir::Key>
+KeyReservoir::sample(metadata::ObjectId table, std::size_t count,
+                     ps_random &rand, KeyDistribution const &dist) const {
+  std::vector<std::uint64_t> draws(count);
+  for (auto &d : draws) {
+    d = rand.random_number<std::uint64_t>();
+  }
+
+  std::vector<Key> out;
+  auto slot = find(table);
+  if (slot == nullptr) {
+    return out;
+  }
+  {
+    std::unique_lock lock(slot->mutex);
+    out.reserve(count);
+    if (dist.kind == KeyDistribution::Kind::latest) {
+      // rank 0 = newest
+      auto const &recent = slot->recent;
+      for (auto const d : draws) {
+        if (recent.empty()) {
+          break;
+        }
+        auto const rank = pick_index(d, recent.size(), dist);
+        out.push_back(recent[recent.size() - 1 - rank]);
+      }
+    } else {
+      for (auto const d : draws) {
+        if (slot->keys.empty()) {
+          break;
+        }
+        out.push_back(slot->keys[pick_index(d, slot->keys.size(), dist)]);
+      }
+    }
+  }
+  std::ranges::sort(out);
+  auto const dups = std::ranges::unique(out);
+  out.erase(dups.begin(), dups.end());
+  return out;
+}
+
+std::size_t KeyReservoir::size(metadata::ObjectId table) const {
+  auto slot = find(table);
+  if (slot == nullptr) {
+    return 0;
+  }
+  std::unique_lock lock(slot->mutex);
+  return slot->keys.size();
+}
+
+} // namespace action
@@ -0,0 +1,243 @@
+#include "action/oracle.hpp"
+#include "action/helper.hpp"
+#include "querygen/generator.hpp"
+#include "querygen/oracle.hpp"
+#include "querygen/render.hpp"
+#include "sql_dialect/dialect.hpp"
+
+#include <algorithm>
+#include <array>
+#include <exception>
+#include <fmt/format.h>
+#include <fmt/ranges.h>
+#include <optional>
+#include <spdlog/spdlog.h>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace action;
+
+namespace {
+
+querygen::QueryResult digest(sql_variant::QueryResult const &res) {
+  querygen::QueryResult out;
+  if (res.data == nullptr) {
+    return out;
+  }
+  auto const rows = res.data->numRows();
+  for (std::size_t i = 0; i < rows; ++i) {
+    auto const row = res.data->nextRow();
+    out.addRow(row.rowData);
+  }
+  return out;
+}
+
+// same 10s cap select_query uses. Watched connections take it from a
+// StatementCap instead. pg: SET LOCAL dies with the transaction; mysql:
+// reset by the caller
+void cap_statement_time(sql_variant::LoggedSQL *conn, bool isMysql) {
+  if (conn->watched()) {
+    return;
+  }
+  conn->executeQuery(isMysql ? "SET SESSION max_execution_time = 10000;"
+                             : "SET LOCAL statement_timeout = 10000;")
+      .maybeThrow();
+}
+
+querygen::QueryResult run_variant(sql_variant::LoggedSQL *conn,
+                                  std::string const &sql) {
+  auto res = conn->executeQuery(sql);
+  res.maybeThrow();
+  return digest(res);
+}
+
+/* Variant k runs on side connection (k - 1) % side.size(); variant 0 and,
+   without side connections, all of them on the worker's connection. Every
+   connection reads the snapshot the worker's transaction exported. */
+class VariantRunner {
+public:
+  VariantRunner(sql_variant::LoggedSQL *connection,
+                sql_dialect::Dialect const &dialect, bool isMysql,
+                OracleConfig const &config, sql_variant::ConnectionPool *pool)
+      : connection(connection), dialect(dialect), isMysql(isMysql),
+        config(config), pool(pool) {}
+
+  std::vector<querygen::QueryResult>
+  run(std::vector<std::string> const &sqls) {
+    for (auto const &stmt : dialect.beginStatements(
+             sql_dialect::IsolationLevel::repeatableRead)) {
+      connection->executeQuery(stmt).maybeThrow();
+    }
+    TxGuard guard(connection);
+    sql_variant::StatementCap const cap(*connection, runaway_query_cap);
+    if (!isMysql) {
+      cap_statement_time(connection, isMysql);
+    }
+
+    std::vector<std::unique_ptr<sql_variant::LoggedSQL>> side;
+    std::optional<std::string> snapshot;
+    auto const exportSql = dialect.exportSnapshot();
+    if (exportSql && sqls.size() > 1 && config.max_connections > 0 &&
+        pool != nullptr) {
+      snapshot = connection->querySingleValue(*exportSql);
+      if (!snapshot) {
+        throw ActionException("oracle-snapshot",
+                              "Cannot export the transaction snapshot");
+      }
+      side = pool->acquire(
+          std::min(config.max_connections, sqls.size() - 1));
+    }
+
+    std::vector<querygen::QueryResult> results(sqls.size());
+    std::vector<std::exception_ptr> errors(side.size());
+    // one slot per thread; vector<bool> would share bytes between them
+    std::vector<std::uint8_t> gone(side.size(), 0);
+    std::vector<std::thread> threads;
+    threads.reserve(side.size());
+    for (std::size_t k = 0; k < side.size(); ++k) {
+      threads.emplace_back([&, k]() {
+        try {
+          runSide(side[k].get(), *snapshot, sqls, results, k + 1,
+                  side.size());
+        } catch (sql_variant::SqlException const &e) {
+          gone[k] = e.serverGone() ? 1 : 0;
+          errors[k] = std::current_exception();
+        } catch (...) {
+          errors[k] = std::current_exception();
+        }
+      });
+    }
+
+    std::exception_ptr mainError;
+    try {
+      if (isMysql) {
+        cap_statement_time(connection, isMysql);
+      }
+      results[0] = run_variant(connection, sqls[0]);
+      for (std::size_t i = 1; side.empty() && i < sqls.size(); ++i) {
+        results[i] = run_variant(connection, sqls[i]);
+      }
+    } catch (...) {
+      mainError = std::current_exception();
+    }
+    if (isMysql && !connection->watched()) {
+      std::ignore =
+          connection->executeQuery("SET SESSION max_execution_time = 0;");
+    }
+
+    for (auto &t : threads) {
+      t.join();
+    }
+    for (std::size_t k = 0; k < side.size(); ++k) {
+      if (gone[k] == 0) {
+        pool->release(std::move(side[k]));
+      }
+    }
+
+    if (mainError) {
+      std::rethrow_exception(mainError);
+    }
+    for (auto const &e : errors) {
+      if (e) {
+        std::rethrow_exception(e);
+      }
+    }
+    connection->executeQuery("COMMIT;").maybeThrow();
+    guard.disarm();
+    return results;
+  }
+
+private:
+  void runSide(sql_variant::LoggedSQL *conn, std::string const &snapshot,
+               std::vector<std::string> const &sqls,
+               std::vector<querygen::QueryResult> &results, std::size_t first,
+               std::size_t stride) const {
+    for (auto const &stmt : dialect.beginStatements(
+             sql_dialect::IsolationLevel::repeatableRead)) {
+      conn->executeQuery(stmt).maybeThrow();
+    }
+    TxGuard guard(conn); // read-only: rolling back is all the end it needs
+    sql_variant::StatementCap const cap(*conn, runaway_query_cap);
+    conn->executeQuery(dialect.importSnapshot(snapshot)).maybeThrow();
+    cap_statement_time(conn, isMysql);
+    for (std::size_t i = first; i < sqls.size(); i += stride) {
+      results[i] = run_variant(conn, sqls[i]);
+    }
+  }
+
+  sql_variant::LoggedSQL *connection;
+  sql_dialect::Dialect const &dialect;
+  bool isMysql;
+  OracleConfig const &config;
+  sql_variant::ConnectionPool *pool;
+};
+
+} // namespace
+
+OracleCheck::OracleCheck(OracleConfig const &config,
+                         querygen::QueryGenConfig const &qgConfig,
+                         RunState state)
+    : config(config), qgConfig(qgConfig), state(std::move(state)) {}
+
+void OracleCheck::execute(metadata::Context &metaCtx, ps_random &rand,
+                          sql_variant::LoggedSQL *connection) const {
+  auto const serverInfo = connection->serverInfo();
+  auto const &dialect = sql_dialect::dialect_for(serverInfo);
+
+  querygen::Generator gen(metaCtx, rand, qgConfig, serverInfo,
+                          state.feedback());
+  auto spec = gen.generate(querygen::Purpose::standalone, nullptr);
+  if (!spec) {
+    throw ActionException("empty-metadata", "No tables to select from");
+  }
+
+  querygen::TlpOracle const tlp;
+  querygen::NoRecOracle const norec;
+  std::array<std::pair<querygen::Oracle const *, std::size_t>, 2> order{
+      {{&tlp, config.tlp_weight}, {&norec, config.norec_weight}}};
+  auto const total = config.tlp_weight + config.norec_weight;
+  if (total == 0) {
+    return;
+  }
+  if (rand.random_number<std::size_t>(1, total) > config.tlp_weight) {
+    std::swap(order[0], order[1]);
+  }
+  // the other oracle gets a go when the first can't use this query
+  querygen::Oracle const *oracle = nullptr;
+  std::vector<querygen::QuerySpec> variants;
+  for (auto const &[candidate, weight] : order) {
+    if (weight == 0) {
+      continue;
+    }
+    variants = candidate->variants(*spec);
+    if (!variants.empty()) {
+      oracle = candidate;
+      break;
+    }
+  }
+  if (oracle == nullptr) {
+    return; // nothing either oracle can reason about; not a failure
+  }
+
+  std::vector<std::string> sqls;
+  sqls.reserve(variants.size());
+  for (auto const &v : variants) {
+    sqls.push_back(querygen::render(v, dialect));
+  }
+
+  VariantRunner runner(connection, dialect, serverInfo.is_mysql_like(),
+                       config, state.connections.get());
+  auto const results = runner.run(sqls);
+  if (!oracle->verdict(results)) {
+    std::vector<std::size_t> counts;
+    counts.reserve(results.size());
+    for (auto const &r : results) {
+      counts.push_back(r.rowCount);
+    }
+    throw ActionException(
+        "oracle-mismatch",
+        fmt::format("{} mismatch, rows per variant [{}]:\n{}", oracle->name(),
+                    fmt::join(counts, ", "), fmt::join(sqls, "\n")));
+  }
+}
@@ -0,0 +1,372 @@
+#include "action/sql_template.hpp"
+#include "action/helper.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <fmt/format.h>
+#include <optional>
+#include <ranges>
+#include <stdexcept>
+
+namespace action {
+
+namespace {
+
+using ColumnKind = SqlTemplate::ColumnKind;
+
+bool is_name(std::string_view text) {
+  if (text.empty() || text.front() < 'a' || text.front() > 'z') {
+    return false;
+  }
+  return std::ranges::all_of(text, [](char c) {
+    return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_' ||
+           c == ':';
+  });
+}
+
+// "" -> 1, "2" -> 2; nullopt for anything else
+std::optional<std::size_t> parse_number(std::string_view text) {
+  if (text.empty()) {
+    return 1;
+  }
+  std::size_t n = 0;
+  auto const [ptr, ec] =
+      std::from_chars(text.data(), text.data() + text.size(), n);
+  if (ec != std::errc{} || ptr != text.data() + text.size() || n == 0) {
+    return std::nullopt;
+  }
+  return n;
+}
+
+// "table" -> 0, "table3" -> 2
+std::optional<std::size_t> parse_table(std::string_view text) {
+  constexpr std::string_view prefix = "table";
+  if (!text.starts_with(prefix)) {
+    return std::nullopt;
+  }
+  auto const n = parse_number(text.substr(prefix.size()));
+  if (!n || (*n == 1 && text.size() != prefix.size())) {
+    return std::nullopt; // "table1" would alias "table"
+  }
+  return *n - 1;
+}
+
+// "int_col" -> (integer, 0), "int_col2" -> (integer, 1)
+std::optional<std::pair<ColumnKind, std::size_t>>
+parse_column(std::string_view text) {
+  constexpr std::array<std::pair<std::string_view, ColumnKind>, 6> kinds{{
+      {"col", ColumnKind::any},
+      {"int_col", ColumnKind::integer},
+      {"real_col", ColumnKind::real},
+      {"str_col", ColumnKind::text},
+      {"bool_col", ColumnKind::boolean},
+      {"bin_col", ColumnKind::binary},
+  }};
+  for (auto const &[prefix, kind] : kinds) {
+    if (!text.starts_with(prefix)) {
+      continue;
+    }
+    auto const n = parse_number(text.substr(prefix.size()));
+    if (n && (*n != 1 || text.size() == prefix.size())) {
+      return std::pair{kind, *n - 1};
+    }
+  }
+  return std::nullopt;
+}
+
+bool matches(metadata::Column const &col, ColumnKind kind) {
+  using metadata::ColumnType;
+  switch (kind) {
+  case ColumnKind::any:
+    return true;
+  case ColumnKind::integer:
+    return col.type == ColumnType::INT;
+  case ColumnKind::real:
+    return col.type == ColumnType::REAL;
+  case ColumnKind::text:
+    return col.type == ColumnType::CHAR || col.type == ColumnType::VARCHAR ||
+           col.type == ColumnType::TEXT;
+  case ColumnKind::boolean:
+    return col.type == ColumnType::BOOL;
+  case ColumnKind::binary:
+    return col.type == ColumnType::BYTEA;
+  }
+  return false;
+}
+
+void append_value(std::string &out, metadata::Column const &col,
+                  ps_random &rand) {
+  switch (col.type) {
+  case metadata::ColumnType::INT:
+    out += std::to_string(rand.random_number(1, 1000000));
+    return;
+  case metadata::ColumnType::REAL:
+    out += std::to_string(rand.random_number(1.0, 1000000.0));
+    return;
+  case metadata::ColumnType::BOOL:
+    out += rand.random_number(0, 1) == 1 ? "true" : "false";
+    return;
+  case metadata::ColumnType::CHAR:
+  case metadata::ColumnType::VARCHAR:
+    out += '\'';
+    out += rand.random_string(0, col.length);
+    out += '\'';
+    return;
+  case metadata::ColumnType::BYTEA:
+  case metadata::ColumnType::TEXT:
+    out += '\'';
+    out += rand.random_string(50, 1000);
+    out += '\'';
+    return;
+  }
+}
+
+} // namespace
+
+SqlTemplate SqlTemplate::compile(std::string_view text) {
+  SqlTemplate out;
+  std::size_t start = 0; // of the pending literal
+  std::size_t i = 0;
+  bool quoted = false;
+  while (i < text.size()) {
+    // string literals ('{foo}' arrays, JSON) are never holes
+    if (quoted) {
+      if (text[i] == '\\') {
+        ++i; // skip the escaped character
+      } else if (text[i] == '\'') {
+        quoted = false;
+      }
+      ++i;
+      continue;
+    }
+    if (text[i] == '\'') {
+      quoted = true;
+      ++i;
+      continue;
+    }
+    if (text[i] != '{') {
+      ++i;
+      continue;
+    }
+    if (i + 1 < text.size() && text[i + 1] == '{') {
+      out.addLiteral(text.substr(start, i + 1 - start));
+      i += 2;
+      start = i;
+      continue;
+    }
+    auto const close = text.find('}', i);
+    auto const name = close == std::string_view::npos
+                          ? std::string_view{}
+                          : text.substr(i + 1, close - i - 1);
+    if (!is_name(name)) {
+      ++i;
+      continue;
+    }
+    out.addLiteral(text.substr(start, i - start));
+    i = close + 1;
+    start = i;
+
+    if (name == "int") {
+      out.addInteger();
+      continue;
+    }
+    if (name == "string") {
+      out.addString();
+      continue;
+    }
+    if (auto slot = parse_table(name)) {
+      out.addTable(*slot);
+      continue;
+    }
+    std::vector<std::string_view> parts;
+    for (auto const part : std::views::split(name, ':')) {
+      parts.emplace_back(part.begin(), part.end());
+    }
+    if (parts.size() == 2 && parts[0] == "pk") {
+      if (auto slot = parse_table(parts[1])) {
+        out.addPk(*slot);
+        continue;
+      }
+    }
+    if (parts.size() == 2) {
+      auto const column = parse_column(parts[0]);
+      auto const slot = parse_table(parts[1]);
+      if (column && slot) {
+        out.addColumn(*slot, column->first, column->second);
+        continue;
+      }
+    }
+    if (parts.size() == 3 && parts[0] == "value") {
+      auto const column = parse_column(parts[1]);
+      auto const slot = parse_table(parts[2]);
+      if (column && slot) {
+        out.addValue(*slot, column->first, column->second);
+        continue;
+      }
+    }
+    throw std::invalid_argument(
+        fmt::format("unknown placeholder {{{}}} in: {}", name, text));
+  }
+  out.addLiteral(text.substr(start));
+  return out;
+}
+
+SqlTemplate SqlTemplate::literal(std::string_view text) {
+  SqlTemplate out;
+  out.addLiteral(text);
+  return out;
+}
+
+void SqlTemplate::addLiteral(std::string_view text) {
+  if (text.empty()) {
+    return;
+  }
+  literalSize_ += text.size();
+  if (!segments_.empty() && segments_.back().kind == Segment::Kind::literal) {
+    segments_.back().text += text;
+    return;
+  }
+  segments_.push_back(
+      {.kind = Segment::Kind::literal, .text = std::string(text), .ref = 0});
+}
+
+void SqlTemplate::addTable(std::size_t slot) {
+  tableSlots_ = std::max(tableSlots_, slot + 1);
+  segments_.push_back({.kind = Segment::Kind::table, .text = {}, .ref = slot});
+}
+
+std::size_t SqlTemplate::columnIndex(ColumnRef ref) {
+  tableSlots_ = std::max(tableSlots_, ref.slot + 1);
+  auto it = std::ranges::find(columns_, ref);
+  if (it != columns_.end()) {
+    return static_cast<std::size_t>(it - columns_.begin());
+  }
+  columns_.push_back(ref);
+  return columns_.size() - 1;
+}
+
+void SqlTemplate::addColumn(std::size_t slot, ColumnKind kind,
+                            std::size_t ordinal) {
+  segments_.push_back({.kind = Segment::Kind::column,
+                       .text = {},
+                       .ref = columnIndex({slot, kind, ordinal})});
+}
+
+void SqlTemplate::addValue(std::size_t slot, ColumnKind kind,
+                           std::size_t ordinal) {
+  segments_.push_back({.kind = Segment::Kind::value,
+                       .text = {},
+                       .ref = columnIndex({slot, kind, ordinal})});
+}
+
+void SqlTemplate::addPk(std::size_t slot) {
+  tableSlots_ = std::max(tableSlots_, slot + 1);
+  segments_.push_back({.kind = Segment::Kind::pk, .text = {}, .ref = slot});
+}
+
+void SqlTemplate::addInteger() {
+  segments_.push_back({.kind = Segment::Kind::integer, .text = {}, .ref = 0});
+}
+
+void SqlTemplate::addString() {
+  segments_.push_back({.kind = Segment::Kind::string, .text = {}, .ref = 0});
+}
+
+std::string SqlTemplate::render(metadata::Context const &metaCtx,
+                                ps_random &rand,
+                                sql_dialect::Dialect const &dialect,
+                                KeyReservoir const *keys) const {
+  // bind tables, then columns, before any value is drawn
+  std::vector<metadata::table_cptr> tables;
+  tables.reserve(tableSlots_);
+  for (std::size_t slot = 0; slot < tableSlots_; ++slot) {
+    if (slot == 0) {
+      tables.push_back(find_random_table(metaCtx, rand));
+      continue;
+    }
+    auto rest = metaCtx.get<metadata::Table>().snapshotAll();
+    std::erase_if(rest, [&](auto const &t) {
+      return std::ranges::any_of(
+          tables, [&](auto const &used) { return used->id == t->id; });
+    });
+    if (rest.empty()) {
+      throw ActionException(
+          "not-enough-tables",
+          fmt::format("template needs {} distinct tables", tableSlots_));
+    }
+    tables.push_back(rest[rand.random_number<std::size_t>(0, rest.size() - 1)]);
+  }
+
+  std::vector<metadata::Column const *> columns;
+  columns.reserve(columns_.size());
+  for (auto const &ref : columns_) {
+    auto const &table = *tables[ref.slot];
+    std::vector<metadata::Column const *> candidates;
+    for (auto const &col : table.columns) {
+      // other ordinals of the same slot and kind want other columns
+      bool taken = false;
+      for (std::size_t j = 0; j < columns.size(); ++j) {
+        taken = taken || (columns[j] == &col && columns_[j].slot == ref.slot &&
+                          columns_[j].kind == ref.kind);
+      }
+      if (!taken && matches(col, ref.kind)) {
+        candidates.push_back(&col);
+      }
+    }
+    if (candidates.empty()) {
+      throw ActionException(
+          "no-matching-column",
+          fmt::format("table {} has no column for the template", table.name));
+    }
+    columns.push_back(
+        candidates[rand.random_number<std::size_t>(0, candidates.size() - 1)]);
+  }
+
+  std::string out;
+  out.reserve(literalSize_ + (32 * segments_.size()));
+  for (auto const &seg : segments_) {
+    switch (seg.kind) {
+    case Segment::Kind::literal:
+      out += seg.text;
+      break;
+    case Segment::Kind::table:
+      out += tables[seg.ref]->name;
+      break;
+    case Segment::Kind::column:
+      out += columns[seg.ref]->name;
+      break;
+    case Segment::Kind::value:
+      append_value(out, *columns[seg.ref], rand);
+      break;
+    case Segment::Kind::pk: {
+      auto const &table = *tables[seg.ref];
+      auto const *pk = table.primaryKey();
+      if (pk == nullptr) {
+        throw ActionException(
+            "no-single-column-pk",
+            fmt::format("table {} has no single column primary key",
+                        table.name));
+      }
+      metadata::TurnScope const turn(metaCtx.turns());
+      auto const key = keys == nullptr
+                           ? std::vector<KeyReservoir::Key>{}
+                           : keys->sample(table.id, 1, rand);
+      out += key.empty() ? dialect.randomRowSubquery(table.name, pk->name, 1)
+                         : std::to_string(key.front());
+      break;
+    }
+    case Segment::Kind::integer:
+      out += std::to_string(rand.random_number(1, 1000000));
+      break;
+    case Segment::Kind::string:
+      out += '\'';
+      out += rand.random_string(1, 32);
+      out += '\'';
+      break;
+    }
+  }
+  return out;
+}
+
+} // namespace action
@@ -0,0 +1,46 @@
+#include "action/statement_cache.hpp"
+
+#include <fmt/format.h>
+#include <fmt/ranges.h>
+
+namespace action {
+
+namespace {
+
+TableStatements build(metadata::table_cptr const &table) {
+  TableStatements out;
+  out.source = table;
+  for (auto const &col : table->columns) {
+    if (col.auto_increment) {
+      continue;
+    }
+    out.valueColumns.push_back(&col);
+    out.valueNames.push_back(col.name);
+    out.assignments.push_back(fmt::format("{} = ", col.name));
+    if (!col.primary_key && !col.partition_key) {
+      out.bulkSetColumns.push_back(&col);
+      out.bulkSetAssignments.push_back(out.assignments.back());
+    }
+  }
+  out.insertPrefix =
+      fmt::format("INSERT INTO {} ({} ) VALUES ", table->name,
+                  fmt::join(out.valueNames, ", "));
+  out.updatePrefix = fmt::format("UPDATE {} SET ", table->name);
+  return out;
+}
+
+} // namespace
+
+TableStatements const &
+StatementCache::forTable(metadata::table_cptr const &table) {
+  auto it = entries_.find(table->id);
+  if (it != entries_.end() && it->second.source == table) {
+    return it->second;
+  }
+  if (it == entries_.end() && entries_.size() >= maxEntries) {
+    entries_.clear();
+  }
+  return entries_.insert_or_assign(table->id, build(table)).first->second;
+}
+
+} // namespace action
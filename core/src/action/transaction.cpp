@@ -65,8 +65,9 @@ struct Savepoint {
 } // namespace
 
 TransactionAction::TransactionAction(AllConfig config,
-                                     ActionRegistry const &pool)
-    : allConfig(std::move(config)),
+                                     ActionRegistry const &pool,
+                                     RunState state)
+    : allConfig(std::move(config)), state(std::move(state)),
       poolAll(pool.filtered([](ActionFactory const &f) {
         return f.type != ActionType::transaction && f.txn_safe;
       })),
@@ -98,8 +99,17 @@ void TransactionAction::execute(metadata::Context &metaCtx, ps_random &rand,
   TxnRecorder rec(connection);
 
   metadata::TxnBuffer<metadata::Table> txn;
-  metadata::Context trxCtx(metaCtx.registry(), &txn);
+  metadata::Context trxCtx(metaCtx.registry(), &txn, metaCtx.turns());
   auto &globalTables = metaCtx.registry().get<metadata::Table>();
+  // these go to the global catalog directly: they wait for the turn too
+  auto publish = [&] {
+    metadata::TurnScope const turn(metaCtx.turns());
+    txn.publishAll(globalTables);
+  };
+  auto rollbackTo = [&](std::size_t mark) {
+    metadata::TurnScope const turn(metaCtx.turns());
+    txn.rollbackTo(mark, globalTables);
+  };
 
   TxGuard guard(connection);
 
@@ -115,8 +125,8 @@ void TransactionAction::execute(metadata::Context &metaCtx, ps_random &rand,
   for (std::size_t i = 0; i < subCount; ++i) {
     const auto w = rand.random_number<std::size_t>(0, pool.totalWeight());
     const auto factory = pool.lookupByWeightOffset(w);
-    auto sub =
-        factory.builder(BuildContext{.config = allConfig, .registry = pool});
+    auto sub = factory.builder(BuildContext{
+        .config = allConfig, .registry = pool, .state = state});
 
     if (inTrx && !ddlTransactional && factory.type == ActionType::ddl) {
       // mysql mirror mode: DDL implicitly commits the open transaction
@@ -131,7 +141,7 @@ void TransactionAction::execute(metadata::Context &metaCtx, ps_random &rand,
       const auto queriesBefore = connection->getQueryCount();
       bool subFailed = false;
       try {
-        auto scope = connection->scopedActionName(factory.name);
+        auto scope = connection->scopedActionName(factory.stats_id);
         sub->execute(metaCtx, rand, connection);
         ++rec.out.subOk;
       } catch (sql_variant::SqlException const &e) {
@@ -154,7 +164,7 @@ void TransactionAction::execute(metadata::Context &metaCtx, ps_random &rand,
       if (connection->getQueryCount() > queriesBefore) {
         // implicit commit happened: buffered work is durable now, the
         // rest of this action runs in autocommit
-        txn.publishAll(globalTables);
+        publish();
         inTrx = false;
         guard.disarm();
         savepoints.clear();
@@ -169,7 +179,7 @@ void TransactionAction::execute(metadata::Context &metaCtx, ps_random &rand,
       // failures here still count into this outcome's subFail even though
       // the transaction already committed (implicitCommits disambiguates)
       try {
-        auto scope = connection->scopedActionName(factory.name);
+        auto scope = connection->scopedActionName(factory.stats_id);
         sub->execute(metaCtx, rand, connection);
         ++rec.out.subOk;
       } catch (sql_variant::SqlException const &e) {
@@ -179,6 +189,8 @@ void TransactionAction::execute(metadata::Context &metaCtx, ps_random &rand,
         ++rec.out.subFail;
       } catch (ActionException const &) {
         ++rec.out.subFail;
+      } catch (ActionSkipped const &) { // NOLINT(bugprone-empty-catch)
+        // didn't run: neither ok nor failed
       }
       continue;
     }
@@ -191,7 +203,7 @@ void TransactionAction::execute(metadata::Context &metaCtx, ps_random &rand,
         // scope closed early: the rewind below is the transaction's SQL,
         // not the sub-action's
         {
-          auto scope = connection->scopedActionName(factory.name);
+          auto scope = connection->scopedActionName(factory.stats_id);
           sub->execute(trxCtx, rand, connection);
         }
         ++rec.out.subOk;
@@ -205,7 +217,7 @@ void TransactionAction::execute(metadata::Context &metaCtx, ps_random &rand,
                                          savepoints[pick].name))
               .maybeThrow();
           ++rec.out.savepointRollbacks;
-          txn.rollbackTo(savepoints[pick].mark, globalTables);
+          rollbackTo(savepoints[pick].mark);
           // ROLLBACK TO destroys the later savepoints, keeps the target
           savepoints.resize(pick + 1);
         }
@@ -225,7 +237,7 @@ void TransactionAction::execute(metadata::Context &metaCtx, ps_random &rand,
                                        savepoints.back().name))
             .maybeThrow();
         ++rec.out.savepointRollbacks;
-        txn.rollbackTo(savepoints.back().mark, globalTables);
+        rollbackTo(savepoints.back().mark);
         ++rec.out.subFail;
       } catch (ActionException const &) {
         // no SQL failed (e.g. empty-metadata skip); rewind for uniformity
@@ -234,12 +246,12 @@ void TransactionAction::execute(metadata::Context &metaCtx, ps_random &rand,
                                        savepoints.back().name))
             .maybeThrow();
         ++rec.out.savepointRollbacks;
-        txn.rollbackTo(savepoints.back().mark, globalTables);
+        rollbackTo(savepoints.back().mark);
         ++rec.out.subFail;
       }
     } else { // abort mode: first failure kills the whole transaction
       try {
-        auto scope = connection->scopedActionName(factory.name);
+        auto scope = connection->scopedActionName(factory.stats_id);
         sub->execute(trxCtx, rand, connection);
         ++rec.out.subOk;
       } catch (sql_variant::SqlException const &e) {
@@ -265,7 +277,7 @@ void TransactionAction::execute(metadata::Context &metaCtx, ps_random &rand,
       guard.disarm();   // success or failure, the transaction is over
       res.maybeThrow(); // commit-time conflict: buffer discarded, reported
       rec.out.end = statistics::TransactionOutcome::End::committed;
-      txn.publishAll(globalTables);
+      publish();
     } else {
       guard.disarm();
       connection->executeQuery("ROLLBACK;").maybeThrow();
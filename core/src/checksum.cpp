@@ -86,13 +86,13 @@ void DatabaseChecksum::processAllRows(const metadata::Table &table,
 
   for (size_t i = 0; i < queryResult.data->numRows(); ++i) {
     auto row = queryResult.data->nextRow();
-    std::string rowHash = buildRowHash(row);
+    std::string rowHash = detail::buildRowHash(row);
     hasher.Update(reinterpret_cast<const CryptoPP::byte *>(rowHash.c_str()),
                   rowHash.length());
   }
 }
 
-std::string DatabaseChecksum::buildRowHash(const sql_variant::RowView &row) {
+std::string detail::buildRowHash(const sql_variant::RowView &row) {
   std::stringstream rowData;
   for (const auto &i : row.rowData) {
     if (i.has_value()) {
@@ -0,0 +1,244 @@
+#include "live_statistics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#include "statistics.hpp"
+
+namespace statistics {
+
+namespace {
+
+// the slot of `action`, claimed if new; otherActions once all are taken
+ActionCounts &slotFor(IntervalStats &stats, NameId action) {
+  for (auto &counts : stats.byAction) {
+    if (counts.action == action) {
+      return counts;
+    }
+    if (counts.action == NameTable::none) {
+      counts.action = action;
+      return counts;
+    }
+  }
+  return stats.otherActions;
+}
+
+void addCounts(ActionCounts &into, ActionCounts const &from) {
+  into.successes += from.successes;
+  into.failures += from.failures;
+  into.conflicts += from.conflicts;
+}
+
+} // namespace
+
+void IntervalStats::recordAction(ActionOutcome outcome,
+                                 std::chrono::nanoseconds took,
+                                 NameId action) {
+  switch (outcome) {
+  case ActionOutcome::success:
+    successes++;
+    break;
+  case ActionOutcome::actionFailure:
+    actionFailures++;
+    break;
+  case ActionOutcome::sqlFailure:
+    sqlFailures++;
+    break;
+  case ActionOutcome::conflict:
+    conflicts++;
+    break;
+  case ActionOutcome::otherFailure:
+    otherFailures++;
+    break;
+  }
+  auto const micros = static_cast<std::uint64_t>(std::max<std::int64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(took).count(), 0));
+  auto const bucket = std::min(
+      LatencyHistogram::bucketOf(micros, latencySubBits), latencyBuckets - 1);
+  latency[bucket]++;
+  latencyMicros += micros;
+
+  if (action == NameTable::none) {
+    return;
+  }
+  auto &counts = slotFor(*this, action);
+  switch (outcome) {
+  case ActionOutcome::success:
+    counts.successes++;
+    break;
+  case ActionOutcome::conflict:
+    counts.conflicts++;
+    break;
+  case ActionOutcome::actionFailure:
+  case ActionOutcome::sqlFailure:
+  case ActionOutcome::otherFailure:
+    counts.failures++;
+    break;
+  }
+}
+
+void IntervalStats::recordTransaction(const TransactionOutcome &outcome) {
+  switch (outcome.end) {
+  case TransactionOutcome::End::committed:
+    committed++;
+    break;
+  case TransactionOutcome::End::rolledBackIntentional:
+    rolledBackIntentional++;
+    break;
+  case TransactionOutcome::End::rolledBackError:
+    rolledBackError++;
+    break;
+  }
+}
+
+void IntervalStats::merge(const IntervalStats &other) {
+  workers += other.workers;
+  successes += other.successes;
+  actionFailures += other.actionFailures;
+  sqlFailures += other.sqlFailures;
+  conflicts += other.conflicts;
+  otherFailures += other.otherFailures;
+  reconnects += other.reconnects;
+  committed += other.committed;
+  rolledBackIntentional += other.rolledBackIntentional;
+  rolledBackError += other.rolledBackError;
+  latencyMicros += other.latencyMicros;
+  for (std::size_t i = 0; i < latency.size(); ++i) {
+    latency[i] += other.latency[i];
+  }
+  for (auto const &counts : other.byAction) {
+    if (counts.action == NameTable::none) {
+      break;
+    }
+    addCounts(slotFor(*this, counts.action), counts);
+  }
+  addCounts(otherActions, other.otherActions);
+}
+
+std::uint64_t IntervalStats::actions() const { return successes + failures(); }
+
+std::uint64_t IntervalStats::failures() const {
+  return actionFailures + sqlFailures + conflicts + otherFailures;
+}
+
+double IntervalStats::percentileMs(double percentile) const {
+  auto const total = actions();
+  if (total == 0) {
+    return 0.0;
+  }
+  auto const wanted = std::max<std::uint64_t>(
+      static_cast<std::uint64_t>(std::ceil(std::clamp(percentile, 0.0, 100.0) /
+                                           100.0 * static_cast<double>(total))),
+      1);
+  std::uint64_t seen = 0;
+  std::size_t bucket = 0;
+  for (; bucket < latency.size(); ++bucket) {
+    seen += latency[bucket];
+    if (seen >= wanted) {
+      break;
+    }
+  }
+  bucket = std::min(bucket, latency.size() - 1);
+  return static_cast<double>(
+             LatencyHistogram::highestIn(bucket, latencySubBits)) /
+         1000.0;
+}
+
+void IntervalTotals::add(const IntervalStats &stats) {
+  counts.merge(stats);
+  for (std::size_t i = 0; i < latency.size(); ++i) {
+    latency[i] += std::exchange(counts.latency[i], 0);
+  }
+}
+
+IntervalCollector::IntervalCollector(std::chrono::milliseconds interval,
+                                     std::size_t keep)
+    : interval_(interval), keep_(keep), epoch_(clock::now()) {
+  if (interval.count() <= 0) {
+    throw std::invalid_argument("a statistics interval must be > 0");
+  }
+  thread_ = std::thread([this] { run(); });
+}
+
+IntervalCollector::~IntervalCollector() {
+  {
+    std::unique_lock lock(mutex_);
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  thread_.join();
+}
+
+std::shared_ptr<IntervalRing> IntervalCollector::attach() {
+  auto ring = std::make_shared<IntervalRing>();
+  std::unique_lock lock(mutex_);
+  sources_.push_back({.ring = ring});
+  return ring;
+}
+
+std::uint64_t IntervalCollector::intervalAt(clock::time_point at) const {
+  if (at < epoch_) {
+    return 0;
+  }
+  return static_cast<std::uint64_t>((at - epoch_) / interval_);
+}
+
+void IntervalCollector::collect() {
+  std::unique_lock lock(mutex_);
+  for (auto &source : sources_) {
+    // the collector holds the last reference: the worker is gone, so this
+    // read is the last one
+    source.done = source.ring.use_count() == 1;
+    auto const published = source.ring->published();
+    auto const capacity = IntervalRing::capacity();
+    // lapped: the oldest ones are gone
+    if (published > capacity) {
+      source.next = std::max(source.next, published - capacity);
+    }
+    for (; source.next < published; ++source.next) {
+      if (auto const stats = source.ring->read(source.next)) {
+        auto &merged = merged_[stats->interval];
+        merged.merge(*stats);
+        merged.interval = stats->interval;
+        totals_.add(*stats);
+      }
+    }
+  }
+  std::erase_if(sources_, [](Source const &source) { return source.done; });
+  while (merged_.size() > keep_) {
+    merged_.erase(merged_.begin());
+  }
+}
+
+std::vector<IntervalStats>
+IntervalCollector::latest(std::size_t count) const {
+  std::unique_lock lock(mutex_);
+  std::vector<IntervalStats> out;
+  auto it = merged_.end();
+  for (std::size_t i = 0; i < count && it != merged_.begin(); ++i) {
+    --it;
+  }
+  for (; it != merged_.end(); ++it) {
+    out.push_back(it->second);
+  }
+  return out;
+}
+
+IntervalTotals IntervalCollector::totals() const {
+  std::unique_lock lock(mutex_);
+  return totals_;
+}
+
+void IntervalCollector::run() {
+  std::unique_lock lock(mutex_);
+  while (!stopping_) {
+    cv_.wait_for(lock, interval_ / 2, [this] { return stopping_; });
+    lock.unlock();
+    collect();
+    lock.lock();
+  }
+}
+
+} // namespace statistics
@@ -11,6 +11,19 @@ bool Table::hasReferenceTo(ObjectId target) const {
   });
 }
 
+Column const *Table::primaryKey() const {
+  Column const *pk = nullptr;
+  for (auto const &column : columns) {
+    if (column.primary_key) {
+      if (pk != nullptr) {
+        return nullptr;
+      }
+      pk = &column;
+    }
+  }
+  return pk;
+}
+
 bool Table::removeReferencesTo(ObjectId target) {
   bool changed = false;
   for (auto &column : columns) {
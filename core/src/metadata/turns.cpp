@@ -0,0 +1,121 @@
+#include "metadata/turns.hpp"
+
+#include <fmt/format.h>
+#include <stdexcept>
+
+namespace metadata {
+
+TurnScheduler::TurnScheduler(std::uint64_t seed, std::size_t participants,
+                             std::chrono::milliseconds stall)
+    : seed_(seed), participants_(participants), stall_(stall) {
+  if (participants == 0) {
+    throw std::invalid_argument("a turn scheduler needs participants");
+  }
+  slots_.reserve(participants);
+}
+
+std::size_t TurnScheduler::enroll() {
+  std::unique_lock lock(mutex_);
+  if (slots_.size() == participants_) {
+    throw std::logic_error(fmt::format(
+        "turn scheduler already has its {} participants", participants_));
+  }
+  // the slot, not the thread, picks the stream: same seed, same steps
+  slots_.push_back({.clock = 0,
+                    .active = true,
+                    .rng = xoshiro256pp(seed_ + slots_.size())});
+  if (slots_.size() == participants_) {
+    cv_.notify_all();
+  }
+  return slots_.size() - 1;
+}
+
+bool TurnScheduler::mayRun(std::size_t slot) const {
+  if (holder_ != none || slots_.size() < participants_) {
+    return false;
+  }
+  auto const &mine = slots_[slot];
+  for (std::size_t other = 0; other < slots_.size(); ++other) {
+    auto const &s = slots_[other];
+    if (other == slot || !s.active) {
+      continue;
+    }
+    if (s.clock < mine.clock || (s.clock == mine.clock && other < slot)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void TurnScheduler::take(std::size_t slot) {
+  holder_ = slot;
+  depth_ = 1;
+  ++turns_;
+}
+
+void TurnScheduler::acquire(std::size_t slot) {
+  std::unique_lock lock(mutex_);
+  if (cancelled_) {
+    return;
+  }
+  if (holder_ == slot) {
+    ++depth_;
+    return;
+  }
+  auto const start = std::chrono::steady_clock::now();
+  auto const ready = [&] { return cancelled_ || mayRun(slot); };
+  if (!cv_.wait_until(lock, start + stall_, ready)) {
+    // out of order; still one holder at a time
+    cv_.wait(lock, [&] { return cancelled_ || holder_ == none; });
+    ++stalls_;
+  }
+  waited_ += std::chrono::steady_clock::now() - start;
+  if (!cancelled_) {
+    take(slot);
+  }
+}
+
+void TurnScheduler::release(std::size_t slot) {
+  std::unique_lock lock(mutex_);
+  if (cancelled_ || holder_ != slot) {
+    return;
+  }
+  if (--depth_ > 0) {
+    return;
+  }
+  holder_ = none;
+  auto &s = slots_[slot];
+  s.clock += 1 + (s.rng() % participants_);
+  cv_.notify_all();
+}
+
+void TurnScheduler::retire(std::size_t slot) {
+  std::unique_lock lock(mutex_);
+  if (slot < slots_.size()) {
+    slots_[slot].active = false;
+  }
+  cv_.notify_all();
+}
+
+void TurnScheduler::cancel() {
+  std::unique_lock lock(mutex_);
+  cancelled_ = true;
+  cv_.notify_all();
+}
+
+std::uint64_t TurnScheduler::turns() const {
+  std::unique_lock lock(mutex_);
+  return turns_;
+}
+
+std::uint64_t TurnScheduler::stalls() const {
+  std::unique_lock lock(mutex_);
+  return stalls_;
+}
+
+std::chrono::nanoseconds TurnScheduler::waited() const {
+  std::unique_lock lock(mutex_);
+  return waited_;
+}
+
+} // namespace metadata
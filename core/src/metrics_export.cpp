@@ -0,0 +1,360 @@
+#include "metrics_export.hpp"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <filesystem>
+#include <fmt/format.h>
+#include <fstream>
+#include <netinet/in.h>
+#include <poll.h>
+#include <spdlog/spdlog.h>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace statistics {
+
+namespace {
+
+// the le bounds of the latency histogram, in seconds and microseconds
+struct LatencyBound {
+  std::string_view le;
+  std::uint64_t micros;
+};
+
+constexpr std::array<LatencyBound, 16> latencyBounds{{
+    {"0.0005", 500},
+    {"0.001", 1'000},
+    {"0.0025", 2'500},
+    {"0.005", 5'000},
+    {"0.01", 10'000},
+    {"0.025", 25'000},
+    {"0.05", 50'000},
+    {"0.1", 100'000},
+    {"0.25", 250'000},
+    {"0.5", 500'000},
+    {"1.0", 1'000'000},
+    {"2.5", 2'500'000},
+    {"5.0", 5'000'000},
+    {"10.0", 10'000'000},
+    {"30.0", 30'000'000},
+    {"60.0", 60'000'000},
+}};
+
+// label values: backslash, quote and newline escaped
+std::string escapeLabel(std::string_view value) {
+  std::string out;
+  out.reserve(value.size());
+  for (char const c : value) {
+    switch (c) {
+    case '\\':
+      out += "\\\\";
+      break;
+    case '"':
+      out += "\\\"";
+      break;
+    case '\n':
+      out += "\\n";
+      break;
+    default:
+      out += c;
+    }
+  }
+  return out;
+}
+
+// OpenMetrics names a counter family without the _total of its samples,
+// the Prometheus text format with it
+void family(std::string &out, MetricsFormat format, std::string_view name,
+            std::string_view type, std::string_view help) {
+  bool const total =
+      format == MetricsFormat::prometheus && type == "counter";
+  auto const *suffix = total ? "_total" : "";
+  out += fmt::format("# TYPE {}{} {}\n# HELP {}{} {}\n", name, suffix, type,
+                     name, suffix, help);
+}
+
+void actionRuns(std::string &out, std::string_view action,
+                ActionCounts const &counts) {
+  auto const label = escapeLabel(action);
+  out += fmt::format(
+      "stormweaver_action_runs_total{{action=\"{}\",outcome=\"success\"}} "
+      "{}\n",
+      label, counts.successes);
+  out += fmt::format(
+      "stormweaver_action_runs_total{{action=\"{}\",outcome=\"failure\"}} "
+      "{}\n",
+      label, counts.failures);
+  out += fmt::format(
+      "stormweaver_action_runs_total{{action=\"{}\",outcome=\"conflict\"}} "
+      "{}\n",
+      label, counts.conflicts);
+}
+
+std::string lastError() { return std::system_category().message(errno); }
+
+void closeFd(int &fd) {
+  if (fd >= 0) {
+    ::close(fd);
+    fd = -1;
+  }
+}
+
+} // namespace
+
+std::string renderMetrics(const IntervalTotals &totals, std::int64_t inFlight,
+                          MetricsFormat format) {
+  auto const &counts = totals.counts;
+  std::string out;
+
+  family(out, format, "stormweaver_actions", "counter",
+         "Actions finished, by outcome.");
+  for (auto const &[outcome, value] :
+       {std::pair{"success", counts.successes},
+        std::pair{"action_failure", counts.actionFailures},
+        std::pair{"sql_failure", counts.sqlFailures},
+        std::pair{"conflict", counts.conflicts},
+        std::pair{"other_failure", counts.otherFailures}}) {
+    out += fmt::format("stormweaver_actions_total{{outcome=\"{}\"}} {}\n",
+                       outcome, value);
+  }
+
+  family(out, format, "stormweaver_action_runs", "counter",
+         "Actions finished, by action; failure excludes conflicts.");
+  for (auto const &slot : counts.byAction) {
+    if (slot.action == NameTable::none) {
+      break;
+    }
+    actionRuns(out, NameTable::name(slot.action), slot);
+  }
+  auto const &other = counts.otherActions;
+  if (other.successes + other.failures + other.conflicts > 0) {
+    actionRuns(out, "(other)", other);
+  }
+
+  family(out, format, "stormweaver_transactions", "counter",
+         "Transaction actions, by how they ended.");
+  for (auto const &[end, value] :
+       {std::pair{"committed", counts.committed},
+        std::pair{"rolled_back_intentional", counts.rolledBackIntentional},
+        std::pair{"rolled_back_error", counts.rolledBackError}}) {
+    out += fmt::format("stormweaver_transactions_total{{end=\"{}\"}} {}\n",
+                       end, value);
+  }
+
+  family(out, format, "stormweaver_reconnects", "counter",
+         "Reconnects after a lost connection.");
+  out += fmt::format("stormweaver_reconnects_total {}\n", counts.reconnects);
+
+  family(out, format, "stormweaver_statements_in_flight", "gauge",
+         "Statements sent and not answered yet.");
+  out += fmt::format("stormweaver_statements_in_flight {}\n", inFlight);
+
+  // a latency bucket counts below a bound only if all of it is: bounds
+  // are exact to the bucket width, about 6%
+  family(out, format, "stormweaver_action_duration_seconds", "histogram",
+         "Action latency.");
+  if (format == MetricsFormat::openMetrics) {
+    out += "# UNIT stormweaver_action_duration_seconds seconds\n";
+  }
+  std::uint64_t seen = 0;
+  std::size_t bucket = 0;
+  for (auto const &bound : latencyBounds) {
+    for (; bucket < totals.latency.size() &&
+           LatencyHistogram::highestIn(bucket, IntervalStats::latencySubBits) <=
+               bound.micros;
+         ++bucket) {
+      seen += totals.latency[bucket];
+    }
+    out += fmt::format(
+        "stormweaver_action_duration_seconds_bucket{{le=\"{}\"}} {}\n",
+        bound.le, seen);
+  }
+  out += fmt::format(
+      "stormweaver_action_duration_seconds_bucket{{le=\"+Inf\"}} {}\n",
+      counts.actions());
+  out += fmt::format("stormweaver_action_duration_seconds_count {}\n",
+                     counts.actions());
+  out += fmt::format("stormweaver_action_duration_seconds_sum {}\n",
+                     static_cast<double>(counts.latencyMicros) / 1e6);
+
+  if (format == MetricsFormat::openMetrics) {
+    out += "# EOF\n";
+  }
+  return out;
+}
+
+MetricsExporter::MetricsExporter(std::shared_ptr<IntervalCollector> collector,
+                                 Options options)
+    : collector_(std::move(collector)), options_(std::move(options)) {
+  if (options_.textfile.empty() && !options_.port) {
+    throw std::invalid_argument(
+        "a metrics exporter needs a textfile, a port or both");
+  }
+  if (options_.period.count() <= 0) {
+    throw std::invalid_argument("a metrics period must be > 0");
+  }
+
+  if (options_.port) {
+    listener_ = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(*options_.port);
+    socklen_t len = sizeof(addr);
+    int const on = 1;
+    if (listener_ < 0 ||
+        ::setsockopt(listener_, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)) !=
+            0 ||
+        ::bind(listener_, reinterpret_cast<sockaddr *>(&addr), len) != 0 ||
+        ::listen(listener_, 16) != 0 ||
+        ::getsockname(listener_, reinterpret_cast<sockaddr *>(&addr), &len) !=
+            0) {
+      auto const error = lastError();
+      closeFd(listener_);
+      throw std::runtime_error(
+          fmt::format("cannot listen for metrics on 127.0.0.1:{}: {}",
+                      *options_.port, error));
+    }
+    port_ = ntohs(addr.sin_port);
+  }
+
+  if (::pipe2(wake_.data(), O_CLOEXEC) != 0) {
+    auto const error = lastError();
+    closeFd(listener_);
+    throw std::runtime_error(fmt::format("cannot create a pipe: {}", error));
+  }
+  thread_ = std::thread([this] { run(); });
+}
+
+MetricsExporter::~MetricsExporter() { stop(); }
+
+std::string MetricsExporter::render(MetricsFormat format) const {
+  // fresher than the collector's next tick
+  collector_->collect();
+  return renderMetrics(collector_->totals(), StatementInFlight::count(),
+                       format);
+}
+
+void MetricsExporter::stop() {
+  if (!thread_.joinable()) {
+    return;
+  }
+  char const wake = 1;
+  // a pipe with room to spare: can't fail short of a closed end
+  [[maybe_unused]] auto const written = ::write(wake_[1], &wake, 1);
+  thread_.join();
+  writeTextfile();
+  closeFd(listener_);
+  closeFd(wake_[0]);
+  closeFd(wake_[1]);
+}
+
+void MetricsExporter::run() {
+  using clock = std::chrono::steady_clock;
+  auto next = clock::now();
+  while (true) {
+    int timeout = -1;
+    if (!options_.textfile.empty()) {
+      auto const now = clock::now();
+      if (now >= next) {
+        writeTextfile();
+        next = now + options_.period;
+      }
+      timeout = static_cast<int>(
+          std::chrono::ceil<std::chrono::milliseconds>(next - now).count());
+    }
+
+    std::array<pollfd, 2> fds{
+        {{.fd = wake_[0], .events = POLLIN, .revents = 0},
+         {.fd = listener_, .events = POLLIN, .revents = 0}}};
+    auto const count = listener_ >= 0 ? 2 : 1;
+    if (::poll(fds.data(), count, timeout) < 0 && errno != EINTR) {
+      spdlog::warn("metrics exporter: poll failed: {}", lastError());
+      return;
+    }
+    if (fds[0].revents != 0) {
+      return;
+    }
+    if (listener_ >= 0 && (fds[1].revents & POLLIN) != 0) {
+      int client = ::accept4(listener_, nullptr, nullptr, SOCK_CLOEXEC);
+      if (client >= 0) {
+        serve(client);
+        closeFd(client);
+      }
+    }
+  }
+}
+
+void MetricsExporter::writeTextfile() const {
+  if (options_.textfile.empty()) {
+    return;
+  }
+  auto const temporary = options_.textfile + ".tmp";
+  {
+    std::ofstream out(temporary, std::ios::trunc);
+    out << render(MetricsFormat::prometheus);
+    if (!out) {
+      spdlog::warn("metrics exporter: cannot write {}", temporary);
+      return;
+    }
+  }
+  std::error_code error;
+  std::filesystem::rename(temporary, options_.textfile, error);
+  if (error) {
+    spdlog::warn("metrics exporter: cannot replace {}: {}", options_.textfile,
+                 error.message());
+  }
+}
+
+void MetricsExporter::serve(int client) const {
+  // a scraper sends its request at once; don't let a silent one hold the
+  // thread
+  timeval const patience{.tv_sec = 1, .tv_usec = 0};
+  ::setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &patience, sizeof(patience));
+  std::string request;
+  std::array<char, 1024> buffer{};
+  while (request.find("\r\n\r\n") == std::string::npos &&
+         request.size() < 8192) {
+    auto const got = ::recv(client, buffer.data(), buffer.size(), 0);
+    if (got <= 0) {
+      break;
+    }
+    request.append(buffer.data(), static_cast<std::size_t>(got));
+  }
+
+  std::string_view const line(request.data(),
+                              std::min(request.find("\r\n"), request.size()));
+  std::string status = "200 OK";
+  std::string type =
+      "application/openmetrics-text; version=1.0.0; charset=utf-8";
+  std::string body;
+  if (!line.starts_with("GET ")) {
+    status = "405 Method Not Allowed";
+    type = "text/plain";
+  } else if (!line.starts_with("GET /metrics ") &&
+             !line.starts_with("GET /metrics?")) {
+    status = "404 Not Found";
+    type = "text/plain";
+  } else {
+    body = render();
+  }
+  auto const response = fmt::format("HTTP/1.1 {}\r\nContent-Type: {}\r\n"
+                                    "Content-Length: {}\r\n"
+                                    "Connection: close\r\n\r\n{}",
+                                    status, type, body.size(), body);
+  std::size_t sent = 0;
+  while (sent < response.size()) {
+    auto const n = ::send(client, response.data() + sent,
+                          response.size() - sent, MSG_NOSIGNAL);
+    if (n <= 0) {
+      return;
+    }
+    sent += static_cast<std::size_t>(n);
+  }
+}
+
+} // namespace statistics
@@ -0,0 +1,136 @@
+#include "querygen/coverage.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <mutex>
+
+namespace querygen {
+
+namespace {
+
+// old samples fade out over a few hundred new ones
+constexpr double scoreDecay = 0.99;
+// below this many samples the rates are noise; no bias yet
+constexpr std::size_t minBiasSamples = 50;
+constexpr double minFactor = 0.5;
+constexpr double maxFactor = 2.0;
+
+// string values that describe the plan shape. Everything else (relation,
+// index and alias names, filter text, costs) varies between otherwise
+// identical plans and only its key is hashed
+constexpr std::array shapeKeys = {
+    // pg
+    std::string_view{"Node Type"},
+    std::string_view{"Join Type"},
+    std::string_view{"Strategy"},
+    std::string_view{"Partial Mode"},
+    std::string_view{"Parent Relationship"},
+    std::string_view{"Scan Direction"},
+    std::string_view{"Operation"},
+    // mysql
+    std::string_view{"access_type"},
+    std::string_view{"select_type"},
+    std::string_view{"message"},
+};
+
+constexpr std::uint64_t fnvOffset = 14695981039346656037ULL;
+constexpr std::uint64_t fnvPrime = 1099511628211ULL;
+
+void mix(std::uint64_t &h, std::string_view s) {
+  for (auto const c : s) {
+    h ^= static_cast<unsigned char>(c);
+    h *= fnvPrime;
+  }
+  // separator, so ("ab","c") and ("a","bc") differ
+  h ^= 0xff;
+  h *= fnvPrime;
+}
+
+void hashNode(std::uint64_t &h, nlohmann::json const &node) {
+  if (node.is_object()) {
+    mix(h, "{");
+    // nlohmann::json keeps object keys sorted: order is canonical
+    for (auto const &[key, value] : node.items()) {
+      mix(h, key);
+      if (value.is_string()) {
+        if (std::ranges::find(shapeKeys, key) != shapeKeys.end()) {
+          mix(h, value.get_ref<std::string const &>());
+        }
+      } else if (value.is_boolean()) {
+        mix(h, value.get<bool>() ? "t" : "f");
+      } else if (value.is_structured()) {
+        hashNode(h, value);
+      }
+    }
+    mix(h, "}");
+  } else if (node.is_array()) {
+    mix(h, "[");
+    for (auto const &item : node) {
+      if (item.is_structured()) {
+        hashNode(h, item);
+      }
+    }
+    mix(h, "]");
+  }
+}
+
+} // namespace
+
+bool PlanCoverage::record(std::uint64_t shape, FeatureSet used) {
+  std::unique_lock lock(mutex_);
+  bool const novel = seen_.insert(shape).second;
+  ++samples_;
+  auto bump = [novel](Score &s) {
+    s.samples = (s.samples * scoreDecay) + 1;
+    s.novel = (s.novel * scoreDecay) + (novel ? 1 : 0);
+  };
+  bump(total_);
+  for (std::size_t i = 0; i < featureCount; ++i) {
+    if (used.test(i)) {
+      bump(scores_[i]);
+    } else {
+      scores_[i].samples *= scoreDecay;
+      scores_[i].novel *= scoreDecay;
+    }
+  }
+  return novel;
+}
+
+FeatureBias PlanCoverage::bias() const {
+  FeatureBias out;
+  out.fill(1.0);
+  std::shared_lock lock(mutex_);
+  if (samples_ < minBiasSamples) {
+    return out;
+  }
+  // laplace-smoothed: a feature nobody sampled lately stays near 1.0
+  auto const base = (total_.novel + 1) / (total_.samples + 2);
+  for (std::size_t i = 0; i < featureCount; ++i) {
+    auto const rate = (scores_[i].novel + 1) / (scores_[i].samples + 2);
+    out[i] = std::clamp(rate / base, minFactor, maxFactor);
+  }
+  return out;
+}
+
+std::size_t PlanCoverage::distinctPlans() const {
+  std::shared_lock lock(mutex_);
+  return seen_.size();
+}
+
+std::size_t PlanCoverage::samples() const {
+  std::shared_lock lock(mutex_);
+  return samples_;
+}
+
+std::optional<std::uint64_t> planShapeHash(std::string_view explainJson) {
+  auto const doc = nlohmann::json::parse(explainJson, nullptr, false);
+  if (doc.is_discarded() || !doc.is_structured()) {
+    return std::nullopt;
+  }
+  std::uint64_t h = fnvOffset;
+  hashNode(h, doc);
+  return h;
+}
+
+} // namespace querygen
@@ -0,0 +1,97 @@
+#include "querygen/estimates.hpp"
+
+#include "sql_dialect/dialect.hpp"
+#include "sql_variant/generic.hpp"
+
+#include <charconv>
+#include <mutex>
+
+namespace querygen {
+
+std::optional<double> RowEstimates::rows(std::string_view table) const {
+  std::shared_lock lock(mutex_);
+  if (map_ == nullptr) {
+    return std::nullopt;
+  }
+  auto it = map_->find(table);
+  if (it == map_->end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+bool RowEstimates::loaded() const {
+  std::shared_lock lock(mutex_);
+  return map_ != nullptr;
+}
+
+void RowEstimates::replace(Map estimates, clock::time_point at) {
+  auto next = std::make_shared<Map const>(std::move(estimates));
+  std::unique_lock lock(mutex_);
+  map_ = std::move(next);
+  attemptedAt_ = at;
+}
+
+bool RowEstimates::stale(std::chrono::seconds interval) const {
+  std::shared_lock lock(mutex_);
+  return attemptedAt_ == clock::time_point{} ||
+         clock::now() - attemptedAt_ >= interval;
+}
+
+bool RowEstimates::tryBeginRefresh(std::chrono::seconds interval) {
+  if (!stale(interval)) {
+    return false;
+  }
+  // one refresher at a time; the rest keep using the old map
+  if (refreshing_.exchange(true, std::memory_order_acquire)) {
+    return false;
+  }
+  // another caller may have finished a refresh since the check above
+  if (!stale(interval)) {
+    endRefresh();
+    return false;
+  }
+  return true;
+}
+
+void RowEstimates::endRefresh() {
+  refreshing_.store(false, std::memory_order_release);
+}
+
+void RowEstimates::refresh(sql_variant::LoggedSQL &conn) {
+  auto const now = clock::now();
+  std::optional<Map> fresh;
+  try {
+    auto const &dialect = sql_dialect::dialect_for(conn.serverInfo());
+    auto res = conn.executeQuery(dialect.rowEstimatesQuery());
+    if (res.success() && res.data != nullptr) {
+      fresh.emplace();
+      auto const n = res.data->numRows();
+      for (std::size_t i = 0; i < n; ++i) {
+        auto const row = res.data->nextRow();
+        if (row.rowData.size() < 2 || !row.rowData[0] || !row.rowData[1]) {
+          continue;
+        }
+        auto const text = *row.rowData[1];
+        double value = 0;
+        auto [ptr, ec] =
+            std::from_chars(text.data(), text.data() + text.size(), value);
+        if (ec != std::errc{} || value < 0) {
+          continue; // never analyzed: no estimate beats a wrong one
+        }
+        fresh->emplace(std::string(*row.rowData[0]), value);
+      }
+    }
+  } catch (std::exception const &) {
+    fresh.reset();
+  }
+  {
+    std::unique_lock lock(mutex_);
+    attemptedAt_ = now;
+    if (fresh) {
+      map_ = std::make_shared<Map const>(*std::move(fresh));
+    }
+  }
+}
+
+} // namespace querygen
@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <array>
+#include <cmath>
 
 namespace querygen {
 
@@ -60,6 +61,10 @@ metadata::Column const *pkColumn(metadata::Table const &table) {
   return table.columns.empty() ? nullptr : table.columns.data();
 }
 
+// tables the server has no estimate for yet (just created, never
+// analyzed) are assumed small
+constexpr double unknownTableRows = 1000;
+
 Expr wrapNullifZero(Expr rhs) {
   FuncCall guard{.fn = Func::nullif, .args = {}};
   auto type = rhs.type;
@@ -73,14 +78,43 @@ Expr wrapNullifZero(Expr rhs) {
 
 Generator::Generator(metadata::Context const &ctx, ps_random &rand,
                      QueryGenConfig const &cfg,
-                     sql_variant::ServerInfo const &server)
-    : ctx_(ctx), rand_(rand), cfg_(cfg), server_(server),
-      tables_(ctx.get<metadata::Table>().snapshotAll()) {}
+                     sql_variant::ServerInfo const &server, Feedback feedback)
+    : ctx_(ctx), rand_(rand), cfg_(cfg), server_(server), feedback_(feedback),
+      tables_(ctx.get<metadata::Table>().snapshotAll()),
+      bounded_(cfg.max_estimated_rows > 0 &&
+               feedback.row_estimates != nullptr &&
+               feedback.row_estimates->loaded()) {
+  bias_.fill(1.0);
+  if (cfg.plan_sample_prob > 0 && feedback.plan_coverage != nullptr) {
+    bias_ = feedback.plan_coverage->bias();
+  }
+}
+
+double Generator::rowsOf(metadata::Table const &table) const {
+  if (auto it = cteRows_.find(table.name); it != cteRows_.end()) {
+    return it->second;
+  }
+  auto const rows = feedback_.row_estimates->rows(table.name);
+  return std::max(1.0, rows.value_or(unknownTableRows));
+}
 
 bool Generator::roll(std::size_t percent) {
   return rand_.random_number<std::size_t>(1, 100) <= percent;
 }
 
+bool Generator::rollFeature(Feature f, std::size_t percent) {
+  auto const i = static_cast<std::size_t>(f);
+  auto const biased = std::min<std::size_t>(
+      100, static_cast<std::size_t>(std::lround(
+               static_cast<double>(percent) * bias_[i])));
+  // same single draw as roll(): the bias never shifts the stream
+  if (!roll(biased)) {
+    return false;
+  }
+  used_.set(i);
+  return true;
+}
+
 std::string Generator::freshAlias() {
   return fmt::format("u{}", aliasCounter_++);
 }
@@ -355,7 +389,7 @@ Expr Generator::genBool(Scope const &scope, std::size_t depth,
     choices.push_back(Pick::likeFn);
   }
   if (!tables_.empty() && subqDepth < cfg_.max_subquery_depth &&
-      roll(cfg_.subquery_prob)) {
+      rollFeature(Feature::subquery, cfg_.subquery_prob)) {
     choices.insert(choices.end(), {Pick::subquery, Pick::subquery});
   }
   auto const pick =
@@ -382,7 +416,7 @@ Expr Generator::genBool(Scope const &scope, std::size_t depth,
     Expr rhs;
     bool haveRhs = false;
     if (!leafOnly && !tables_.empty() && subqDepth < cfg_.max_subquery_depth &&
-        roll(cfg_.subquery_prob)) {
+        rollFeature(Feature::subquery, cfg_.subquery_prob)) {
       // scalar subquery operand: one select item of the compared family,
       // LIMIT 1 caps it to a single row
       QuerySpec sub =
@@ -507,15 +541,20 @@ Expr Generator::genBool(Scope const &scope, std::size_t depth,
 
 QuerySpec Generator::genQuery(Purpose purpose, metadata::table_cptr target,
                               Scope const &outer, std::size_t subqDepth,
-                              bool allowExtras) {
+                              bool allowExtras, double *estimatedRows) {
   QuerySpec q;
+  auto const maxRows = static_cast<double>(cfg_.max_estimated_rows);
 
   // from/join candidates; a CTE adds a synthetic table visible only here
   auto cands = tables_;
-  if (allowExtras && roll(cfg_.cte_prob)) {
-    QuerySpec body =
-        genQuery(Purpose::standalone, nullptr, Scope{}, subqDepth + 1, false);
+  if (allowExtras && rollFeature(Feature::cte, cfg_.cte_prob)) {
+    double bodyRows = 0;
+    QuerySpec body = genQuery(Purpose::standalone, nullptr, Scope{},
+                              subqDepth + 1, false, &bodyRows);
     auto name = fmt::format("w{}", aliasCounter_++);
+    if (bounded_) {
+      cteRows_.emplace(name, std::max(1.0, bodyRows));
+    }
     metadata::Table synth;
     synth.name = name;
     for (auto const &item : body.selectItems) {
@@ -536,10 +575,12 @@ QuerySpec Generator::genQuery(Purpose purpose, metadata::table_cptr target,
   Scope scope;
   scope.push_back({.alias = freshAlias(), .table = seed});
   q.from = TableSource{.table = seed->name, .alias = scope[0].alias};
+  double rows = bounded_ ? rowsOf(*seed) : 0;
 
   // chained cross joins multiply row counts without bound; one is plenty
   bool haveCross = false;
-  while (q.joins.size() < cfg_.max_joins && roll(cfg_.join_prob)) {
+  while (q.joins.size() < cfg_.max_joins &&
+         rollFeature(Feature::join, cfg_.join_prob)) {
     auto const &base =
         scope[rand_.random_number<std::size_t>(0, scope.size() - 1)];
 
@@ -549,6 +590,7 @@ QuerySpec Generator::genQuery(Purpose purpose, metadata::table_cptr target,
       std::string baseCol;
       metadata::ColumnType newType;
       metadata::ColumnType baseType;
+      bool toParent; // every base row matches at most one new row
     };
     std::vector<Edge> edges;
     for (auto const &col : base.table->columns) {
@@ -563,7 +605,8 @@ QuerySpec Generator::genQuery(Purpose purpose, metadata::table_cptr target,
                              .newCol = pk->name,
                              .baseCol = col.name,
                              .newType = pk->type,
-                             .baseType = col.type});
+                             .baseType = col.type,
+                             .toParent = true});
           }
         }
       }
@@ -578,7 +621,8 @@ QuerySpec Generator::genQuery(Purpose purpose, metadata::table_cptr target,
                              .newCol = col.name,
                              .baseCol = pk->name,
                              .newType = col.type,
-                             .baseType = pk->type});
+                             .baseType = pk->type,
+                             .toParent = false});
           }
         }
       }
@@ -586,11 +630,13 @@ QuerySpec Generator::genQuery(Purpose purpose, metadata::table_cptr target,
 
     metadata::table_cptr joined;
     box<Expr> cond;
+    bool toParent = false;
     std::string alias = freshAlias();
     if (!edges.empty() && roll(70)) {
       auto const &e =
           edges[rand_.random_number<std::size_t>(0, edges.size() - 1)];
       joined = e.tbl;
+      toParent = e.toParent;
       cond = box<Expr>(Expr{
           .node =
               BinaryExpr{
@@ -645,6 +691,23 @@ QuerySpec Generator::genQuery(Purpose purpose, metadata::table_cptr target,
     if (!cond && haveCross) {
       break; // would be a second cross join; stop extending
     }
+    if (bounded_) {
+      // a child-to-parent FK join keeps the row count; other equi-joins fan
+      // out by the size ratio; a cross join multiplies. Scanning a big
+      // joined table costs even when few rows match
+      auto const joinedRows = rowsOf(*joined);
+      double next = rows * joinedRows;
+      if (cond) {
+        next = toParent
+                   ? rows
+                   : rows * std::max(1.0, joinedRows / rowsOf(*base.table));
+        next = std::max(next, joinedRows);
+      }
+      if (next > maxRows) {
+        break; // too expensive; keep the tree built so far
+      }
+      rows = next;
+    }
     JoinKind kind = JoinKind::cross;
     if (cond) {
       auto const r = rand_.random_number<std::size_t>(1, 100);
@@ -681,7 +744,8 @@ QuerySpec Generator::genQuery(Purpose purpose, metadata::table_cptr target,
     return scopeCols[rand_.random_number<std::size_t>(0, scopeCols.size() - 1)];
   };
 
-  bool const isAgg = purpose != Purpose::pkSelect && roll(cfg_.aggregate_prob);
+  bool const isAgg = purpose != Purpose::pkSelect &&
+                     rollFeature(Feature::aggregate, cfg_.aggregate_prob);
   if (purpose == Purpose::pkSelect) {
     // exactly the seed pk (columns[0], repo-wide single-pk assumption);
     // joins may duplicate pk values, DISTINCT keeps the id set clean
@@ -730,7 +794,7 @@ QuerySpec Generator::genQuery(Purpose purpose, metadata::table_cptr target,
            .colAlias = ""});
     }
   }
-  if (allowExtras && !isAgg && roll(cfg_.window_prob)) {
+  if (allowExtras && !isAgg && rollFeature(Feature::window, cfg_.window_prob)) {
     q.selectItems.push_back({.expr = genWindowCall(scope), .colAlias = ""});
   }
   for (std::size_t i = 0; i < q.selectItems.size(); ++i) {
@@ -739,14 +803,15 @@ QuerySpec Generator::genQuery(Purpose purpose, metadata::table_cptr target,
 
   if (roll(75)) {
     Scope whereScope = scope;
-    if (!outer.empty() && roll(cfg_.correlation_prob)) {
+    if (!outer.empty() &&
+        rollFeature(Feature::correlation, cfg_.correlation_prob)) {
       whereScope.insert(whereScope.end(), outer.begin(), outer.end());
     }
     q.where =
         box<Expr>(genBool(whereScope, cfg_.max_expr_depth, subqDepth, false));
   }
 
-  if (roll(cfg_.order_by_prob)) {
+  if (rollFeature(Feature::orderBy, cfg_.order_by_prob)) {
     std::vector<Expr const *> refs;
     for (auto const &item : q.selectItems) {
       if (std::holds_alternative<ColumnRef>(item.expr.node)) {
@@ -764,7 +829,8 @@ QuerySpec Generator::genQuery(Purpose purpose, metadata::table_cptr target,
     }
   }
 
-  if (purpose != Purpose::pkSelect && roll(cfg_.limit_prob)) {
+  if (purpose != Purpose::pkSelect &&
+      rollFeature(Feature::limit, cfg_.limit_prob)) {
     q.limit = rand_.random_number<std::size_t>(1, 1000);
     if (roll(25)) {
       q.offset = rand_.random_number<std::size_t>(0, 100);
@@ -774,9 +840,18 @@ QuerySpec Generator::genQuery(Purpose purpose, metadata::table_cptr target,
     q.distinct = true;
   }
 
-  if (allowExtras && roll(cfg_.setop_prob)) {
-    QuerySpec rhs =
-        genQuery(Purpose::standalone, nullptr, Scope{}, subqDepth + 1, false);
+  if (allowExtras && rollFeature(Feature::setop, cfg_.setop_prob)) {
+    double rhsRows = 0;
+    QuerySpec rhs = genQuery(Purpose::standalone, nullptr, Scope{},
+                             subqDepth + 1, false, &rhsRows);
+    if (bounded_ && rows + rhsRows > maxRows) {
+      // both operands get materialized for INTERSECT/EXCEPT/UNION
+      if (estimatedRows != nullptr) {
+        *estimatedRows = rows;
+      }
+      return q;
+    }
+    rows += rhsRows;
     // force rhs select list into lhs shape: same count, same family per
     // position; mismatches become literals (always valid, no scope needed).
     // rhs ORDER BY may reference replaced items - drop it
@@ -812,7 +887,7 @@ QuerySpec Generator::genQuery(Purpose purpose, metadata::table_cptr target,
 
     // outer ORDER BY on a set op must use output column names
     q.orderBy.clear();
-    if (roll(cfg_.order_by_prob)) {
+    if (rollFeature(Feature::orderBy, cfg_.order_by_prob)) {
       auto const idx =
           rand_.random_number<std::size_t>(0, q.selectItems.size() - 1);
       q.orderBy.push_back(
@@ -823,6 +898,9 @@ QuerySpec Generator::genQuery(Purpose purpose, metadata::table_cptr target,
     }
   }
 
+  if (estimatedRows != nullptr) {
+    *estimatedRows = rows;
+  }
   return q;
 }
 
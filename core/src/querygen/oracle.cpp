@@ -0,0 +1,225 @@
+#include "querygen/oracle.hpp"
+
+#include <algorithm>
+#include <variant>
+
+namespace querygen {
+
+namespace {
+
+constexpr std::uint64_t fnvOffset = 14695981039346656037ULL;
+constexpr std::uint64_t fnvPrime = 1099511628211ULL;
+
+void mixByte(std::uint64_t &h, unsigned char c) {
+  h ^= c;
+  h *= fnvPrime;
+}
+
+bool limited(QuerySpec const &q);
+
+// true when a query nested anywhere in the expression has LIMIT/OFFSET:
+// without a total ORDER BY those pick arbitrary rows, and two variants
+// may legitimately disagree
+struct LimitScan {
+  bool operator()(ColumnRef const & /*unused*/) const { return false; }
+  bool operator()(Literal const & /*unused*/) const { return false; }
+  bool operator()(UnaryExpr const &u) const { return any(u.arg); }
+  bool operator()(BinaryExpr const &b) const {
+    return any(b.lhs) || any(b.rhs);
+  }
+  bool operator()(BetweenExpr const &b) const {
+    return any(b.arg) || any(b.lo) || any(b.hi);
+  }
+  bool operator()(InListExpr const &in) const {
+    return any(in.arg) || std::ranges::any_of(in.items, [this](auto const &i) {
+             return any(i);
+           });
+  }
+  bool operator()(InSubquery const &in) const {
+    return any(in.arg) || limited(*in.sub);
+  }
+  bool operator()(ExistsSubquery const &ex) const { return limited(*ex.sub); }
+  bool operator()(ScalarSubquery const &s) const { return limited(*s.sub); }
+  bool operator()(FuncCall const &f) const {
+    return std::ranges::any_of(f.args,
+                               [this](auto const &a) { return any(a); });
+  }
+  bool operator()(CaseExpr const &c) const {
+    return any(c.elseExpr) ||
+           std::ranges::any_of(c.whens, [this](CaseWhen const &w) {
+             return any(w.when) || any(w.then);
+           });
+  }
+  bool operator()(AggCall const &a) const { return any(a.arg); }
+  bool operator()(WindowCall const &w) const { return any(w.arg); }
+
+  [[nodiscard]] bool any(box<Expr> const &e) const {
+    return e && std::visit(*this, e->node);
+  }
+  [[nodiscard]] bool any(Expr const &e) const {
+    return std::visit(*this, e.node);
+  }
+};
+
+bool nestedLimit(QuerySpec const &q) {
+  LimitScan const scan;
+  return std::ranges::any_of(q.ctes,
+                             [](Cte const &c) { return limited(*c.query); }) ||
+         std::ranges::any_of(
+             q.joins, [&](Join const &j) { return scan.any(j.condition); }) ||
+         std::ranges::any_of(
+             q.selectItems,
+             [&](SelectItem const &s) { return scan.any(s.expr); }) ||
+         scan.any(q.where) || scan.any(q.having) ||
+         (q.setOpRhs && limited(*q.setOpRhs));
+}
+
+bool limited(QuerySpec const &q) {
+  return q.limit.has_value() || q.offset.has_value() || nestedLimit(q);
+}
+
+// a plain filtered row source both oracles can reason about: one SELECT
+// block with a WHERE, no grouping, no aggregate or window items
+bool applicable(QuerySpec const &q) {
+  if (!q.where || q.setOpRhs || !q.groupBy.empty() || q.having) {
+    return false;
+  }
+  auto const computedOverRows = [](SelectItem const &s) {
+    return std::holds_alternative<AggCall>(s.expr.node) ||
+           std::holds_alternative<WindowCall>(s.expr.node);
+  };
+  return !std::ranges::any_of(q.selectItems, computedOverRows) &&
+         !nestedLimit(q);
+}
+
+// ordering, row caps and DISTINCT don't change which rows qualify
+QuerySpec unordered(QuerySpec q) {
+  q.orderBy.clear();
+  q.limit.reset();
+  q.offset.reset();
+  q.distinct = false;
+  q.lock = LockSpec{};
+  return q;
+}
+
+Expr countStar() {
+  return Expr{.node = AggCall{.fn = AggFunc::count, .arg = {}},
+              .type = metadata::ColumnType::INT};
+}
+
+Expr intLiteral(std::int64_t v) {
+  return Expr{.node = Literal{v}, .type = metadata::ColumnType::INT};
+}
+
+} // namespace
+
+void QueryResult::addRow(
+    std::span<std::optional<std::string_view> const> fields) {
+  std::uint64_t h = fnvOffset;
+  for (auto const &field : fields) {
+    if (field) {
+      for (auto const c : *field) {
+        mixByte(h, static_cast<unsigned char>(c));
+      }
+      mixByte(h, 0x00); // terminator: ("ab","c") != ("a","bc")
+    } else {
+      mixByte(h, 0xff); // NULL != ''
+    }
+  }
+  ++rows[h];
+  ++rowCount;
+}
+
+void QueryResult::merge(QueryResult const &other) {
+  for (auto const &[h, n] : other.rows) {
+    rows[h] += n;
+  }
+  rowCount += other.rowCount;
+}
+
+std::vector<QuerySpec> TlpOracle::variants(QuerySpec const &base) const {
+  if (!applicable(base)) {
+    return {};
+  }
+  QuerySpec all = unordered(base);
+  Expr const p = *all.where;
+  all.where = box<Expr>{};
+
+  auto partition = [&](Expr pred) {
+    QuerySpec q = all;
+    q.where = box<Expr>(std::move(pred));
+    return q;
+  };
+  std::vector<QuerySpec> out;
+  out.push_back(all);
+  out.push_back(partition(p));
+  out.push_back(partition(Expr{
+      .node = UnaryExpr{.op = UnOp::not_, .arg = box<Expr>(p)},
+      .type = metadata::ColumnType::BOOL}));
+  out.push_back(partition(Expr{
+      .node = UnaryExpr{.op = UnOp::isNull, .arg = box<Expr>(p)},
+      .type = metadata::ColumnType::BOOL}));
+  return out;
+}
+
+bool TlpOracle::verdict(std::vector<QueryResult> const &results) const {
+  if (results.size() != 4) {
+    return true; // nothing to judge
+  }
+  QueryResult parts;
+  for (std::size_t i = 1; i < results.size(); ++i) {
+    parts.merge(results[i]);
+  }
+  return parts == results[0];
+}
+
+std::vector<QuerySpec> NoRecOracle::variants(QuerySpec const &base) const {
+  if (!applicable(base)) {
+    return {};
+  }
+  QuerySpec filtered = unordered(base);
+  filtered.selectItems = {{.expr = countStar(), .colAlias = "c0"}};
+
+  // WITH <base ctes>, norec AS (SELECT CASE WHEN p THEN 1 ELSE 0 END ...)
+  // SELECT COUNT(*) FROM norec WHERE c0 = 1
+  QuerySpec flagged = unordered(base);
+  std::vector<Cte> ctes = std::move(flagged.ctes);
+  flagged.ctes.clear();
+  CaseExpr flag;
+  flag.whens.push_back(
+      {.when = box<Expr>(*flagged.where), .then = box<Expr>(intLiteral(1))});
+  flag.elseExpr = box<Expr>(intLiteral(0));
+  flagged.where = box<Expr>{};
+  flagged.selectItems = {
+      {.expr = Expr{.node = std::move(flag), .type = metadata::ColumnType::INT},
+       .colAlias = "c0"}};
+  ctes.push_back(
+      {.name = "norec", .query = box<QuerySpec>(std::move(flagged))});
+
+  QuerySpec counted;
+  counted.ctes = std::move(ctes);
+  counted.from = TableSource{.table = "norec", .alias = "nr"};
+  counted.selectItems = {{.expr = countStar(), .colAlias = "c0"}};
+  counted.where = box<Expr>(Expr{
+      .node = BinaryExpr{.op = BinOp::eq,
+                         .lhs = box<Expr>(Expr{
+                             .node = ColumnRef{.alias = "nr", .column = "c0"},
+                             .type = metadata::ColumnType::INT}),
+                         .rhs = box<Expr>(intLiteral(1))},
+      .type = metadata::ColumnType::BOOL});
+
+  std::vector<QuerySpec> out;
+  out.push_back(std::move(filtered));
+  out.push_back(std::move(counted));
+  return out;
+}
+
+bool NoRecOracle::verdict(std::vector<QueryResult> const &results) const {
+  if (results.size() != 2) {
+    return true;
+  }
+  // both sides are one COUNT(*) row: equal multisets = equal counts
+  return results[0] == results[1];
+}
+
+} // namespace querygen
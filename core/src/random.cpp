@@ -1,46 +1,202 @@
-
 #include "random.hpp"
 
-#include <algorithm>
-#include <functional>
-#include <random>
-#include <utility>
-#include <vector>
+#include <charconv>
+#include <cstring>
+#include <fmt/format.h>
+#include <sstream>
+#include <stdexcept>
 
 namespace {
-using char_array = std::vector<char>;
-
-char_array charset() {
-  return char_array({'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A',
-                     'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L',
-                     'M', 'N', 'O', 'P', 'Q', 'R', 'S', 'T', 'U', 'V', 'W',
-                     'X', 'Y', 'Z', 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h',
-                     'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's',
-                     't', 'u', 'v', 'w', 'x', 'y', 'z'});
-};
-
-inline std::string random_str(size_t length,
-                              std::function<char(void)> rand_char) {
-  std::string str(length, 0);
-  std::generate_n(str.begin(), length, std::move(rand_char));
-  return str;
+
+constexpr std::array<char, 62> charset{
+    '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C',
+    'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P',
+    'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z', 'a', 'b', 'c',
+    'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p',
+    'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z'};
+
+std::uint64_t splitmix64(std::uint64_t &x) {
+  auto z = (x += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+// one random byte -> [0-9A-Za-z], arithmetic instead of a charset lookup
+// so the block loop below vectorizes. (b * 62) >> 8 gives 8 of the 62
+// characters 5/256 instead of 4/256; fine for test data
+constexpr char alnum(std::uint8_t b) {
+  auto const k = static_cast<std::uint8_t>((b * 62U) >> 8U);
+  return static_cast<char>(k + '0' + (7 * static_cast<int>(k >= 10)) +
+                           (6 * static_cast<int>(k >= 36)));
+}
+
+// 32 characters from 4 draws, written through a fixed-size block the
+// compiler turns into vector code
+constexpr std::size_t blockChars = 32;
+
+template <typename Engine> void alnum_block(Engine &engine, char *out) {
+  std::array<std::uint64_t, blockChars / 8> words{};
+  for (auto &w : words) {
+    w = engine();
+  }
+  std::array<std::uint8_t, blockChars> bytes{};
+  if constexpr (std::endian::native == std::endian::little) {
+    std::memcpy(bytes.data(), words.data(), blockChars);
+  } else {
+    for (std::size_t i = 0; i < blockChars; ++i) {
+      bytes[i] = static_cast<std::uint8_t>(words[i / 8] >> ((i % 8) * 8));
+    }
+  }
+  for (std::size_t i = 0; i < blockChars; ++i) {
+    out[i] = alnum(bytes[i]);
+  }
 }
 
+constexpr std::string_view xoshiroTag = "xoshiro:";
+constexpr std::string_view mt19937Tag = "mt19937:";
+
 } // namespace
-  //
 
-ps_random::ps_random() : seed(std::random_device{}()), rng(seed) {}
+xoshiro256pp::xoshiro256pp(std::uint64_t seed) {
+  for (auto &word : s) {
+    word = splitmix64(seed);
+  }
+}
+
+void xoshiro256pp::jump() {
+  jumpWith({0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+            0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL});
+}
 
-ps_random::ps_random(std::uint64_t fixed_seed) : seed(fixed_seed), rng(seed) {}
+void xoshiro256pp::long_jump() {
+  jumpWith({0x76e15d3efefdcbbfULL, 0xc5004e441c522fb3ULL,
+            0x77710069854ee241ULL, 0x39109bb02acbe635ULL});
+}
+
+void xoshiro256pp::jumpWith(std::array<std::uint64_t, 4> const &poly) {
+  std::array<std::uint64_t, 4> acc{};
+  for (auto const word : poly) {
+    for (int b = 0; b < 64; ++b) {
+      if ((word & (std::uint64_t{1} << b)) != 0) {
+        for (std::size_t i = 0; i < acc.size(); ++i) {
+          acc[i] ^= s[i];
+        }
+      }
+      (*this)();
+    }
+  }
+  s = acc;
+}
+
+ps_random::ps_random() : ps_random(std::random_device{}()) {}
+
+ps_random::ps_random(std::uint64_t fixed_seed, RngStream stream)
+    : seed(fixed_seed), fast(fixed_seed) {
+  if (stream == RngStream::mt19937) {
+    legacy.emplace(seed);
+  }
+}
 
 std::string ps_random::random_string(std::size_t min_length,
                                      std::size_t max_length) {
-  const auto ch_set = charset();
+  auto const length = random_number(min_length, max_length);
 
-  std::uniform_int_distribution<> dist(0, static_cast<int>(ch_set.size() - 1));
-  auto randchar = [&]() { return ch_set[dist(rng)]; };
+  if (legacy) {
+    std::uniform_int_distribution<> dist(0,
+                                         static_cast<int>(charset.size() - 1));
+    std::string str(length, 0);
+    std::ranges::generate(str, [&]() { return charset[dist(*legacy)]; });
+    return str;
+  }
+
+  std::string str(length, 0);
+  std::size_t i = 0;
+  for (; i + blockChars <= length; i += blockChars) {
+    alnum_block(fast, str.data() + i);
+  }
+  // tail: one draw per 8 characters, unused bytes are dropped
+  for (; i < length; i += 8) {
+    auto const word = fast();
+    for (std::size_t j = 0; j < 8 && i + j < length; ++j) {
+      str[i + j] = alnum(static_cast<std::uint8_t>(word >> (j * 8)));
+    }
+  }
+  return str;
+}
 
-  auto length = random_number(min_length, max_length);
+void ps_random::fill_bytes(std::span<std::byte> out) {
+  std::size_t i = 0;
+  while (i < out.size()) {
+    auto const word = legacy ? (*legacy)() : fast();
+    // explicit little-endian: the same bytes on every host
+    for (std::size_t j = 0; j < 8 && i < out.size(); ++j, ++i) {
+      out[i] = static_cast<std::byte>(word >> (j * 8));
+    }
+  }
+}
+
+void ps_random::jump() {
+  if (legacy) {
+    throw std::logic_error("the mt19937 stream cannot jump");
+  }
+  fast.jump();
+}
+
+void ps_random::long_jump() {
+  if (legacy) {
+    throw std::logic_error("the mt19937 stream cannot jump");
+  }
+  fast.long_jump();
+}
+
+std::string ps_random::checkpoint() const {
+  if (legacy) {
+    // the standard fixes the engine's text representation
+    std::ostringstream out;
+    out << *legacy;
+    return fmt::format("{}{}", mt19937Tag, out.str());
+  }
+  auto const &s = fast.state();
+  return fmt::format("{}{:016x},{:016x},{:016x},{:016x}", xoshiroTag, s[0],
+                     s[1], s[2], s[3]);
+}
 
-  return random_str(length, randchar);
+void ps_random::restore(std::string_view checkpoint) {
+  if (checkpoint.starts_with(mt19937Tag)) {
+    std::mt19937_64 engine;
+    std::istringstream in{std::string(checkpoint.substr(mt19937Tag.size()))};
+    in >> engine;
+    if (in.fail()) {
+      throw std::invalid_argument("malformed mt19937 checkpoint");
+    }
+    legacy = engine;
+    return;
+  }
+  if (!checkpoint.starts_with(xoshiroTag)) {
+    throw std::invalid_argument(
+        fmt::format("unknown rng checkpoint: {}", checkpoint));
+  }
+  std::array<std::uint64_t, 4> state{};
+  auto const *p = checkpoint.data() + xoshiroTag.size();
+  auto const *end = checkpoint.data() + checkpoint.size();
+  for (std::size_t i = 0; i < state.size(); ++i) {
+    if (i > 0) {
+      if (p == end || *p != ',') {
+        throw std::invalid_argument("malformed xoshiro checkpoint");
+      }
+      ++p;
+    }
+    auto const [next, ec] = std::from_chars(p, end, state[i], 16);
+    if (ec != std::errc{}) {
+      throw std::invalid_argument("malformed xoshiro checkpoint");
+    }
+    p = next;
+  }
+  if (p != end || state == std::array<std::uint64_t, 4>{}) {
+    // all-zero is xoshiro's one invalid state: it only ever yields zeros
+    throw std::invalid_argument("malformed xoshiro checkpoint");
+  }
+  fast.setState(state);
+  legacy.reset();
 }
@@ -4,6 +4,7 @@
 #include <boost/algorithm/string/join.hpp>
 #include <fmt/format.h>
 #include <rfl.hpp>
+#include <stdexcept>
 
 using namespace metadata;
 
@@ -170,6 +171,25 @@ public:
                        columnName, tableName, limit, lockClauseSuffix(lock));
   }
 
+  // 8.0 has no RETURNING; a multi-row simple insert gets consecutive
+  // auto_increment values starting at mysql_insert_id
+  [[nodiscard]] std::string
+  insertReturning(std::string_view /*columnName*/) const override {
+    return "";
+  }
+
+  [[nodiscard]] std::string rowEstimatesQuery() const override {
+    // innodb TABLE_ROWS is a sampled estimate, cached per
+    // information_schema_stats_expiry
+    return "SELECT TABLE_NAME, TABLE_ROWS FROM information_schema.TABLES "
+           "WHERE TABLE_SCHEMA = DATABASE();";
+  }
+
+  [[nodiscard]] std::string
+  explainJson(std::string_view query) const override {
+    return fmt::format("EXPLAIN FORMAT=JSON {}", query);
+  }
+
   [[nodiscard]] bool partitionsInlineInCreate() const override { return true; }
 
   [[nodiscard]] bool supportsFkOnPartitionedTables() const override {
@@ -234,6 +254,16 @@ public:
     return out;
   }
 
+  // WITH CONSISTENT SNAPSHOT is per session; nothing can be handed over
+  [[nodiscard]] std::optional<std::string> exportSnapshot() const override {
+    return std::nullopt;
+  }
+
+  [[nodiscard]] std::string
+  importSnapshot(std::string_view /*snapshotId*/) const override {
+    throw std::logic_error("mysql cannot import snapshots");
+  }
+
   [[nodiscard]] std::string concatExpr(std::string_view lhs,
                                        std::string_view rhs) const override {
     return fmt::format("CONCAT({}, {})", lhs, rhs);
@@ -132,6 +132,23 @@ public:
                        columnName, tableName, limit, lockClauseSuffix(lock));
   }
 
+  [[nodiscard]] std::string
+  insertReturning(std::string_view columnName) const override {
+    return fmt::format(" RETURNING {}", columnName);
+  }
+
+  [[nodiscard]] std::string rowEstimatesQuery() const override {
+    // reltuples is -1 until the first VACUUM/ANALYZE on pg 14+
+    return "SELECT c.relname, c.reltuples FROM pg_class c "
+           "JOIN pg_namespace n ON n.oid = c.relnamespace "
+           "WHERE c.relkind IN ('r', 'p') AND n.nspname = current_schema();";
+  }
+
+  [[nodiscard]] std::string
+  explainJson(std::string_view query) const override {
+    return fmt::format("EXPLAIN (FORMAT JSON) {}", query);
+  }
+
   [[nodiscard]] bool partitionsInlineInCreate() const override { return false; }
 
   [[nodiscard]] bool supportsFkOnPartitionedTables() const override {
@@ -179,6 +196,15 @@ public:
     return {"BEGIN;"};
   }
 
+  [[nodiscard]] std::optional<std::string> exportSnapshot() const override {
+    return "SELECT pg_export_snapshot();";
+  }
+
+  [[nodiscard]] std::string
+  importSnapshot(std::string_view snapshotId) const override {
+    return fmt::format("SET TRANSACTION SNAPSHOT '{}';", snapshotId);
+  }
+
   [[nodiscard]] std::string concatExpr(std::string_view lhs,
                                        std::string_view rhs) const override {
     return fmt::format("({} || {})", lhs, rhs);
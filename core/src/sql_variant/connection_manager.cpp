@@ -0,0 +1,222 @@
+#include "sql_variant/connection_manager.hpp"
+
+#include <algorithm>
+#include <fmt/format.h>
+#include <random>
+
+namespace sql_variant {
+
+namespace {
+
+SqlException not_ready(std::string const &why) {
+  return {"server-not-ready", why, SqlStatus::serverGone,
+          ErrorClass::serverGone};
+}
+
+} // namespace
+
+ConnectionManager::ConnectionManager(std::size_t spares,
+                                     std::chrono::milliseconds patience,
+                                     ReconnectBackoff backoff)
+    : spares_(spares), patience_(patience), backoff_(backoff),
+      jitter_(std::random_device{}()) {}
+
+ConnectionManager::~ConnectionManager() {
+  {
+    std::unique_lock lock(mutex_);
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  if (filler_.joinable()) {
+    filler_.join();
+  }
+}
+
+void ConnectionManager::setConnector(connector_t connector) {
+  std::unique_lock lock(mutex_);
+  if (connector_) {
+    return;
+  }
+  connector_ = std::move(connector);
+  if (spares_ > 0) {
+    filler_ = std::thread([this] { fill(); });
+  }
+}
+
+std::unique_ptr<LoggedSQL>
+ConnectionManager::open(connector_t const &connector,
+                        std::string const &logName) {
+  try {
+    auto conn = connector();
+    if (conn != nullptr && !logName.empty()) {
+      conn->renameLog(logName);
+    }
+    // accepted is not ready: pg refuses work while it recovers
+    if (conn != nullptr && conn->executeQuery("SELECT 1").success()) {
+      conn->clearObservations();
+      return conn;
+    }
+  } catch (std::exception const &e) {
+    spdlog::debug("connection manager: cannot connect: {}", e.what());
+  }
+  return nullptr;
+}
+
+void ConnectionManager::failed() {
+  ++failedAttempts_;
+  if (!down_) {
+    down_ = true;
+    downSince_ = clock::now();
+    ++outages_;
+  }
+}
+
+void ConnectionManager::up() {
+  down_ = false;
+  upAgain_ = clock::now();
+  lastDowntime_ = upAgain_ - downSince_;
+  lastRestore_ = std::chrono::nanoseconds{0};
+  restoring_ = waiting_;
+  // opened before the outage, dead with it
+  idle_.clear();
+  cv_.notify_all();
+}
+
+void ConnectionManager::served() {
+  if (restoring_ > 0 && --restoring_ == 0) {
+    lastRestore_ = clock::now() - upAgain_;
+  }
+}
+
+std::chrono::milliseconds ConnectionManager::jittered(std::size_t round) {
+  auto delay = backoff_.initial;
+  for (std::size_t i = 0; i < round && delay < backoff_.max; ++i) {
+    delay *= 2;
+  }
+  delay = std::min(delay, backoff_.max);
+  auto const half = delay.count() / 2;
+  auto const spread = static_cast<std::uint64_t>(delay.count() - half) + 1;
+  return std::chrono::milliseconds(
+      half + static_cast<std::int64_t>(jitter_() % spread));
+}
+
+std::unique_ptr<LoggedSQL>
+ConnectionManager::connect(connector_t const &connector,
+                           std::string const &logName) {
+  auto const deadline = clock::now() + patience_;
+  std::unique_lock lock(mutex_);
+  for (;;) {
+    // spares first; one opened a while ago may have died since
+    while (!idle_.empty() && !down_) {
+      auto conn = std::move(idle_.back());
+      idle_.pop_back();
+      cv_.notify_all(); // the filler tops up
+      lock.unlock();
+      bool const alive = conn->executeQuery("SELECT 1").success();
+      conn->clearObservations();
+      if (alive) {
+        conn->renameLog(logName);
+      }
+      lock.lock();
+      if (alive) {
+        served();
+        return conn;
+      }
+      failed();
+    }
+
+    if (down_ && probing_) {
+      // someone else probes: wait for the outcome
+      ++waiting_;
+      bool const woke = cv_.wait_until(lock, deadline, [&] {
+        return !down_ || !probing_ || stopping_;
+      });
+      --waiting_;
+      if (!woke || stopping_) {
+        throw not_ready(fmt::format("server not back within {}ms",
+                                    patience_.count()));
+      }
+      continue;
+    }
+
+    // up as far as anyone knows: connect. Down: become the prober
+    bool const probe = down_;
+    probing_ = probing_ || probe;
+    for (std::size_t round = 0;; ++round) {
+      lock.unlock();
+      auto conn = open(connector);
+      lock.lock();
+      if (conn != nullptr) {
+        if (probe) {
+          probing_ = false;
+          up();
+        }
+        served();
+        return conn;
+      }
+      failed();
+      if (!probe) {
+        break; // down now: start over as prober or waiter
+      }
+      auto const now = clock::now();
+      if (now >= deadline || stopping_) {
+        // a waiter with time left takes over
+        probing_ = false;
+        cv_.notify_all();
+        throw not_ready(fmt::format("server not back within {}ms",
+                                    patience_.count()));
+      }
+      cv_.wait_until(lock, std::min(deadline, now + jittered(round)),
+                     [&] { return stopping_; });
+    }
+  }
+}
+
+void ConnectionManager::fill() {
+  std::unique_lock lock(mutex_);
+  for (;;) {
+    cv_.wait(lock, [&] {
+      return stopping_ || (!down_ && idle_.size() < spares_);
+    });
+    if (stopping_) {
+      return;
+    }
+    auto const logName = fmt::format("spare-{}", ++sparesOpened_);
+    lock.unlock();
+    auto conn = open(connector_, logName);
+    lock.lock();
+    if (conn != nullptr) {
+      idle_.push_back(std::move(conn));
+      cv_.notify_all();
+    } else {
+      failed(); // a worker's probe brings it back
+    }
+  }
+}
+
+std::size_t ConnectionManager::idle() const {
+  std::unique_lock lock(mutex_);
+  return idle_.size();
+}
+
+std::uint64_t ConnectionManager::outages() const {
+  std::unique_lock lock(mutex_);
+  return outages_;
+}
+
+std::uint64_t ConnectionManager::failedAttempts() const {
+  std::unique_lock lock(mutex_);
+  return failedAttempts_;
+}
+
+std::chrono::nanoseconds ConnectionManager::lastDowntime() const {
+  std::unique_lock lock(mutex_);
+  return lastDowntime_;
+}
+
+std::chrono::nanoseconds ConnectionManager::lastRestore() const {
+  std::unique_lock lock(mutex_);
+  return lastRestore_;
+}
+
+} // namespace sql_variant
@@ -0,0 +1,71 @@
+#include "sql_variant/connection_pool.hpp"
+
+#include <fmt/format.h>
+
+namespace sql_variant {
+
+void ConnectionPool::setConnector(connector_t connector) {
+  std::unique_lock lock(mutex_);
+  if (!connector_) {
+    connector_ = std::move(connector);
+  }
+}
+
+std::vector<std::unique_ptr<LoggedSQL>>
+ConnectionPool::acquire(std::size_t count) {
+  std::vector<std::unique_ptr<LoggedSQL>> out;
+  connector_t connector;
+  {
+    std::unique_lock lock(mutex_);
+    while (out.size() < count && !idle_.empty()) {
+      out.push_back(std::move(idle_.back()));
+      idle_.pop_back();
+    }
+    connector = connector_;
+  }
+  // an idle connection may have died since its release: probe, outside
+  // the lock, and open a fresh one in its place
+  std::erase_if(out, [](std::unique_ptr<LoggedSQL> const &conn) {
+    bool const alive = conn->executeQuery("SELECT 1").success();
+    conn->clearObservations();
+    return !alive;
+  });
+  // connecting takes a while; never under the lock
+  while (out.size() < count && connector) {
+    try {
+      auto conn = connector();
+      if (conn == nullptr) {
+        break;
+      }
+      std::size_t n = 0;
+      {
+        std::unique_lock lock(mutex_);
+        n = ++opened_;
+      }
+      conn->renameLog(fmt::format("pool-{}", n));
+      out.push_back(std::move(conn));
+    } catch (std::exception const &e) {
+      spdlog::warn("connection pool: cannot open connection: {}", e.what());
+      break;
+    }
+  }
+  return out;
+}
+
+void ConnectionPool::release(std::unique_ptr<LoggedSQL> conn) {
+  if (conn == nullptr) {
+    return;
+  }
+  // nobody drains a pooled connection's observations into statistics
+  conn->setCurrentAction("");
+  conn->clearObservations();
+  std::unique_lock lock(mutex_);
+  idle_.push_back(std::move(conn));
+}
+
+std::size_t ConnectionPool::idle() const {
+  std::unique_lock lock(mutex_);
+  return idle_.size();
+}
+
+} // namespace sql_variant
@@ -3,8 +3,12 @@
 
 #include <cctype>
 #include <fmt/format.h>
+#include <fmt/ranges.h>
+#include <string_view>
 
+#include "live_statistics.hpp"
 #include "logging.hpp"
+#include "sql_variant/watchdog.hpp"
 
 namespace {
 // binary values are logged as length only, never raw bytes
@@ -25,6 +29,37 @@ std::string describe_params(std::vector<sql_variant::Param> const &params) {
   }
   return out + "]";
 }
+
+// a stopped worker still sends these: they close what the cut action
+// opened (ROLLBACK, ROLLBACK TO SAVEPOINT)
+bool is_rollback(std::string_view query) {
+  constexpr std::string_view keyword = "rollback";
+  auto const start = query.find_first_not_of(" \t\r\n");
+  if (start == std::string_view::npos ||
+      query.size() - start < keyword.size()) {
+    return false;
+  }
+  for (std::size_t i = 0; i < keyword.size(); ++i) {
+    if (std::tolower(static_cast<unsigned char>(query[start + i])) !=
+        keyword[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// what a stopped worker gets instead of sending the statement
+sql_variant::QueryResult not_sent(std::string const &query) {
+  sql_variant::QueryResult result;
+  result.query = query;
+  result.executedAt = std::chrono::high_resolution_clock::now();
+  result.executionTime = std::chrono::nanoseconds{0};
+  result.errorInfo.errorCode = "worker-stopped";
+  result.errorInfo.errorMessage = "not sent, the worker was stopped";
+  result.errorInfo.errorStatus = sql_variant::SqlStatus::error;
+  result.errorInfo.errorClass = sql_variant::ErrorClass::other;
+  return result;
+}
 } // namespace
 
 namespace sql_variant {
@@ -33,8 +68,55 @@ QuerySpecificResult::~QuerySpecificResult() = default;
 
 GenericSQL::~GenericSQL() = default;
 
+StatementSink::~StatementSink() = default;
+
 ServerInfo GenericSQL::serverInfo() const { return serverInfo_; }
 
+void appendCopyField(std::string &line, std::size_t index,
+                     std::optional<std::string_view> value) {
+  if (index != 0) {
+    line += '\t';
+  }
+  if (!value) {
+    line += "\\N";
+    return;
+  }
+  for (char const c : *value) {
+    switch (c) {
+    case '\\':
+      line += "\\\\";
+      break;
+    case '\t':
+      line += "\\t";
+      break;
+    case '\n':
+      line += "\\n";
+      break;
+    case '\r':
+      line += "\\r";
+      break;
+    default:
+      line += c;
+    }
+  }
+}
+
+QueryResult GenericSQL::bulkLoad(std::string const &table,
+                                 std::vector<std::string> const & /*columns*/,
+                                 RowSource const & /*rows*/) const {
+  QueryResult result;
+  result.query = fmt::format("bulk load into {}", table);
+  result.executedAt = std::chrono::high_resolution_clock::now();
+  result.executionTime = std::chrono::nanoseconds{0};
+  result.errorInfo.errorCode = "bulk-unsupported";
+  result.errorInfo.errorMessage = "this connection can't bulk load";
+  result.errorInfo.errorStatus = SqlStatus::error;
+  result.errorInfo.errorClass = ErrorClass::other;
+  return result;
+}
+
+void GenericSQL::cancelQuery() const {}
+
 LoggedSQL::LoggedSQL(std::unique_ptr<GenericSQL> sql,
                      std::string const &logName)
     : sql(std::move(sql)), logger(logging::make_file_logger(
@@ -46,10 +128,23 @@ LoggedSQL::LoggedSQL(std::unique_ptr<GenericSQL> sql,
 ServerInfo LoggedSQL::serverInfo() const { return sql->serverInfo(); }
 
 QueryResult LoggedSQL::executeQuery(std::string const &query) const {
+  if (stopToken.stop_requested() && !is_rollback(query)) {
+    logger->info("Not sent, stopped: {}", query);
+    return not_sent(query);
+  }
   logger->info("Statement: {}", query);
+  if (sink) {
+    sink->statement(query, nullptr);
+  }
 
   ++queryCount;
-  auto res = sql->executeQuery(query);
+  auto const ticket = watch();
+  QueryResult res;
+  {
+    statistics::StatementInFlight const inFlight;
+    res = sql->executeQuery(query);
+  }
+  unwatch(ticket, res);
   accumulatedSqlTime += res.executionTime;
 
   if (!res.success()) {
@@ -64,10 +159,23 @@ QueryResult LoggedSQL::executeQuery(std::string const &query) const {
 
 QueryResult LoggedSQL::executeParams(std::string const &query,
                                      std::vector<Param> const &params) const {
+  if (stopToken.stop_requested()) {
+    logger->info("Not sent, stopped: {}", query);
+    return not_sent(query);
+  }
   logger->info("Statement: {} params: {}", query, describe_params(params));
+  if (sink) {
+    sink->statement(query, &params);
+  }
 
   ++queryCount;
-  auto res = sql->executeParams(query, params);
+  auto const ticket = watch();
+  QueryResult res;
+  {
+    statistics::StatementInFlight const inFlight;
+    res = sql->executeParams(query, params);
+  }
+  unwatch(ticket, res);
   accumulatedSqlTime += res.executionTime;
 
   if (!res.success()) {
@@ -80,6 +188,51 @@ QueryResult LoggedSQL::executeParams(std::string const &query,
   return res;
 }
 
+QueryResult LoggedSQL::bulkLoad(std::string const &table,
+                                std::vector<std::string> const &columns,
+                                RowSource const &rows) const {
+  if (stopToken.stop_requested()) {
+    logger->info("Not sent, stopped: bulk load into {}", table);
+    return not_sent(fmt::format("bulk load into {}", table));
+  }
+  logger->info("Bulk load: {} ({})", table, fmt::join(columns, ", "));
+
+  ++queryCount;
+  std::vector<std::string> sent;
+  auto const ticket = watch();
+  QueryResult res;
+  {
+    statistics::StatementInFlight const inFlight;
+    res = sink ? sql->bulkLoad(table, columns,
+                               [&rows, &sent](std::string &line) {
+                                 if (!rows(line)) {
+                                   return false;
+                                 }
+                                 sent.push_back(line);
+                                 return true;
+                               })
+               : sql->bulkLoad(table, columns, rows);
+  }
+  unwatch(ticket, res);
+  accumulatedSqlTime += res.executionTime;
+  if (sink) {
+    sink->bulkLoad(table, columns, sent);
+  }
+
+  if (!res.success()) {
+    logger->error("Error while bulk loading: {} {}", res.errorInfo.errorCode,
+                  res.errorInfo.errorMessage);
+  } else {
+    logger->info("Result: loaded={} time={:.2f}ms", res.affectedRows,
+                 static_cast<double>(res.executionTime.count()) / 1'000'000.0);
+    rowObservations.push_back({.action = currentAction_,
+                               .kind = statistics::RowKind::insert,
+                               .rows = res.affectedRows});
+  }
+
+  return res;
+}
+
 QueryResult LoggedSQL::safeQuery(std::string const &query,
                                  std::vector<Param> const &params) const {
   auto res =
@@ -114,6 +267,50 @@ LoggedSQL::querySingleValue(const std::string &sql) const {
 
 void LoggedSQL::reconnect() { sql->reconnect(); }
 
+void LoggedSQL::cancelQuery() const { sql->cancelQuery(); }
+
+void LoggedSQL::setStopToken(std::stop_token token) {
+  stopToken = std::move(token);
+}
+
+void LoggedSQL::setWatchdog(std::shared_ptr<StatementWatchdog> watchdog,
+                            std::chrono::milliseconds timeout) {
+  this->watchdog = std::move(watchdog);
+  statementTimeout = timeout;
+}
+
+std::optional<std::uint64_t> LoggedSQL::watch() const {
+  if (watchdog == nullptr) {
+    return std::nullopt;
+  }
+  // the tighter of the connection's timeout and the innermost cap
+  auto limit = statementTimeout;
+  if (cap.count() > 0 && (limit.count() == 0 || cap < limit)) {
+    limit = cap;
+  }
+  if (limit.count() == 0) {
+    return std::nullopt;
+  }
+  return watchdog->arm(*sql, StatementWatchdog::clock::now() + limit);
+}
+
+void LoggedSQL::unwatch(std::optional<std::uint64_t> ticket,
+                        QueryResult &res) const {
+  if (!ticket || !watchdog->disarm(*ticket)) {
+    return;
+  }
+  // a lost connection stays serverGone: the worker reconnects on that
+  if (res.errorInfo.errorStatus == SqlStatus::error) {
+    res.errorInfo.errorClass = ErrorClass::timeout;
+    logger->error("Statement ran past its deadline, cancelled");
+  }
+}
+
+void LoggedSQL::renameLog(std::string const &logName) {
+  logger = logging::make_file_logger(fmt::format("sql-conn-{}", logName),
+                                     fmt::format("sql-conn-{}.log", logName));
+}
+
 std::chrono::nanoseconds LoggedSQL::getAccumulatedSqlTime() const {
   return accumulatedSqlTime;
 }
@@ -124,21 +321,40 @@ void LoggedSQL::resetAccumulatedSqlTime() {
 
 std::uint64_t LoggedSQL::getQueryCount() const { return queryCount; }
 
-ActionNameScope::ActionNameScope(LoggedSQL &conn, std::string name)
-    : conn(conn), prev(conn.currentAction()) {
-  conn.setCurrentAction(std::move(name));
+ActionNameScope::ActionNameScope(LoggedSQL &conn, statistics::NameId name)
+    : conn(conn), prev(conn.currentAction_) {
+  conn.setCurrentAction(name);
 }
 
-ActionNameScope::~ActionNameScope() { conn.setCurrentAction(std::move(prev)); }
+ActionNameScope::~ActionNameScope() { conn.setCurrentAction(prev); }
 
-void LoggedSQL::setCurrentAction(std::string name) {
-  currentAction_ = std::move(name);
+void LoggedSQL::setCurrentAction(statistics::NameId name) {
+  currentAction_ = name;
+}
+
+void LoggedSQL::setCurrentAction(std::string_view name) {
+  currentAction_ = statistics::NameTable::intern(name);
+}
+
+std::string const &LoggedSQL::currentAction() const {
+  return statistics::NameTable::name(currentAction_);
+}
+
+StatementCap::StatementCap(LoggedSQL &conn, std::chrono::milliseconds limit)
+    : conn(conn), prev(conn.cap) {
+  if (conn.watched() && (prev.count() == 0 || limit < prev)) {
+    conn.cap = limit;
+  }
 }
 
-std::string const &LoggedSQL::currentAction() const { return currentAction_; }
+StatementCap::~StatementCap() { conn.cap = prev; }
 
-ActionNameScope LoggedSQL::scopedActionName(std::string name) {
-  return {*this, std::move(name)};
+ActionNameScope LoggedSQL::scopedActionName(statistics::NameId name) {
+  return {*this, name};
+}
+
+ActionNameScope LoggedSQL::scopedActionName(std::string_view name) {
+  return {*this, statistics::NameTable::intern(name)};
 }
 
 void LoggedSQL::recordTransactionOutcome(
@@ -146,13 +362,16 @@ void LoggedSQL::recordTransactionOutcome(
   txnOutcomes.push_back(outcome);
 }
 
-std::vector<statistics::RowObservation> LoggedSQL::drainRowObservations() {
-  return std::exchange(rowObservations, {});
+void LoggedSQL::drainRowObservations(
+    std::vector<statistics::RowObservation> &into) {
+  into.clear();
+  std::swap(into, rowObservations);
 }
 
-std::vector<statistics::TransactionOutcome>
-LoggedSQL::drainTransactionOutcomes() {
-  return std::exchange(txnOutcomes, {});
+void LoggedSQL::drainTransactionOutcomes(
+    std::vector<statistics::TransactionOutcome> &into) {
+  into.clear();
+  std::swap(into, txnOutcomes);
 }
 
 void LoggedSQL::clearObservations() {
@@ -160,6 +379,10 @@ void LoggedSQL::clearObservations() {
   txnOutcomes.clear();
 }
 
+void LoggedSQL::setStatementSink(std::shared_ptr<StatementSink> sink) {
+  this->sink = std::move(sink);
+}
+
 void LoggedSQL::observeResult(std::string const &query,
                               QueryResult const &res) const {
   const auto kind = classifyStatement(query);
@@ -181,29 +404,33 @@ void LoggedSQL::observeResult(std::string const &query,
   switch (kind) {
   case StmtKind::select:
     rowObservations.push_back({.action = currentAction_,
-                               .kind = "select",
+                               .kind = statistics::RowKind::select,
                                .rows = hasData ? res.data->numRows() : 0});
     break;
   case StmtKind::insert:
-    rowObservations.push_back(
-        {.action = currentAction_, .kind = "insert", .rows = res.affectedRows});
+    rowObservations.push_back({.action = currentAction_,
+                               .kind = statistics::RowKind::insert,
+                               .rows = res.affectedRows});
     break;
   case StmtKind::update:
-    rowObservations.push_back(
-        {.action = currentAction_, .kind = "update", .rows = res.affectedRows});
+    rowObservations.push_back({.action = currentAction_,
+                               .kind = statistics::RowKind::update,
+                               .rows = res.affectedRows});
     break;
   case StmtKind::del:
-    rowObservations.push_back(
-        {.action = currentAction_, .kind = "delete", .rows = res.affectedRows});
+    rowObservations.push_back({.action = currentAction_,
+                               .kind = statistics::RowKind::del,
+                               .rows = res.affectedRows});
     break;
   case StmtKind::with:
     if (hasData) {
       rowObservations.push_back({.action = currentAction_,
-                                 .kind = "select",
+                                 .kind = statistics::RowKind::select,
                                  .rows = res.data->numRows()});
     } else {
-      rowObservations.push_back(
-          {.action = currentAction_, .kind = "dml", .rows = res.affectedRows});
+      rowObservations.push_back({.action = currentAction_,
+                                 .kind = statistics::RowKind::dml,
+                                 .rows = res.affectedRows});
     }
     break;
   case StmtKind::other:
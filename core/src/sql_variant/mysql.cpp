@@ -1,13 +1,21 @@
 
 #include "sql_variant/mysql.hpp"
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fmt/format.h>
+#include <fmt/ranges.h>
 #include <limits>
+#include <map>
 #include <mutex>
 #include <mysql.h>
 #include <optional>
 #include <sstream>
 #include <stdexcept>
 #include <string_view>
+#include <tuple>
 
 // #include "common.hpp"
 #ifndef MAX_PACKET_DEFAULT
@@ -130,6 +138,120 @@ std::optional<std::string> escape_param(MYSQL *conn,
   buf.resize(len);
   return "'" + buf + "'";
 }
+
+// LOAD DATA LOCAL reader state: the client library pulls file bytes
+// through these callbacks, and they come from the RowSource instead
+struct InfileStream {
+  sql_variant::RowSource const &rows;
+  std::string buffer;
+  std::size_t offset = 0;
+  std::uint64_t loaded = 0;
+  bool done = false;
+  // a throwing RowSource can't unwind through libmysqlclient
+  std::exception_ptr error;
+};
+
+int infile_init(void **ptr, const char * /*filename*/, void *userdata) {
+  *ptr = userdata;
+  return 0;
+}
+
+int infile_read(void *ptr, char *buf, unsigned int len) {
+  auto &stream = *static_cast<InfileStream *>(ptr);
+  unsigned int written = 0;
+  try {
+    while (written < len) {
+      if (stream.offset == stream.buffer.size()) {
+        if (stream.done) {
+          break;
+        }
+        stream.buffer.clear();
+        stream.offset = 0;
+        if (!stream.rows(stream.buffer)) {
+          stream.done = true;
+          break;
+        }
+        stream.buffer += '\n';
+        ++stream.loaded;
+      }
+      auto const n = std::min<std::size_t>(
+          len - written, stream.buffer.size() - stream.offset);
+      std::memcpy(buf + written, stream.buffer.data() + stream.offset, n);
+      stream.offset += n;
+      written += static_cast<unsigned int>(n);
+    }
+  } catch (...) {
+    stream.error = std::current_exception();
+    return -1;
+  }
+  return static_cast<int>(written);
+}
+
+void infile_end(void * /*ptr*/) {}
+
+int infile_error(void * /*ptr*/, char *msg, unsigned int len) {
+  std::snprintf(msg, len, "bulk load row source failed");
+  return CR_UNKNOWN_ERROR;
+}
+
+// installed whenever bulkLoad() isn't running: a LOAD DATA LOCAL sent any
+// other way (custom SQL, a grammar rule) fails instead of letting the
+// server name a file on this host for the default handler to read
+int refuse_init(void **ptr, const char * /*filename*/, void * /*userdata*/) {
+  *ptr = nullptr;
+  return 1;
+}
+
+int refuse_read(void * /*ptr*/, char * /*buf*/, unsigned int /*len*/) {
+  return -1;
+}
+
+int refuse_error(void * /*ptr*/, char *msg, unsigned int len) {
+  std::snprintf(msg, len, "LOCAL INFILE is only served by bulkLoad");
+  return CR_UNKNOWN_ERROR;
+}
+
+void refuse_local_infile(MYSQL *conn) {
+  mysql_set_local_infile_handler(conn, refuse_init, refuse_read, infile_end,
+                                 refuse_error, nullptr);
+}
+
+MYSQL *init_handle() {
+  // mysql_init is not thread safe, hold a mutex
+  static std::mutex mysql_init_mutex;
+  std::lock_guard<std::mutex> guard(mysql_init_mutex);
+  return mysql_init(nullptr);
+}
+
+/* Whether an endpoint runs PXC costs a SHOW VARIABLES round trip, on
+   every connect of a reconnect storm too. The answer only changes with
+   the server binary, which the handshake's version string tells apart:
+   endpoint + version string -> flavor. */
+class FlavorCache {
+public:
+  std::optional<sql_variant::flavor> find(std::string const &key) {
+    std::lock_guard<std::mutex> guard(mutex);
+    auto const it = flavors.find(key);
+    if (it == flavors.end()) {
+      return std::nullopt;
+    }
+    return it->second;
+  }
+
+  void store(std::string key, sql_variant::flavor flav) {
+    std::lock_guard<std::mutex> guard(mutex);
+    flavors.insert_or_assign(std::move(key), flav);
+  }
+
+private:
+  std::mutex mutex;
+  std::map<std::string, sql_variant::flavor> flavors;
+};
+
+FlavorCache &flavor_cache() {
+  static FlavorCache cache;
+  return cache;
+}
 } // namespace
 
 namespace sql_variant {
@@ -139,16 +261,8 @@ ErrorClass classify_mysql_errno(unsigned int errcode) {
                                               : ErrorClass::other;
 }
 
-MySQL::MySQL(ServerParams const &params) {
-  {
-    // mysql_connect is not thread safe, hold a mutex
-
-    static std::mutex mysql_init_mutex;
-    std::lock_guard<std::mutex> guard(mysql_init_mutex);
-
-    connection = mysql_init(nullptr);
-  }
-
+MySQL::MySQL(ServerParams const &params)
+    : params(params), connection(init_handle()) {
   if (connection == nullptr) {
     throw SqlException("mysql-init-failed", "mysql_init failed");
   }
@@ -156,10 +270,18 @@ MySQL::MySQL(ServerParams const &params) {
   if (params.maxpacket != MAX_PACKET_DEFAULT) {
     mysql_options(connection, MYSQL_OPT_MAX_ALLOWED_PACKET, &params.maxpacket);
   }
+  // bulkLoad() serves LOCAL INFILE from its own handler, never from disk,
+  // and every other request is refused; the server still needs
+  // local_infile=ON
+  unsigned int const localInfile = 1;
+  mysql_options(connection, MYSQL_OPT_LOCAL_INFILE, &localInfile);
   if (mysql_real_connect(connection, params.address.c_str(),
                          params.username.c_str(), params.password.c_str(),
                          params.database.c_str(), params.port,
-                         params.socket.c_str(), 0) == NULL) {
+                         params.socket.c_str(),
+                         // affected rows = rows matched, as on pg: an UPDATE
+                         // that leaves a row as it was still found it
+                         CLIENT_FOUND_ROWS) == NULL) {
 
     std::stringstream ss;
     logError(ss);
@@ -169,9 +291,13 @@ MySQL::MySQL(ServerParams const &params) {
     throw SqlException("mysql-connection-failed", ss.str());
   }
 
+  threadId = mysql_thread_id(connection);
+  refuse_local_infile(connection);
+
   // anything past this point must not leak the live handle on throw
   try {
     serverInfo_ = calculateServerInfo();
+    insertIdStep = readInsertIdStep();
   } catch (...) {
     mysql_close(connection);
     mysql_thread_end();
@@ -190,6 +316,27 @@ MySQL::~MySQL() {
   }
 }
 
+// the blocked handle can't send anything while its statement runs; the
+// statement then fails with 1317 (query execution was interrupted)
+void MySQL::cancelQuery() const {
+  auto *killer = init_handle();
+  if (killer == nullptr) {
+    return;
+  }
+  // stop() waits on this: don't hang on a server that is gone
+  unsigned int const timeout = 5;
+  mysql_options(killer, MYSQL_OPT_CONNECT_TIMEOUT, &timeout);
+  if (mysql_real_connect(killer, params.address.c_str(),
+                         params.username.c_str(), params.password.c_str(),
+                         params.database.c_str(), params.port,
+                         params.socket.c_str(), 0) != nullptr) {
+    auto const kill = fmt::format("KILL QUERY {}", threadId);
+    std::ignore = mysql_real_query(killer, kill.c_str(), kill.size());
+  }
+  mysql_close(killer);
+  mysql_thread_end();
+}
+
 void MySQL::logError(std::ostream &ostream) const {
   ostream << mysql_errno(connection) << ": " << mysql_error(connection);
 }
@@ -232,6 +379,8 @@ QueryResult MySQL::executeQuery(std::string const &query) const {
       result.errorInfo.errorStatus = SqlStatus::success;
       result.data = std::make_unique<MySQLSpecificResult>(res);
       result.affectedRows = mysql_affected_rows(connection);
+      result.insertId = mysql_insert_id(connection);
+      result.insertIdStep = insertIdStep;
     }
   }
 
@@ -299,8 +448,41 @@ QueryResult MySQL::executeParams(std::string const &query,
   return executeQuery(expanded);
 }
 
+// the default FIELDS/LINES options of LOAD DATA are the COPY text format
+// RowSource produces; the file name is only a label for the handler.
+// LOCAL implies IGNORE: duplicate keys, FK failures and bad values turn
+// into warnings and skipped or adjusted rows, not an error
+QueryResult MySQL::bulkLoad(std::string const &table,
+                            std::vector<std::string> const &columns,
+                            RowSource const &rows) const {
+  InfileStream stream{.rows = rows};
+  mysql_set_local_infile_handler(connection, infile_init, infile_read,
+                                 infile_end, infile_error, &stream);
+  auto result = executeQuery(fmt::format(
+      "LOAD DATA LOCAL INFILE 'stormweaver-stream' INTO TABLE {} ({})", table,
+      fmt::join(columns, ", ")));
+  refuse_local_infile(connection);
+  if (stream.error) {
+    std::rethrow_exception(stream.error);
+  }
+  return result;
+}
+
 std::string MySQL::serverInfoString() const { return "TODO"; }
 
+std::uint64_t MySQL::readInsertIdStep() const {
+  auto const res = executeQuery("SELECT @@auto_increment_increment");
+  if (!res.success() || res.data == nullptr || res.data->numRows() != 1) {
+    return 1;
+  }
+  auto const row = res.data->nextRow();
+  if (row.rowData.empty() || !row.rowData[0]) {
+    return 1;
+  }
+  return std::max<std::uint64_t>(
+      1, parseVersionComponent(std::string(*row.rowData[0])));
+}
+
 ServerInfo MySQL::calculateServerInfo() const {
   std::string versionInfo = mysql_get_server_info(connection);
   unsigned long major = 0;
@@ -325,6 +507,12 @@ ServerInfo MySQL::calculateServerInfo() const {
   }
   auto server_version = (major * 10000) + (minor * 100) + version;
 
+  auto const key = fmt::format("{}:{}:{}|{}", params.address, params.port,
+                               params.socket, versionInfo);
+  if (auto const known = flavor_cache().find(key)) {
+    return {*known, server_version};
+  }
+
   flavor flav = flavor::mysql;
 
   const auto res = executeQuery("SHOW VARIABLES LIKE '%wsrep%';");
@@ -334,6 +522,10 @@ ServerInfo MySQL::calculateServerInfo() const {
   } else if (versionInfo.find("-") != std::string::npos) {
     flav = flavor::ps; // PS is like X.Y.Z-U, upstream is just X.Y.Z
   }
+  // a failed probe says nothing: ask again next time
+  if (res.success()) {
+    flavor_cache().store(key, flav);
+  }
 
   return {flav, server_version};
 }
@@ -1,10 +1,13 @@
 
 #include "sql_variant/postgresql.hpp"
 
+#include <fmt/format.h>
+#include <fmt/ranges.h>
 #include <mutex>
 #include <pqxx/pqxx>
 #include <sstream>
 #include <stdexcept>
+#include <type_traits>
 
 #include <iostream>
 #include <utility>
@@ -107,8 +110,13 @@ sql_variant::QueryResult run_pg_query(std::string const &query, Fn &&fn) {
     result.executionTime = end - result.executedAt;
     result.errorInfo.errorStatus = sql_variant::SqlStatus::success;
 
-    result.affectedRows = qres.affected_rows();
-    result.data = std::make_unique<PostgreSQLSpecificResult>(qres);
+    if constexpr (std::is_same_v<decltype(qres), std::uint64_t const>) {
+      // COPY: a row count, no result set
+      result.affectedRows = qres;
+    } else {
+      result.affectedRows = qres.affected_rows();
+      result.data = std::make_unique<PostgreSQLSpecificResult>(qres);
+    }
 
   } catch (pqxx::sql_error const &e) {
     const auto end = std::chrono::high_resolution_clock::now();
@@ -191,6 +199,29 @@ QueryResult PostgreSQL::executeParams(std::string const &query,
   });
 }
 
+// text format only: pqxx::stream_to has no raw binary COPY, and the
+// text form is what the RowSource already produces
+QueryResult PostgreSQL::bulkLoad(std::string const &table,
+                                 std::vector<std::string> const &columns,
+                                 RowSource const &rows) const {
+  auto const statement =
+      fmt::format("COPY {} ({}) FROM STDIN", table, fmt::join(columns, ", "));
+  return run_pg_query(statement, [&] {
+    pqxx::nontransaction work(*connection);
+    auto stream = pqxx::stream_to::raw_table(
+        work, table, fmt::format("{}", fmt::join(columns, ",")));
+    std::uint64_t loaded = 0;
+    std::string line;
+    while (rows(line)) {
+      stream.write_raw_line(line);
+      line.clear();
+      ++loaded;
+    }
+    stream.complete();
+    return loaded;
+  });
+}
+
 std::string PostgreSQL::serverInfoString() const {
   return ""; // TODO
 }
@@ -213,4 +244,13 @@ void PostgreSQL::reconnect() {
       std::make_unique<pqxx::connection>(build_connection_string(params));
 }
 
+// the statement then fails with 57014 (query_canceled)
+void PostgreSQL::cancelQuery() const {
+  try {
+    connection->cancel_query();
+  } catch (std::exception const &) {
+    // best effort: nothing in flight, or the server is gone anyway
+  }
+}
+
 } // namespace sql_variant
@@ -0,0 +1,241 @@
+#include "sql_variant/sim.hpp"
+
+#include <cmath>
+#include <fmt/format.h>
+#include <numbers>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+struct SimSpecificResult : sql_variant::QuerySpecificResult {
+  std::size_t fields;
+  std::vector<std::string> values; // row-major, fields per row
+  mutable std::size_t rowIdx{0};
+
+  SimSpecificResult(std::size_t fields, std::vector<std::string> values)
+      : fields(fields), values(std::move(values)) {}
+
+  std::size_t numFields() const override { return fields; }
+
+  std::size_t numRows() const override {
+    return fields == 0 ? 0 : values.size() / fields;
+  }
+
+  sql_variant::RowView nextRow() const override { return rowAt(rowIdx++); }
+
+  sql_variant::RowView rowAt(std::size_t index) const override {
+    if (index >= numRows()) {
+      throw std::out_of_range("row index out of range");
+    }
+    sql_variant::RowView row;
+    row.rowData.reserve(fields);
+    for (std::size_t i = 0; i < fields; ++i) {
+      row.rowData.emplace_back(values[(index * fields) + i]);
+    }
+    return row;
+  }
+};
+
+// FNV-1a over the ordinal's eight bytes, low byte first, from the same
+// basis as derive_seed in workload.cpp: stable across toolchains
+std::uint64_t mix_seed(std::uint64_t seed, std::uint64_t ordinal) {
+  std::uint64_t h = 1469598103934665603ULL ^ seed;
+  for (int i = 0; i < 8; ++i) {
+    h ^= (ordinal >> (i * 8)) & 0xff;
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+} // namespace
+
+namespace sql_variant {
+
+SimServer::SimServer(SimParams params) : params_(std::move(params)) {}
+
+std::uint64_t SimServer::nextConnectionSeed() {
+  return mix_seed(params_.seed,
+                  connections_.fetch_add(1, std::memory_order_relaxed));
+}
+
+std::uint64_t SimServer::connect() {
+  std::unique_lock lock(mutex_);
+  if (refuseConnects_ > 0) {
+    --refuseConnects_;
+    throw SqlException("sim-connection-refused",
+                       "simulated server refused the connection",
+                       SqlStatus::serverGone, ErrorClass::serverGone);
+  }
+  return incarnation_;
+}
+
+void SimServer::crash() {
+  std::unique_lock lock(mutex_);
+  ++incarnation_;
+  refuseConnects_ = params_.down_connects;
+}
+
+bool SimServer::alive(std::uint64_t incarnation) const {
+  std::unique_lock lock(mutex_);
+  return incarnation == incarnation_;
+}
+
+std::uint64_t SimServer::allocateIds(std::uint64_t count) {
+  return nextInsertId_.fetch_add(count, std::memory_order_relaxed);
+}
+
+Simulated::Simulated(std::shared_ptr<SimServer> server)
+    : server(std::move(server)), incarnation(this->server->connect()),
+      rng(this->server->nextConnectionSeed(), RngStream::xoshiro) {
+  serverInfo_ = {.flavor_ = this->server->params().flavor_,
+                 .version = this->server->params().version};
+}
+
+void Simulated::logError(std::ostream & /*ostream*/) const {}
+
+QueryResult Simulated::executeQuery(std::string const &query) const {
+  auto const &params = server->params();
+  QueryResult result;
+  result.query = query;
+  result.executedAt = std::chrono::high_resolution_clock::now();
+  result.executionTime = std::chrono::nanoseconds{0};
+
+  // every draw happens for every statement, so injected failures don't
+  // shift the stream of the statements after them
+  auto const goneRoll = rng.random_number(0.0, 1.0);
+  auto const conflictRoll = rng.random_number(0.0, 1.0);
+  auto const errorRoll = rng.random_number(0.0, 1.0);
+  std::chrono::nanoseconds latency{0};
+  if (params.latency_median.count() > 0) {
+    // lognormal: exp of a Box-Muller normal; 1 - u keeps log() off 0
+    auto const u1 = 1.0 - rng.random_number(0.0, 1.0);
+    auto const u2 = rng.random_number(0.0, 1.0);
+    auto const normal =
+        std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * std::numbers::pi * u2);
+    latency = std::chrono::nanoseconds(
+        static_cast<std::chrono::nanoseconds::rep>(
+            static_cast<double>(params.latency_median.count()) *
+            std::exp(params.latency_sigma * normal)));
+  }
+
+  bool const mysql = serverInfo_.is_mysql_like();
+  auto fail = [&](std::string code, std::string message, SqlStatus status,
+                  ErrorClass errorClass) {
+    result.errorInfo.errorCode = std::move(code);
+    result.errorInfo.errorMessage = std::move(message);
+    result.errorInfo.errorStatus = status;
+    result.errorInfo.errorClass = errorClass;
+  };
+
+  if (!server->alive(incarnation)) {
+    fail(mysql ? "2013" : "0", "simulated server gone", SqlStatus::serverGone,
+         ErrorClass::serverGone);
+    return result;
+  }
+  if (goneRoll < params.server_gone_rate) {
+    server->crash();
+    fail(mysql ? "2013" : "0", "simulated server crash", SqlStatus::serverGone,
+         ErrorClass::serverGone);
+    return result;
+  }
+
+  if (params.sleep && latency.count() > 0) {
+    std::unique_lock lock(cancelMutex);
+    sleeping = true;
+    cancelCv.wait_for(lock, latency, [this] { return cancelled; });
+    sleeping = false;
+    if (std::exchange(cancelled, false)) {
+      result.executionTime =
+          std::chrono::high_resolution_clock::now() - result.executedAt;
+      fail(mysql ? "1317" : "57014", "simulated query cancel",
+           SqlStatus::error, ErrorClass::other);
+      return result;
+    }
+  }
+  result.executionTime = latency;
+
+  if (conflictRoll < params.conflict_rate) {
+    fail(mysql ? "1213" : "40001", "simulated serialization failure",
+         SqlStatus::error,
+         mysql ? classify_mysql_errno(1213) : classify_pg_sqlstate("40001"));
+    return result;
+  }
+  if (errorRoll < params.error_rate) {
+    fail(mysql ? "1105" : "XX000", "simulated error", SqlStatus::error,
+         ErrorClass::other);
+    return result;
+  }
+
+  result.errorInfo.errorStatus = SqlStatus::success;
+  // mirror the real drivers: data is always attached, row-shaped only for
+  // select-like statements
+  auto const kind = classifyStatement(query);
+  if (kind == StmtKind::select || kind == StmtKind::with) {
+    std::vector<std::string> values;
+    values.reserve(params.select_rows * params.select_fields);
+    for (std::size_t i = 0; i < params.select_rows * params.select_fields;
+         ++i) {
+      values.push_back(
+          fmt::format("{}", rng.random_number<std::uint64_t>(0, 999999)));
+    }
+    result.data = std::make_unique<SimSpecificResult>(params.select_fields,
+                                                      std::move(values));
+  } else {
+    result.data =
+        std::make_unique<SimSpecificResult>(0, std::vector<std::string>{});
+    if (kind != StmtKind::other) {
+      result.affectedRows = params.affected_rows;
+    }
+    // pg flavor would need RETURNING rows; mysql reports the range start
+    if (kind == StmtKind::insert && mysql && params.affected_rows > 0) {
+      result.insertId = server->allocateIds(params.affected_rows);
+    }
+  }
+  return result;
+}
+
+// no placeholders to bind: the statement text is all the simulation sees
+QueryResult
+Simulated::executeParams(std::string const &query,
+                         std::vector<Param> const & /*params*/) const {
+  return executeQuery(query);
+}
+
+// one statement's worth of failure injection and latency, then every row
+// is pulled and counted
+QueryResult Simulated::bulkLoad(std::string const &table,
+                                std::vector<std::string> const & /*columns*/,
+                                RowSource const &rows) const {
+  auto result = executeQuery(fmt::format("COPY {} FROM STDIN", table));
+  if (!result.success()) {
+    return result;
+  }
+  std::uint64_t loaded = 0;
+  std::string line;
+  while (rows(line)) {
+    line.clear();
+    ++loaded;
+  }
+  result.affectedRows = loaded;
+  if (serverInfo_.is_mysql_like() && loaded > 0) {
+    result.insertId = server->allocateIds(loaded);
+  }
+  return result;
+}
+
+std::string Simulated::serverInfoString() const { return "simulated"; }
+
+std::string Simulated::hostInfo() const { return "simulated"; }
+
+void Simulated::reconnect() { incarnation = server->connect(); }
+
+void Simulated::cancelQuery() const {
+  std::unique_lock lock(cancelMutex);
+  if (sleeping) {
+    cancelled = true;
+    cancelCv.notify_all();
+  }
+}
+
+} // namespace sql_variant
@@ -0,0 +1,92 @@
+#include "sql_variant/watchdog.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include "sql_variant/generic.hpp"
+
+namespace sql_variant {
+
+StatementWatchdog::StatementWatchdog() : thread_([this] { run(); }) {}
+
+StatementWatchdog::~StatementWatchdog() {
+  {
+    std::unique_lock lock(mutex_);
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  thread_.join();
+}
+
+std::uint64_t StatementWatchdog::arm(GenericSQL const &conn,
+                                     clock::time_point deadline) {
+  std::unique_lock lock(mutex_);
+  auto const ticket = nextTicket_++;
+  watches_.emplace(ticket, Watch{.conn = &conn, .deadline = deadline});
+  // may be earlier than what the thread sleeps towards
+  cv_.notify_all();
+  return ticket;
+}
+
+bool StatementWatchdog::disarm(std::uint64_t ticket) {
+  std::unique_lock lock(mutex_);
+  auto const it = watches_.find(ticket);
+  if (it == watches_.end()) {
+    return false;
+  }
+  cv_.wait(lock, [&] { return !it->second.cancelling; });
+  bool const fired = it->second.fired;
+  watches_.erase(it);
+  return fired;
+}
+
+std::uint64_t StatementWatchdog::cancels() const {
+  std::unique_lock lock(mutex_);
+  return cancels_;
+}
+
+void StatementWatchdog::run() {
+  std::unique_lock lock(mutex_);
+  while (!stopping_) {
+    auto const now = clock::now();
+    auto next = clock::time_point::max();
+    std::vector<std::uint64_t> due;
+    std::vector<GenericSQL const *> conns;
+    for (auto &[ticket, watch] : watches_) {
+      if (watch.fired) {
+        continue;
+      }
+      if (watch.deadline <= now) {
+        watch.fired = true;
+        watch.cancelling = true;
+        due.push_back(ticket);
+        conns.push_back(watch.conn);
+      } else {
+        next = std::min(next, watch.deadline);
+      }
+    }
+
+    if (due.empty()) {
+      if (next == clock::time_point::max()) {
+        cv_.wait(lock);
+      } else {
+        cv_.wait_until(lock, next);
+      }
+      continue;
+    }
+    // cancelling can take a round trip (KILL QUERY connects first); the
+    // watches stay put meanwhile, disarm() waits for them
+    lock.unlock();
+    for (auto const *conn : conns) {
+      conn->cancelQuery();
+    }
+    lock.lock();
+    for (auto const ticket : due) {
+      watches_.at(ticket).cancelling = false;
+    }
+    cancels_ += due.size();
+    cv_.notify_all();
+  }
+}
+
+} // namespace sql_variant
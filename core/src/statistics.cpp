@@ -1,13 +1,75 @@
 #include "statistics.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <deque>
+#include <fmt/format.h>
 #include <iomanip>
 #include <iostream>
+#include <mutex>
+#include <shared_mutex>
 #include <sstream>
 #include <stdexcept>
 
 namespace statistics {
 
+namespace {
+
+struct Names {
+  std::shared_mutex mutex;
+  // a deque: interned strings never move, the views in `ids` stay valid
+  std::deque<std::string> names{""};
+  std::unordered_map<std::string_view, NameId> ids{{names.front(), 0}};
+};
+
+Names &names() {
+  static Names table;
+  return table;
+}
+
+} // namespace
+
+NameId NameTable::intern(std::string_view name) {
+  auto &table = names();
+  {
+    std::shared_lock lock(table.mutex);
+    if (auto const it = table.ids.find(name); it != table.ids.end()) {
+      return it->second;
+    }
+  }
+  std::unique_lock lock(table.mutex);
+  if (auto const it = table.ids.find(name); it != table.ids.end()) {
+    return it->second;
+  }
+  auto const id = static_cast<NameId>(table.names.size());
+  table.ids.emplace(table.names.emplace_back(name), id);
+  return id;
+}
+
+std::string const &NameTable::name(NameId id) {
+  auto &table = names();
+  std::shared_lock lock(table.mutex);
+  return table.names.at(id);
+}
+
+std::string_view rowKindName(RowKind kind) {
+  switch (kind) {
+  case RowKind::select:
+    return "select";
+  case RowKind::insert:
+    return "insert";
+  case RowKind::update:
+    return "update";
+  case RowKind::del:
+    return "delete";
+  case RowKind::dml:
+    break;
+  }
+  return "dml";
+}
+
 void RowHistogram::record(uint64_t rows) {
   if (rows == 0) {
     buckets[0]++;
@@ -24,6 +86,12 @@ void RowHistogram::record(uint64_t rows) {
   }
 }
 
+void RowHistogram::merge(const RowHistogram &other) {
+  for (std::size_t i = 0; i < buckets.size(); ++i) {
+    buckets[i] += other.buckets[i];
+  }
+}
+
 uint64_t RowHistogram::total() const {
   uint64_t sum = 0;
   for (auto b : buckets) {
@@ -55,14 +123,134 @@ void TimingHistogram::record(std::chrono::nanoseconds duration) {
   }
 }
 
+void TimingHistogram::merge(const TimingHistogram &other) {
+  for (std::size_t i = 0; i < buckets.size(); ++i) {
+    buckets[i] += other.buckets[i];
+  }
+}
+
 void TimingHistogram::reset() { buckets.fill(0); }
 
+namespace {
+
+std::atomic<unsigned> default_latency_digits{2};
+
+void check_digits(unsigned digits) {
+  if (digits < 1 || digits > LatencyHistogram::maxDigits) {
+    throw std::invalid_argument(
+        fmt::format("latency precision must be 1-{} digits, not {}",
+                    LatencyHistogram::maxDigits, digits));
+  }
+}
+
+} // namespace
+
+LatencyHistogram::LatencyHistogram(unsigned digits) : digits_(digits) {
+  check_digits(digits);
+  // the smallest subBits with 2^-subBits <= 10^-digits
+  subBits_ = static_cast<unsigned>(
+      std::ceil(static_cast<double>(digits) * std::log2(10.0)));
+}
+
+void LatencyHistogram::setDefaultDigits(unsigned digits) {
+  check_digits(digits);
+  default_latency_digits.store(digits, std::memory_order_relaxed);
+}
+
+unsigned LatencyHistogram::defaultDigits() {
+  return default_latency_digits.load(std::memory_order_relaxed);
+}
+
+std::size_t LatencyHistogram::bucketOf(uint64_t micros, unsigned subBits) {
+  auto const bits = static_cast<unsigned>(std::bit_width(micros));
+  if (bits <= subBits) {
+    return micros;
+  }
+  // micros >> shift is in [2^subBits, 2^(subBits+1)): its position there
+  // is the bucket within this power of two
+  auto const shift = bits - 1 - subBits;
+  return ((std::size_t{shift} + 1) << subBits) +
+         ((micros >> shift) - (uint64_t{1} << subBits));
+}
+
+uint64_t LatencyHistogram::highestIn(std::size_t bucket, unsigned subBits) {
+  auto const linear = std::size_t{1} << subBits;
+  if (bucket < linear) {
+    return bucket;
+  }
+  auto const shift = (bucket >> subBits) - 1;
+  auto const lowest = ((bucket & (linear - 1)) + linear) << shift;
+  return lowest + (uint64_t{1} << shift) - 1;
+}
+
+void LatencyHistogram::record(std::chrono::nanoseconds duration) {
+  auto const micros = static_cast<uint64_t>(std::max<int64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(duration).count(),
+      0));
+  auto const index = bucketOf(micros, subBits_);
+  if (index >= counts_.size()) {
+    counts_.resize(index + 1);
+  }
+  counts_[index]++;
+  count_++;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other) {
+  if (other.digits_ != digits_) {
+    throw std::invalid_argument(
+        fmt::format("cannot merge a {}-digit latency histogram into a "
+                    "{}-digit one",
+                    other.digits_, digits_));
+  }
+  if (other.counts_.size() > counts_.size()) {
+    counts_.resize(other.counts_.size());
+  }
+  for (std::size_t i = 0; i < other.counts_.size(); ++i) {
+    counts_[i] += other.counts_[i];
+  }
+  count_ += other.count_;
+}
+
+std::chrono::nanoseconds
+LatencyHistogram::valueAtPercentile(double percentile) const {
+  if (count_ == 0) {
+    return std::chrono::nanoseconds{0};
+  }
+  auto const wanted = std::max<uint64_t>(
+      static_cast<uint64_t>(std::ceil(std::clamp(percentile, 0.0, 100.0) /
+                                      100.0 * static_cast<double>(count_))),
+      1);
+  uint64_t seen = 0;
+  for (std::size_t i = 0; i < counts_.size(); ++i) {
+    seen += counts_[i];
+    if (seen >= wanted) {
+      return std::chrono::microseconds(highestIn(i, subBits_));
+    }
+  }
+  return std::chrono::microseconds(highestIn(counts_.size() - 1, subBits_));
+}
+
+void LatencyHistogram::reset() {
+  counts_.clear();
+  count_ = 0;
+}
+
 void TimingStatistics::record(std::chrono::nanoseconds duration) {
   totalTime += duration;
   minTime = std::min(minTime, duration);
   maxTime = std::max(maxTime, duration);
   count++;
   histogram.record(duration);
+  latency.record(duration);
+}
+
+void TimingStatistics::merge(const TimingStatistics &other) {
+  totalTime += other.totalTime;
+  minTime = std::min(minTime, other.minTime);
+  maxTime = std::max(maxTime, other.maxTime);
+  count += other.count;
+  histogram.merge(other.histogram);
+  latency.merge(other.latency);
 }
 
 double TimingStatistics::getAverageMs() const {
@@ -87,12 +275,23 @@ double TimingStatistics::getMaxMs() const {
   return static_cast<double>(maxTime.count()) / 1'000'000.0;
 }
 
+double TimingStatistics::getPercentileMs(double percentile) const {
+  if (count == 0) {
+    return 0.0;
+  }
+  // a bucket's highest value can lie past what was actually seen
+  auto const value =
+      std::clamp(latency.valueAtPercentile(percentile), minTime, maxTime);
+  return static_cast<double>(value.count()) / 1'000'000.0;
+}
+
 void TimingStatistics::reset() {
   totalTime = std::chrono::nanoseconds{0};
   minTime = std::chrono::nanoseconds::max();
   maxTime = std::chrono::nanoseconds{0};
   count = 0;
   histogram.reset();
+  latency.reset();
 }
 
 bool TimingStatistics::hasData() const { return count > 0; }
@@ -116,6 +315,17 @@ void TransactionStatistics::record(const TransactionOutcome &outcome) {
   subActionsPerTxn.record(outcome.subOk + outcome.subFail);
 }
 
+void TransactionStatistics::merge(const TransactionStatistics &other) {
+  committed += other.committed;
+  rolledBackIntentional += other.rolledBackIntentional;
+  rolledBackError += other.rolledBackError;
+  implicitCommits += other.implicitCommits;
+  savepointRollbacks += other.savepointRollbacks;
+  subActionsOk += other.subActionsOk;
+  subActionsFail += other.subActionsFail;
+  subActionsPerTxn.merge(other.subActionsPerTxn);
+}
+
 uint64_t TransactionStatistics::total() const {
   return committed + rolledBackIntentional + rolledBackError;
 }
@@ -134,6 +344,14 @@ void TransactionStatistics::reset() {
 }
 
 namespace {
+
+// ", p50=..ms, p99=..ms, p99.9=..ms" and the line end
+void reportPercentiles(std::ostream &oss, const TimingStatistics &timing) {
+  oss << ", p50=" << timing.getPercentileMs(50) << "ms";
+  oss << ", p99=" << timing.getPercentileMs(99) << "ms";
+  oss << ", p99.9=" << timing.getPercentileMs(99.9) << "ms\n";
+}
+
 std::chrono::nanoseconds calculateExecutionTime(
     const std::chrono::high_resolution_clock::time_point &startTime) {
   if (startTime == std::chrono::high_resolution_clock::time_point{}) {
@@ -144,6 +362,29 @@ std::chrono::nanoseconds calculateExecutionTime(
   return std::chrono::duration_cast<std::chrono::nanoseconds>(endTime -
                                                               startTime);
 }
+
+void countErrors(ErrorCounts &counts, NameId error, uint64_t count) {
+  auto const it =
+      std::ranges::find(counts, error, &ErrorCounts::value_type::first);
+  if (it == counts.end()) {
+    counts.emplace_back(error, count);
+  } else {
+    it->second += count;
+  }
+}
+
+void countError(ErrorCounts &counts, NameId error) {
+  countErrors(counts, error, 1);
+}
+
+std::map<std::string, uint64_t> byName(ErrorCounts const &counts) {
+  std::map<std::string, uint64_t> out;
+  for (auto const &[error, count] : counts) {
+    out[NameTable::name(error)] += count;
+  }
+  return out;
+}
+
 } // namespace
 
 void ActionStatistics::start() {
@@ -157,24 +398,34 @@ void ActionStatistics::recordSuccess(std::chrono::nanoseconds sqlTime) {
   sqlTiming.record(sqlTime);
 }
 
-void ActionStatistics::recordActionFailure(const std::string &errorName,
+void ActionStatistics::recordActionFailure(NameId errorName,
                                            std::chrono::nanoseconds sqlTime) {
   auto execTime = calculateExecutionTime(startTime);
   actionFailureCount++;
-  actionErrorNames[errorName]++;
+  countError(actionErrors, errorName);
   executionTiming.record(execTime);
   sqlTiming.record(sqlTime);
 }
 
-void ActionStatistics::recordSqlFailure(const std::string &errorCode,
+void ActionStatistics::recordActionFailure(const std::string &errorName,
+                                           std::chrono::nanoseconds sqlTime) {
+  recordActionFailure(NameTable::intern(errorName), sqlTime);
+}
+
+void ActionStatistics::recordSqlFailure(NameId errorCode,
                                         std::chrono::nanoseconds sqlTime) {
   auto execTime = calculateExecutionTime(startTime);
   sqlFailureCount++;
-  sqlErrorCodes[errorCode]++;
+  countError(sqlErrors, errorCode);
   executionTiming.record(execTime);
   sqlTiming.record(sqlTime);
 }
 
+void ActionStatistics::recordSqlFailure(const std::string &errorCode,
+                                        std::chrono::nanoseconds sqlTime) {
+  recordSqlFailure(NameTable::intern(errorCode), sqlTime);
+}
+
 void ActionStatistics::recordOtherFailure(std::chrono::nanoseconds sqlTime) {
   auto execTime = calculateExecutionTime(startTime);
   otherFailureCount++;
@@ -182,17 +433,59 @@ void ActionStatistics::recordOtherFailure(std::chrono::nanoseconds sqlTime) {
   sqlTiming.record(sqlTime);
 }
 
-void ActionStatistics::recordConflict(const std::string &errorCode,
+void ActionStatistics::recordConflict(NameId errorCode,
                                       std::chrono::nanoseconds sqlTime) {
   auto execTime = calculateExecutionTime(startTime);
   sqlConflictCount++;
-  sqlErrorCodes[errorCode]++;
+  countError(sqlErrors, errorCode);
   executionTiming.record(execTime);
   sqlTiming.record(sqlTime);
 }
 
-void ActionStatistics::recordRows(const std::string &kind, uint64_t rows) {
-  rowHistograms[kind].record(rows);
+void ActionStatistics::recordConflict(const std::string &errorCode,
+                                      std::chrono::nanoseconds sqlTime) {
+  recordConflict(NameTable::intern(errorCode), sqlTime);
+}
+
+void ActionStatistics::recordRows(RowKind kind, uint64_t rows) {
+  this->rows[static_cast<std::size_t>(kind)].record(rows);
+}
+
+std::map<std::string, uint64_t> ActionStatistics::actionErrorNames() const {
+  return byName(actionErrors);
+}
+
+std::map<std::string, uint64_t> ActionStatistics::sqlErrorCodes() const {
+  return byName(sqlErrors);
+}
+
+std::map<std::string, RowHistogram> ActionStatistics::rowHistograms() const {
+  std::map<std::string, RowHistogram> out;
+  for (std::size_t i = 0; i < rows.size(); ++i) {
+    if (rows[i].hasData()) {
+      out.emplace(rowKindName(static_cast<RowKind>(i)), rows[i]);
+    }
+  }
+  return out;
+}
+
+void ActionStatistics::merge(const ActionStatistics &other) {
+  successCount += other.successCount;
+  actionFailureCount += other.actionFailureCount;
+  sqlFailureCount += other.sqlFailureCount;
+  otherFailureCount += other.otherFailureCount;
+  sqlConflictCount += other.sqlConflictCount;
+  for (auto const &[error, count] : other.actionErrors) {
+    countErrors(actionErrors, error, count);
+  }
+  for (auto const &[error, count] : other.sqlErrors) {
+    countErrors(sqlErrors, error, count);
+  }
+  for (std::size_t i = 0; i < rows.size(); ++i) {
+    rows[i].merge(other.rows[i]);
+  }
+  executionTiming.merge(other.executionTiming);
+  sqlTiming.merge(other.sqlTiming);
 }
 
 uint64_t ActionStatistics::getTotalCount() const {
@@ -219,9 +512,11 @@ void ActionStatistics::reset() {
   sqlFailureCount = 0;
   otherFailureCount = 0;
   sqlConflictCount = 0;
-  actionErrorNames.clear();
-  sqlErrorCodes.clear();
-  rowHistograms.clear();
+  actionErrors.clear();
+  sqlErrors.clear();
+  for (auto &histogram : rows) {
+    histogram.reset();
+  }
   executionTiming.reset();
   sqlTiming.reset();
   startTime = std::chrono::high_resolution_clock::time_point{};
@@ -229,47 +524,138 @@ void ActionStatistics::reset() {
 
 bool ActionStatistics::hasData() const { return getTotalCount() > 0; }
 
+WorkerStatistics::WorkerStatistics(const WorkerStatistics &other)
+    : actionStats(other.actionStats), txnStats(other.txnStats),
+      reconnectTiming(other.reconnectTiming), startTime(other.startTime),
+      endTime(other.endTime) {}
+
+WorkerStatistics &WorkerStatistics::operator=(const WorkerStatistics &other) {
+  if (this != &other) {
+    actionStats = other.actionStats;
+    txnStats = other.txnStats;
+    reconnectTiming = other.reconnectTiming;
+    startTime = other.startTime;
+    endTime = other.endTime;
+    byId_.clear();
+  }
+  return *this;
+}
+
+ActionStatistics &WorkerStatistics::action(NameId actionName) {
+  if (actionName >= byId_.size()) {
+    byId_.resize(actionName + 1, nullptr);
+  }
+  auto *&entry = byId_[actionName];
+  if (entry == nullptr) {
+    entry = &actionStats[NameTable::name(actionName)];
+  }
+  return *entry;
+}
+
+void WorkerStatistics::startAction(NameId actionName) {
+  action(actionName).start();
+}
+
 void WorkerStatistics::startAction(const std::string &actionName) {
-  actionStats[actionName].start();
+  startAction(NameTable::intern(actionName));
+}
+
+void WorkerStatistics::recordSuccess(NameId actionName,
+                                     std::chrono::nanoseconds sqlTime) {
+  action(actionName).recordSuccess(sqlTime);
 }
 
 void WorkerStatistics::recordSuccess(const std::string &actionName,
                                      std::chrono::nanoseconds sqlTime) {
-  actionStats[actionName].recordSuccess(sqlTime);
+  recordSuccess(NameTable::intern(actionName), sqlTime);
+}
+
+void WorkerStatistics::recordActionFailure(NameId actionName,
+                                           NameId errorName,
+                                           std::chrono::nanoseconds sqlTime) {
+  action(actionName).recordActionFailure(errorName, sqlTime);
 }
 
 void WorkerStatistics::recordActionFailure(const std::string &actionName,
                                            const std::string &errorName,
                                            std::chrono::nanoseconds sqlTime) {
-  actionStats[actionName].recordActionFailure(errorName, sqlTime);
+  recordActionFailure(NameTable::intern(actionName),
+                      NameTable::intern(errorName), sqlTime);
+}
+
+void WorkerStatistics::recordSqlFailure(NameId actionName, NameId errorCode,
+                                        std::chrono::nanoseconds sqlTime) {
+  action(actionName).recordSqlFailure(errorCode, sqlTime);
 }
 
 void WorkerStatistics::recordSqlFailure(const std::string &actionName,
                                         const std::string &errorCode,
                                         std::chrono::nanoseconds sqlTime) {
-  actionStats[actionName].recordSqlFailure(errorCode, sqlTime);
+  recordSqlFailure(NameTable::intern(actionName), NameTable::intern(errorCode),
+                   sqlTime);
+}
+
+void WorkerStatistics::recordOtherFailure(NameId actionName,
+                                          std::chrono::nanoseconds sqlTime) {
+  action(actionName).recordOtherFailure(sqlTime);
 }
 
 void WorkerStatistics::recordOtherFailure(const std::string &actionName,
                                           std::chrono::nanoseconds sqlTime) {
-  actionStats[actionName].recordOtherFailure(sqlTime);
+  recordOtherFailure(NameTable::intern(actionName), sqlTime);
+}
+
+void WorkerStatistics::recordConflict(NameId actionName, NameId errorCode,
+                                      std::chrono::nanoseconds sqlTime) {
+  action(actionName).recordConflict(errorCode, sqlTime);
 }
 
 void WorkerStatistics::recordConflict(const std::string &actionName,
                                       const std::string &errorCode,
                                       std::chrono::nanoseconds sqlTime) {
-  actionStats[actionName].recordConflict(errorCode, sqlTime);
+  recordConflict(NameTable::intern(actionName), NameTable::intern(errorCode),
+                 sqlTime);
 }
 
-void WorkerStatistics::recordRows(const std::string &actionName,
-                                  const std::string &kind, uint64_t rows) {
-  actionStats[actionName].recordRows(kind, rows);
+void WorkerStatistics::recordRows(NameId actionName, RowKind kind,
+                                  uint64_t rows) {
+  action(actionName).recordRows(kind, rows);
+}
+
+void WorkerStatistics::recordRows(const std::string &actionName, RowKind kind,
+                                  uint64_t rows) {
+  recordRows(NameTable::intern(actionName), kind, rows);
 }
 
 void WorkerStatistics::recordTransaction(const TransactionOutcome &outcome) {
   txnStats.record(outcome);
 }
 
+void WorkerStatistics::recordReconnect(std::chrono::nanoseconds downtime) {
+  reconnectTiming.record(downtime);
+}
+
+void WorkerStatistics::merge(const WorkerStatistics &other) {
+  if (this == &other) {
+    // would walk actionStats while adding to it
+    WorkerStatistics const copy = other;
+    merge(copy);
+    return;
+  }
+  for (auto const &[actionName, stats] : other.actionStats) {
+    actionStats[actionName].merge(stats);
+  }
+  txnStats.merge(other.txnStats);
+  reconnectTiming.merge(other.reconnectTiming);
+  // a default-constructed side has no span yet
+  if (startTime == std::chrono::steady_clock::time_point{} ||
+      (other.startTime != std::chrono::steady_clock::time_point{} &&
+       other.startTime < startTime)) {
+    startTime = other.startTime;
+  }
+  endTime = std::max(endTime, other.endTime);
+}
+
 void WorkerStatistics::start() {
   startTime = std::chrono::steady_clock::now();
   endTime = startTime;
@@ -279,7 +665,9 @@ void WorkerStatistics::stop() { endTime = std::chrono::steady_clock::now(); }
 
 void WorkerStatistics::reset() {
   actionStats.clear();
+  byId_.clear();
   txnStats.reset();
+  reconnectTiming.reset();
   startTime = std::chrono::steady_clock::now();
   endTime = startTime;
 }
@@ -342,6 +730,11 @@ std::string WorkerStatistics::reportSummary() const {
   oss << "  Success rate: " << getOverallSuccessRate() << "%\n";
   oss << "  Duration: " << getTotalDurationSeconds() << "s\n";
   oss << "  Actions/sec: " << getActionsPerSecond() << "\n";
+  if (reconnectTiming.hasData()) {
+    oss << "  Reconnects: " << reconnectTiming.count
+        << " (avg=" << reconnectTiming.getAverageMs()
+        << "ms, max=" << reconnectTiming.getMaxMs() << "ms)\n";
+  }
   return oss.str();
 }
 
@@ -369,19 +762,21 @@ std::string WorkerStatistics::reportDetailed() const {
       oss << "  Execution Time: avg=" << stats.executionTiming.getAverageMs()
           << "ms";
       oss << ", min=" << stats.executionTiming.getMinMs() << "ms";
-      oss << ", max=" << stats.executionTiming.getMaxMs() << "ms\n";
+      oss << ", max=" << stats.executionTiming.getMaxMs() << "ms";
+      reportPercentiles(oss, stats.executionTiming);
     }
 
     if (stats.sqlTiming.hasData()) {
       oss << "  SQL Time: avg=" << stats.sqlTiming.getAverageMs() << "ms";
       oss << ", min=" << stats.sqlTiming.getMinMs() << "ms";
-      oss << ", max=" << stats.sqlTiming.getMaxMs() << "ms\n";
+      oss << ", max=" << stats.sqlTiming.getMaxMs() << "ms";
+      reportPercentiles(oss, stats.sqlTiming);
     }
 
-    if (!stats.actionErrorNames.empty()) {
+    if (!stats.actionErrors.empty()) {
       oss << "  Action Errors: ";
       bool first = true;
-      for (const auto &[errorName, count] : stats.actionErrorNames) {
+      for (const auto &[errorName, count] : stats.actionErrorNames()) {
         if (!first) {
           oss << ", ";
         }
@@ -391,10 +786,10 @@ std::string WorkerStatistics::reportDetailed() const {
       oss << "\n";
     }
 
-    if (!stats.sqlErrorCodes.empty()) {
+    if (!stats.sqlErrors.empty()) {
       oss << "  SQL Errors: ";
       bool first = true;
-      for (const auto &[errorCode, count] : stats.sqlErrorCodes) {
+      for (const auto &[errorCode, count] : stats.sqlErrorCodes()) {
         if (!first) {
           oss << ", ";
         }
@@ -413,4 +808,96 @@ std::string WorkerStatistics::report() const {
   return reportSummary() + reportDetailed();
 }
 
+void WorkloadStatistics::add(std::size_t cycle,
+                             const WorkerStatistics &worker) {
+  total_.merge(worker);
+  for (auto const &[actionName, stats] : worker.actionStats) {
+    executionTiming_.merge(stats.executionTiming);
+  }
+  ++workers_;
+
+  if (worker.startTime == std::chrono::steady_clock::time_point{}) {
+    return; // never started, no span to cover
+  }
+  cover(cycle, Span{worker.startTime, worker.endTime});
+}
+
+void WorkloadStatistics::merge(const WorkloadStatistics &other) {
+  if (this == &other) {
+    WorkloadStatistics const copy = other;
+    merge(copy);
+    return;
+  }
+  total_.merge(other.total_);
+  executionTiming_.merge(other.executionTiming_);
+  workers_ += other.workers_;
+  for (auto const &[cycle, span] : other.cycles_) {
+    cover(cycle, span);
+  }
+}
+
+void WorkloadStatistics::cover(std::size_t cycle, Span span) {
+  auto const [it, inserted] = cycles_.try_emplace(cycle, span);
+  if (!inserted) {
+    it->second.start = std::min(it->second.start, span.start);
+    it->second.end = std::max(it->second.end, span.end);
+  }
+}
+
+void WorkloadStatistics::reset() { *this = WorkloadStatistics{}; }
+
+double WorkloadStatistics::getTotalDurationSeconds() const {
+  double seconds = 0.0;
+  for (auto const &[cycle, span] : cycles_) {
+    seconds += std::chrono::duration<double>(span.end - span.start).count();
+  }
+  return seconds;
+}
+
+double WorkloadStatistics::getActionsPerSecond() const {
+  double const duration = getTotalDurationSeconds();
+  if (duration <= 0.0) {
+    return 0.0;
+  }
+  return static_cast<double>(total_.getTotalActionCount()) / duration;
+}
+
+std::string WorkloadStatistics::reportSummary() const {
+  std::ostringstream oss;
+  oss << std::fixed << std::setprecision(2);
+  oss << "Workload Summary:\n";
+  oss << "  Workers: " << workers_ << " in " << cycles_.size()
+      << " cycle(s)\n";
+  oss << "  Total actions: " << total_.getTotalActionCount() << "\n";
+  oss << "  Successful: " << total_.getTotalSuccessCount() << "\n";
+  oss << "  Failed: " << total_.getTotalFailureCount() << "\n";
+  oss << "  Success rate: " << total_.getOverallSuccessRate() << "%\n";
+  oss << "  Duration: " << getTotalDurationSeconds() << "s\n";
+  oss << "  Actions/sec: " << getActionsPerSecond() << "\n";
+  if (executionTiming_.hasData()) {
+    oss << "  Execution Time: avg=" << executionTiming_.getAverageMs()
+        << "ms, min=" << executionTiming_.getMinMs()
+        << "ms, max=" << executionTiming_.getMaxMs() << "ms";
+    reportPercentiles(oss, executionTiming_);
+  }
+  if (total_.txnStats.hasData()) {
+    oss << "  Transactions: " << total_.txnStats.total()
+        << " (committed: " << total_.txnStats.committed
+        << ", rolled back: "
+        << total_.txnStats.rolledBackIntentional +
+               total_.txnStats.rolledBackError
+        << ")\n";
+  }
+  if (total_.reconnectTiming.hasData()) {
+    oss << "  Reconnects: " << total_.reconnectTiming.count
+        << " (avg=" << total_.reconnectTiming.getAverageMs()
+        << "ms, max=" << total_.reconnectTiming.getMaxMs() << "ms)\n";
+  }
+  return oss.str();
+}
+
+std::string WorkloadStatistics::report() const {
+  return reportSummary() + total_.reportDetailed();
+}
+
 } // namespace statistics
@@ -1,13 +1,20 @@
 
 #include "workload.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <ctime>
+#include <filesystem>
 #include <fstream>
+#include <fmt/chrono.h>
 #include <iomanip>
+#include <nlohmann/json.hpp>
+#include <optional>
 #include <sstream>
+#include <stdexcept>
 #include <string_view>
+#include <tuple>
 #include <utility>
 
 #include "action/action_registry.hpp"
@@ -56,21 +63,256 @@ std::uint64_t derive_seed(std::uint64_t seed, std::string_view name) {
   return h;
 }
 
+// connections the worker opens, its side connections included, run under
+// the workload's watchdog
+Worker::sql_connector_t watched(Worker::sql_connector_t connector,
+                                WorkloadParams const &config,
+                                RunContext const &run) {
+  if (run.watchdog == nullptr) {
+    return connector;
+  }
+  return [connector = std::move(connector), watchdog = run.watchdog,
+          timeout = std::chrono::milliseconds(config.statement_timeout_ms)]() {
+    auto conn = connector();
+    conn->setWatchdog(watchdog, timeout);
+    return conn;
+  };
+}
+
 } // anonymous namespace
 
+WorkerControl::WorkerControl(double rate) : rate_(rate) {
+  if (rate < 0) {
+    throw std::invalid_argument("rate must be >= 0");
+  }
+}
+
+void WorkerControl::pause() {
+  std::unique_lock lock(mutex);
+  paused = true;
+}
+
+void WorkerControl::resume() {
+  std::unique_lock lock(mutex);
+  paused = false;
+  cv.notify_all();
+}
+
+void WorkerControl::stop() {
+  std::unique_lock lock(mutex);
+  stopSource.request_stop();
+  cv.notify_all();
+}
+
+WorkerControl::State WorkerControl::state() const {
+  std::unique_lock lock(mutex);
+  if (stopSource.stop_requested()) {
+    return State::stopped;
+  }
+  return paused ? State::paused : State::running;
+}
+
+void WorkerControl::setRate(double actionsPerSecond) {
+  if (actionsPerSecond < 0) {
+    throw std::invalid_argument("rate must be >= 0");
+  }
+  std::unique_lock lock(mutex);
+  rate_ = actionsPerSecond;
+  cv.notify_all();
+}
+
+double WorkerControl::rate() const {
+  std::unique_lock lock(mutex);
+  return rate_;
+}
+
+void WorkerControl::setWeight(std::string name, std::size_t weight) {
+  std::unique_lock lock(mutex);
+  weights.emplace_back(std::move(name), weight);
+}
+
+bool WorkerControl::admit(std::chrono::steady_clock::time_point deadline) {
+  std::unique_lock lock(mutex);
+  for (;;) {
+    auto const now = std::chrono::steady_clock::now();
+    if (stopSource.stop_requested() || now >= deadline) {
+      return false;
+    }
+    if (!paused) {
+      if (rate_ <= 0) {
+        return true;
+      }
+      if (now >= nextDue) {
+        auto const interval =
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(1.0 / rate_));
+        // on schedule: no drift. Behind (slow actions, a pause): no burst
+        // to catch up
+        nextDue = std::max(nextDue + interval, now);
+        return true;
+      }
+    }
+    // any control change notifies: re-evaluate from the top
+    cv.wait_until(lock, paused ? deadline : std::min(deadline, nextDue));
+  }
+}
+
+bool WorkerControl::idleUntil(std::chrono::steady_clock::time_point until) {
+  std::unique_lock lock(mutex);
+  cv.wait_until(lock, until, [this] { return stopSource.stop_requested(); });
+  return !stopSource.stop_requested();
+}
+
+std::vector<std::pair<std::string, std::size_t>> WorkerControl::takeWeights() {
+  std::unique_lock lock(mutex);
+  return std::exchange(weights, {});
+}
+
 Worker::Worker(std::string const &name, sql_connector_t const &sql_connector,
-               WorkloadParams config, metadata_ptr metadata)
-    : name(name), sql_connector(sql_connector), sql_conn(sql_connector()),
-      config(std::move(config)), metadata(std::move(metadata)),
+               WorkloadParams config, metadata_ptr metadata,
+               RunContext const &run)
+    : name(name), sql_connector(watched(sql_connector, config, run)),
+      sql_conn(this->sql_connector()), config(std::move(config)),
+      run(run.forWorker()), metadata(std::move(metadata)),
       rand(this->config.seed == 0
                ? ps_random()
-               : ps_random(derive_seed(this->config.seed, this->name))),
+               : ps_random(derive_seed(this->config.seed, this->name),
+                           this->config.rng_stream)),
       logger(logging::make_file_logger(fmt::format("worker-{}", name),
-                                       fmt::format("worker-{}.log", name))) {}
+                                       fmt::format("worker-{}.log", name))),
+      control(std::make_shared<WorkerControl>(this->config.target_rate)) {
+  // side connections for multi-connection actions (oracle_check)
+  if (auto const &pool = this->run.actions.connections) {
+    pool->setConnector(this->sql_connector);
+  }
+  if (auto const &manager = this->run.connection_manager) {
+    manager->setConnector(this->sql_connector);
+  }
+  if (!this->config.resume_from.empty()) {
+    auto const line =
+        nlohmann::json::parse(this->config.resume_from, nullptr, false);
+    if (!line.is_object() || !line.contains("rng") ||
+        !line["rng"].is_string() || !line.contains("actions") ||
+        !line["actions"].is_number_unsigned()) {
+      throw std::invalid_argument(fmt::format(
+          "worker {}: malformed rng checkpoint: {}", name,
+          this->config.resume_from));
+    }
+    rand.restore(line["rng"].get<std::string>());
+    actionCount = line["actions"].get<std::uint64_t>();
+    logger->info("Worker {} resuming at action {}", name, actionCount);
+  }
+}
+
+Worker::~Worker() {
+  // never ran: must not hold the others back. Subclasses have joined
+  if (run.start_barrier != nullptr) {
+    run.start_barrier->cancel();
+  }
+}
+
+void Worker::reconnect() {
+  logged_sql_ptr fresh;
+  if (run.connection_manager) {
+    fresh = run.connection_manager->connect(sql_connector, name);
+  } else {
+    fresh = sql_connector();
+  }
+  if (recorder) {
+    fresh->setStatementSink(recorder);
+  }
+  if (stopArmed) {
+    fresh->setStopToken(control->stopToken());
+  }
+  std::unique_lock lock(control->connectionMutex);
+  sql_conn.swap(fresh);
+}
+
+void Worker::pause() { control->pause(); }
 
-Worker::~Worker() = default;
+void Worker::resume() { control->resume(); }
 
-void Worker::reconnect() { sql_conn = sql_connector(); }
+void Worker::stop() {
+  control->stop();
+  std::unique_lock lock(control->connectionMutex);
+  sql_conn->cancelQuery();
+}
+
+void Worker::set_rate(double actions_per_second) {
+  control->setRate(actions_per_second);
+}
+
+WorkerControl::State Worker::state() const { return control->state(); }
+
+std::optional<std::chrono::nanoseconds>
+Worker::recoverConnection(std::size_t &attempts) {
+  auto const lostAt = std::chrono::steady_clock::now();
+  if (++attempts > config.max_reconnect_attempts) {
+    logger->error("Failed to connect {} times, stopping worker",
+                  config.max_reconnect_attempts);
+    return std::nullopt;
+  }
+  // the manager paces its own probes
+  if (run.connection_manager == nullptr) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+  }
+  logger->warn("Lost connection to the server, trying to reconnect");
+  try {
+    reconnect();
+  } catch (sql_variant::SqlException const &e) {
+    logger->error("Worker {} cannot reconnect, stopping: {}", name, e.what());
+    return std::nullopt;
+  }
+  // the manager only hands out connections that answered: the next
+  // outage is a new one, not another failed attempt at this one
+  if (run.connection_manager != nullptr) {
+    attempts = 0;
+  }
+  return std::chrono::steady_clock::now() - lostAt;
+}
+
+void Worker::drainObservations(statistics::WorkerStatistics &stats,
+                               statistics::IntervalStats *live) {
+  sql_conn->drainRowObservations(observed);
+  for (auto const &obs : observed) {
+    stats.recordRows(obs.action, obs.kind, obs.rows);
+  }
+  sql_conn->drainTransactionOutcomes(outcomes);
+  for (auto const &txn : outcomes) {
+    stats.recordTransaction(txn);
+    if (live != nullptr) {
+      live->recordTransaction(txn);
+    }
+  }
+}
+
+void Worker::armStop() {
+  stopArmed = true;
+  sql_conn->setStopToken(control->stopToken());
+}
+
+void Worker::disarmStop() {
+  stopArmed = false;
+  sql_conn->setStopToken({});
+}
+
+std::chrono::steady_clock::time_point Worker::awaitStart() {
+  if (run.start_barrier == nullptr) {
+    return std::chrono::steady_clock::now();
+  }
+  return run.start_barrier->arriveAndWait(control->stopToken());
+}
+
+std::string Worker::rng_checkpoint() const {
+  // "at" is UTC with microseconds, comparable to a PITR recovery target
+  auto const at = std::chrono::time_point_cast<std::chrono::microseconds>(
+      std::chrono::system_clock::now());
+  nlohmann::json const line{{"worker", name},
+                            {"actions", actionCount},
+                            {"at", fmt::format("{:%FT%T}Z", at)},
+                            {"rng", rand.checkpoint()}};
+  return line.dump();
+}
 
 void Worker::create_random_tables(std::size_t count) {
   metadata::Context ctx(*metadata);
@@ -81,6 +323,17 @@ void Worker::create_random_tables(std::size_t count) {
   }
 }
 
+void Worker::bulk_load(std::string const &table, std::size_t rows) {
+  metadata::Context ctx(*metadata);
+  auto target = ctx.get<metadata::Table>().byName(table);
+  if (target == nullptr) {
+    throw std::invalid_argument(fmt::format("unknown table: {}", table));
+  }
+  action::BulkLoad loader(config.actionConfig.dml, run.actions, rows,
+                          [&target]() { return target; });
+  loader.execute(ctx, rand, sql_conn.get());
+}
+
 void Worker::discover_existing_schema() {
   logger->info("Worker {} starting schema discovery from existing database",
                name);
@@ -143,9 +396,29 @@ void Worker::calculate_database_checksums(const std::string &filename) {
 RandomWorker::RandomWorker(std::string const &name,
                            Worker::sql_connector_t const &sql_connector,
                            WorkloadParams const &config, metadata_ptr metadata,
-                           action::ActionRegistry actions)
-    : Worker(name, sql_connector, config, std::move(metadata)),
-      actions(std::move(actions)) {}
+                           action::ActionRegistry actions,
+                           RunContext const &run)
+    : Worker(name, sql_connector, config, std::move(metadata), run),
+      actions(std::move(actions)) {
+  if (!this->config.plan_dir.empty()) {
+    // setup statements (create_random_tables) go into the plan as well
+    recorder = std::make_shared<plan::PlanRecorder>(
+        (std::filesystem::path(this->config.plan_dir) /
+         fmt::format("{}.plan.jsonl", name))
+            .string(),
+        name, this->config.seed);
+    sql_conn->setStatementSink(recorder);
+  }
+  if (this->run.turns) {
+    turns = metadata::TurnSlot(*this->run.turns);
+  }
+  if (this->run.phases) {
+    phaseSlot = this->run.phases->enroll();
+  }
+  if (this->run.intervals) {
+    liveRing = this->run.intervals->attach();
+  }
+}
 
 RandomWorker::~RandomWorker() { join(); }
 
@@ -153,6 +426,9 @@ void RandomWorker::run_thread(std::size_t duration_in_seconds) {
   spdlog::info("Worker {} starting, resetting statistics", name);
   stats.reset();
   stats.start();
+  phaseStats.clear();
+  phase.reset();
+  liveInterval = {};
 
   if (thread.joinable()) {
     spdlog::error("Error: thread is already running");
@@ -166,91 +442,127 @@ void RandomWorker::run_thread(std::size_t duration_in_seconds) {
     // the first action
     sql_conn->clearObservations();
 
-    auto drainIntoStats = [&] {
-      for (auto const &obs : sql_conn->drainRowObservations()) {
-        stats.recordRows(obs.action, obs.kind, obs.rows);
-      }
-      for (auto const &txn : sql_conn->drainTransactionOutcomes()) {
-        stats.recordTransaction(txn);
-      }
-    };
+    std::ofstream checkpoints;
+    if (config.checkpoint_interval > 0) {
+      checkpoints.open(
+          logging::log_path(fmt::format("worker-{}.rng.jsonl", name)),
+          std::ios::app);
+    }
+
+    auto const started = awaitStart();
+    stats.start();
+    if (run.phases) {
+      run.phases->begin(started);
+    }
+    auto const deadline = started + std::chrono::seconds(duration_in_seconds);
+    armStop();
 
-    std::chrono::steady_clock::time_point begin =
-        std::chrono::steady_clock::now();
-    std::chrono::steady_clock::time_point now =
-        std::chrono::steady_clock::now();
+    while ((config.max_actions == 0 || actionCount < config.max_actions) &&
+           followPhases(deadline) && control->admit(deadline)) {
+      for (auto const &[action, weight] : control->takeWeights()) {
+        actions.setWeight(action, weight);
+      }
+      auto const actionStarted = std::chrono::steady_clock::now();
+      advanceInterval(actionStarted);
 
-    while (
-        std::chrono::duration_cast<std::chrono::seconds>(now - begin).count() <
-        static_cast<int64_t>(duration_in_seconds)) {
+      // at the action boundary: nothing of the next action is drawn yet
+      if (checkpoints.is_open() &&
+          actionCount % config.checkpoint_interval == 0) {
+        checkpoints << rng_checkpoint() << '\n' << std::flush;
+      }
+      ++actionCount;
 
       const auto w = rand.random_number(static_cast<std::size_t>(0),
                                         actions.totalWeight());
       const auto actionFactory = actions.lookupByWeightOffset(w);
-      auto action = actionFactory.builder(action::BuildContext{
-          .config = config.actionConfig, .registry = actions});
-
-      stats.startAction(actionFactory.name);
+      auto action = actionFactory.builder(
+          action::BuildContext{.config = config.actionConfig,
+                               .registry = actions,
+                               .state = run.actions});
+
+      auto const actionId = actionFactory.stats_id;
+      auto const recordLive = [&](statistics::ActionOutcome outcome) {
+        liveInterval.recordAction(
+            outcome, std::chrono::steady_clock::now() - actionStarted,
+            actionId);
+      };
+      stats.startAction(actionId);
       sql_conn->resetAccumulatedSqlTime();
-      sql_conn->setCurrentAction(actionFactory.name);
+      sql_conn->setCurrentAction(actionId);
+      if (recorder) {
+        recorder->beginAction(actionFactory.name, actionFactory.type);
+      }
 
       try {
-        metadata::Context actionCtx(*metadata);
+        metadata::Context actionCtx(*metadata, nullptr, turns.turns());
         action->execute(actionCtx, rand, sql_conn.get());
         auto sqlTime = sql_conn->getAccumulatedSqlTime();
-        stats.recordSuccess(actionFactory.name, sqlTime);
+        stats.recordSuccess(actionId, sqlTime);
+        recordLive(statistics::ActionOutcome::success);
+
+      } catch (const action::ActionSkipped &e) {
+        logger->debug("Worker {} Action skipped: {}", name, e.what());
 
       } catch (const action::ActionException &e) {
         auto sqlTime = sql_conn->getAccumulatedSqlTime();
-        stats.recordActionFailure(actionFactory.name, e.getErrorName(),
-                                  sqlTime);
+        stats.recordActionFailure(
+            actionId, statistics::NameTable::intern(e.getErrorName()), sqlTime);
+        recordLive(statistics::ActionOutcome::actionFailure);
         logger->warn("Worker {} Action failed ({}): {}", name, e.getErrorName(),
                      e.what());
 
       } catch (const sql_variant::SqlException &e) {
         auto sqlTime = sql_conn->getAccumulatedSqlTime();
         if (e.errorClass() == sql_variant::ErrorClass::conflict) {
-          stats.recordConflict(actionFactory.name, e.getErrorCode(), sqlTime);
+          stats.recordConflict(
+              actionId, statistics::NameTable::intern(e.getErrorCode()),
+              sqlTime);
+          recordLive(statistics::ActionOutcome::conflict);
           logger->info("Worker {} conflict ({}): {}", name, e.getErrorCode(),
                        e.what());
         } else {
-          stats.recordSqlFailure(actionFactory.name, e.getErrorCode(), sqlTime);
+          stats.recordSqlFailure(
+              actionId, statistics::NameTable::intern(e.getErrorCode()),
+              sqlTime);
+          recordLive(statistics::ActionOutcome::sqlFailure);
           logger->warn("Worker {} SQL failed ({}): {}", name, e.getErrorCode(),
                        e.what());
         }
         if (e.serverGone()) {
-          connectionAttempts++;
-
-          if (connectionAttempts <= config.max_reconnect_attempts) {
-
-            if (connectionAttempts > 1) {
-              std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-            }
-
-            logger->warn("Lost connection to the server, trying to reconnect");
-            // reconnect replaces the connection, drain before it is destroyed
-            drainIntoStats();
-            reconnect();
-          } else {
-            logger->error("Failed to connect {} times, stopping worker",
-                          config.max_reconnect_attempts);
-            drainIntoStats();
+          // reconnect replaces the connection, drain before it is destroyed
+          drainObservations(stats, &liveInterval);
+          auto const downtime = recoverConnection(connectionAttempts);
+          if (!downtime) {
             break;
           }
+          stats.recordReconnect(*downtime);
+          liveInterval.reconnects++;
         }
 
       } catch (const std::exception &e) {
         auto sqlTime = sql_conn->getAccumulatedSqlTime();
-        stats.recordOtherFailure(actionFactory.name, sqlTime);
+        stats.recordOtherFailure(actionId, sqlTime);
+        recordLive(statistics::ActionOutcome::otherFailure);
         logger->warn("Worker {} Action failed (other): {}", name, e.what());
       }
 
-      drainIntoStats();
-
-      now = std::chrono::steady_clock::now();
+      if (recorder) {
+        recorder->endAction();
+      }
+      drainObservations(stats, &liveInterval);
     }
 
+    disarmStop();
+    if (recorder) {
+      recorder->flush();
+    }
+    turns.retire();
     stats.stop();
+    publishInterval();
+    if (run.phases) {
+      // phases the run didn't reach end where it ended
+      closePhases(run.phases->size());
+    }
     // post-loop utility queries (checksums, validation) must not accumulate
     // under a stale action name
     sql_conn->setCurrentAction("");
@@ -271,24 +583,242 @@ void RandomWorker::join() {
 
 action::ActionRegistry &RandomWorker::possibleActions() { return actions; }
 
+void RandomWorker::set_weight(std::string const &action, std::size_t weight) {
+  if (!actions.has(action)) {
+    throw std::invalid_argument(
+        fmt::format("worker {} has no action {}", name, action));
+  }
+  control->setWeight(action, weight);
+}
+
 const statistics::WorkerStatistics &RandomWorker::statistics() const {
   return stats;
 }
 
+bool RandomWorker::followPhases(
+    std::chrono::steady_clock::time_point deadline) {
+  auto const &profile = run.phases;
+  if (profile == nullptr) {
+    return true;
+  }
+  for (;;) {
+    auto const now = std::chrono::steady_clock::now();
+    auto const current = profile->phaseAt(now);
+    closePhases(current);
+    if (current == profile->size() || now >= deadline) {
+      return false;
+    }
+    auto const &step = profile->phase(current);
+    if (phase != current) {
+      phase = current;
+      // the phase owns the rate: a set_rate() lasts until the next one
+      control->setRate(step.rate);
+      logger->info("Worker {} phase {}: {}", name, current,
+                   phaseSlot < step.workers ? "running" : "idle");
+    }
+    if (phaseSlot < step.workers) {
+      return true;
+    }
+    if (!control->idleUntil(std::min(deadline, profile->phaseEnd(current)))) {
+      return false;
+    }
+  }
+}
+
+void RandomWorker::closePhases(std::size_t current) {
+  auto const ended = std::min(current, run.phases->size());
+  while (phaseStats.size() < ended) {
+    // actions are counted in the phase they started in
+    auto &snapshot = phaseStats.emplace_back(stats);
+    snapshot.stop();
+  }
+}
+
+void RandomWorker::advanceInterval(
+    std::chrono::steady_clock::time_point now) {
+  if (liveRing == nullptr) {
+    return;
+  }
+  auto const current = run.intervals->intervalAt(now);
+  if (current == liveInterval.interval) {
+    return;
+  }
+  publishInterval();
+  liveInterval = {};
+  liveInterval.interval = current;
+}
+
+void RandomWorker::publishInterval() {
+  if (liveRing == nullptr ||
+      (liveInterval.actions() == 0 && liveInterval.reconnects == 0)) {
+    return;
+  }
+  liveInterval.workers = 1;
+  liveRing->publish(liveInterval);
+}
+
+namespace {
+
+// statements sent outside any action, table setup mostly
+std::string const setupName = "setup";
+
+sql_variant::QueryResult play(sql_variant::LoggedSQL &conn,
+                              plan::Statement const &stmt) {
+  switch (stmt.kind) {
+  case plan::Statement::Kind::params:
+    return conn.executeParams(stmt.sql, stmt.params);
+  case plan::Statement::Kind::bulk: {
+    std::size_t next = 0;
+    return conn.bulkLoad(stmt.sql, stmt.columns,
+                         [&stmt, &next](std::string &line) {
+                           if (next == stmt.rows.size()) {
+                             return false;
+                           }
+                           line = stmt.rows[next++];
+                           return true;
+                         });
+  }
+  case plan::Statement::Kind::query:
+    break;
+  }
+  return conn.executeQuery(stmt.sql);
+}
+
+} // namespace
+
+PlanWorker::PlanWorker(std::string const &name,
+                       Worker::sql_connector_t const &sql_connector,
+                       WorkloadParams const &config,
+                       std::string const &plan_path, RunContext const &run)
+    : Worker(name, sql_connector, config,
+             std::make_shared<metadata::TableRegistry>(), run),
+      plan(plan::read_plan(plan_path)) {
+  logger->info("Worker {} loaded plan {}: {} actions", name, plan_path,
+               plan.actions.size());
+}
+
+PlanWorker::~PlanWorker() { join(); }
+
+void PlanWorker::run_thread(std::size_t duration_in_seconds) {
+  spdlog::info("Worker {} starting plan playback, resetting statistics",
+               name);
+  stats.reset();
+  stats.start();
+
+  if (thread.joinable()) {
+    spdlog::error("Error: thread is already running");
+    return;
+  }
+
+  thread = std::thread([this, duration_in_seconds]() {
+    std::size_t connectionAttempts = 0;
+    sql_conn->clearObservations();
+
+    auto const started = awaitStart();
+    stats.start();
+    auto const deadline = started + std::chrono::seconds(duration_in_seconds);
+    armStop();
+
+    for (auto const &act : plan.actions) {
+      if (!control->admit(deadline)) {
+        break;
+      }
+      ++actionCount;
+      auto const &actionName = act.name.empty() ? setupName : act.name;
+      auto const actionId = statistics::NameTable::intern(actionName);
+      stats.startAction(actionId);
+      sql_conn->resetAccumulatedSqlTime();
+      sql_conn->setCurrentAction(actionId);
+
+      // results are checked, not thrown: no exception per failed statement
+      bool inTxn = false;
+      std::optional<sql_variant::QueryResult> failed;
+      for (auto const &stmt : act.statements) {
+        auto res = play(*sql_conn, stmt);
+        if (!res.success()) {
+          failed = std::move(res);
+          break;
+        }
+        if (stmt.txn != plan::TxnEffect::none) {
+          inTxn = stmt.txn == plan::TxnEffect::begin;
+        }
+      }
+
+      auto const sqlTime = sql_conn->getAccumulatedSqlTime();
+      if (!failed) {
+        stats.recordSuccess(actionId, sqlTime);
+        drainObservations(stats);
+        continue;
+      }
+
+      auto const &error = failed->errorInfo;
+      if (error.errorClass == sql_variant::ErrorClass::conflict) {
+        stats.recordConflict(
+            actionId, statistics::NameTable::intern(error.errorCode), sqlTime);
+      } else {
+        stats.recordSqlFailure(
+            actionId, statistics::NameTable::intern(error.errorCode), sqlTime);
+      }
+      logger->warn("Worker {} plan action {} failed ({}): {}", name,
+                   actionName, error.errorCode, error.errorMessage);
+
+      if (!error.serverGone()) {
+        // the rest of the action is skipped; don't leave its
+        // transaction open for the next one
+        if (inTxn) {
+          std::ignore = sql_conn->executeQuery("ROLLBACK;");
+        }
+        drainObservations(stats);
+        continue;
+      }
+
+      drainObservations(stats);
+      auto const downtime = recoverConnection(connectionAttempts);
+      if (!downtime) {
+        break;
+      }
+      stats.recordReconnect(*downtime);
+    }
+
+    disarmStop();
+    stats.stop();
+    sql_conn->setCurrentAction("");
+    sql_conn->clearObservations();
+    spdlog::info("Worker {} finished playback: {} actions, {:.2f}% success, "
+                 "{:.2f} actions/sec",
+                 name, stats.getTotalActionCount(),
+                 stats.getOverallSuccessRate(), stats.getActionsPerSecond());
+  });
+}
+
+void PlanWorker::join() {
+  if (thread.joinable()) {
+    thread.join();
+  }
+  thread = std::thread();
+}
+
+const statistics::WorkerStatistics &PlanWorker::statistics() const {
+  return stats;
+}
+
 Workload::Workload(WorkloadParams const &params,
                    Worker::sql_connector_t const &sql_connector,
                    const metadata_ptr &metadata,
-                   action::ActionRegistry const &actions)
+                   action::ActionRegistry const &actions, RunContext run)
     : duration_in_seconds(params.duration_in_seconds),
-      repeat_times(params.repeat_times), actions(actions) {
+      repeat_times(params.repeat_times), runContext(std::move(run)),
+      actions(actions) {
 
   if (repeat_times == 0) {
     return;
   }
 
+  workers.reserve(params.number_of_workers);
   for (std::size_t idx = 0; idx < params.number_of_workers; ++idx) {
     auto name = fmt::format("Worker {}", idx + 1);
-    workers.emplace_back(name, sql_connector, params, metadata, actions);
+    workers.emplace_back(name, sql_connector, params, metadata, actions,
+                         runContext);
   }
 }
 
@@ -310,6 +840,24 @@ void Workload::reconnect_workers() {
   }
 }
 
+void Workload::pause() {
+  for (auto &worker : workers) {
+    worker.pause();
+  }
+}
+
+void Workload::resume() {
+  for (auto &worker : workers) {
+    worker.resume();
+  }
+}
+
+void Workload::stop() {
+  for (auto &worker : workers) {
+    worker.stop();
+  }
+}
+
 RandomWorker &Workload::worker(std::size_t idx) {
   if (idx == 0 || idx > workers.size()) {
     throw std::runtime_error(
@@ -0,0 +1,79 @@
+#include "workload_phases.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+StartBarrier::StartBarrier(std::size_t participants)
+    : participants_(participants) {
+  if (participants == 0) {
+    throw std::invalid_argument("a start barrier needs participants");
+  }
+}
+
+StartBarrier::clock::time_point
+StartBarrier::arriveAndWait(std::stop_token const &stop) {
+  std::unique_lock lock(mutex_);
+  if (++arrived_ >= participants_ && !released_) {
+    released_ = clock::now();
+    cv_.notify_all();
+  }
+  if (!cv_.wait(lock, stop, [this] { return released_.has_value(); })) {
+    return clock::now();
+  }
+  return *released_;
+}
+
+void StartBarrier::cancel() {
+  std::unique_lock lock(mutex_);
+  if (!released_) {
+    released_ = clock::now();
+  }
+  cv_.notify_all();
+}
+
+PhaseProfile::PhaseProfile(std::vector<Phase> phases)
+    : phases_(std::move(phases)) {
+  if (phases_.empty()) {
+    throw std::invalid_argument("a phase profile needs phases");
+  }
+  std::chrono::milliseconds end{0};
+  for (auto const &phase : phases_) {
+    if (phase.duration.count() <= 0) {
+      throw std::invalid_argument("a phase needs a duration");
+    }
+    if (phase.rate < 0) {
+      throw std::invalid_argument("a phase rate must be >= 0");
+    }
+    end += phase.duration;
+    ends_.push_back(end);
+  }
+}
+
+std::size_t PhaseProfile::enroll() {
+  std::unique_lock lock(mutex_);
+  return enrolled_++;
+}
+
+void PhaseProfile::begin(clock::time_point at) {
+  std::unique_lock lock(mutex_);
+  if (!start_) {
+    start_ = at;
+  }
+}
+
+std::size_t PhaseProfile::phaseAt(clock::time_point now) const {
+  std::unique_lock lock(mutex_);
+  if (!start_ || now < *start_) {
+    return 0;
+  }
+  auto const elapsed = now - *start_;
+  return static_cast<std::size_t>(
+      std::upper_bound(ends_.begin(), ends_.end(), elapsed) - ends_.begin());
+}
+
+PhaseProfile::clock::time_point
+PhaseProfile::phaseEnd(std::size_t phase) const {
+  std::unique_lock lock(mutex_);
+  return start_.value() + ends_.at(phase);
+}
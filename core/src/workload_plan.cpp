@@ -0,0 +1,290 @@
+#include "workload_plan.hpp"
+
+#include <cctype>
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+
+namespace plan {
+
+namespace {
+
+using nlohmann::json;
+
+// next bare word of `text` from `pos`, upper-cased; advances `pos`
+std::string next_word(std::string_view text, std::size_t &pos) {
+  while (pos < text.size() &&
+         std::isspace(static_cast<unsigned char>(text[pos])) != 0) {
+    ++pos;
+  }
+  std::string word;
+  while (pos < text.size() &&
+         std::isalpha(static_cast<unsigned char>(text[pos])) != 0) {
+    word += static_cast<char>(
+        std::toupper(static_cast<unsigned char>(text[pos])));
+    ++pos;
+  }
+  return word;
+}
+
+char const *type_name(action::ActionType type) {
+  switch (type) {
+  case action::ActionType::ddl:
+    return "ddl";
+  case action::ActionType::dml:
+    return "dml";
+  case action::ActionType::transaction:
+    return "transaction";
+  case action::ActionType::other:
+    break;
+  }
+  return "other";
+}
+
+action::ActionType parse_type(std::string_view name) {
+  if (name == "ddl") {
+    return action::ActionType::ddl;
+  }
+  if (name == "dml") {
+    return action::ActionType::dml;
+  }
+  if (name == "transaction") {
+    return action::ActionType::transaction;
+  }
+  return action::ActionType::other;
+}
+
+std::string to_hex(std::string_view bytes) {
+  static constexpr std::string_view digits = "0123456789abcdef";
+  std::string out;
+  out.reserve(bytes.size() * 2);
+  for (auto const c : bytes) {
+    auto const b = static_cast<unsigned char>(c);
+    out += digits[b >> 4];
+    out += digits[b & 0xF];
+  }
+  return out;
+}
+
+std::string from_hex(std::string_view hex) {
+  auto nibble = [&hex](char c) {
+    if (c >= '0' && c <= '9') {
+      return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+      return c - 'a' + 10;
+    }
+    throw std::invalid_argument(fmt::format("bad hex value: {}", hex));
+  };
+  if (hex.size() % 2 != 0) {
+    throw std::invalid_argument(fmt::format("bad hex value: {}", hex));
+  }
+  std::string out(hex.size() / 2, '\0');
+  for (std::size_t i = 0; i < out.size(); ++i) {
+    out[i] = static_cast<char>((nibble(hex[2 * i]) << 4) |
+                               nibble(hex[(2 * i) + 1]));
+  }
+  return out;
+}
+
+json param_to_json(sql_variant::Param const &p) {
+  if (!p.value) {
+    return nullptr;
+  }
+  if (p.binary) {
+    return json{{"hex", to_hex(*p.value)}};
+  }
+  return *p.value;
+}
+
+sql_variant::Param param_from_json(json const &j) {
+  if (j.is_null()) {
+    return {};
+  }
+  if (j.is_string()) {
+    return {.value = j.get<std::string>(), .binary = false};
+  }
+  return {.value = from_hex(j.at("hex").get<std::string>()), .binary = true};
+}
+
+json statement_to_json(Statement const &stmt) {
+  if (stmt.kind == Statement::Kind::bulk) {
+    return json{
+        {"bulk", stmt.sql}, {"columns", stmt.columns}, {"rows", stmt.rows}};
+  }
+  json out{{"sql", stmt.sql}};
+  if (stmt.kind == Statement::Kind::params) {
+    auto &params = out["params"] = json::array();
+    for (auto const &p : stmt.params) {
+      params.push_back(param_to_json(p));
+    }
+  }
+  if (stmt.txn != TxnEffect::none) {
+    out["txn"] = stmt.txn == TxnEffect::begin ? "begin" : "end";
+  }
+  return out;
+}
+
+Statement statement_from_json(json const &j) {
+  Statement stmt;
+  if (j.contains("bulk")) {
+    stmt.kind = Statement::Kind::bulk;
+    stmt.sql = j.at("bulk").get<std::string>();
+    stmt.columns = j.at("columns").get<std::vector<std::string>>();
+    stmt.rows = j.at("rows").get<std::vector<std::string>>();
+    return stmt;
+  }
+  stmt.sql = j.at("sql").get<std::string>();
+  if (j.contains("params")) {
+    stmt.kind = Statement::Kind::params;
+    for (auto const &p : j.at("params")) {
+      stmt.params.push_back(param_from_json(p));
+    }
+  }
+  if (j.contains("txn")) {
+    stmt.txn = j.at("txn").get<std::string>() == "begin" ? TxnEffect::begin
+                                                         : TxnEffect::end;
+  }
+  return stmt;
+}
+
+} // namespace
+
+TxnEffect txn_effect(std::string_view query) {
+  std::size_t pos = 0;
+  auto const first = next_word(query, pos);
+  if (first == "BEGIN") {
+    return TxnEffect::begin;
+  }
+  if (first == "START") {
+    return next_word(query, pos) == "TRANSACTION" ? TxnEffect::begin
+                                                  : TxnEffect::none;
+  }
+  if (first == "COMMIT") {
+    return TxnEffect::end;
+  }
+  if (first == "ROLLBACK") {
+    auto const second = next_word(query, pos);
+    return second == "TO" ? TxnEffect::none : TxnEffect::end;
+  }
+  return TxnEffect::none;
+}
+
+Plan read_plan(std::string const &path) {
+  std::ifstream in(path);
+  if (!in) {
+    throw std::invalid_argument(fmt::format("cannot read plan file {}", path));
+  }
+
+  Plan plan;
+  std::string line;
+  std::size_t lineNo = 0;
+  try {
+    while (std::getline(in, line)) {
+      ++lineNo;
+      if (line.empty()) {
+        continue;
+      }
+      auto const j = json::parse(line);
+      if (lineNo == 1) {
+        auto const version = j.at("plan").get<std::uint64_t>();
+        if (version > formatVersion) {
+          throw std::invalid_argument(fmt::format(
+              "plan format {} is newer than {}", version, formatVersion));
+        }
+        plan.worker = j.value("worker", "");
+        plan.seed = j.value("seed", std::uint64_t{0});
+        continue;
+      }
+      Action act;
+      act.name = j.at("action").get<std::string>();
+      act.type = parse_type(j.value("type", "other"));
+      for (auto const &stmt : j.at("stmts")) {
+        act.statements.push_back(statement_from_json(stmt));
+      }
+      plan.actions.push_back(std::move(act));
+    }
+  } catch (json::exception const &e) {
+    throw std::invalid_argument(
+        fmt::format("{}:{}: malformed plan: {}", path, lineNo, e.what()));
+  }
+  if (lineNo == 0) {
+    throw std::invalid_argument(fmt::format("{}: empty plan", path));
+  }
+  return plan;
+}
+
+PlanRecorder::PlanRecorder(std::string const &path, std::string const &worker,
+                           std::uint64_t seed)
+    : out_(path, std::ios::trunc) {
+  if (!out_) {
+    throw std::invalid_argument(
+        fmt::format("cannot create plan file {}", path));
+  }
+  out_ << json{{"plan", formatVersion}, {"worker", worker}, {"seed", seed}}
+              .dump()
+       << '\n';
+}
+
+PlanRecorder::~PlanRecorder() { flush(); }
+
+void PlanRecorder::beginAction(std::string const &name,
+                               action::ActionType type) {
+  writeCurrent();
+  current_.name = name;
+  current_.type = type;
+}
+
+void PlanRecorder::endAction() {
+  writeCurrent();
+  current_.name.clear();
+  current_.type = action::ActionType::other;
+}
+
+void PlanRecorder::statement(std::string const &query,
+                             std::vector<sql_variant::Param> const *params) {
+  Statement stmt;
+  stmt.sql = query;
+  stmt.txn = txn_effect(query);
+  if (params != nullptr) {
+    stmt.kind = Statement::Kind::params;
+    stmt.params = *params;
+  }
+  current_.statements.push_back(std::move(stmt));
+}
+
+void PlanRecorder::bulkLoad(std::string const &table,
+                            std::vector<std::string> const &columns,
+                            std::vector<std::string> const &rows) {
+  current_.statements.push_back({.kind = Statement::Kind::bulk,
+                                 .sql = table,
+                                 .params = {},
+                                 .txn = TxnEffect::none,
+                                 .columns = columns,
+                                 .rows = rows});
+}
+
+void PlanRecorder::flush() {
+  writeCurrent();
+  out_.flush();
+}
+
+void PlanRecorder::writeCurrent() {
+  if (current_.statements.empty()) {
+    return;
+  }
+  json stmts = json::array();
+  for (auto const &stmt : current_.statements) {
+    stmts.push_back(statement_to_json(stmt));
+  }
+  // replace, not throw: the worker thread can't take an exception here
+  out_ << json{{"action", current_.name},
+               {"type", type_name(current_.type)},
+               {"stmts", std::move(stmts)}}
+              .dump(-1, ' ', false, json::error_handler_t::replace)
+       << '\n';
+  current_.statements.clear();
+  ++written_;
+}
+
+} // namespace plan
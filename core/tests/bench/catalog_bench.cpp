@@ -0,0 +1,133 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <fmt/format.h>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+#include "metadata/context.hpp"
+#include "metadata/table.hpp"
+
+using namespace metadata;
+
+namespace {
+
+constexpr std::size_t tableCount = 64;
+constexpr std::array<std::size_t, 3> backgroundThreads{0, 3, 7};
+
+Table makeTable(ObjectId id, std::size_t n) {
+  Table t;
+  t.id = id;
+  t.name = fmt::format("t{}", n);
+  t.columns.push_back({.name = "id",
+                       .type = ColumnType::INT,
+                       .nullable = false,
+                       .primary_key = true});
+  for (std::size_t c = 1; c < 8; ++c) {
+    t.columns.push_back(
+        {.name = fmt::format("c{}", c), .type = ColumnType::VARCHAR});
+  }
+  return t;
+}
+
+std::vector<ObjectId> fillCatalog(TableRegistry &reg) {
+  std::vector<ObjectId> ids;
+  for (std::size_t i = 0; i < tableCount; ++i) {
+    ids.push_back(reg.nextId());
+    reg.get<Table>().insert(makeTable(ids.back(), i));
+  }
+  return ids;
+}
+
+// what a DDL action does to a table: copy, touch one column, republish
+bool touchColumn(Table &t) {
+  t.columns.back().length++;
+  return true;
+}
+
+// workers hammering the catalog for the lifetime of the object: mostly
+// picks, every 8th operation an update
+class Contention {
+public:
+  Contention(Catalog<Table> &catalog, std::vector<ObjectId> const &ids,
+             std::size_t threads) {
+    for (std::size_t t = 0; t < threads; ++t) {
+      workers.emplace_back([&catalog, &ids, t](std::stop_token stop) {
+        ps_random rand(t + 1);
+        for (std::size_t op = 0; !stop.stop_requested(); ++op) {
+          if (op % 8 == 0) {
+            std::ignore = catalog.update(
+                ids[rand.random_number<std::size_t>(0, ids.size() - 1)],
+                touchColumn);
+          } else {
+            std::ignore = catalog.randomPick(rand);
+          }
+        }
+      });
+    }
+  }
+
+private:
+  std::vector<std::jthread> workers;
+};
+
+} // namespace
+
+TEST_CASE("catalog randomPick and update under contention",
+          "[bench][catalog]") {
+  TableRegistry reg;
+  auto const ids = fillCatalog(reg);
+  auto &catalog = reg.get<Table>();
+  ps_random rand(42);
+
+  for (auto const threads : backgroundThreads) {
+    Contention const contention(catalog, ids, threads);
+
+    BENCHMARK(fmt::format("randomPick, {} contending threads", threads)) {
+      return catalog.randomPick(rand);
+    };
+
+    BENCHMARK(fmt::format("update, {} contending threads", threads)) {
+      return catalog.update(
+          ids[rand.random_number<std::size_t>(0, ids.size() - 1)],
+          touchColumn);
+    };
+  }
+}
+
+TEST_CASE("TxnBuffer replay", "[bench][catalog]") {
+  TableRegistry reg;
+  auto const ids = fillCatalog(reg);
+  auto &catalog = reg.get<Table>();
+
+  // a long transaction: 16 creates and 48 alters of existing tables
+  auto const fill = [&](TxnBuffer<Table> &txn) {
+    for (std::size_t i = 0; i < 16; ++i) {
+      txn.insert(makeTable(reg.nextId(), tableCount + i));
+    }
+    for (std::size_t i = 0; i < 48; ++i) {
+      std::ignore = txn.update(ids[i % ids.size()], touchColumn, catalog);
+    }
+  };
+
+  BENCHMARK_ADVANCED("rollbackTo (overlay rebuild), 64 ops")
+  (Catch::Benchmark::Chronometer meter) {
+    TxnBuffer<Table> txn;
+    fill(txn);
+    meter.measure([&] {
+      txn.rollbackTo(txn.mark(), catalog);
+      return txn.mark();
+    });
+  };
+
+  BENCHMARK_ADVANCED("publishAll, 64 ops")
+  (Catch::Benchmark::Chronometer meter) {
+    std::vector<TxnBuffer<Table>> txns(meter.runs());
+    for (auto &txn : txns) {
+      fill(txn);
+    }
+    meter.measure([&](int i) { txns[i].publishAll(catalog); });
+  };
+}
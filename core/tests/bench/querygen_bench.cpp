@@ -0,0 +1,99 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <fmt/format.h>
+
+#include "querygen/generator.hpp"
+#include "querygen/render.hpp"
+#include "sql_dialect/dialect.hpp"
+
+using namespace querygen;
+using namespace metadata;
+
+namespace {
+
+constexpr std::array<std::size_t, 3> schemaWidths{4, 16, 64};
+
+// four tables of `width` columns cycling through every type, each after
+// the first with an FK to its predecessor
+void fillCatalog(TableRegistry &reg, std::size_t width) {
+  constexpr std::array<ColumnType, 5> types{
+      ColumnType::INT, ColumnType::VARCHAR, ColumnType::REAL, ColumnType::BOOL,
+      ColumnType::TEXT};
+  ObjectId prev = 0;
+  for (std::size_t t = 0; t < 4; ++t) {
+    Table tab;
+    tab.id = reg.nextId();
+    tab.name = fmt::format("t{}_tab", t);
+    tab.columns.push_back({.name = "id",
+                           .type = ColumnType::INT,
+                           .nullable = false,
+                           .primary_key = true,
+                           .auto_increment = true});
+    for (std::size_t c = 1; c < width; ++c) {
+      Column col{.name = fmt::format("c{}", c),
+                 .type = types[c % types.size()],
+                 .length = 32};
+      if (c == 1 && prev != 0) {
+        col.type = ColumnType::INT;
+        col.foreign_key_references = Ref<Table>{prev};
+      }
+      tab.columns.push_back(col);
+    }
+    prev = tab.id;
+    reg.get<Table>().insert(std::move(tab));
+  }
+}
+
+sql_variant::ServerInfo pgInfo() {
+  return {sql_variant::flavor::postgres, 180000};
+}
+
+} // namespace
+
+TEST_CASE("querygen generate", "[bench][querygen]") {
+  for (auto const width : schemaWidths) {
+    TableRegistry reg;
+    fillCatalog(reg, width);
+    Context ctx(reg);
+    QueryGenConfig const cfg;
+    auto const target = ctx.get<Table>().byName("t1_tab");
+    ps_random rand(42);
+
+    BENCHMARK(fmt::format("generate standalone, {} columns", width)) {
+      Generator gen(ctx, rand, cfg, pgInfo());
+      return gen.generate(Purpose::standalone, nullptr);
+    };
+
+    BENCHMARK(fmt::format("generatePredicate, {} columns", width)) {
+      Generator gen(ctx, rand, cfg, pgInfo());
+      return gen.generatePredicate(target, "t1_tab");
+    };
+  }
+}
+
+TEST_CASE("querygen render", "[bench][querygen]") {
+  TableRegistry reg;
+  fillCatalog(reg, 16);
+  Context ctx(reg);
+  QueryGenConfig const cfg;
+  ps_random rand(42);
+
+  // a fixed pool, so every run renders the same mix of shapes
+  std::vector<QuerySpec> specs;
+  for (int i = 0; i < 256; ++i) {
+    Generator gen(ctx, rand, cfg, pgInfo());
+    specs.push_back(*gen.generate(Purpose::standalone, nullptr));
+  }
+
+  for (auto const *dialect :
+       {&sql_dialect::pg_dialect(), &sql_dialect::mysql_dialect()}) {
+    std::size_t next = 0;
+    BENCHMARK(fmt::format("render, {}", dialect == &sql_dialect::pg_dialect()
+                                            ? "pg"
+                                            : "mysql")) {
+      return render(specs[next++ % specs.size()], *dialect);
+    };
+  }
+}
@@ -0,0 +1,59 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <chrono>
+#include <string>
+
+#include "statistics.hpp"
+
+using namespace statistics;
+using namespace std::chrono_literals;
+
+TEST_CASE("WorkerStatistics record", "[bench][statistics]") {
+  // names as the registry hands them out; a real worker cycles through a
+  // couple dozen
+  std::array<std::string, 4> const actions{"insert_some_data", "update_one_row",
+                                           "delete_some_data", "select_query"};
+  WorkerStatistics stats;
+  stats.start();
+  std::size_t next = 0;
+
+  // what the worker does: ids interned when the registry was built
+  std::array<NameId, 4> ids{};
+  for (std::size_t i = 0; i < actions.size(); ++i) {
+    ids[i] = NameTable::intern(actions[i]);
+  }
+  auto const uniqueViolation = NameTable::intern("23505");
+
+  BENCHMARK("startAction + recordSuccess") {
+    auto const id = ids[next++ % ids.size()];
+    stats.startAction(id);
+    stats.recordSuccess(id, 150us);
+  };
+
+  BENCHMARK("startAction + recordSuccess by name") {
+    auto const &name = actions[next++ % actions.size()];
+    stats.startAction(name);
+    stats.recordSuccess(name, 150us);
+  };
+
+  BENCHMARK("recordSqlFailure") {
+    stats.recordSqlFailure(ids[next++ % ids.size()], uniqueViolation, 80us);
+  };
+
+  BENCHMARK("recordConflict") {
+    stats.recordConflict(ids[next++ % ids.size()], NameTable::intern("40001"),
+                         80us);
+  };
+
+  BENCHMARK("recordRows") {
+    auto const n = next++;
+    stats.recordRows(ids[n % ids.size()], RowKind::select, n % 100);
+  };
+
+  BENCHMARK("recordTransaction") {
+    stats.recordTransaction(
+        {.end = TransactionOutcome::End::committed, .subOk = 5});
+  };
+}
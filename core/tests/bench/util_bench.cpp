@@ -0,0 +1,60 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <fmt/format.h>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "checksum.hpp"
+#include "random.hpp"
+#include "sql_variant/generic.hpp"
+
+TEST_CASE("classifyStatement", "[bench][sql]") {
+  std::array<std::string_view, 4> const queries{
+      "SELECT t0.id AS c0 FROM t1_tab t0 WHERE (t0.id > 5)",
+      "  /* worker-3 */ INSERT INTO t1_tab (c1, c2) VALUES (1, 'x')",
+      "-- retry\nUPDATE t1_tab SET c1 = 2 WHERE id = 7",
+      "WITH d AS (SELECT 1) DELETE FROM t1_tab WHERE id IN (SELECT * FROM d)"};
+  std::size_t next = 0;
+
+  BENCHMARK("classifyStatement") {
+    return sql_variant::classifyStatement(queries[next++ % queries.size()]);
+  };
+}
+
+TEST_CASE("checksum buildRowHash", "[bench][checksum]") {
+  for (std::size_t const width : {4, 16, 64}) {
+    std::vector<std::string> values;
+    for (std::size_t c = 0; c < width; ++c) {
+      values.push_back(fmt::format("value-{:08}", c * 7919));
+    }
+    sql_variant::RowView row;
+    for (std::size_t c = 0; c < width; ++c) {
+      // every 5th column NULL
+      row.rowData.emplace_back(c % 5 == 4 ? std::nullopt
+                                          : std::optional<std::string_view>(
+                                                values[c]));
+    }
+
+    BENCHMARK(fmt::format("buildRowHash, {} columns", width)) {
+      return detail::buildRowHash(row);
+    };
+  }
+}
+
+TEST_CASE("ps_random random_string", "[bench][random]") {
+  ps_random rand(42);
+
+  for (std::size_t const len : {8, 32, 256}) {
+    BENCHMARK(fmt::format("random_string, {} chars", len)) {
+      return rand.random_string(len, len);
+    };
+  }
+
+  BENCHMARK("random_number<std::size_t>") {
+    return rand.random_number<std::size_t>(0, 1000);
+  };
+}
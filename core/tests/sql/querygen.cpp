@@ -51,14 +51,15 @@ TEST_CASE("select_query action runs clean on seeded schema",
   metadata::Context ctx(reg);
 
   action::AllConfig config;
+  action::RunState const state;
   auto const &registry =
       action::default_registry(sqlConnection->serverInfo().flavor_);
   auto factory = registry["select_query"];
   ps_random rand(1234);
 
   for (int i = 0; i < 100; ++i) {
-    auto act = factory.builder(
-        action::BuildContext{.config = config, .registry = registry});
+    auto act = factory.builder(action::BuildContext{
+        .config = config, .registry = registry, .state = state});
     REQUIRE_NOTHROW(act->execute(ctx, rand, sqlConnection.get()));
   }
 }
@@ -71,6 +72,7 @@ TEST_CASE("dml actions with generated predicates run clean",
   metadata::Context ctx(reg);
 
   action::AllConfig config;
+  action::RunState const state;
   config.querygen.dml_predicate_prob = 100;
   auto const &registry =
       action::default_registry(sqlConnection->serverInfo().flavor_);
@@ -79,8 +81,8 @@ TEST_CASE("dml actions with generated predicates run clean",
   for (auto const &name : {"delete_some_data", "update_one_row"}) {
     auto factory = registry[name];
     for (int i = 0; i < 100; ++i) {
-      auto act = factory.builder(
-          action::BuildContext{.config = config, .registry = registry});
+      auto act = factory.builder(action::BuildContext{
+          .config = config, .registry = registry, .state = state});
       REQUIRE_NOTHROW(act->execute(ctx, rand, sqlConnection.get()));
     }
   }
@@ -94,6 +96,7 @@ TEST_CASE("select-then-modify with generated pk-select runs clean",
   metadata::Context ctx(reg);
 
   action::AllConfig config;
+  action::RunState const state;
   config.querygen.dml_pk_select_prob = 100;
   auto const &registry =
       action::default_registry(sqlConnection->serverInfo().flavor_);
@@ -103,8 +106,8 @@ TEST_CASE("select-then-modify with generated pk-select runs clean",
     for (auto const &name : {"delete_selected", "update_selected"}) {
       auto factory = registry[name];
       for (int i = 0; i < 100; ++i) {
-        auto act = factory.builder(
-            action::BuildContext{.config = config, .registry = registry});
+        auto act = factory.builder(action::BuildContext{
+            .config = config, .registry = registry, .state = state});
         REQUIRE_NOTHROW(act->execute(ctx, rand, sqlConnection.get()));
       }
     }
@@ -118,8 +121,8 @@ TEST_CASE("select-then-modify with generated pk-select runs clean",
       auto factory = registry[name];
       for (int i = 0; i < 100; ++i) {
         sqlConnection->executeQuery("BEGIN;").maybeThrow();
-        auto act = factory.builder(
-            action::BuildContext{.config = config, .registry = registry});
+        auto act = factory.builder(action::BuildContext{
+            .config = config, .registry = registry, .state = state});
         REQUIRE_NOTHROW(act->execute(trxCtx, rand, sqlConnection.get()));
         sqlConnection->executeQuery("COMMIT;").maybeThrow();
       }
@@ -183,7 +186,7 @@ TEST_CASE("select_query throws empty-metadata on empty catalog",
           "[querygen][sql]") {
   metadata::TableRegistry reg;
   metadata::Context ctx(reg);
-  action::SelectQuery act{querygen::QueryGenConfig{}};
+  action::SelectQuery act{querygen::QueryGenConfig{}, action::RunState{}};
   ps_random rand(1);
   try {
     act.execute(ctx, rand, sqlConnection.get());
@@ -48,7 +48,8 @@ TEST_CASE_PERSISTENT_FIXTURE(Fixture, "transactions") {
 
     config.transaction.commit_probability = 100;
     action::TransactionAction trx(
-        config, action::default_registry(sqlConnection->serverInfo().flavor_));
+        config, action::default_registry(sqlConnection->serverInfo().flavor_),
+        {});
     for (int i = 0; i < 100; ++i) {
       REQUIRE_NOTHROW(trx.execute(ctx, rand, sqlConnection.get()));
     }
@@ -65,7 +66,8 @@ TEST_CASE_PERSISTENT_FIXTURE(Fixture, "transactions") {
     // buffer is discarded for every action type.
     config.transaction.commit_probability = 0; // always ROLLBACK
     action::TransactionAction trx(
-        config, action::default_registry(sqlConnection->serverInfo().flavor_));
+        config, action::default_registry(sqlConnection->serverInfo().flavor_),
+        {});
     for (int i = 0; i < 50; ++i) {
       REQUIRE_NOTHROW(trx.execute(ctx, rand, sqlConnection.get()));
     }
@@ -86,7 +88,7 @@ TEST_CASE_PERSISTENT_FIXTURE(Fixture, "transactions") {
     config.transaction.error_mode =
         action::TransactionConfig::ErrorMode::savepoint;
     config.transaction.commit_probability = 100;
-    action::TransactionAction trx(config, pool);
+    action::TransactionAction trx(config, pool, {});
     for (int i = 0; i < 100; ++i) {
       REQUIRE_NOTHROW(trx.execute(ctx, rand, sqlConnection.get()));
     }
@@ -104,7 +106,7 @@ TEST_CASE_PERSISTENT_FIXTURE(Fixture, "transactions") {
     pool.makeCustomSqlAction("boom", "SELECT * FROM no_such_table_ever;", 1000);
 
     config.transaction.error_mode = action::TransactionConfig::ErrorMode::abort;
-    action::TransactionAction trx(config, pool);
+    action::TransactionAction trx(config, pool, {});
     REQUIRE_THROWS_AS(trx.execute(ctx, rand, sqlConnection.get()),
                       sql_variant::SqlException);
     // connection must be usable again immediately (guard rolled back)
@@ -136,7 +138,7 @@ TEST_CASE_PERSISTENT_FIXTURE(Fixture, "transactions") {
     config.transaction.mysql_ddl_mode =
         action::TransactionConfig::MysqlDdlMode::mirror;
     config.transaction.commit_probability = 100;
-    action::TransactionAction trx(config, pool);
+    action::TransactionAction trx(config, pool, {});
     for (int i = 0; i < 10; ++i) {
       REQUIRE_NOTHROW(trx.execute(ctx, rand, sqlConnection.get()));
     }
@@ -174,7 +176,7 @@ TEST_CASE_PERSISTENT_FIXTURE(Fixture, "transactions") {
         action::TransactionConfig::MysqlDdlMode::mirror;
     config.transaction.error_mode =
         action::TransactionConfig::ErrorMode::savepoint;
-    action::TransactionAction trx(config, pool);
+    action::TransactionAction trx(config, pool, {});
     for (int i = 0; i < 10; ++i) {
       REQUIRE_NOTHROW(trx.execute(ctx, rand, sqlConnection.get()));
     }
@@ -196,7 +198,8 @@ TEST_CASE_PERSISTENT_FIXTURE(Fixture, "transactions") {
     config.transaction.error_mode =
         action::TransactionConfig::ErrorMode::savepoint;
     action::TransactionAction trx(
-        config, action::default_registry(sqlConnection->serverInfo().flavor_));
+        config, action::default_registry(sqlConnection->serverInfo().flavor_),
+        {});
     for (int i = 0; i < 30; ++i) {
       REQUIRE_NOTHROW(trx.execute(ctx, rand, sqlConnection.get()));
     }
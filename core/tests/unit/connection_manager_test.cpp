@@ -0,0 +1,140 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <fmt/format.h>
+#include <thread>
+#include <vector>
+
+#include "sim_connector.hpp"
+#include "sql_variant/connection_manager.hpp"
+#include "sql_variant/connection_pool.hpp"
+#include "sql_variant/sim.hpp"
+#include "workload.hpp"
+
+using namespace sql_variant;
+using namespace std::chrono_literals;
+using testutil::sim_connector;
+
+namespace {
+
+// a restart refuses the next `downConnects` connections
+std::shared_ptr<SimServer> sim_server(std::size_t downConnects) {
+  return std::make_shared<SimServer>(
+      SimParams{.sleep = false, .down_connects = downConnects});
+}
+
+constexpr ReconnectBackoff fast_backoff{.initial = 1ms, .max = 4ms};
+
+} // namespace
+
+TEST_CASE("one probe brings every waiting worker back",
+          "[sql][connection_manager]") {
+  auto const server = sim_server(6);
+  ConnectionManager manager(0, 5s, fast_backoff);
+  server->crash();
+
+  std::vector<std::unique_ptr<LoggedSQL>> conns(4);
+  std::vector<std::thread> workers;
+  for (std::size_t i = 0; i < conns.size(); ++i) {
+    workers.emplace_back([&, i] {
+      auto const name = fmt::format("cm-parallel-{}", i);
+      conns[i] = manager.connect(sim_connector(server, name), name);
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  for (auto const &conn : conns) {
+    REQUIRE(conn != nullptr);
+    REQUIRE(conn->executeQuery("SELECT 1").success());
+  }
+  // every refused connect failed exactly once, by the prober or by a worker
+  // that tried before the outage was known
+  REQUIRE(manager.failedAttempts() == 6);
+  REQUIRE(manager.outages() == 1);
+  REQUIRE(manager.lastDowntime() > 0ns);
+}
+
+TEST_CASE("reconnecting gives up after the patience runs out",
+          "[sql][connection_manager]") {
+  auto const server = sim_server(1000000);
+  ConnectionManager manager(0, 50ms, fast_backoff);
+  server->crash();
+
+  auto const start = std::chrono::steady_clock::now();
+  REQUIRE_THROWS_AS(
+      manager.connect(sim_connector(server, "cm-patience"), "cm-patience"),
+      SqlException);
+  REQUIRE(std::chrono::steady_clock::now() - start < 5s);
+  REQUIRE(manager.outages() == 1);
+  REQUIRE(manager.failedAttempts() > 1);
+}
+
+TEST_CASE("spares are opened ahead and handed out first",
+          "[sql][connection_manager]") {
+  auto const server = sim_server(3);
+  ConnectionManager manager(2, 5s, fast_backoff);
+  manager.setConnector(sim_connector(server, "cm-spares"));
+
+  auto const deadline = std::chrono::steady_clock::now() + 5s;
+  while (manager.idle() < 2 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(1ms);
+  }
+  REQUIRE(manager.idle() == 2);
+
+  // a connector that never gets through: only a spare can serve
+  auto const refused = [] { return std::unique_ptr<LoggedSQL>(); };
+  auto const conn = manager.connect(refused, "cm-spare-taken");
+  REQUIRE(conn != nullptr);
+  REQUIRE(conn->executeQuery("SELECT 1").success());
+
+  // spares opened before a restart die with it and are dropped
+  server->crash();
+  auto const back =
+      manager.connect(sim_connector(server, "cm-after"), "cm-after");
+  REQUIRE(back->executeQuery("SELECT 1").success());
+  REQUIRE(manager.outages() == 1);
+}
+
+TEST_CASE("pooled connections that died are replaced on acquire",
+          "[sql][connection_pool]") {
+  auto const server = sim_server(0);
+  ConnectionPool pool;
+  pool.setConnector(sim_connector(server, "pool-probe"));
+  for (auto &conn : pool.acquire(2)) {
+    pool.release(std::move(conn));
+  }
+  REQUIRE(pool.idle() == 2);
+
+  server->crash();
+  auto const conns = pool.acquire(2);
+  REQUIRE(conns.size() == 2);
+  for (auto const &conn : conns) {
+    REQUIRE(conn->executeQuery("SELECT 1").success());
+  }
+  REQUIRE(pool.idle() == 0);
+}
+
+TEST_CASE("workers record how long they took to get back",
+          "[sql][connection_manager]") {
+  auto const server = std::make_shared<SimServer>(SimParams{
+      .seed = 2, .sleep = false, .server_gone_rate = 0.05});
+  WorkloadParams params;
+  params.seed = 2;
+  params.max_actions = 200;
+  RunContext run;
+  run.connection_manager =
+      std::make_shared<ConnectionManager>(1, 5s, fast_backoff);
+  action::ActionRegistry registry;
+  registry.makeCustomSqlAction("select", "SELECT 1", 1);
+  RandomWorker worker("cm-worker", sim_connector(server, "cm-worker"), params,
+                      std::make_shared<metadata::TableRegistry>(), registry,
+                      run);
+  worker.run_thread(60);
+  worker.join();
+
+  auto const &reconnects = worker.statistics().reconnectTiming;
+  REQUIRE(worker.statistics().getTotalActionCount() == 200);
+  REQUIRE(reconnects.count > 0);
+  REQUIRE(reconnects.count == run.connection_manager->outages());
+}
@@ -170,6 +170,23 @@ TEST_CASE("pg randomRowsSelect", "[dialect]") {
           "SELECT id FROM foo1 ORDER BY random() LIMIT 5 FOR SHARE;");
 }
 
+TEST_CASE("pg insertReturning", "[dialect]") {
+  REQUIRE(pg_dialect().insertReturning("id") == " RETURNING id");
+}
+
+TEST_CASE("pg explainJson", "[dialect]") {
+  REQUIRE(pg_dialect().explainJson("SELECT 1") ==
+          "EXPLAIN (FORMAT JSON) SELECT 1");
+}
+
+TEST_CASE("pg snapshot sharing", "[dialect]") {
+  auto const &dialect = pg_dialect();
+
+  REQUIRE(dialect.exportSnapshot() == "SELECT pg_export_snapshot();");
+  REQUIRE(dialect.importSnapshot("00000003-0000001B-1") ==
+          "SET TRANSACTION SNAPSHOT '00000003-0000001B-1';");
+}
+
 TEST_CASE("pg typeName", "[dialect]") {
   auto const &dialect = pg_dialect();
 
@@ -360,6 +377,19 @@ TEST_CASE("mysql randomRowsSelect", "[dialect]") {
           "SELECT id FROM foo1 ORDER BY RAND() LIMIT 5 FOR SHARE;");
 }
 
+TEST_CASE("mysql insertReturning: keys come from insert id", "[dialect]") {
+  REQUIRE(mysql_dialect().insertReturning("id").empty());
+}
+
+TEST_CASE("mysql explainJson", "[dialect]") {
+  REQUIRE(mysql_dialect().explainJson("SELECT 1") ==
+          "EXPLAIN FORMAT=JSON SELECT 1");
+}
+
+TEST_CASE("mysql snapshot sharing", "[dialect]") {
+  REQUIRE(!mysql_dialect().exportSnapshot().has_value());
+}
+
 TEST_CASE("mysql typeName", "[dialect]") {
   auto const &dialect = mysql_dialect();
 
@@ -0,0 +1,76 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "action/grammar.hpp"
+
+using action::ActionType;
+using action::parse_grammar;
+using metadata::Column;
+using metadata::ColumnType;
+using metadata::Context;
+using metadata::Table;
+using metadata::TableRegistry;
+
+namespace {
+
+void addTable(Context &ctx, std::string name) {
+  Table t;
+  t.id = ctx.nextId();
+  t.name = std::move(name);
+  for (auto const *col : {"i1", "i2"}) {
+    Column c;
+    c.name = col;
+    t.columns.push_back(c);
+  }
+  Column v;
+  v.name = "v1";
+  v.type = ColumnType::VARCHAR;
+  v.length = 4;
+  t.columns.push_back(v);
+  REQUIRE(ctx.get<Table>().insert(std::move(t)));
+}
+
+} // namespace
+
+TEST_CASE("grammar files become weighted rules", "[grammar]") {
+  auto const rules = parse_grammar("# comment\n"
+                                   "SELECT T1_INT_1 FROM T1;\n"
+                                   "\n"
+                                   "  -- another comment\n"
+                                   "DELETE FROM T1 WHERE T1_INT_2 > 5;\n"
+                                   "SELECT T1_INT_1 FROM T1;\n"
+                                   "analyze table T1");
+  REQUIRE(rules.size() == 3);
+  REQUIRE(rules[0].line == 2);
+  REQUIRE(rules[0].occurrences == 2);
+  REQUIRE(rules[0].type == ActionType::dml);
+  REQUIRE(rules[1].line == 5);
+  REQUIRE(rules[2].type == ActionType::other);
+  REQUIRE(rules[2].compiled.tableSlots() == 1);
+}
+
+TEST_CASE("grammar placeholders resolve against the catalog", "[grammar]") {
+  TableRegistry reg;
+  Context ctx(reg);
+  addTable(ctx, "t1");
+  addTable(ctx, "t2");
+  ps_random rand(3);
+  auto const &dialect = sql_dialect::dialect_for(
+      {.flavor_ = sql_variant::flavor::mysql, .version = 0});
+
+  auto const tmpl = action::compile_pstress_rule(
+      "UPDATE T1 SET T1_INT_1 = T1_INT_1_VALUE, T1_VARCHAR_1 = 'T2' "
+      "WHERE T1_INT_2 IN (SELECT T2_INT_1 FROM T2) AND T10X = 1");
+  REQUIRE(tmpl.tableSlots() == 2);
+  for (int i = 0; i < 10; ++i) {
+    auto const sql = tmpl.render(ctx, rand, dialect, nullptr);
+    REQUIRE((sql.starts_with("UPDATE t1 SET i") ||
+             sql.starts_with("UPDATE t2 SET i")));
+    REQUIRE(sql.find("v1 = 'T2'") != std::string::npos);
+    REQUIRE(sql.ends_with("AND T10X = 1"));
+    // T1_INT_1 and T1_INT_2 are the two different INT columns
+    REQUIRE(((sql.find("SET i1 =") != std::string::npos &&
+              sql.find("WHERE i2 IN") != std::string::npos) ||
+             (sql.find("SET i2 =") != std::string::npos &&
+              sql.find("WHERE i1 IN") != std::string::npos)));
+  }
+}
@@ -0,0 +1,142 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <map>
+#include <numeric>
+#include <set>
+
+#include "action/key_reservoir.hpp"
+
+using action::KeyReservoir;
+
+namespace {
+
+std::vector<KeyReservoir::Key> keyRange(KeyReservoir::Key from,
+                                        std::size_t count) {
+  std::vector<KeyReservoir::Key> keys(count);
+  std::iota(keys.begin(), keys.end(), from);
+  return keys;
+}
+
+} // namespace
+
+TEST_CASE("reservoir samples only keys it was given", "[reservoir]") {
+  KeyReservoir reservoir;
+  ps_random rand(1);
+  REQUIRE(reservoir.sample(7, 5, rand).empty());
+
+  reservoir.add(7, keyRange(100, 10));
+  REQUIRE(reservoir.size(7) == 10);
+  REQUIRE(reservoir.size(8) == 0);
+
+  auto const picked = reservoir.sample(7, 5, rand);
+  REQUIRE(!picked.empty());
+  REQUIRE(picked.size() <= 5);
+  REQUIRE(std::ranges::is_sorted(picked));
+  REQUIRE(std::ranges::adjacent_find(picked) == picked.end());
+  for (auto const key : picked) {
+    REQUIRE(key >= 100);
+    REQUIRE(key < 110);
+  }
+  REQUIRE(reservoir.sample(8, 5, rand).empty());
+}
+
+TEST_CASE("reservoir removal and forget", "[reservoir]") {
+  KeyReservoir reservoir;
+  ps_random rand(2);
+  reservoir.add(1, keyRange(1, 3));
+  // duplicates are not counted twice
+  reservoir.add(1, keyRange(1, 3));
+  REQUIRE(reservoir.size(1) == 3);
+
+  std::array<KeyReservoir::Key, 3> const gone{1, 3, 42};
+  reservoir.remove(1, gone);
+  REQUIRE(reservoir.size(1) == 1);
+  REQUIRE(reservoir.sample(1, 4, rand) == std::vector<KeyReservoir::Key>{2});
+
+  reservoir.forget(1);
+  REQUIRE(reservoir.size(1) == 0);
+  REQUIRE(reservoir.sample(1, 4, rand).empty());
+}
+
+TEST_CASE("reservoir stays bounded and keeps new keys", "[reservoir]") {
+  KeyReservoir reservoir(100);
+  reservoir.add(1, keyRange(0, 10000));
+  REQUIRE(reservoir.size(1) == 100);
+
+  // a uniform subset: not just the first 100 keys
+  ps_random rand(3);
+  auto const picked = reservoir.sample(1, 100, rand);
+  REQUIRE(picked.back() >= 100);
+}
+
+TEST_CASE("reservoir draws don't depend on its contents", "[reservoir]") {
+  KeyReservoir full;
+  full.add(1, keyRange(0, 50));
+  KeyReservoir const empty;
+
+  ps_random a(4);
+  ps_random b(4);
+  std::ignore = full.sample(1, 10, a);
+  std::ignore = empty.sample(1, 10, b);
+  REQUIRE(a.checkpoint() == b.checkpoint());
+}
+
+TEST_CASE("skewed key distributions", "[reservoir]") {
+  using Kind = action::KeyDistribution::Kind;
+  KeyReservoir reservoir;
+  reservoir.add(1, keyRange(0, 1000));
+
+  // hits on the most popular key out of 2000 single-key picks
+  auto const topHits = [&](action::KeyDistribution const &dist) {
+    ps_random rand(5);
+    std::map<KeyReservoir::Key, std::size_t> hits;
+    for (int i = 0; i < 2000; ++i) {
+      auto const picked = reservoir.sample(1, 1, rand, dist);
+      REQUIRE(picked.size() == 1);
+      ++hits[picked.front()];
+    }
+    std::size_t top = 0;
+    for (auto const &[key, n] : hits) {
+      top = std::max(top, n);
+    }
+    return top;
+  };
+
+  auto const uniform = topHits({});
+  REQUIRE(uniform < 20);
+  REQUIRE(topHits({.kind = Kind::zipfian}) > 10 * uniform);
+
+  // 1% of the keys take 90% of the picks
+  auto const hotspot = action::KeyDistribution{
+      .kind = Kind::hotspot, .hot_fraction = 0.01, .hot_probability = 0.9};
+  ps_random rand(6);
+  std::set<KeyReservoir::Key> hot;
+  for (int i = 0; i < 1000; ++i) {
+    hot.insert(reservoir.sample(1, 1, rand, hotspot).front());
+  }
+  REQUIRE(hot.size() < 200);
+
+  // latest favors the newest keys
+  ps_random latestRand(7);
+  std::size_t recent = 0;
+  for (int i = 0; i < 1000; ++i) {
+    auto const key =
+        reservoir.sample(1, 1, latestRand, {.kind = Kind::latest}).front();
+    recent += key >= 990 ? 1 : 0;
+  }
+  REQUIRE(recent > 300);
+}
+
+TEST_CASE("reservoir hands out one seed scan per interval", "[reservoir]") {
+  using namespace std::chrono_literals;
+  KeyReservoir reservoir;
+  REQUIRE(reservoir.claimSeed(7, 1h));
+  REQUIRE_FALSE(reservoir.claimSeed(7, 1h));
+  REQUIRE(reservoir.claimSeed(8, 1h));
+
+  reservoir.forget(7);
+  REQUIRE(reservoir.claimSeed(7, 1h));
+
+  REQUIRE(reservoir.claimSeed(9, 0s));
+  REQUIRE(reservoir.claimSeed(9, 0s));
+}
@@ -0,0 +1,188 @@
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+
+#include <thread>
+#include <vector>
+
+#include "live_statistics.hpp"
+#include "sim_connector.hpp"
+#include "sql_variant/sim.hpp"
+#include "workload.hpp"
+
+using namespace std::chrono_literals;
+using statistics::ActionOutcome;
+using statistics::IntervalStats;
+using testutil::sim_connector;
+
+namespace {
+
+IntervalStats interval(std::uint64_t number, std::uint64_t successes) {
+  IntervalStats stats;
+  stats.interval = number;
+  stats.workers = 1;
+  for (std::uint64_t i = 0; i < successes; ++i) {
+    stats.recordAction(ActionOutcome::success, 1ms);
+  }
+  return stats;
+}
+
+} // namespace
+
+TEST_CASE("the seqlock ring keeps the last values", "[live_statistics]") {
+  statistics::SeqlockRing<IntervalStats, 4> ring;
+  REQUIRE(ring.published() == 0);
+  REQUIRE_FALSE(ring.read(0).has_value());
+
+  for (std::uint64_t i = 0; i < 6; ++i) {
+    ring.publish(interval(i, i));
+  }
+  REQUIRE(ring.published() == 6);
+  // 0 and 1 were overwritten by 4 and 5
+  REQUIRE_FALSE(ring.read(0).has_value());
+  REQUIRE_FALSE(ring.read(1).has_value());
+  for (std::uint64_t i = 2; i < 6; ++i) {
+    auto const value = ring.read(i);
+    REQUIRE(value.has_value());
+    REQUIRE(value->interval == i);
+    REQUIRE(value->successes == i);
+  }
+  REQUIRE_FALSE(ring.read(6).has_value());
+}
+
+TEST_CASE("intervals merge outcomes and latencies", "[live_statistics]") {
+  IntervalStats fast;
+  for (int i = 0; i < 98; ++i) {
+    fast.recordAction(ActionOutcome::success, 1ms);
+  }
+  fast.recordAction(ActionOutcome::conflict, 1ms);
+  IntervalStats slow;
+  slow.recordAction(ActionOutcome::sqlFailure, 200ms);
+  slow.reconnects = 1;
+
+  fast.merge(slow);
+  REQUIRE(fast.actions() == 100);
+  REQUIRE(fast.failures() == 2);
+  REQUIRE(fast.conflicts == 1);
+  REQUIRE(fast.reconnects == 1);
+  REQUIRE(fast.percentileMs(50) >= 1.0);
+  REQUIRE(fast.percentileMs(50) < 1.1);
+  REQUIRE(fast.percentileMs(100) >= 200.0);
+  REQUIRE(fast.percentileMs(100) < 215.0);
+  REQUIRE(IntervalStats{}.percentileMs(99) == 0.0);
+
+  // beyond the last bucket: counted, not lost
+  IntervalStats stuck;
+  stuck.recordAction(ActionOutcome::otherFailure, 1h);
+  REQUIRE(stuck.otherFailures == 1);
+  REQUIRE(stuck.percentileMs(50) > 100000.0);
+}
+
+TEST_CASE("intervals count actions one by one", "[live_statistics]") {
+  auto const insert = statistics::NameTable::intern("live_insert");
+  auto const select = statistics::NameTable::intern("live_select");
+  IntervalStats first;
+  first.recordAction(ActionOutcome::success, 1ms, insert);
+  first.recordAction(ActionOutcome::conflict, 1ms, insert);
+  first.recordAction(ActionOutcome::sqlFailure, 1ms, select);
+  first.recordAction(ActionOutcome::success, 1ms); // totals only
+  statistics::TransactionOutcome txn;
+  txn.end = statistics::TransactionOutcome::End::committed;
+  first.recordTransaction(txn);
+  REQUIRE(first.byAction[0].action == insert);
+  REQUIRE(first.byAction[0].successes == 1);
+  REQUIRE(first.byAction[0].conflicts == 1);
+  REQUIRE(first.byAction[1].action == select);
+  REQUIRE(first.byAction[1].failures == 1);
+  REQUIRE(first.byAction[2].action == statistics::NameTable::none);
+  REQUIRE(first.latencyMicros == 4000);
+
+  // merged by action, whatever slot it has on the other side
+  IntervalStats second;
+  second.recordAction(ActionOutcome::success, 1ms, select);
+  second.recordTransaction(txn);
+  first.merge(second);
+  REQUIRE(first.byAction[1].successes == 1);
+  REQUIRE(first.byAction[2].action == statistics::NameTable::none);
+  REQUIRE(first.committed == 2);
+
+  // past the slots: still counted, as other actions
+  IntervalStats crowded;
+  for (std::size_t i = 0; i <= IntervalStats::actionSlots; ++i) {
+    crowded.recordAction(
+        ActionOutcome::success, 1ms,
+        statistics::NameTable::intern(fmt::format("live_action_{}", i)));
+  }
+  REQUIRE(crowded.byAction.back().successes == 1);
+  REQUIRE(crowded.otherActions.successes == 1);
+}
+
+TEST_CASE("the collector merges the rings of all workers",
+          "[live_statistics]") {
+  statistics::IntervalCollector collector(1h);
+  REQUIRE(collector.intervalAt(std::chrono::steady_clock::now()) == 0);
+  REQUIRE(collector.intervalAt(std::chrono::steady_clock::now() + 90min) ==
+          1);
+
+  auto first = collector.attach();
+  auto second = collector.attach();
+  first->publish(interval(0, 3));
+  first->publish(interval(1, 2));
+  second->publish(interval(1, 5));
+  collector.collect();
+
+  auto merged = collector.latest(10);
+  REQUIRE(merged.size() == 2);
+  REQUIRE(merged[0].interval == 0);
+  REQUIRE(merged[0].workers == 1);
+  REQUIRE(merged[0].successes == 3);
+  REQUIRE(merged[1].interval == 1);
+  REQUIRE(merged[1].workers == 2);
+  REQUIRE(merged[1].successes == 7);
+  REQUIRE(collector.latest(1).front().interval == 1);
+
+  // a worker that is gone is read to the end first
+  second->publish(interval(2, 4));
+  second.reset();
+  collector.collect();
+  REQUIRE(collector.latest(1).front().successes == 4);
+  collector.collect();
+  REQUIRE(collector.latest(10).size() == 3);
+  // every value once, however often collected
+  auto const totals = collector.totals();
+  REQUIRE(totals.counts.successes == 14);
+  REQUIRE(totals.latency[statistics::LatencyHistogram::bucketOf(
+              1000, IntervalStats::latencySubBits)] == 14);
+  REQUIRE(totals.counts.latency ==
+          std::array<std::uint32_t, IntervalStats::latencyBuckets>{});
+
+  REQUIRE_THROWS_AS(statistics::IntervalCollector(0ms), std::invalid_argument);
+}
+
+TEST_CASE("workers publish while they run", "[live_statistics]") {
+  auto const server = std::make_shared<sql_variant::SimServer>(
+      sql_variant::SimParams{.sleep = false});
+  WorkloadParams params;
+  params.seed = 1;
+  params.target_rate = 200;
+  RunContext run;
+  run.intervals = std::make_shared<statistics::IntervalCollector>(100ms);
+  action::ActionRegistry registry;
+  registry.makeCustomSqlAction("select", "SELECT 1", 1);
+
+  RandomWorker worker("live-1", sim_connector(server, "live-1"), params,
+                      std::make_shared<metadata::TableRegistry>(), registry,
+                      run);
+  worker.run_thread(1);
+  // the collector's own thread picks the intervals up meanwhile
+  std::this_thread::sleep_for(500ms);
+  REQUIRE_FALSE(run.intervals->latest(100).empty());
+  worker.join();
+
+  run.intervals->collect();
+  std::uint64_t actions = 0;
+  for (auto const &stats : run.intervals->latest(100)) {
+    REQUIRE(stats.workers == 1);
+    actions += stats.actions();
+  }
+  REQUIRE(actions == worker.statistics().getTotalActionCount());
+}
@@ -83,16 +83,18 @@ TEST_CASE("LoggedSQL records row observations", "[sql][loggedsql]") {
   (void)conn.executeQuery("UPDATE t SET a=1");
   (void)conn.executeQuery("COMMIT;"); // no observation
 
-  auto obs = conn.drainRowObservations();
+  std::vector<statistics::RowObservation> obs;
+  conn.drainRowObservations(obs);
   REQUIRE(obs.size() == 2);
-  REQUIRE(obs[0].action == "my_select");
-  REQUIRE(obs[0].kind == "select");
+  REQUIRE(statistics::NameTable::name(obs[0].action) == "my_select");
+  REQUIRE(obs[0].kind == statistics::RowKind::select);
   REQUIRE(obs[0].rows == 42);
-  REQUIRE(obs[1].action == "my_update");
-  REQUIRE(obs[1].kind == "update");
+  REQUIRE(statistics::NameTable::name(obs[1].action) == "my_update");
+  REQUIRE(obs[1].kind == statistics::RowKind::update);
   REQUIRE(obs[1].rows == 3);
 
-  REQUIRE(conn.drainRowObservations().empty()); // drained
+  conn.drainRowObservations(obs);
+  REQUIRE(obs.empty()); // drained
 }
 
 TEST_CASE("LoggedSQL WITH classification by result shape", "[sql][loggedsql]") {
@@ -106,9 +108,10 @@ TEST_CASE("LoggedSQL WITH classification by result shape", "[sql][loggedsql]") {
   // fake returns no data for WITH -> falls back to affected as kind "dml"
   (void)conn.executeQuery("WITH w AS (SELECT 1) UPDATE t SET a=1");
 
-  auto obs = conn.drainRowObservations();
+  std::vector<statistics::RowObservation> obs;
+  conn.drainRowObservations(obs);
   REQUIRE(obs.size() == 1);
-  REQUIRE(obs[0].kind == "dml");
+  REQUIRE(obs[0].kind == statistics::RowKind::dml);
   REQUIRE(obs[0].rows == 7);
 }
 
@@ -125,9 +128,10 @@ TEST_CASE("LoggedSQL DML with present-but-fieldless data records affected",
   conn.setCurrentAction("act");
   (void)conn.executeQuery("UPDATE t SET a=1");
 
-  auto obs = conn.drainRowObservations();
+  std::vector<statistics::RowObservation> obs;
+  conn.drainRowObservations(obs);
   REQUIRE(obs.size() == 1);
-  REQUIRE(obs[0].kind == "update");
+  REQUIRE(obs[0].kind == statistics::RowKind::update);
   REQUIRE(obs[0].rows == 11);
 }
 
@@ -145,10 +149,11 @@ TEST_CASE("ActionNameScope restores previous name", "[sql][loggedsql]") {
   }
   (void)conn.executeQuery("SELECT 2");
 
-  auto obs = conn.drainRowObservations();
+  std::vector<statistics::RowObservation> obs;
+  conn.drainRowObservations(obs);
   REQUIRE(obs.size() == 2);
-  REQUIRE(obs[0].action == "sub_action");
-  REQUIRE(obs[1].action == "transaction");
+  REQUIRE(statistics::NameTable::name(obs[0].action) == "sub_action");
+  REQUIRE(statistics::NameTable::name(obs[1].action) == "transaction");
 }
 
 TEST_CASE("LoggedSQL transaction outcomes drain", "[sql][loggedsql]") {
@@ -160,14 +165,17 @@ TEST_CASE("LoggedSQL transaction outcomes drain", "[sql][loggedsql]") {
   out.end = statistics::TransactionOutcome::End::committed;
   conn.recordTransactionOutcome(out);
 
-  auto drained = conn.drainTransactionOutcomes();
+  std::vector<statistics::TransactionOutcome> drained;
+  conn.drainTransactionOutcomes(drained);
   REQUIRE(drained.size() == 1);
   REQUIRE(drained[0].end == statistics::TransactionOutcome::End::committed);
-  REQUIRE(conn.drainTransactionOutcomes().empty());
+  conn.drainTransactionOutcomes(drained);
+  REQUIRE(drained.empty());
 
   conn.recordTransactionOutcome(out);
   conn.clearObservations();
-  REQUIRE(conn.drainTransactionOutcomes().empty());
+  conn.drainTransactionOutcomes(drained);
+  REQUIRE(drained.empty());
 }
 
 TEST_CASE("LoggedSQL executeParams records an observation",
@@ -181,10 +189,11 @@ TEST_CASE("LoggedSQL executeParams records an observation",
   conn.setCurrentAction("act");
   (void)conn.executeParams("SELECT * FROM t", {});
 
-  auto obs = conn.drainRowObservations();
+  std::vector<statistics::RowObservation> obs;
+  conn.drainRowObservations(obs);
   REQUIRE(obs.size() == 1);
-  REQUIRE(obs[0].action == "act");
-  REQUIRE(obs[0].kind == "select");
+  REQUIRE(statistics::NameTable::name(obs[0].action) == "act");
+  REQUIRE(obs[0].kind == statistics::RowKind::select);
   REQUIRE(obs[0].rows == 5);
 }
 
@@ -200,9 +209,10 @@ TEST_CASE("LoggedSQL WITH returning data records kind select",
   conn.setCurrentAction("act");
   (void)conn.executeQuery("WITH w AS (SELECT 1) SELECT * FROM w");
 
-  auto obs = conn.drainRowObservations();
+  std::vector<statistics::RowObservation> obs;
+  conn.drainRowObservations(obs);
   REQUIRE(obs.size() == 1);
-  REQUIRE(obs[0].action == "act");
-  REQUIRE(obs[0].kind == "select");
+  REQUIRE(statistics::NameTable::name(obs[0].action) == "act");
+  REQUIRE(obs[0].kind == statistics::RowKind::select);
   REQUIRE(obs[0].rows == 9);
 }
@@ -0,0 +1,193 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <arpa/inet.h>
+#include <filesystem>
+#include <fmt/format.h>
+#include <fstream>
+#include <netinet/in.h>
+#include <sstream>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "metrics_export.hpp"
+
+using namespace std::chrono_literals;
+using statistics::ActionOutcome;
+using statistics::IntervalStats;
+
+namespace {
+
+bool contains(std::string const &text, std::string const &line) {
+  return text.find(line + "\n") != std::string::npos;
+}
+
+// what one worker did, published into `collector`
+std::shared_ptr<statistics::IntervalRing>
+publishSome(statistics::IntervalCollector &collector) {
+  auto const insert = statistics::NameTable::intern("metrics_insert");
+  auto const quoted = statistics::NameTable::intern("say \"hi\"");
+  IntervalStats stats;
+  stats.workers = 1;
+  stats.recordAction(ActionOutcome::success, 2ms, insert);
+  stats.recordAction(ActionOutcome::success, 2ms, insert);
+  stats.recordAction(ActionOutcome::conflict, 40ms, insert);
+  stats.recordAction(ActionOutcome::sqlFailure, 3s, quoted);
+  stats.reconnects = 1;
+  statistics::TransactionOutcome txn;
+  txn.end = statistics::TransactionOutcome::End::rolledBackError;
+  stats.recordTransaction(txn);
+  auto ring = collector.attach();
+  ring->publish(stats);
+  return ring;
+}
+
+// the response to `request` on 127.0.0.1:port
+std::string fetch(std::uint16_t port, std::string const &request) {
+  int const fd = ::socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(port);
+  REQUIRE(::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) ==
+          0);
+  REQUIRE(::send(fd, request.data(), request.size(), 0) ==
+          static_cast<ssize_t>(request.size()));
+  std::string response;
+  std::array<char, 4096> buffer{};
+  ssize_t got = 0;
+  while ((got = ::recv(fd, buffer.data(), buffer.size(), 0)) > 0) {
+    response.append(buffer.data(), static_cast<std::size_t>(got));
+  }
+  ::close(fd);
+  return response;
+}
+
+} // namespace
+
+TEST_CASE("OpenMetrics text of the collector's totals", "[metrics]") {
+  statistics::IntervalCollector collector(1h);
+  auto const ring = publishSome(collector);
+  collector.collect();
+
+  auto const text = statistics::renderMetrics(
+      collector.totals(), 3, statistics::MetricsFormat::openMetrics);
+  REQUIRE(contains(text, "# TYPE stormweaver_actions counter"));
+  REQUIRE(contains(text, "stormweaver_actions_total{outcome=\"success\"} 2"));
+  REQUIRE(contains(text, "stormweaver_actions_total{outcome=\"conflict\"} 1"));
+  REQUIRE(
+      contains(text, "stormweaver_actions_total{outcome=\"sql_failure\"} 1"));
+  REQUIRE(contains(text, "stormweaver_action_runs_total{action=\"metrics_"
+                         "insert\",outcome=\"success\"} 2"));
+  REQUIRE(contains(text, "stormweaver_action_runs_total{action=\"metrics_"
+                         "insert\",outcome=\"conflict\"} 1"));
+  REQUIRE(contains(text, "stormweaver_action_runs_total{action=\"say "
+                         "\\\"hi\\\"\",outcome=\"failure\"} 1"));
+  REQUIRE(contains(
+      text, "stormweaver_transactions_total{end=\"rolled_back_error\"} 1"));
+  REQUIRE(contains(text, "stormweaver_reconnects_total 1"));
+  REQUIRE(contains(text, "stormweaver_statements_in_flight 3"));
+
+  // cumulative buckets
+  REQUIRE(contains(
+      text, "stormweaver_action_duration_seconds_bucket{le=\"0.001\"} 0"));
+  REQUIRE(contains(
+      text, "stormweaver_action_duration_seconds_bucket{le=\"0.0025\"} 2"));
+  REQUIRE(contains(
+      text, "stormweaver_action_duration_seconds_bucket{le=\"0.05\"} 3"));
+  REQUIRE(contains(
+      text, "stormweaver_action_duration_seconds_bucket{le=\"5.0\"} 4"));
+  REQUIRE(contains(
+      text, "stormweaver_action_duration_seconds_bucket{le=\"+Inf\"} 4"));
+  REQUIRE(contains(text, "stormweaver_action_duration_seconds_count 4"));
+  REQUIRE(contains(text, "stormweaver_action_duration_seconds_sum 3.044"));
+  REQUIRE(contains(text, "# UNIT stormweaver_action_duration_seconds seconds"));
+  REQUIRE(text.ends_with("# EOF\n"));
+}
+
+TEST_CASE("Prometheus text of the collector's totals", "[metrics]") {
+  statistics::IntervalCollector collector(1h);
+  auto const ring = publishSome(collector);
+  collector.collect();
+
+  auto const text = statistics::renderMetrics(
+      collector.totals(), 3, statistics::MetricsFormat::prometheus);
+  // families named as their samples
+  REQUIRE(contains(text, "# TYPE stormweaver_actions_total counter"));
+  REQUIRE(contains(text, "# HELP stormweaver_reconnects_total Reconnects "
+                         "after a lost connection."));
+  REQUIRE(contains(text, "stormweaver_actions_total{outcome=\"success\"} 2"));
+  REQUIRE(contains(text, "# TYPE stormweaver_statements_in_flight gauge"));
+  REQUIRE(
+      contains(text, "# TYPE stormweaver_action_duration_seconds histogram"));
+  REQUIRE(contains(text, "stormweaver_action_duration_seconds_count 4"));
+  REQUIRE(text.find("# UNIT") == std::string::npos);
+  REQUIRE(text.find("# EOF") == std::string::npos);
+}
+
+TEST_CASE("the metrics textfile is rewritten", "[metrics]") {
+  auto const dir = std::filesystem::temp_directory_path() /
+                   fmt::format("sw-metrics-{}", ::getpid());
+  std::filesystem::create_directories(dir);
+  auto const path = dir / "stormweaver.prom";
+
+  auto collector = std::make_shared<statistics::IntervalCollector>(1h);
+  {
+    statistics::MetricsExporter exporter(collector,
+                                         {.textfile = path.string(),
+                                          .port = std::nullopt,
+                                          .period = 20ms});
+    REQUIRE(exporter.port() == 0);
+    // published after the first write, in the file by the last
+    auto const ring = publishSome(*collector);
+    exporter.stop();
+    exporter.stop();
+  }
+  std::ifstream in(path);
+  std::stringstream text;
+  text << in.rdbuf();
+  REQUIRE(
+      contains(text.str(), "stormweaver_actions_total{outcome=\"success\"} 2"));
+  // node_exporter reads the Prometheus text format, not OpenMetrics
+  REQUIRE(contains(text.str(), "# TYPE stormweaver_actions_total counter"));
+  REQUIRE(text.str().find("# EOF") == std::string::npos);
+  REQUIRE_FALSE(std::filesystem::exists(path.string() + ".tmp"));
+  std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("the metrics listener answers scrapes", "[metrics]") {
+  auto collector = std::make_shared<statistics::IntervalCollector>(1h);
+  auto const ring = publishSome(*collector);
+  statistics::MetricsExporter exporter(
+      collector, {.textfile = "", .port = 0, .period = 5s});
+  REQUIRE(exporter.port() != 0);
+
+  auto const ok = fetch(exporter.port(), "GET /metrics HTTP/1.1\r\n"
+                                         "Host: localhost\r\n\r\n");
+  REQUIRE(ok.starts_with("HTTP/1.1 200 OK\r\n"));
+  REQUIRE(ok.find("Content-Type: application/openmetrics-text") !=
+          std::string::npos);
+  REQUIRE(contains(ok, "stormweaver_actions_total{outcome=\"success\"} 2"));
+  REQUIRE(ok.ends_with("# EOF\n"));
+
+  REQUIRE(fetch(exporter.port(), "GET / HTTP/1.1\r\n\r\n")
+              .starts_with("HTTP/1.1 404 "));
+  REQUIRE(fetch(exporter.port(), "POST /metrics HTTP/1.1\r\n\r\n")
+              .starts_with("HTTP/1.1 405 "));
+
+  // taken
+  REQUIRE_THROWS_AS(
+      statistics::MetricsExporter(
+          collector, {.textfile = "", .port = exporter.port(), .period = 5s}),
+      std::runtime_error);
+}
+
+TEST_CASE("a metrics exporter needs somewhere to write", "[metrics]") {
+  auto collector = std::make_shared<statistics::IntervalCollector>(1h);
+  REQUIRE_THROWS_AS(statistics::MetricsExporter(collector, {}),
+                    std::invalid_argument);
+  REQUIRE_THROWS_AS(
+      statistics::MetricsExporter(collector, {.textfile = "x.prom",
+                                              .port = std::nullopt,
+                                              .period = 0ms}),
+      std::invalid_argument);
+}
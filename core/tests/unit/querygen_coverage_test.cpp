@@ -0,0 +1,102 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "querygen/coverage.hpp"
+#include "querygen/generator.hpp"
+
+using namespace querygen;
+using namespace metadata;
+
+namespace {
+
+FeatureSet only(Feature f) {
+  FeatureSet s;
+  s.set(static_cast<std::size_t>(f));
+  return s;
+}
+
+} // namespace
+
+TEST_CASE("plan shape ignores costs and names", "[querygen]") {
+  auto const a = planShapeHash(
+      R"([{"Plan": {"Node Type": "Seq Scan", "Relation Name": "t1",)"
+      R"( "Total Cost": 12.5, "Plan Rows": 100}}])");
+  auto const b = planShapeHash(
+      R"([{"Plan": {"Node Type": "Seq Scan", "Relation Name": "t7",)"
+      R"( "Total Cost": 99.0, "Plan Rows": 3}}])");
+  auto const c = planShapeHash(
+      R"([{"Plan": {"Node Type": "Index Scan", "Relation Name": "t1",)"
+      R"( "Total Cost": 12.5, "Plan Rows": 100}}])");
+  REQUIRE(a.has_value());
+  CHECK(a == b);
+  CHECK(a != c);
+}
+
+TEST_CASE("plan shape follows the tree", "[querygen]") {
+  auto const nested = planShapeHash(
+      R"({"query_block": {"nested_loop": [)"
+      R"({"table": {"table_name": "a", "access_type": "ALL"}},)"
+      R"({"table": {"table_name": "b", "access_type": "eq_ref"}}]}})");
+  auto const swapped = planShapeHash(
+      R"({"query_block": {"nested_loop": [)"
+      R"({"table": {"table_name": "a", "access_type": "eq_ref"}},)"
+      R"({"table": {"table_name": "b", "access_type": "ALL"}}]}})");
+  REQUIRE(nested.has_value());
+  CHECK(nested != swapped);
+  CHECK(!planShapeHash("not json").has_value());
+  CHECK(!planShapeHash("42").has_value());
+}
+
+TEST_CASE("coverage counts distinct shapes", "[querygen]") {
+  PlanCoverage cov;
+  CHECK(cov.record(1, {}));
+  CHECK(!cov.record(1, {}));
+  CHECK(cov.record(2, {}));
+  CHECK(cov.distinctPlans() == 2);
+  CHECK(cov.samples() == 3);
+}
+
+TEST_CASE("coverage bias favours productive features", "[querygen]") {
+  PlanCoverage cov;
+  for (auto const b : cov.bias()) {
+    CHECK(b == 1.0);
+  }
+  for (std::uint64_t i = 0; i < 100; ++i) {
+    if (i % 2 == 0) {
+      cov.record(1000 + i, only(Feature::join));
+    } else {
+      cov.record(1, only(Feature::aggregate));
+    }
+  }
+  auto const bias = cov.bias();
+  CHECK(bias[static_cast<std::size_t>(Feature::join)] > 1.0);
+  CHECK(bias[static_cast<std::size_t>(Feature::aggregate)] < 1.0);
+  for (auto const b : bias) {
+    CHECK(b >= 0.5);
+    CHECK(b <= 2.0);
+  }
+}
+
+TEST_CASE("generator reports rolled features", "[querygen]") {
+  TableRegistry reg;
+  Table t;
+  t.id = reg.nextId();
+  t.name = "t1_tab";
+  t.columns.push_back({.name = "id",
+                       .type = ColumnType::INT,
+                       .nullable = false,
+                       .primary_key = true,
+                       .auto_increment = true});
+  t.columns.push_back({.name = "num", .type = ColumnType::INT});
+  reg.get<Table>().insert(std::move(t));
+  Context ctx(reg);
+
+  QueryGenConfig cfg;
+  cfg.limit_prob = 100;
+  cfg.aggregate_prob = 0;
+  ps_random rand(31);
+  Generator gen(ctx, rand, cfg, {sql_variant::flavor::postgres, 180000});
+  auto q = gen.generate(Purpose::standalone, nullptr);
+  REQUIRE(q.has_value());
+  CHECK(gen.features().test(static_cast<std::size_t>(Feature::limit)));
+  CHECK(!gen.features().test(static_cast<std::size_t>(Feature::aggregate)));
+}
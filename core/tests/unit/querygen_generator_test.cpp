@@ -526,3 +526,69 @@ TEST_CASE("division always guarded", "[querygen]") {
     }
   }
 }
+
+TEST_CASE("row estimates bound joins and set ops", "[querygen]") {
+  TableRegistry reg;
+  fillCatalog(reg);
+  Context ctx(reg);
+  QueryGenConfig cfg;
+  cfg.join_prob = 100;
+  cfg.setop_prob = 100;
+  cfg.cte_prob = 0;
+  RowEstimates estimates;
+  Feedback const feedback{.row_estimates = &estimates};
+
+  SECTION("no estimates loaded, no bound") {
+    REQUIRE(estimates.stale(std::chrono::seconds(30)));
+    // one refresher at a time
+    REQUIRE(estimates.tryBeginRefresh(std::chrono::seconds(30)));
+    REQUIRE_FALSE(estimates.tryBeginRefresh(std::chrono::seconds(30)));
+    estimates.endRefresh();
+    REQUIRE(estimates.tryBeginRefresh(std::chrono::seconds(30)));
+    estimates.endRefresh();
+    ps_random rand(21);
+    Generator gen(ctx, rand, cfg, pgInfo(), feedback);
+    auto q = gen.generate(Purpose::standalone, nullptr);
+    REQUIRE(q.has_value());
+    CHECK(static_cast<bool>(q->setOpRhs));
+  }
+
+  SECTION("large tables never cross join") {
+    estimates.replace({{"t1_tab", 1e6}, {"t2_tab", 1e6}});
+    REQUIRE_FALSE(estimates.stale(std::chrono::seconds(30)));
+    REQUIRE_FALSE(estimates.tryBeginRefresh(std::chrono::seconds(30)));
+    REQUIRE(estimates.stale(std::chrono::seconds(0)));
+    ps_random rand(23);
+    for (int i = 0; i < 200; ++i) {
+      Generator gen(ctx, rand, cfg, pgInfo(), feedback);
+      auto q = gen.generate(Purpose::standalone, nullptr);
+      REQUIRE(q.has_value());
+      for (auto const &j : q->joins) {
+        CHECK(j.kind != JoinKind::cross);
+      }
+    }
+  }
+
+  SECTION("tables over the cap get neither joins nor set ops") {
+    cfg.max_estimated_rows = 10;
+    estimates.replace({{"t1_tab", 1000}, {"t2_tab", 1000}});
+    ps_random rand(25);
+    for (int i = 0; i < 100; ++i) {
+      Generator gen(ctx, rand, cfg, pgInfo(), feedback);
+      auto q = gen.generate(Purpose::standalone, nullptr);
+      REQUIRE(q.has_value());
+      CHECK(q->joins.empty());
+      CHECK(!static_cast<bool>(q->setOpRhs));
+    }
+  }
+
+  SECTION("zero cap disables the bound") {
+    cfg.max_estimated_rows = 0;
+    estimates.replace({{"t1_tab", 1000}, {"t2_tab", 1000}});
+    ps_random rand(27);
+    Generator gen(ctx, rand, cfg, pgInfo(), feedback);
+    auto q = gen.generate(Purpose::standalone, nullptr);
+    REQUIRE(q.has_value());
+    CHECK(static_cast<bool>(q->setOpRhs));
+  }
+}
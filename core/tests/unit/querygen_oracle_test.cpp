@@ -0,0 +1,133 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+
+#include "querygen/oracle.hpp"
+#include "querygen/render.hpp"
+#include "sql_dialect/dialect.hpp"
+
+using namespace querygen;
+
+namespace {
+
+Expr col(std::string alias, std::string name) {
+  return Expr{ColumnRef{std::move(alias), std::move(name)},
+              metadata::ColumnType::INT};
+}
+
+Expr lit(std::int64_t v) {
+  return Expr{Literal{v}, metadata::ColumnType::INT};
+}
+
+// SELECT t0.id, t0.a FROM t1_table t0 WHERE t0.a > 3 ORDER BY ... LIMIT 5
+QuerySpec filteredBase() {
+  QuerySpec q;
+  q.from = {"t1_table", "t0"};
+  q.selectItems.push_back({col("t0", "id"), "c0"});
+  q.selectItems.push_back({col("t0", "a"), "c1"});
+  q.where = box<Expr>(
+      Expr{BinaryExpr{BinOp::gt, box<Expr>(col("t0", "a")), box<Expr>(lit(3))},
+           metadata::ColumnType::BOOL});
+  q.orderBy.push_back({col("t0", "id"), false});
+  q.limit = 5;
+  return q;
+}
+
+QueryResult resultOf(std::vector<std::vector<char const *>> const &rows) {
+  QueryResult r;
+  for (auto const &row : rows) {
+    std::vector<std::optional<std::string_view>> fields;
+    for (auto const *f : row) {
+      fields.emplace_back(f == nullptr ? std::nullopt
+                                       : std::optional<std::string_view>(f));
+    }
+    r.addRow(fields);
+  }
+  return r;
+}
+
+} // namespace
+
+TEST_CASE("result multiset ignores order, keeps multiplicity",
+          "[querygen]") {
+  auto const a = resultOf({{"1", "x"}, {"2", "y"}, {"1", "x"}});
+  auto const b = resultOf({{"1", "x"}, {"1", "x"}, {"2", "y"}});
+  auto const c = resultOf({{"1", "x"}, {"2", "y"}, {"2", "y"}});
+  CHECK(a == b);
+  CHECK(a != c);
+  CHECK(resultOf({{nullptr}}) != resultOf({{""}}));
+  CHECK(resultOf({{"ab", "c"}}) != resultOf({{"a", "bc"}}));
+}
+
+TEST_CASE("tlp partitions on the where clause", "[querygen]") {
+  TlpOracle const tlp;
+  auto const v = tlp.variants(filteredBase());
+  REQUIRE(v.size() == 4);
+  auto const &pg = sql_dialect::pg_dialect();
+  CHECK(render(v[0], pg) == "SELECT t0.id AS c0, t0.a AS c1 FROM t1_table t0");
+  CHECK(render(v[1], pg) ==
+        "SELECT t0.id AS c0, t0.a AS c1 FROM t1_table t0 WHERE (t0.a > 3)");
+  CHECK(render(v[2], pg) == "SELECT t0.id AS c0, t0.a AS c1 FROM t1_table t0 "
+                            "WHERE (NOT (t0.a > 3))");
+  CHECK(render(v[3], pg) == "SELECT t0.id AS c0, t0.a AS c1 FROM t1_table t0 "
+                            "WHERE ((t0.a > 3) IS NULL)");
+
+  auto const all = resultOf({{"1", "2"}, {"2", "5"}, {"3", nullptr}});
+  CHECK(tlp.verdict({all, resultOf({{"2", "5"}}), resultOf({{"1", "2"}}),
+                     resultOf({{"3", nullptr}})}));
+  CHECK(!tlp.verdict({all, resultOf({{"2", "5"}}), resultOf({{"1", "2"}}),
+                      resultOf({})}));
+}
+
+TEST_CASE("norec counts the predicate as an expression", "[querygen]") {
+  NoRecOracle const norec;
+  auto const v = norec.variants(filteredBase());
+  REQUIRE(v.size() == 2);
+  auto const &pg = sql_dialect::pg_dialect();
+  CHECK(render(v[0], pg) ==
+        "SELECT COUNT(*) AS c0 FROM t1_table t0 WHERE (t0.a > 3)");
+  CHECK(render(v[1], pg) ==
+        "WITH norec AS (SELECT CASE WHEN (t0.a > 3) THEN 1 ELSE 0 END AS c0 "
+        "FROM t1_table t0) SELECT COUNT(*) AS c0 FROM norec nr "
+        "WHERE (nr.c0 = 1)");
+
+  CHECK(norec.verdict({resultOf({{"4"}}), resultOf({{"4"}})}));
+  CHECK(!norec.verdict({resultOf({{"4"}}), resultOf({{"3"}})}));
+}
+
+TEST_CASE("oracles skip queries they can't reason about", "[querygen]") {
+  TlpOracle const tlp;
+  NoRecOracle const norec;
+  std::array<Oracle const *, 2> const oracles{&tlp, &norec};
+
+  auto noWhere = filteredBase();
+  noWhere.where = box<Expr>{};
+
+  auto grouped = filteredBase();
+  grouped.groupBy.push_back({"t0", "a"});
+
+  auto aggregated = filteredBase();
+  aggregated.selectItems.push_back(
+      {Expr{AggCall{AggFunc::count, {}, false}, metadata::ColumnType::INT},
+       "c2"});
+
+  auto setOp = filteredBase();
+  setOp.setOpRhs = box<QuerySpec>(filteredBase());
+
+  // IN (SELECT ... LIMIT 1) picks an arbitrary row per execution
+  auto limitedSub = filteredBase();
+  QuerySpec sub;
+  sub.from = {"t2_table", "t1"};
+  sub.selectItems.push_back({col("t1", "id"), "c0"});
+  sub.limit = 1;
+  limitedSub.where = box<Expr>(
+      Expr{InSubquery{box<Expr>(col("t0", "a")), box<QuerySpec>(sub), false},
+           metadata::ColumnType::BOOL});
+
+  for (auto const *oracle : oracles) {
+    CHECK(!oracle->variants(filteredBase()).empty());
+    for (auto const &q : {noWhere, grouped, aggregated, setOp, limitedSub}) {
+      CHECK(oracle->variants(q).empty());
+    }
+  }
+}
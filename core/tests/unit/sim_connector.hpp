@@ -0,0 +1,23 @@
+#pragma once
+
+#include "sql_variant/sim.hpp"
+
+#include <functional>
+#include <memory>
+#include <string>
+
+// shared unit test helpers. do not add to core lib.
+namespace testutil {
+
+// each call opens a new connection to the simulated server, logged under
+// `name`: what Worker and ConnectionManager take as their connector
+inline std::function<std::unique_ptr<sql_variant::LoggedSQL>()>
+sim_connector(std::shared_ptr<sql_variant::SimServer> server,
+              std::string name) {
+  return [server = std::move(server), name = std::move(name)]() {
+    return std::make_unique<sql_variant::LoggedSQL>(
+        std::make_unique<sql_variant::Simulated>(server), name);
+  };
+}
+
+} // namespace testutil
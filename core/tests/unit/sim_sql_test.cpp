@@ -0,0 +1,148 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "sql_variant/sim.hpp"
+
+using namespace sql_variant;
+
+namespace {
+
+std::shared_ptr<SimServer> simServer(SimParams params) {
+  return std::make_shared<SimServer>(std::move(params));
+}
+
+// one outcome per statement: error code, or the first value returned
+std::vector<std::string> outcomes(Simulated const &sql, std::size_t count) {
+  std::vector<std::string> out;
+  for (std::size_t i = 0; i < count; ++i) {
+    auto const res = sql.executeQuery("SELECT 1");
+    out.push_back(res.success() ? std::string(*res.data->nextRow().rowData[0])
+                                : res.errorInfo.errorCode);
+  }
+  return out;
+}
+
+} // namespace
+
+TEST_CASE("sim results follow the configured shape", "[sql][sim]") {
+  auto const server = simServer(
+      {.flavor_ = flavor::mysql, .select_rows = 3, .select_fields = 2,
+       .affected_rows = 7});
+  Simulated const sql(server);
+
+  REQUIRE(sql.serverInfo().is_mysql_like());
+
+  auto const sel = sql.executeQuery("SELECT a, b FROM t");
+  REQUIRE(sel.success());
+  REQUIRE(sel.data->numRows() == 3);
+  REQUIRE(sel.data->numFields() == 2);
+  REQUIRE(sel.data->rowAt(2).rowData[1].has_value());
+
+  auto const upd = sql.executeQuery("UPDATE t SET a = 1");
+  REQUIRE(upd.success());
+  REQUIRE(upd.affectedRows == 7);
+  REQUIRE(upd.data->numFields() == 0);
+
+  REQUIRE(sql.executeQuery("BEGIN;").affectedRows == 0);
+}
+
+TEST_CASE("sim injects errors and conflicts per flavor", "[sql][sim]") {
+  Simulated const pgConflict(simServer({.conflict_rate = 1}));
+  auto const conflict = pgConflict.executeQuery("SELECT 1");
+  REQUIRE(conflict.errorInfo.errorCode == "40001");
+  REQUIRE(conflict.errorInfo.errorClass == ErrorClass::conflict);
+
+  Simulated const mysqlConflict(
+      simServer({.flavor_ = flavor::mysql, .conflict_rate = 1}));
+  REQUIRE(mysqlConflict.executeQuery("SELECT 1").errorInfo.errorClass ==
+          ErrorClass::conflict);
+
+  Simulated const pgError(simServer({.error_rate = 1}));
+  auto const error = pgError.executeQuery("SELECT 1");
+  REQUIRE(!error.success());
+  REQUIRE(error.errorInfo.errorClass == ErrorClass::other);
+  REQUIRE_THROWS_AS(error.maybeThrow(), SqlException);
+}
+
+TEST_CASE("sim streams are reproducible from the seed", "[sql][sim]") {
+  SimParams const params{.seed = 42, .error_rate = 0.2, .conflict_rate = 0.1};
+  auto const run = [&](SimParams const &p) {
+    Simulated const sql(simServer(p));
+    return outcomes(sql, 200);
+  };
+  REQUIRE(run(params) == run(params));
+
+  auto other = params;
+  other.seed = 43;
+  REQUIRE(run(params) != run(other));
+
+  // a second connection to the same server gets its own stream
+  auto const server = simServer(params);
+  Simulated const first(server);
+  Simulated const second(server);
+  REQUIRE(outcomes(first, 50) != outcomes(second, 50));
+}
+
+TEST_CASE("sim outages refuse a fixed number of connects", "[sql][sim]") {
+  auto const server = simServer({.down_connects = 2});
+  Simulated a(server);
+  Simulated b(server);
+  REQUIRE(a.executeQuery("SELECT 1").success());
+
+  server->crash();
+  REQUIRE(a.executeQuery("SELECT 1").errorInfo.errorStatus ==
+          SqlStatus::serverGone);
+  REQUIRE(b.executeQuery("SELECT 1").errorInfo.errorStatus ==
+          SqlStatus::serverGone);
+
+  REQUIRE_THROWS_AS(a.reconnect(), SqlException);
+  REQUIRE_THROWS_AS(Simulated(server), SqlException);
+  REQUIRE(!a.executeQuery("SELECT 1").success());
+  REQUIRE(!b.executeQuery("SELECT 1").success());
+
+  a.reconnect();
+  REQUIRE(a.executeQuery("SELECT 1").success());
+  REQUIRE(!b.executeQuery("SELECT 1").success());
+}
+
+TEST_CASE("sim server crash takes every connection down", "[sql][sim]") {
+  auto const server = simServer({.server_gone_rate = 1, .down_connects = 0});
+  Simulated const a(server);
+  Simulated const b(server);
+
+  auto const res = a.executeQuery("SELECT 1");
+  REQUIRE(res.errorInfo.errorStatus == SqlStatus::serverGone);
+  REQUIRE(res.errorInfo.errorClass == ErrorClass::serverGone);
+  REQUIRE(b.executeQuery("SELECT 1").errorInfo.errorStatus ==
+          SqlStatus::serverGone);
+}
+
+TEST_CASE("copy fields are tab separated and escaped", "[sql][sim]") {
+  std::string line;
+  appendCopyField(line, 0, "a\tb");
+  appendCopyField(line, 1, std::nullopt);
+  appendCopyField(line, 2, "c\\d\ne");
+  REQUIRE(line == "a\\tb\t\\N\tc\\\\d\\ne");
+}
+
+TEST_CASE("sim bulk loads pull every row", "[sql][sim]") {
+  auto const server = simServer({.flavor_ = flavor::mysql});
+  Simulated const sql(server);
+
+  std::size_t produced = 0;
+  auto const res =
+      sql.bulkLoad("t", {"a", "b"}, [&](std::string &line) {
+        if (produced == 5) {
+          return false;
+        }
+        appendCopyField(line, 0, std::to_string(produced++));
+        appendCopyField(line, 1, "x");
+        return true;
+      });
+  REQUIRE(res.success());
+  REQUIRE(res.affectedRows == 5);
+  REQUIRE(res.insertId == 1);
+
+  Simulated const failing(simServer({.error_rate = 1}));
+  REQUIRE(!failing.bulkLoad("t", {"a"}, [](std::string &) { return false; })
+               .success());
+}
@@ -0,0 +1,138 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <stdexcept>
+
+#include "action/action.hpp"
+#include "action/sql_template.hpp"
+
+using action::KeyReservoir;
+using action::SqlTemplate;
+using metadata::Column;
+using metadata::ColumnType;
+using metadata::Context;
+using metadata::Table;
+using metadata::TableRegistry;
+
+namespace {
+
+void addTable(Context &ctx, std::string name) {
+  Table t;
+  t.id = ctx.nextId();
+  t.name = std::move(name);
+
+  Column pk;
+  pk.name = "id";
+  pk.primary_key = true;
+  t.columns.push_back(pk);
+
+  Column a;
+  a.name = "a";
+  t.columns.push_back(a);
+
+  Column s;
+  s.name = "s";
+  s.type = ColumnType::VARCHAR;
+  s.length = 8;
+  t.columns.push_back(s);
+
+  REQUIRE(ctx.get<Table>().insert(std::move(t)));
+}
+
+sql_dialect::Dialect const &pg() {
+  return sql_dialect::dialect_for(
+      {.flavor_ = sql_variant::flavor::postgres, .version = 0});
+}
+
+} // namespace
+
+TEST_CASE("templates reject unknown placeholders", "[template]") {
+  REQUIRE_THROWS_AS(SqlTemplate::compile("SELECT {tabel}"),
+                    std::invalid_argument);
+  REQUIRE_THROWS_AS(SqlTemplate::compile("SELECT {int_col:t}"),
+                    std::invalid_argument);
+  REQUIRE_THROWS_AS(SqlTemplate::compile("SELECT * FROM {table1}"),
+                    std::invalid_argument);
+  REQUIRE_NOTHROW(SqlTemplate::compile("SELECT '{1,2}', '{\"k\": 1}'"));
+  REQUIRE_NOTHROW(SqlTemplate::compile("SELECT '{foo,bar}'::text[]"));
+}
+
+TEST_CASE("templates leave string literals alone", "[template]") {
+  TableRegistry reg;
+  Context ctx(reg);
+  addTable(ctx, "t1");
+  ps_random rand(7);
+
+  auto const tmpl = SqlTemplate::compile(
+      "SELECT '{foo}', 'it''s {table}', 'a\\'{b}' FROM {table}");
+  REQUIRE(tmpl.tableSlots() == 1);
+  REQUIRE(tmpl.render(ctx, rand, pg(), nullptr) ==
+          "SELECT '{foo}', 'it''s {table}', 'a\\'{b}' FROM t1");
+}
+
+TEST_CASE("templates fill tables and columns consistently", "[template]") {
+  TableRegistry reg;
+  Context ctx(reg);
+  addTable(ctx, "t1");
+  addTable(ctx, "t2");
+  ps_random rand(7);
+
+  auto const tmpl = SqlTemplate::compile(
+      "SELECT {col:table}, {col2:table} FROM {table} JOIN {table2} "
+      "ON {table}.{col:table} = {table2}.{str_col:table2} {{x}");
+  REQUIRE(tmpl.tableSlots() == 2);
+
+  for (int i = 0; i < 20; ++i) {
+    auto const sql = tmpl.render(ctx, rand, pg(), nullptr);
+    bool const t1First = sql.find("FROM t1 JOIN t2") != std::string::npos;
+    REQUIRE((t1First || sql.find("FROM t2 JOIN t1") != std::string::npos));
+    REQUIRE(sql.ends_with(".s {x}"));
+    // {col:table} and {col2:table} are different columns
+    auto const first = sql.substr(7, sql.find(',') - 7);
+    auto const second =
+        sql.substr(sql.find(", ") + 2, sql.find(" FROM") - sql.find(", ") - 2);
+    REQUIRE(first != second);
+  }
+
+  TableRegistry lonely;
+  Context one(lonely);
+  addTable(one, "t1");
+  REQUIRE_THROWS_AS(tmpl.render(one, rand, pg(), nullptr),
+                    action::ActionException);
+}
+
+TEST_CASE("templates take keys from the reservoir", "[template]") {
+  TableRegistry reg;
+  Context ctx(reg);
+  addTable(ctx, "t1");
+  ps_random rand(7);
+
+  auto const tmpl = SqlTemplate::compile(
+      "UPDATE {table} SET {str_col:table} = {value:str_col:table} "
+      "WHERE id = {pk:table}");
+  KeyReservoir keys;
+  REQUIRE(tmpl.render(ctx, rand, pg(), &keys).ends_with("LIMIT 1)"));
+
+  std::vector<KeyReservoir::Key> const known{42};
+  keys.add(reg.get<Table>().byName("t1")->id, known);
+  auto const sql = tmpl.render(ctx, rand, pg(), &keys);
+  REQUIRE(sql.starts_with("UPDATE t1 SET s = '"));
+  REQUIRE(sql.ends_with("WHERE id = 42"));
+}
+
+TEST_CASE("templates want a single column pk for {pk}", "[template]") {
+  TableRegistry reg;
+  Context ctx(reg);
+  Table t;
+  t.id = ctx.nextId();
+  t.name = "keyless";
+  Column a;
+  a.name = "a";
+  t.columns.push_back(a);
+  REQUIRE(ctx.get<Table>().insert(std::move(t)));
+  ps_random rand(7);
+
+  auto const tmpl =
+      SqlTemplate::compile("DELETE FROM {table} WHERE a = {pk:table}");
+  REQUIRE_THROWS_AS(tmpl.render(ctx, rand, pg(), nullptr),
+                    action::ActionException);
+}
@@ -0,0 +1,67 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "action/statement_cache.hpp"
+
+using action::StatementCache;
+using metadata::Column;
+using metadata::Table;
+
+namespace {
+
+metadata::table_cptr makeTable(metadata::ObjectId id, std::string name) {
+  Table t;
+  t.id = id;
+  t.name = std::move(name);
+
+  Column pk;
+  pk.name = "id";
+  pk.primary_key = true;
+  pk.auto_increment = true;
+  t.columns.push_back(pk);
+
+  Column a;
+  a.name = "a";
+  t.columns.push_back(a);
+
+  Column b;
+  b.name = "b";
+  b.partition_key = true;
+  t.columns.push_back(b);
+
+  return std::make_shared<Table const>(std::move(t));
+}
+
+} // namespace
+
+TEST_CASE("statement skeletons skip auto_increment columns", "[dml]") {
+  StatementCache cache;
+  auto const table = makeTable(1, "t1");
+  auto const &stmts = cache.forTable(table);
+
+  REQUIRE(stmts.insertPrefix == "INSERT INTO t1 (a, b ) VALUES ");
+  REQUIRE(stmts.updatePrefix == "UPDATE t1 SET ");
+  REQUIRE(stmts.valueNames == std::vector<std::string>{"a", "b"});
+  REQUIRE(stmts.assignments == std::vector<std::string>{"a = ", "b = "});
+  REQUIRE(stmts.bulkSetAssignments == std::vector<std::string>{"a = "});
+  REQUIRE(stmts.valueColumns.front() == &table->columns[1]);
+}
+
+TEST_CASE("statement skeletons follow the table record", "[dml]") {
+  StatementCache cache;
+  auto const table = makeTable(1, "t1");
+  auto const *first = &cache.forTable(table);
+  REQUIRE(&cache.forTable(table) == first);
+
+  // a rename publishes a new record under the same id
+  auto renamed = std::make_shared<Table>(*table);
+  renamed->name = "t2";
+  ++renamed->version;
+  REQUIRE(cache.forTable(renamed).insertPrefix.starts_with("INSERT INTO t2 "));
+  REQUIRE(cache.size() == 1);
+
+  // a transaction overlay copy keeps the version but is a new record
+  auto overlay = std::make_shared<Table>(*renamed);
+  overlay->columns.pop_back();
+  REQUIRE(cache.forTable(overlay).valueNames ==
+          std::vector<std::string>{"a"});
+}
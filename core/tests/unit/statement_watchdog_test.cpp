@@ -0,0 +1,72 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "sql_variant/sim.hpp"
+#include "sql_variant/watchdog.hpp"
+
+using namespace sql_variant;
+using namespace std::chrono_literals;
+
+namespace {
+
+// every statement would take `latency`
+std::unique_ptr<LoggedSQL> sim_conn(std::chrono::milliseconds latency,
+                                    std::string const &name) {
+  auto const server = std::make_shared<SimServer>(
+      SimParams{.latency_median = latency, .latency_sigma = 0});
+  return std::make_unique<LoggedSQL>(std::make_unique<Simulated>(server),
+                                     name);
+}
+
+} // namespace
+
+TEST_CASE("the watchdog cancels statements past their deadline",
+          "[sql][watchdog]") {
+  auto const watchdog = std::make_shared<StatementWatchdog>();
+  auto const conn = sim_conn(10s, "watchdog-deadline");
+  REQUIRE_FALSE(conn->watched());
+  conn->setWatchdog(watchdog, 100ms);
+  REQUIRE(conn->watched());
+
+  auto const start = std::chrono::steady_clock::now();
+  auto const res = conn->executeQuery("SELECT 1");
+  REQUIRE(std::chrono::steady_clock::now() - start < 5s);
+  REQUIRE_FALSE(res.success());
+  REQUIRE(res.errorInfo.errorClass == ErrorClass::timeout);
+  REQUIRE(watchdog->cancels() == 1);
+}
+
+TEST_CASE("statements within their deadline are left alone",
+          "[sql][watchdog]") {
+  auto const watchdog = std::make_shared<StatementWatchdog>();
+  auto const conn = sim_conn(1ms, "watchdog-fast");
+  conn->setWatchdog(watchdog, 10s);
+  for (int i = 0; i < 20; ++i) {
+    REQUIRE(conn->executeQuery("SELECT 1").success());
+  }
+  REQUIRE(watchdog->cancels() == 0);
+}
+
+TEST_CASE("caps tighten the deadline while alive", "[sql][watchdog]") {
+  auto const watchdog = std::make_shared<StatementWatchdog>();
+  auto const conn = sim_conn(10s, "watchdog-cap");
+  // no default deadline: only capped statements are watched
+  conn->setWatchdog(watchdog, 0ms);
+  {
+    StatementCap const cap(*conn, 50ms);
+    // an inner, looser cap doesn't loosen the outer one
+    StatementCap const loose(*conn, 60s);
+    auto const start = std::chrono::steady_clock::now();
+    auto const res = conn->executeQuery("SELECT 1");
+    REQUIRE(std::chrono::steady_clock::now() - start < 5s);
+    REQUIRE(res.errorInfo.errorClass == ErrorClass::timeout);
+  }
+  REQUIRE(watchdog->cancels() == 1);
+
+  // unwatched: a cap changes nothing
+  auto const plain = std::make_unique<LoggedSQL>(
+      std::make_unique<Simulated>(
+          std::make_shared<SimServer>(SimParams{.sleep = false})),
+      "watchdog-plain");
+  StatementCap const cap(*plain, 1ms);
+  REQUIRE(plain->executeQuery("SELECT 1").success());
+}
@@ -95,8 +95,8 @@ TEST_CASE("ActionStatistics basic functionality", "[statistics][action]") {
     REQUIRE(stats.getSuccessRate() == 0.0);
 
     // Check error tracking
-    REQUIRE(stats.actionErrorNames.count("test-error") == 1);
-    REQUIRE(stats.actionErrorNames.at("test-error") == 1);
+    REQUIRE(stats.actionErrorNames().count("test-error") == 1);
+    REQUIRE(stats.actionErrorNames().at("test-error") == 1);
 
     // Check timing was recorded
     REQUIRE(stats.executionTiming.hasData());
@@ -109,8 +109,8 @@ TEST_CASE("ActionStatistics basic functionality", "[statistics][action]") {
     stats.recordSqlFailure("sql-error-code", 700000ns); // 0.7ms SQL time
 
     REQUIRE(stats.sqlFailureCount == 1);
-    REQUIRE(stats.sqlErrorCodes.count("sql-error-code") == 1);
-    REQUIRE(stats.sqlErrorCodes.at("sql-error-code") == 1);
+    REQUIRE(stats.sqlErrorCodes().count("sql-error-code") == 1);
+    REQUIRE(stats.sqlErrorCodes().at("sql-error-code") == 1);
     REQUIRE_THAT(stats.sqlTiming.getAverageMs(),
                  Catch::Matchers::WithinAbs(0.7, 0.001));
   }
@@ -153,8 +153,8 @@ TEST_CASE("ActionStatistics basic functionality", "[statistics][action]") {
                  Catch::Matchers::WithinAbs(25.0, 0.001));
 
     // Check error aggregation
-    REQUIRE(stats.actionErrorNames.at("error1") == 2);
-    REQUIRE(stats.sqlErrorCodes.at("sql-err") == 1);
+    REQUIRE(stats.actionErrorNames().at("error1") == 2);
+    REQUIRE(stats.sqlErrorCodes().at("sql-err") == 1);
 
     // Check SQL timing aggregation
     REQUIRE(stats.sqlTiming.count == 4);
@@ -178,8 +178,8 @@ TEST_CASE("ActionStatistics basic functionality", "[statistics][action]") {
 
     REQUIRE_FALSE(stats.hasData());
     REQUIRE(stats.getTotalCount() == 0);
-    REQUIRE(stats.actionErrorNames.empty());
-    REQUIRE(stats.sqlErrorCodes.empty());
+    REQUIRE(stats.actionErrorNames().empty());
+    REQUIRE(stats.sqlErrorCodes().empty());
     REQUIRE_FALSE(stats.executionTiming.hasData());
     REQUIRE_FALSE(stats.sqlTiming.hasData());
   }
@@ -260,7 +260,7 @@ TEST_CASE("WorkerStatistics functionality", "[statistics][worker]") {
     const auto &insertStats = worker.actionStats.at("insert-data");
     REQUIRE(insertStats.successCount == 0);
     REQUIRE(insertStats.sqlFailureCount == 1);
-    REQUIRE(insertStats.sqlErrorCodes.at("constraint-violation") == 1);
+    REQUIRE(insertStats.sqlErrorCodes().at("constraint-violation") == 1);
   }
 
   SECTION("Duration calculation") {
@@ -337,8 +337,8 @@ TEST_CASE("Statistics edge cases", "[statistics][edge]") {
     stats.recordActionFailure("", 0ns);
     stats.recordSqlFailure("", 0ns);
 
-    REQUIRE(stats.actionErrorNames.count("") == 1);
-    REQUIRE(stats.sqlErrorCodes.count("") == 1);
+    REQUIRE(stats.actionErrorNames().count("") == 1);
+    REQUIRE(stats.sqlErrorCodes().count("") == 1);
   }
 }
 
@@ -411,17 +411,59 @@ TEST_CASE("TimingHistogram boundary values round up",
 
 TEST_CASE("WorkerStatistics recordRows", "[statistics][histogram]") {
   WorkerStatistics ws;
-  ws.recordRows("select_all", "select", 0);
-  ws.recordRows("select_all", "select", 42);
-  ws.recordRows("update_one", "update", 1);
+  ws.recordRows("select_all", RowKind::select, 0);
+  ws.recordRows("select_all", RowKind::select, 42);
+  ws.recordRows("update_one", RowKind::update, 1);
 
-  auto &sel = ws.actionStats["select_all"].rowHistograms["select"];
+  auto const &sel = ws.actionStats["select_all"].rowHistogram(RowKind::select);
   REQUIRE(sel.buckets[0] == 1);
   REQUIRE(sel.buckets[3] == 1); // 42 -> 11-100
-  REQUIRE(ws.actionStats["update_one"].rowHistograms["update"].buckets[1] == 1);
+  auto const rows = ws.actionStats["update_one"].rowHistograms();
+  REQUIRE(rows.size() == 1);
+  REQUIRE(rows.at("update").buckets[1] == 1);
 
   ws.actionStats["select_all"].reset();
-  REQUIRE(ws.actionStats["select_all"].rowHistograms.empty());
+  REQUIRE(ws.actionStats["select_all"].rowHistograms().empty());
+}
+
+TEST_CASE("recording by interned name", "[statistics]") {
+  auto const insert = NameTable::intern("interned_insert");
+  REQUIRE(NameTable::intern("interned_insert") == insert);
+  REQUIRE(NameTable::name(insert) == "interned_insert");
+  REQUIRE(NameTable::intern("") == NameTable::none);
+  REQUIRE_THROWS_AS(NameTable::name(insert + 1'000'000), std::out_of_range);
+
+  WorkerStatistics ws;
+  auto const duplicate = NameTable::intern("23505");
+  ws.startAction(insert);
+  ws.recordSqlFailure(insert, duplicate);
+  ws.startAction(insert);
+  ws.recordConflict("interned_insert", "23505");
+  ws.recordRows(insert, RowKind::insert, 1);
+  // by id and by name: the same entry
+  REQUIRE(ws.actionStats.size() == 1);
+  auto const &stats = ws.actionStats.at("interned_insert");
+  REQUIRE(stats.getTotalFailureCount() == 2);
+  REQUIRE(stats.sqlErrors.size() == 1);
+  REQUIRE(stats.sqlErrorCodes().at("23505") == 2);
+  REQUIRE(stats.rowHistogram(RowKind::insert).buckets[1] == 1);
+
+  // a copy records into its own entries
+  WorkerStatistics copy = ws;
+  copy.startAction(insert);
+  copy.recordSuccess(insert);
+  REQUIRE(copy.actionStats.at("interned_insert").successCount == 1);
+  REQUIRE(ws.actionStats.at("interned_insert").successCount == 0);
+  ws = copy;
+  ws.startAction(insert);
+  ws.recordSuccess(insert);
+  REQUIRE(ws.actionStats.at("interned_insert").successCount == 2);
+  REQUIRE(copy.actionStats.at("interned_insert").successCount == 1);
+
+  ws.reset();
+  ws.startAction(insert);
+  ws.recordSuccess(insert);
+  REQUIRE(ws.getTotalActionCount() == 1);
 }
 
 TEST_CASE("TransactionStatistics folding", "[statistics][transaction]") {
@@ -473,3 +515,176 @@ TEST_CASE("TransactionOutcome default counts as rolledBackError",
   REQUIRE(ws.txnStats.committed == 0);
   REQUIRE(ws.txnStats.rolledBackIntentional == 0);
 }
+
+TEST_CASE("LatencyHistogram percentiles", "[statistics][histogram]") {
+  LatencyHistogram h(2);
+  REQUIRE(h.valueAtPercentile(99) == 0ns);
+  // 1..1000ms, one each
+  for (int i = 1; i <= 1000; ++i) {
+    h.record(std::chrono::milliseconds(i));
+  }
+  REQUIRE(h.count() == 1000);
+  auto const within = [](std::chrono::nanoseconds value, double ms) {
+    auto const got = std::chrono::duration<double, std::milli>(value).count();
+    return got >= ms && got <= ms * 1.01;
+  };
+  REQUIRE(within(h.valueAtPercentile(50), 500));
+  REQUIRE(within(h.valueAtPercentile(99), 990));
+  REQUIRE(within(h.valueAtPercentile(99.9), 999));
+  REQUIRE(within(h.valueAtPercentile(100), 1000));
+  // below 2^subBits microseconds the buckets are exact
+  LatencyHistogram small(2);
+  small.record(42us);
+  REQUIRE(small.valueAtPercentile(50) == 42us);
+
+  REQUIRE_THROWS_AS(LatencyHistogram(0), std::invalid_argument);
+  REQUIRE_THROWS_AS(LatencyHistogram(LatencyHistogram::maxDigits + 1),
+                    std::invalid_argument);
+  h.reset();
+  REQUIRE(h.count() == 0);
+}
+
+TEST_CASE("TimingStatistics merge exactly", "[statistics][histogram]") {
+  TimingStatistics fast;
+  TimingStatistics slow;
+  TimingStatistics both;
+  for (int i = 1; i <= 100; ++i) {
+    fast.record(std::chrono::microseconds(i * 10));
+    slow.record(std::chrono::milliseconds(i * 10));
+    both.record(std::chrono::microseconds(i * 10));
+    both.record(std::chrono::milliseconds(i * 10));
+  }
+  fast.merge(slow);
+  REQUIRE(fast.count == both.count);
+  REQUIRE(fast.totalTime == both.totalTime);
+  REQUIRE(fast.minTime == both.minTime);
+  REQUIRE(fast.maxTime == both.maxTime);
+  REQUIRE(fast.histogram.buckets == both.histogram.buckets);
+  for (double const p : {1.0, 50.0, 90.0, 99.0, 99.9}) {
+    REQUIRE(fast.getPercentileMs(p) == both.getPercentileMs(p));
+  }
+  // clamped to what was seen
+  REQUIRE(fast.getPercentileMs(100) == fast.getMaxMs());
+
+  TimingStatistics coarse;
+  coarse.latency = LatencyHistogram(1);
+  REQUIRE_THROWS_AS(coarse.merge(fast), std::invalid_argument);
+}
+
+TEST_CASE("detailed report has percentiles", "[statistics]") {
+  WorkerStatistics ws;
+  ws.startAction("select_all");
+  ws.recordSuccess("select_all", 2ms);
+  auto const report = ws.reportDetailed();
+  REQUIRE(report.find("p50=") != std::string::npos);
+  REQUIRE(report.find("p99.9=") != std::string::npos);
+}
+
+TEST_CASE("WorkerStatistics merge", "[statistics][worker]") {
+  auto fill = [](WorkerStatistics &ws, std::chrono::milliseconds sql) {
+    ws.start();
+    ws.startAction("insert_row");
+    ws.recordSuccess("insert_row", sql);
+    ws.startAction("insert_row");
+    ws.recordSqlFailure("insert_row", "23505", sql);
+    ws.startAction("delete_row");
+    ws.recordConflict("delete_row", "40001", sql);
+    ws.recordRows("insert_row", RowKind::insert, 1);
+    TransactionOutcome outcome;
+    outcome.end = TransactionOutcome::End::committed;
+    outcome.subOk = 2;
+    ws.recordTransaction(outcome);
+    ws.recordReconnect(sql);
+    ws.stop();
+  };
+
+  WorkerStatistics first;
+  WorkerStatistics second;
+  fill(first, 1ms);
+  fill(second, 3ms);
+  second.startAction("select_all");
+  second.recordActionFailure("select_all", "no-table");
+
+  WorkerStatistics merged;
+  merged.merge(first);
+  merged.merge(second);
+
+  REQUIRE(merged.getTotalActionCount() == 7);
+  REQUIRE(merged.getTotalSuccessCount() == 2);
+  auto const &insert = merged.actionStats.at("insert_row");
+  REQUIRE(insert.successCount == 2);
+  REQUIRE(insert.sqlErrorCodes().at("23505") == 2);
+  REQUIRE(insert.rowHistogram(RowKind::insert).buckets[1] == 2);
+  REQUIRE(insert.sqlTiming.count == 4);
+  REQUIRE(insert.sqlTiming.getMaxMs() == 3.0);
+  REQUIRE(merged.actionStats.at("delete_row").sqlConflictCount == 2);
+  REQUIRE(merged.actionStats.at("select_all").actionErrorNames().at(
+              "no-table") == 1);
+  REQUIRE(merged.txnStats.committed == 2);
+  REQUIRE(merged.txnStats.subActionsOk == 4);
+  REQUIRE(merged.txnStats.subActionsPerTxn.buckets[2] == 2);
+  REQUIRE(merged.reconnectTiming.count == 2);
+  REQUIRE(merged.startTime == first.startTime);
+  REQUIRE(merged.endTime == second.endTime);
+
+  // recording continues on merged entries
+  merged.startAction("insert_row");
+  merged.recordSuccess("insert_row");
+  REQUIRE(merged.actionStats.at("insert_row").successCount == 3);
+
+  merged.merge(merged);
+  REQUIRE(merged.getTotalActionCount() == 16);
+}
+
+TEST_CASE("WorkloadStatistics across workers and cycles",
+          "[statistics][worker]") {
+  auto worker = [](std::chrono::steady_clock::time_point start,
+                   std::chrono::seconds seconds, int actions) {
+    WorkerStatistics ws;
+    for (int i = 0; i < actions; ++i) {
+      ws.startAction("select_all");
+      ws.recordSuccess("select_all");
+    }
+    ws.startTime = start;
+    ws.endTime = start + seconds;
+    return ws;
+  };
+
+  auto const t0 = std::chrono::steady_clock::now();
+  WorkloadStatistics workload;
+  // cycle 1: two workers side by side, 10s in total
+  workload.add(1, worker(t0, 10s, 30));
+  workload.add(1, worker(t0 + 1s, 9s, 20));
+  // cycle 2, after a pause that is not counted
+  workload.add(2, worker(t0 + 60s, 10s, 50));
+
+  REQUIRE(workload.workerCount() == 3);
+  REQUIRE(workload.cycleCount() == 2);
+  REQUIRE(workload.total().getTotalActionCount() == 100);
+  REQUIRE(workload.executionTiming().count == 100);
+  REQUIRE_THAT(workload.getTotalDurationSeconds(),
+               Catch::Matchers::WithinAbs(20.0, 1e-9));
+  REQUIRE_THAT(workload.getActionsPerSecond(),
+               Catch::Matchers::WithinAbs(5.0, 1e-9));
+
+  auto const report = workload.report();
+  REQUIRE(report.find("Workers: 3 in 2 cycle(s)") != std::string::npos);
+  REQUIRE(report.find("Actions/sec: 5.00") != std::string::npos);
+  REQUIRE(report.find("Action: select_all") != std::string::npos);
+
+  // a second run's aggregate, one cycle of which overlaps
+  WorkloadStatistics later;
+  later.add(2, worker(t0 + 65s, 10s, 10));
+  later.add(3, worker(t0 + 100s, 5s, 15));
+  workload.merge(later);
+  REQUIRE(workload.workerCount() == 5);
+  REQUIRE(workload.cycleCount() == 3);
+  REQUIRE(workload.total().getTotalActionCount() == 125);
+  REQUIRE_THAT(workload.getTotalDurationSeconds(),
+               Catch::Matchers::WithinAbs(30.0, 1e-9));
+
+  workload.reset();
+  REQUIRE(workload.workerCount() == 0);
+  REQUIRE_FALSE(workload.total().hasData());
+  REQUIRE(workload.getActionsPerSecond() == 0.0);
+}
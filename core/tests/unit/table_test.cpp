@@ -60,6 +60,19 @@ TEST_CASE("Table reference helpers work by id", "[table]") {
   REQUIRE_FALSE(referrer.removeReferencesTo(targetId));
 }
 
+TEST_CASE("primaryKey is the single key column", "[table]") {
+  TableRegistry reg;
+  auto table = makeTable(reg, "keyed");
+  REQUIRE(table.primaryKey() == &table.columns[0]);
+
+  table.columns[1].primary_key = true;
+  REQUIRE(table.primaryKey() == nullptr);
+
+  table.columns[0].primary_key = false;
+  table.columns[1].primary_key = false;
+  REQUIRE(table.primaryKey() == nullptr);
+}
+
 TEST_CASE("normalize is id-independent and resolves refs to names", "[table]") {
   TableRegistry a;
   {
@@ -0,0 +1,208 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include "metadata/turns.hpp"
+#include "sql_variant/sim.hpp"
+#include "workload.hpp"
+
+using metadata::TurnScheduler;
+using metadata::TurnScope;
+
+namespace {
+
+// the slot order three threads take `steps` turns each in
+std::vector<std::size_t> turn_order(std::uint64_t seed, std::size_t steps) {
+  TurnScheduler scheduler(seed, 3);
+  std::vector<std::size_t> order;
+  std::vector<std::size_t> slots;
+  for (int i = 0; i < 3; ++i) {
+    slots.push_back(scheduler.enroll());
+  }
+  std::vector<std::jthread> threads;
+  for (auto const slot : slots) {
+    threads.emplace_back([&, slot] {
+      for (std::size_t i = 0; i < steps; ++i) {
+        TurnScope const turn({.scheduler = &scheduler, .slot = slot});
+        order.push_back(slot);
+      }
+      scheduler.retire(slot);
+    });
+  }
+  threads.clear();
+  REQUIRE(scheduler.stalls() == 0);
+  REQUIRE(scheduler.turns() == 3 * steps);
+  return order;
+}
+
+std::filesystem::path plan_dir(std::string const &name) {
+  auto dir = std::filesystem::temp_directory_path() / ("sw-turns-" + name);
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+  return dir;
+}
+
+std::string slurp(std::filesystem::path const &path) {
+  std::ifstream in(path);
+  std::stringstream text;
+  text << in.rdbuf();
+  return text.str();
+}
+
+// two ordered workers sharing one catalog, recording their plans. Worker
+// names are part of their seeds, so every run uses the same ones
+std::filesystem::path generate(std::string const &dirName) {
+  auto const dir = plan_dir(dirName);
+  WorkloadParams params;
+  params.seed = 11;
+  params.max_actions = 150;
+  params.plan_dir = dir.string();
+  RunContext run;
+  run.turns = std::make_shared<TurnScheduler>(params.seed, 2);
+
+  auto const server = std::make_shared<sql_variant::SimServer>(
+      sql_variant::SimParams{.sleep = false});
+  auto const registry = std::make_shared<metadata::TableRegistry>();
+  auto const actions = action::default_registry(sql_variant::flavor::postgres);
+  std::vector<std::unique_ptr<RandomWorker>> workers;
+  for (auto const *name : {"turns-a", "turns-b"}) {
+    std::string const n = name;
+    workers.push_back(std::make_unique<RandomWorker>(
+        n,
+        [server, n]() {
+          return std::make_unique<sql_variant::LoggedSQL>(
+              std::make_unique<sql_variant::Simulated>(server), n);
+        },
+        params, registry, actions, run));
+  }
+  workers.front()->create_random_tables(3);
+  for (auto &w : workers) {
+    w->run_thread(60);
+  }
+  for (auto &w : workers) {
+    w->join();
+    REQUIRE(w->action_count() == 150);
+  }
+  REQUIRE(run.turns->stalls() == 0);
+  return dir;
+}
+
+// the same through a Workload, whose workers move as its vector grows
+std::filesystem::path generateWorkload(std::string const &dirName) {
+  auto const dir = plan_dir(dirName);
+  WorkloadParams params;
+  params.seed = 11;
+  params.max_actions = 100;
+  params.number_of_workers = 3;
+  params.repeat_times = 1;
+  params.duration_in_seconds = 60;
+  params.plan_dir = dir.string();
+  RunContext run;
+  run.turns = std::make_shared<TurnScheduler>(params.seed, 3);
+
+  auto const server = std::make_shared<sql_variant::SimServer>(
+      sql_variant::SimParams{.sleep = false});
+  auto const registry = std::make_shared<metadata::TableRegistry>();
+  Workload workload(
+      params,
+      [server]() {
+        return std::make_unique<sql_variant::LoggedSQL>(
+            std::make_unique<sql_variant::Simulated>(server), "turns-wl");
+      },
+      registry, action::default_registry(sql_variant::flavor::postgres), run);
+  workload.worker(1).create_random_tables(3);
+  workload.run();
+  workload.wait_completion();
+  for (std::size_t idx = 1; idx <= workload.worker_count(); ++idx) {
+    REQUIRE(workload.worker(idx).action_count() == 100);
+  }
+  REQUIRE(run.turns->stalls() == 0);
+  return dir;
+}
+
+} // namespace
+
+TEST_CASE("turns follow the seed, not the thread timing", "[turns]") {
+  auto const first = turn_order(3, 50);
+  REQUIRE(first.size() == 150);
+  REQUIRE(turn_order(3, 50) == first);
+  REQUIRE(turn_order(4, 50) != first);
+}
+
+TEST_CASE("turns are reentrant for the holder", "[turns]") {
+  TurnScheduler scheduler(1, 1);
+  metadata::Turns const turns{.scheduler = &scheduler,
+                              .slot = scheduler.enroll()};
+  {
+    TurnScope const outer(turns);
+    TurnScope const inner(turns);
+  }
+  REQUIRE(scheduler.turns() == 1);
+  REQUIRE_THROWS_AS(scheduler.enroll(), std::logic_error);
+  REQUIRE_THROWS_AS(TurnScheduler(1, 0), std::invalid_argument);
+}
+
+TEST_CASE("a worker that never takes its turn stalls the others",
+          "[turns]") {
+  TurnScheduler scheduler(1, 2, std::chrono::milliseconds(20));
+  auto const idle = scheduler.enroll();
+  auto const busy = scheduler.enroll();
+  {
+    // idle has the lower slot at the same clock: busy waits it out
+    TurnScope const turn({.scheduler = &scheduler, .slot = busy});
+  }
+  REQUIRE(scheduler.stalls() == 1);
+  REQUIRE(scheduler.waited() >= std::chrono::milliseconds(20));
+
+  scheduler.retire(idle);
+  {
+    TurnScope const turn({.scheduler = &scheduler, .slot = busy});
+  }
+  REQUIRE(scheduler.stalls() == 1);
+
+  scheduler.cancel();
+  TurnScope const turn({.scheduler = &scheduler, .slot = idle});
+  REQUIRE(scheduler.turns() == 2);
+}
+
+TEST_CASE("ordered workers record the same plans twice", "[turns]") {
+  auto const first = generate("gen-a");
+  auto const second = generate("gen-b");
+  for (auto const *name : {"turns-a.plan.jsonl", "turns-b.plan.jsonl"}) {
+    REQUIRE(!slurp(first / name).empty());
+    REQUIRE(slurp(first / name) == slurp(second / name));
+  }
+}
+
+TEST_CASE("a moved turn slot stays enrolled", "[turns]") {
+  TurnScheduler scheduler(1, 2, std::chrono::milliseconds(20));
+  std::vector<metadata::TurnSlot> slots;
+  slots.emplace_back(scheduler);
+  slots.emplace_back(scheduler); // grows: slot 0 moves
+  REQUIRE(slots[0].turns().slot == 0);
+  {
+    // slot 0 is still active at the same clock: slot 1 waits it out
+    TurnScope const turn(slots[1].turns());
+  }
+  REQUIRE(scheduler.stalls() == 1);
+
+  // destroying the owner retires it
+  slots.erase(slots.begin());
+  {
+    TurnScope const turn(slots[0].turns());
+  }
+  REQUIRE(scheduler.stalls() == 1);
+}
+
+TEST_CASE("an ordered Workload records the same plans twice", "[turns]") {
+  auto const first = generateWorkload("wl-a");
+  auto const second = generateWorkload("wl-b");
+  for (auto const *name :
+       {"Worker 1.plan.jsonl", "Worker 2.plan.jsonl", "Worker 3.plan.jsonl"}) {
+    REQUIRE(!slurp(first / name).empty());
+    REQUIRE(slurp(first / name) == slurp(second / name));
+  }
+}
@@ -0,0 +1,146 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <thread>
+
+#include "sim_connector.hpp"
+#include "sql_variant/sim.hpp"
+#include "workload.hpp"
+
+using namespace std::chrono_literals;
+using State = WorkerControl::State;
+using testutil::sim_connector;
+
+namespace {
+
+action::ActionRegistry two_selects() {
+  action::ActionRegistry reg;
+  reg.makeCustomSqlAction("select_a", "SELECT 1", 1);
+  reg.makeCustomSqlAction("select_b", "SELECT 2", 1);
+  return reg;
+}
+
+// looks, and never finds anything worth running
+class SkipAlways : public action::Action {
+public:
+  void execute(metadata::Context & /*metaCtx*/, ps_random & /*rand*/,
+               sql_variant::LoggedSQL * /*connection*/) const override {
+    throw action::ActionSkipped("nothing to do");
+  }
+};
+
+std::uint64_t count_of(statistics::WorkerStatistics const &stats,
+                       std::string const &action) {
+  auto const it = stats.actionStats.find(action);
+  return it == stats.actionStats.end() ? 0 : it->second.getTotalCount();
+}
+
+} // namespace
+
+TEST_CASE("admit paces actions at the target rate", "[control]") {
+  WorkerControl control(100);
+  auto const deadline = std::chrono::steady_clock::now() + 60s;
+  auto const start = std::chrono::steady_clock::now();
+  for (int i = 0; i < 21; ++i) {
+    REQUIRE(control.admit(deadline));
+  }
+  // the first one is due at once, 20 more at 10ms each
+  REQUIRE(std::chrono::steady_clock::now() - start >= 190ms);
+
+  control.setRate(0);
+  REQUIRE(control.admit(deadline));
+  REQUIRE_THROWS_AS(control.setRate(-1), std::invalid_argument);
+  REQUIRE_THROWS_AS(WorkerControl(-1), std::invalid_argument);
+
+  REQUIRE_FALSE(control.admit(std::chrono::steady_clock::now()));
+}
+
+TEST_CASE("a paused worker waits for resume or stop", "[control]") {
+  WorkerControl control;
+  auto const deadline = std::chrono::steady_clock::now() + 60s;
+  control.pause();
+  REQUIRE(control.state() == State::paused);
+
+  std::jthread resumer([&] {
+    std::this_thread::sleep_for(50ms);
+    control.resume();
+  });
+  auto const start = std::chrono::steady_clock::now();
+  REQUIRE(control.admit(deadline));
+  REQUIRE(std::chrono::steady_clock::now() - start >= 50ms);
+  REQUIRE(control.state() == State::running);
+
+  control.pause();
+  std::jthread stopper([&] {
+    std::this_thread::sleep_for(50ms);
+    control.stop();
+  });
+  REQUIRE_FALSE(control.admit(deadline));
+  REQUIRE(control.state() == State::stopped);
+  REQUIRE(control.stopToken().stop_requested());
+}
+
+TEST_CASE("weight changes apply from the next action", "[control]") {
+  auto const server = std::make_shared<sql_variant::SimServer>(
+      sql_variant::SimParams{.sleep = false});
+  WorkloadParams params;
+  params.seed = 1;
+  params.max_actions = 50;
+  RandomWorker worker("ctl-weights", sim_connector(server, "ctl-weights"),
+                      params, std::make_shared<metadata::TableRegistry>(),
+                      two_selects());
+  REQUIRE_THROWS_AS(worker.set_weight("nope", 1), std::invalid_argument);
+  worker.set_weight("select_b", 0);
+  worker.run_thread(60);
+  worker.join();
+  REQUIRE(count_of(worker.statistics(), "select_a") == 50);
+  REQUIRE(count_of(worker.statistics(), "select_b") == 0);
+}
+
+TEST_CASE("skipped actions count as neither success nor failure",
+          "[control]") {
+  auto const server = std::make_shared<sql_variant::SimServer>(
+      sql_variant::SimParams{.sleep = false});
+  WorkloadParams params;
+  params.seed = 1;
+  params.max_actions = 20;
+  auto registry = two_selects();
+  registry.insert({.name = "skip",
+                   .builder = [](action::BuildContext const &) {
+                     return std::make_unique<SkipAlways>();
+                   },
+                   .weight = 1});
+  RandomWorker worker("ctl-skip", sim_connector(server, "ctl-skip"), params,
+                      std::make_shared<metadata::TableRegistry>(), registry);
+  worker.set_weight("select_a", 0);
+  worker.set_weight("select_b", 0);
+  worker.run_thread(60);
+  worker.join();
+  REQUIRE(worker.action_count() == 20);
+  REQUIRE(count_of(worker.statistics(), "skip") == 0);
+  REQUIRE(worker.statistics().getTotalFailureCount() == 0);
+}
+
+TEST_CASE("stop cancels the statement in flight", "[control]") {
+  // every statement would take 10s
+  auto const server = std::make_shared<sql_variant::SimServer>(
+      sql_variant::SimParams{.latency_median = 10s, .latency_sigma = 0});
+  WorkloadParams params;
+  params.seed = 1;
+  RandomWorker worker("ctl-stop", sim_connector(server, "ctl-stop"), params,
+                      std::make_shared<metadata::TableRegistry>(),
+                      two_selects());
+  auto const start = std::chrono::steady_clock::now();
+  worker.run_thread(60);
+  std::this_thread::sleep_for(100ms);
+  worker.stop();
+  worker.join();
+  REQUIRE(std::chrono::steady_clock::now() - start < 5s);
+  REQUIRE(worker.state() == State::stopped);
+  REQUIRE(worker.action_count() == 1);
+  REQUIRE(worker.statistics().getTotalFailureCount() == 1);
+
+  // final: a later run doesn't start
+  worker.run_thread(60);
+  worker.join();
+  REQUIRE(worker.action_count() == 1);
+}
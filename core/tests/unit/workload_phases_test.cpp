@@ -0,0 +1,113 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <thread>
+#include <vector>
+
+#include "sim_connector.hpp"
+#include "sql_variant/sim.hpp"
+#include "workload.hpp"
+
+using namespace std::chrono_literals;
+using testutil::sim_connector;
+
+TEST_CASE("phases run back to back from the first begin", "[phases]") {
+  PhaseProfile profile(
+      std::vector<Phase>{{.duration = 100ms, .workers = 1},
+                         {.duration = 200ms, .workers = 2, .rate = 5}});
+  REQUIRE(profile.enroll() == 0);
+  REQUIRE(profile.enroll() == 1);
+
+  auto const start = std::chrono::steady_clock::now();
+  REQUIRE(profile.phaseAt(start) == 0);
+  profile.begin(start);
+  profile.begin(start + 1s); // too late, the first one counts
+  REQUIRE(profile.phaseAt(start + 99ms) == 0);
+  REQUIRE(profile.phaseAt(start + 100ms) == 1);
+  REQUIRE(profile.phaseAt(start + 299ms) == 1);
+  REQUIRE(profile.phaseAt(start + 300ms) == 2);
+  REQUIRE(profile.phaseEnd(0) == start + 100ms);
+  REQUIRE(profile.phaseEnd(1) == start + 300ms);
+
+  using Phases = std::vector<Phase>;
+  REQUIRE_THROWS_AS(PhaseProfile(Phases{}), std::invalid_argument);
+  REQUIRE_THROWS_AS(PhaseProfile(Phases{{.duration = 0ms, .workers = 1}}),
+                    std::invalid_argument);
+  REQUIRE_THROWS_AS(
+      PhaseProfile(Phases{{.duration = 1s, .workers = 1, .rate = -1}}),
+      std::invalid_argument);
+}
+
+TEST_CASE("the start barrier releases everyone at once", "[phases]") {
+  StartBarrier barrier(3);
+  std::vector<StartBarrier::clock::time_point> released(3);
+  std::vector<std::jthread> threads;
+  for (std::size_t i = 0; i < 3; ++i) {
+    threads.emplace_back([&, i] {
+      // the last one to arrive is late
+      if (i == 2) {
+        std::this_thread::sleep_for(50ms);
+      }
+      released[i] = barrier.arriveAndWait({});
+    });
+  }
+  threads.clear();
+  REQUIRE(released[0] == released[1]);
+  REQUIRE(released[1] == released[2]);
+
+  REQUIRE_THROWS_AS(StartBarrier(0), std::invalid_argument);
+
+  // one that never arrives: cancel, or a stop, lets the others go
+  StartBarrier cancelled(2);
+  std::jthread waiter([&] { cancelled.arriveAndWait({}); });
+  cancelled.cancel();
+  waiter.join();
+
+  StartBarrier stopped(2);
+  std::stop_source stop;
+  std::jthread stoppee([&] { stopped.arriveAndWait(stop.get_token()); });
+  stop.request_stop();
+  stoppee.join();
+}
+
+TEST_CASE("workers follow the phase profile", "[phases]") {
+  auto const server = std::make_shared<sql_variant::SimServer>(
+      sql_variant::SimParams{.sleep = false});
+  WorkloadParams params;
+  params.seed = 1;
+  RunContext run;
+  run.start_barrier = std::make_shared<StartBarrier>(2);
+  run.phases = std::make_shared<PhaseProfile>(
+      std::vector<Phase>{{.duration = 150ms, .workers = 1, .rate = 200},
+                         {.duration = 150ms, .workers = 2, .rate = 200}});
+  action::ActionRegistry registry;
+  registry.makeCustomSqlAction("select", "SELECT 1", 1);
+
+  std::vector<RandomWorker> workers;
+  workers.reserve(2);
+  for (auto const *name : {"phases-1", "phases-2"}) {
+    workers.emplace_back(name, sim_connector(server, name), params,
+                         std::make_shared<metadata::TableRegistry>(), registry,
+                         run);
+  }
+  auto const start = std::chrono::steady_clock::now();
+  for (auto &worker : workers) {
+    worker.run_thread(60);
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  // the profile, not the duration, ended the run
+  REQUIRE(std::chrono::steady_clock::now() - start < 10s);
+
+  auto const &first = workers[0].phase_statistics();
+  auto const &second = workers[1].phase_statistics();
+  REQUIRE(first.size() == 2);
+  REQUIRE(second.size() == 2);
+  REQUIRE(first[0].getTotalActionCount() > 0);
+  REQUIRE(first[1].getTotalActionCount() > first[0].getTotalActionCount());
+  // no room for the second worker in the first phase
+  REQUIRE(second[0].getTotalActionCount() == 0);
+  REQUIRE(second[1].getTotalActionCount() > 0);
+  REQUIRE(second[1].getTotalActionCount() ==
+          workers[1].statistics().getTotalActionCount());
+}
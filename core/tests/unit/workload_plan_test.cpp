@@ -0,0 +1,157 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include "sim_connector.hpp"
+#include "sql_variant/sim.hpp"
+#include "workload.hpp"
+#include "workload_plan.hpp"
+
+using plan::TxnEffect;
+using plan::txn_effect;
+using testutil::sim_connector;
+
+namespace {
+
+std::filesystem::path plan_dir(std::string const &name) {
+  auto dir = std::filesystem::temp_directory_path() / ("sw-plan-" + name);
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+  return dir;
+}
+
+std::string slurp(std::filesystem::path const &path) {
+  std::ifstream in(path);
+  std::stringstream text;
+  text << in.rdbuf();
+  return text.str();
+}
+
+// one seeded single-worker generation run against a fresh sim server. The
+// worker name is part of its seed, so every run uses the same one
+std::filesystem::path generate(std::string const &dirName) {
+  std::string const name = "plan-gen";
+  auto const dir = plan_dir(dirName);
+  WorkloadParams params;
+  params.seed = 7;
+  params.max_actions = 200;
+  params.plan_dir = dir.string();
+  auto const server = std::make_shared<sql_variant::SimServer>(
+      sql_variant::SimParams{.sleep = false});
+  RandomWorker worker(name, sim_connector(server, name), params,
+                      std::make_shared<metadata::TableRegistry>(),
+                      action::default_registry(sql_variant::flavor::postgres));
+  worker.create_random_tables(3);
+  worker.run_thread(60);
+  worker.join();
+  REQUIRE(worker.action_count() == 200);
+  return dir / (name + ".plan.jsonl");
+}
+
+} // namespace
+
+TEST_CASE("plan statements know their transaction effect", "[plan]") {
+  REQUIRE(txn_effect("BEGIN;") == TxnEffect::begin);
+  REQUIRE(txn_effect("  begin isolation level serializable;") ==
+          TxnEffect::begin);
+  REQUIRE(txn_effect("START TRANSACTION;") == TxnEffect::begin);
+  REQUIRE(txn_effect("COMMIT;") == TxnEffect::end);
+  REQUIRE(txn_effect("ROLLBACK;") == TxnEffect::end);
+  REQUIRE(txn_effect("ROLLBACK TO SAVEPOINT sp1;") == TxnEffect::none);
+  REQUIRE(txn_effect("SELECT 1") == TxnEffect::none);
+  REQUIRE(txn_effect("BEGINNING") == TxnEffect::none);
+}
+
+TEST_CASE("plans round-trip through the file", "[plan]") {
+  auto const path = plan_dir("roundtrip") / "p.plan.jsonl";
+  {
+    plan::PlanRecorder rec(path.string(), "w", 42);
+    rec.statement("CREATE TABLE t (a INT)", nullptr);
+    rec.beginAction("insert_some_data", action::ActionType::dml);
+    rec.statement("BEGIN;", nullptr);
+    std::vector<sql_variant::Param> const params{
+        {.value = std::nullopt, .binary = false},
+        {.value = "x'y", .binary = false},
+        {.value = std::string("\0\xff", 2), .binary = true}};
+    rec.statement("INSERT INTO t VALUES ($1, $2, $3)", &params);
+    rec.statement("COMMIT;", nullptr);
+    rec.endAction();
+    rec.beginAction("no_sql", action::ActionType::other);
+    rec.endAction();
+    rec.beginAction("bulk_load", action::ActionType::other);
+    rec.bulkLoad("t", {"a"}, {"1", "\\N"});
+    rec.endAction();
+    REQUIRE(rec.actionsWritten() == 3);
+  }
+
+  auto const p = plan::read_plan(path.string());
+  REQUIRE(p.worker == "w");
+  REQUIRE(p.seed == 42);
+  // actions without SQL leave nothing behind
+  REQUIRE(p.actions.size() == 3);
+
+  REQUIRE(p.actions[0].name.empty());
+  REQUIRE(p.actions[0].statements.size() == 1);
+
+  auto const &ins = p.actions[1];
+  REQUIRE(ins.name == "insert_some_data");
+  REQUIRE(ins.type == action::ActionType::dml);
+  REQUIRE(ins.statements.size() == 3);
+  REQUIRE(ins.statements[0].txn == TxnEffect::begin);
+  REQUIRE(ins.statements[2].txn == TxnEffect::end);
+  auto const &stmt = ins.statements[1];
+  REQUIRE(stmt.kind == plan::Statement::Kind::params);
+  REQUIRE(stmt.params.size() == 3);
+  REQUIRE(!stmt.params[0].value);
+  REQUIRE(*stmt.params[1].value == "x'y");
+  REQUIRE(stmt.params[2].binary);
+  REQUIRE(*stmt.params[2].value == std::string("\0\xff", 2));
+
+  auto const &bulk = p.actions[2].statements.at(0);
+  REQUIRE(bulk.kind == plan::Statement::Kind::bulk);
+  REQUIRE(bulk.sql == "t");
+  REQUIRE(bulk.rows == std::vector<std::string>{"1", "\\N"});
+}
+
+TEST_CASE("malformed plans are rejected", "[plan]") {
+  auto const dir = plan_dir("malformed");
+  REQUIRE_THROWS_AS(plan::read_plan((dir / "missing").string()),
+                    std::invalid_argument);
+
+  std::ofstream(dir / "newer") << R"({"plan":99})" << '\n';
+  REQUIRE_THROWS_AS(plan::read_plan((dir / "newer").string()),
+                    std::invalid_argument);
+
+  std::ofstream(dir / "broken") << R"({"plan":1})" << '\n'
+                                << R"({"action":"x"})" << '\n';
+  REQUIRE_THROWS_AS(plan::read_plan((dir / "broken").string()),
+                    std::invalid_argument);
+}
+
+TEST_CASE("a seeded worker records the same plan twice", "[plan]") {
+  auto const first = generate("gen-a");
+  auto const second = generate("gen-b");
+
+  auto const p = plan::read_plan(first.string());
+  REQUIRE(p.seed == 7);
+  // create_random_tables ran before the first action
+  REQUIRE(p.actions.front().name.empty());
+  REQUIRE(slurp(first) == slurp(second));
+}
+
+TEST_CASE("a plan plays back without metadata", "[plan]") {
+  auto const path = generate("gen-play");
+  auto const server = std::make_shared<sql_variant::SimServer>(
+      sql_variant::SimParams{.sleep = false});
+  PlanWorker player("plan-play", sim_connector(server, "plan-play"), {},
+                    path.string());
+  REQUIRE(player.plan_size() > 0);
+
+  player.run_thread(60);
+  player.join();
+  REQUIRE(player.statistics().getTotalActionCount() == player.plan_size());
+  REQUIRE(player.statistics().getTotalFailureCount() == 0);
+  REQUIRE(player.action_count() == player.plan_size());
+}
@@ -12,29 +12,48 @@ from stormweaver._stormweaver import (
     ActionRegistry,
     ActionStatistics,
     AllConfig,
+    ConnectionManager,
     DdlConfig,
     DmlConfig,
+    IntervalCollector,
+    IntervalStats,
+    KeyDistribution,
+    KeyReservoir,
     LoggedSQL,
     Metadata,
+    MetricsExporter,
+    Phase,
+    PhaseProfile,
+    PlanWorker,
     QueryResult,
     Random,
     RandomWorker,
+    RunContext,
+    RunState,
+    SimParams,
+    SimServer,
     SqlError,
+    StartBarrier,
+    StatementWatchdog,
     TimingStatistics,
+    TurnScheduler,
     VariableConfig,
     VariableSpec,
     Worker,
     WorkerStatistics,
     WorkloadParams,
+    WorkloadStatistics,
     __version__,
     connect_mysql,
     connect_pg,
+    connect_sim,
     default_action_registry,
+    set_latency_precision,
 )
 from stormweaver.actions import action
 from stormweaver.backends import DatabaseBackend, MySQL, Postgres
 from stormweaver.config import Config
-from stormweaver.workload import Workload
+from stormweaver.workload import PlanPlayback, Workload
 from stormweaver.wrappers import (
     ExecPrefixWrapper,
     RRWrapper,
@@ -49,21 +68,38 @@ __all__ = [
     "ActionStatistics",
     "AllConfig",
     "Config",
+    "ConnectionManager",
     "DatabaseBackend",
     "DdlConfig",
     "DmlConfig",
     "ExecPrefixWrapper",
+    "IntervalCollector",
+    "IntervalStats",
+    "KeyDistribution",
+    "KeyReservoir",
     "LoggedSQL",
     "Metadata",
+    "MetricsExporter",
     "MySQL",
+    "Phase",
+    "PhaseProfile",
+    "PlanPlayback",
+    "PlanWorker",
     "Postgres",
     "QueryResult",
     "RRWrapper",
     "Random",
     "RandomWorker",
+    "RunContext",
+    "RunState",
     "ServerWrapper",
+    "SimParams",
+    "SimServer",
     "SqlError",
+    "StartBarrier",
+    "StatementWatchdog",
     "TimingStatistics",
+    "TurnScheduler",
     "ValgrindWrapper",
     "VariableConfig",
     "VariableSpec",
@@ -71,11 +107,14 @@ __all__ = [
     "WorkerStatistics",
     "Workload",
     "WorkloadParams",
+    "WorkloadStatistics",
     "WrapCtx",
     "__version__",
     "action",
     "connect_mysql",
     "connect_pg",
+    "connect_sim",
     "default_action_registry",
     "scenario",
+    "set_latency_precision",
 ]
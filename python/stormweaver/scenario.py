@@ -32,6 +32,13 @@ def add_common_arguments(parser: argparse._ActionsContainer) -> None:
     group.add_argument("--workers", type=int, default=5, help="number of workers")
     group.add_argument("--repeat", type=int, default=5, help="workload cycles")
     group.add_argument("--seed", type=int, default=0, help="workload seed, 0 = random")
+    group.add_argument(
+        "--rng-stream",
+        type=int,
+        choices=[1, 2],
+        default=2,
+        help="what the seed expands to: 1 = mt19937 (older seeds), 2 = xoshiro",
+    )
     group.add_argument(
         "--var-fuzz",
         choices=["off", "safe", "semantics", "disruptive"],
@@ -197,6 +204,7 @@ class ScenarioContext:
             worker_name_prefix=self._name_prefix,
             worker_setup=worker_setup,
             seed=getattr(opts, "seed", 0),
+            rng_stream=getattr(opts, "rng_stream", 2),
         )
 
     def _access_methods(self) -> list[str]:
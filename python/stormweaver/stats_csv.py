@@ -1,4 +1,5 @@
-"""Long-format CSV statistics output, one row per (worker, cycle, action).
+"""Long-format CSV statistics output, one row per (worker, cycle, action),
+and summary.csv with one row per cycle over all workers.
 
 Duck-typed on the binding objects so tests can use plain fakes.
 """
@@ -37,6 +38,9 @@ SUB_BUCKETS = [
     "sub_1000_plus",
 ]
 
+# column suffix, percentile
+PERCENTILES = [("p50", 50.0), ("p90", 90.0), ("p99", 99.0), ("p999", 99.9)]
+
 STATS_HEADER = [
     "worker",
     "cycle",
@@ -53,6 +57,7 @@ STATS_HEADER = [
     "sql_avg_ms",
     "sql_min_ms",
     "sql_max_ms",
+    *(f"{kind}_{name}_ms" for kind in ("exec", "sql") for name, _ in PERCENTILES),
 ]
 HIST_HEADER = ["worker", "cycle", "action", "stmt_kind", *ROW_BUCKETS]
 TIMING_HEADER = ["worker", "cycle", "action", "timing_kind", *TIME_BUCKETS]
@@ -69,6 +74,33 @@ TXN_HEADER = [
     "sub_fail",
     *SUB_BUCKETS,
 ]
+SUMMARY_HEADER = [
+    "cycle",
+    "workers",
+    "actions",
+    "success",
+    "failures",
+    "success_rate",
+    "duration_s",
+    "actions_per_sec",
+    "transactions",
+    "reconnects",
+    *(f"exec_{name}_ms" for name, _ in PERCENTILES),
+]
+INTERVAL_HEADER = [
+    "interval",
+    "start_s",
+    "workers",
+    "actions",
+    "success",
+    "action_fail",
+    "sql_fail",
+    "other_fail",
+    "conflict",
+    "reconnects",
+    "actions_per_sec",
+    *(f"{name}_ms" for name, _ in PERCENTILES),
+]
 
 
 class StatsLike(Protocol):
@@ -137,6 +169,11 @@ def _append_stats(
                         f"{act.sql_timing.avg_ms():.3f}",
                         f"{act.sql_timing.min_ms():.3f}",
                         f"{act.sql_timing.max_ms():.3f}",
+                        *(
+                            f"{timing.percentile_ms(p):.3f}"
+                            for timing in (act.execution_timing, act.sql_timing)
+                            for _, p in PERCENTILES
+                        ),
                     ]
                 )
                 for kind, timing in (
@@ -176,3 +213,70 @@ def _append_stats(
     _append(log_dir / "timings.csv", TIMING_HEADER, timing_rows)
     _append(log_dir / "errors.csv", ERRORS_HEADER, error_rows)
     _append(log_dir / "transactions.csv", TXN_HEADER, txn_rows)
+
+
+def summary_row(cycle: int | str, workload: Any) -> list[Any]:
+    """One WorkloadStatistics as a SUMMARY_HEADER row: all workers of a
+    cycle, or of the whole run with cycle "all"."""
+    total = workload.total()
+    actions = total.total_action_count()
+    success = total.total_success_count()
+    return [
+        cycle,
+        workload.worker_count,
+        actions,
+        success,
+        total.total_failure_count(),
+        f"{100.0 * success / actions if actions else 0.0:.2f}",
+        f"{workload.duration_seconds():.3f}",
+        f"{workload.actions_per_sec():.2f}",
+        total.transaction_stats().total(),
+        total.reconnect_timing().count,
+        *(
+            f"{workload.execution_timing().percentile_ms(p):.3f}"
+            for _, p in PERCENTILES
+        ),
+    ]
+
+
+def append_summary(log_dir: str | Path, cycle: int | str, workload: Any) -> None:
+    """Append one summary_row() to summary.csv."""
+    try:
+        _append(
+            Path(log_dir) / "summary.csv",
+            SUMMARY_HEADER,
+            [summary_row(cycle, workload)],
+        )
+    except OSError:
+        logger.warning("could not write the statistics summary", exc_info=True)
+
+
+def interval_row(stats: Any, interval_seconds: float) -> dict[str, Any]:
+    """One merged IntervalStats as a time-series row, keyed by
+    INTERVAL_HEADER."""
+    return {
+        "interval": stats.interval,
+        "start_s": stats.interval * interval_seconds,
+        "workers": stats.workers,
+        "actions": stats.actions(),
+        "success": stats.successes,
+        "action_fail": stats.action_failures,
+        "sql_fail": stats.sql_failures,
+        "other_fail": stats.other_failures,
+        "conflict": stats.conflicts,
+        "reconnects": stats.reconnects,
+        "actions_per_sec": stats.actions() / interval_seconds,
+        **{f"{name}_ms": stats.percentile_ms(p) for name, p in PERCENTILES},
+    }
+
+
+def append_intervals(log_dir: str | Path, rows: Iterable[dict[str, Any]]) -> None:
+    """Append interval_row()s to timeseries.csv."""
+    try:
+        _append(
+            Path(log_dir) / "timeseries.csv",
+            INTERVAL_HEADER,
+            [[row[key] for key in INTERVAL_HEADER] for row in rows],
+        )
+    except OSError:
+        logger.warning("could not write the statistics time series", exc_info=True)
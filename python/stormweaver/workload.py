@@ -1,6 +1,8 @@
+import copy
 import inspect
 import logging
 from collections.abc import Callable
+from typing import Any
 
 import stormweaver._stormweaver as _stormweaver
 from stormweaver import log as swlog
@@ -22,8 +24,44 @@ class Workload:
         max_reconnect_attempts: int = 5,
         action_config: _stormweaver.AllConfig | None = None,
         seed: int = 0,
+        rng_stream: int = 2,
+        checkpoint_interval: int = 0,
+        # Worker.rng_checkpoint() lines, one per worker in order: the next
+        # cycle continues from them instead of from the seed
+        resume_from: list[str] | None = None,
         worker_name_prefix: str = "",
         worker_setup: Callable[[_stormweaver.RandomWorker, int], None] | None = None,
+        # stop every worker after this many actions, 0 = duration only
+        max_actions: int = 0,
+        # record each worker's statements to <plan_dir>/<name>.plan.jsonl
+        plan_dir: str | None = None,
+        # order the workers' catalog access by a seeded logical clock, so a
+        # multi-worker run makes the same metadata decisions every time
+        deterministic: bool = False,
+        # actions per second per worker, 0 = unlimited; see set_rate()
+        rate: float = 0,
+        # cancel any statement still running after this long, 0 = only the
+        # 10s cap of generated SELECTs
+        statement_timeout_ms: int = 0,
+        # connections kept open for workers that lose theirs
+        spare_connections: int = 0,
+        # how long a worker waits for the server after losing its connection
+        reconnect_timeout: float = 60,
+        # every worker's first action goes out at the same moment
+        start_barrier: bool = False,
+        # (seconds, active workers, rate) steps each cycle runs through,
+        # rate per worker, 0 = unlimited; implies start_barrier
+        phases: list[_stormweaver.Phase | tuple[float, int, float]] | None = None,
+        # seconds per point of the live time series, see live_intervals();
+        # 0 = none
+        live_interval: float = 1.0,
+        # the live statistics for Prometheus: a textfile for node_exporter,
+        # rewritten every metrics_period seconds, and/or an OpenMetrics
+        # listener on 127.0.0.1:metrics_port (0 = any free port); need
+        # live_interval
+        metrics_file: str | None = None,
+        metrics_port: int | None = None,
+        metrics_period: float = 5.0,
     ) -> None:
         if workers < 1:
             raise ValueError("workers must be >= 1")
@@ -40,6 +78,86 @@ class Workload:
         self.max_reconnect_attempts = max_reconnect_attempts
         self.action_config = action_config
         self.seed = seed
+        self.rng_stream = rng_stream
+        self.checkpoint_interval = checkpoint_interval
+        if max_actions < 0:
+            raise ValueError("max_actions must be >= 0")
+        if rate < 0:
+            raise ValueError("rate must be >= 0")
+        self.rate = rate
+        if statement_timeout_ms < 0:
+            raise ValueError("statement_timeout_ms must be >= 0")
+        self.statement_timeout_ms = statement_timeout_ms
+        # one thread cancels overdue statements for every worker, every cycle
+        self.watchdog = _stormweaver.StatementWatchdog()
+        if spare_connections < 0:
+            raise ValueError("spare_connections must be >= 0")
+        if reconnect_timeout <= 0:
+            raise ValueError("reconnect_timeout must be > 0")
+        # one readiness probe for all workers after a restart, then they
+        # reconnect in parallel
+        self.connection_manager = _stormweaver.ConnectionManager(
+            spares=spare_connections,
+            patience_ms=int(reconnect_timeout * 1000),
+        )
+        self.phases = [
+            p if isinstance(p, _stormweaver.Phase) else _stormweaver.Phase(*p)
+            for p in phases or []
+        ]
+        for phase in self.phases:
+            if phase.workers > workers:
+                raise ValueError(
+                    f"a phase runs {phase.workers} workers, the workload "
+                    f"has {workers}"
+                )
+        if self.phases:
+            # the checks of the C++ side (durations, rates) up front
+            _stormweaver.PhaseProfile(self.phases)
+        self.start_barrier = start_barrier or bool(self.phases)
+        if live_interval < 0:
+            raise ValueError("live_interval must be >= 0")
+        self.live_interval = live_interval
+        # merges what the workers publish per interval, across cycles
+        self.intervals = (
+            _stormweaver.IntervalCollector(interval_ms=int(live_interval * 1000))
+            if live_interval > 0
+            else None
+        )
+        wants_metrics = bool(metrics_file) or metrics_port is not None
+        if wants_metrics and self.intervals is None:
+            raise ValueError("metrics need live_interval > 0")
+        if metrics_period <= 0:
+            raise ValueError("metrics_period must be > 0")
+        # stops with the Workload, or through metrics.stop()
+        self.metrics: _stormweaver.MetricsExporter | None = None
+        if wants_metrics:
+            self.metrics = _stormweaver.MetricsExporter(
+                self.intervals,
+                textfile=metrics_file or "",
+                port=metrics_port,
+                period_ms=max(1, int(metrics_period * 1000)),
+            )
+        # what the workers of every cycle share: the objects above, and
+        # what the actions learn (keys, row estimates, plan shapes)
+        self.context = _stormweaver.RunContext()
+        self.context.watchdog = self.watchdog
+        self.context.connection_manager = self.connection_manager
+        if self.intervals is not None:
+            self.context.intervals = self.intervals
+        # the last interval written to timeseries.csv
+        self._intervals_written = -1
+        self._phase_rows: list[dict[str, float]] = []
+        # set_weight() overrides, carried into later cycles
+        self._weights: dict[str, int] = {}
+        self._stop_requested = False
+        self.max_actions = max_actions
+        self.plan_dir = plan_dir
+        self.deterministic = deterministic
+        # the running (or last) cycle's, for its turns / stalls / wait time
+        self.turn_scheduler: _stormweaver.TurnScheduler | None = None
+        if resume_from is not None and len(resume_from) != workers:
+            raise ValueError("resume_from needs one checkpoint per worker")
+        self._resume_from = resume_from
         # worker names become spdlog logger names on the C++ side, and spdlog
         # loggers are get-or-create in a process-wide registry: a name already
         # registered keeps its original log file forever. Give every Workload
@@ -64,6 +182,8 @@ class Workload:
             # signature, assume the zero-arg legacy form
             self._factory_wants_name = False
         self._reports: list[str] = []
+        # every worker of every cycle of the last run()
+        self._totals = _stormweaver.WorkloadStatistics()
 
     @property
     def workers(self) -> list[_stormweaver.RandomWorker]:
@@ -78,6 +198,27 @@ class Workload:
         workers: list[_stormweaver.RandomWorker] = []
         started: list[_stormweaver.RandomWorker] = []
         names: list[str] = []
+        # workers enroll as they are constructed, in index order
+        turns = (
+            _stormweaver.TurnScheduler(self.seed, self.num_workers)
+            if self.deterministic
+            else None
+        )
+        self.turn_scheduler = turns
+        barrier = (
+            _stormweaver.StartBarrier(self.num_workers)
+            if self.start_barrier
+            else None
+        )
+        profile = _stormweaver.PhaseProfile(self.phases) if self.phases else None
+        # the workload's context with this cycle's turns, barrier and phases
+        context = copy.copy(self.context)
+        if turns is not None:
+            context.turn_scheduler = turns
+        if barrier is not None:
+            context.start_barrier = barrier
+        if profile is not None:
+            context.phases = profile
 
         try:
             for i in range(self.num_workers):
@@ -89,6 +230,15 @@ class Workload:
                 # same scenario seed everywhere, C++ derives a distinct
                 # per-worker stream by mixing in the worker name
                 params.seed = self.seed
+                params.rng_stream = self.rng_stream
+                params.checkpoint_interval = self.checkpoint_interval
+                if self._resume_from:
+                    params.resume_from = self._resume_from[i]
+                params.max_actions = self.max_actions
+                if self.plan_dir:
+                    params.plan_dir = self.plan_dir
+                params.target_rate = self.rate
+                params.statement_timeout_ms = self.statement_timeout_ms
 
                 name = f"{self.worker_name_prefix}worker-{self._cycle}-{i + 1}"
                 names.append(name)
@@ -103,7 +253,10 @@ class Workload:
                     params,
                     self.metadata,
                     self.registry,
+                    context,
                 )
+                for action, weight in self._weights.items():
+                    worker.set_weight(action, weight)
                 workers.append(worker)
 
             if self.worker_setup:
@@ -116,19 +269,27 @@ class Workload:
                 w.run_thread(self.duration)
                 started.append(w)
         except BaseException:
-            # workers cannot be cancelled, wait for them before unwinding
+            # unstarted workers would hold the started ones back
+            if turns is not None:
+                turns.cancel()
+            if barrier is not None:
+                barrier.cancel()
             if started:
-                logger.warning(
-                    "waiting for %d running workers to finish (up to %ss)",
-                    len(started),
-                    self.duration,
-                )
+                logger.warning("stopping %d running workers", len(started))
+                for w in started:
+                    w.stop()
                 for w in started:
                     w.join()
             raise
 
         self._live = workers
         self._live_names = names
+        # a stop() that came while the workers were being started
+        if self._stop_requested:
+            for w in workers:
+                w.stop()
+        # a resume point is used once, later cycles continue on their own
+        self._resume_from = None
 
     def wait(self) -> None:
         """Join the running cycle's workers and capture their statistics."""
@@ -140,36 +301,260 @@ class Workload:
         # join waits for each C++ thread to finish
         for w in workers:
             w.join()
+        if self.connection_manager.outages:
+            logger.info(
+                "%d server outages so far; the last: down %.2fs, full load "
+                "again %.2fs after",
+                self.connection_manager.outages,
+                self.connection_manager.last_downtime_seconds,
+                self.connection_manager.last_restore_seconds,
+            )
+        if self.watchdog.cancels:
+            logger.info(
+                "statement watchdog: %d overdue statements cancelled so far",
+                self.watchdog.cancels,
+            )
+        if self.turn_scheduler is not None:
+            logger.info(
+                "ordered catalog access: %d turns, %d stalls, %.1fs waited",
+                self.turn_scheduler.turns,
+                self.turn_scheduler.stalls,
+                self.turn_scheduler.waited_seconds,
+            )
 
         # Capture reports as strings while workers are still alive.
         # statistics() ties the worker's lifetime to the returned
         # object (reference_internal), so keeping it here keeps the
         # worker's stats readable after the cycle ends.
         cycle_stats: list[_stormweaver.WorkerStatistics] = []
+        cycle_total = _stormweaver.WorkloadStatistics()
         for w in workers:
             stats = w.statistics()
             self._reports.append(stats.report())
             self._worker_stats.append(stats)
             cycle_stats.append(stats)
+            cycle_total.add(self._cycle, stats)
+            self._totals.add(self._cycle, stats)
+        logger.info(
+            "cycle %d: %d actions, %.1f/s over all workers",
+            self._cycle,
+            cycle_total.total().total_action_count(),
+            cycle_total.actions_per_sec(),
+        )
 
         log_dir = swlog.log_dir()
         if log_dir is not None:
             stats_csv.append_stats(
                 log_dir, self._cycle, list(zip(names, cycle_stats, strict=True))
             )
+            stats_csv.append_summary(log_dir, self._cycle, cycle_total)
+        if self.phases:
+            self._summarize_phases(workers)
+        if self.intervals is not None:
+            # the workers' last intervals, without waiting for a tick
+            self.intervals.collect()
+        if self.intervals is not None and log_dir is not None:
+            rows = [
+                row
+                for row in self.live_intervals(0)
+                if row["interval"] > self._intervals_written
+            ]
+            if rows:
+                stats_csv.append_intervals(log_dir, rows)
+                self._intervals_written = rows[-1]["interval"]
+
+    def _summarize_phases(self, workers: list[_stormweaver.RandomWorker]) -> None:
+        # snapshots are cumulative: a phase is the difference to the one
+        # before
+        snapshots = [w.phase_statistics() for w in workers]
+        for idx, phase in enumerate(self.phases):
+            actions = failures = 0
+            for snaps in snapshots:
+                actions += snaps[idx].total_action_count()
+                failures += snaps[idx].total_failure_count()
+                if idx > 0:
+                    actions -= snaps[idx - 1].total_action_count()
+                    failures -= snaps[idx - 1].total_failure_count()
+            row = {
+                "cycle": self._cycle,
+                "phase": idx,
+                "workers": phase.workers,
+                "rate": phase.rate,
+                "seconds": phase.seconds,
+                "actions": actions,
+                "failures": failures,
+                "actions_per_sec": actions / phase.seconds,
+            }
+            self._phase_rows.append(row)
+            logger.info(
+                "phase %d: %d workers, %d actions (%.1f/s), %d failed",
+                idx,
+                phase.workers,
+                actions,
+                row["actions_per_sec"],
+                failures,
+            )
+
+    def phase_summary(self) -> list[dict[str, float]]:
+        """One row per phase and cycle of a phases= workload: actions and
+        failures started in the phase, and the throughput - plotted
+        against workers, the concurrency curve."""
+        return self._phase_rows
+
+    def live_intervals(self, count: int = 60) -> list[dict[str, Any]]:
+        """The last `count` points of the time series (0 = all kept),
+        oldest first: actions of all workers per interval, by outcome,
+        their rate and latency percentiles. Safe while the workload runs;
+        the newest point may still grow. Empty with live_interval=0."""
+        if self.intervals is None:
+            return []
+        kept = self.intervals.latest(count if count > 0 else 2**32)
+        return [stats_csv.interval_row(s, self.live_interval) for s in kept]
 
     def run(self) -> None:
         self._reports = []
         self._worker_stats = []
+        self._totals.reset()
+        self._phase_rows = []
+        self._stop_requested = False
         for cycle in range(self.repeat):
             logger.info("Workload cycle %d/%d", cycle + 1, self.repeat)
             self.start()
             self.wait()
             logger.info("Workload cycle %d complete", cycle + 1)
+            if self._stop_requested:
+                logger.info("Workload stopped, skipping the remaining cycles")
+                break
+        log_dir = swlog.log_dir()
+        if log_dir is not None and self._totals.cycle_count > 1:
+            stats_csv.append_summary(log_dir, "all", self._totals)
+
+    # Mid-run control, safe from another thread than the one in run() or
+    # wait(). Workers act on it between actions.
+
+    def pause(self) -> None:
+        """Let the running actions finish, then hold every worker."""
+        for w in self._live:
+            w.pause()
+
+    def resume(self) -> None:
+        for w in self._live:
+            w.resume()
+
+    def stop(self) -> None:
+        """End the running cycle now, and run() with it: in-flight
+        statements are cancelled, no new ones are sent."""
+        self._stop_requested = True
+        for w in self._live:
+            w.stop()
+
+    def set_rate(self, rate: float) -> None:
+        """Actions per second per worker, 0 = unlimited; also for later
+        cycles. With phases, only until the next phase starts."""
+        if rate < 0:
+            raise ValueError("rate must be >= 0")
+        self.rate = rate
+        for w in self._live:
+            w.set_rate(rate)
+
+    def set_weight(self, action: str, weight: int) -> None:
+        """Change one action's weight, from the workers' next action on
+        and in later cycles. Raises ValueError for an unknown action."""
+        if not self.registry.has(action):
+            raise ValueError(f"no action {action} in the registry")
+        for w in self._live:
+            w.set_weight(action, weight)
+        self._weights[action] = weight
 
     def worker_statistics(self) -> list[_stormweaver.WorkerStatistics]:
         return self._worker_stats
 
-    def print_report(self) -> None:
-        for report in self._reports:
-            print(report)
+    def workload_statistics(self) -> _stormweaver.WorkloadStatistics:
+        """Every worker of every cycle of the last run() merged: counters,
+        errors, histograms and latencies by action, and the actions per
+        second of all workers together."""
+        return self._totals
+
+    def print_report(self, per_worker: bool = True) -> None:
+        """The reports of each worker of each cycle, then the merged one."""
+        if per_worker:
+            for report in self._reports:
+                print(report)
+        if self._totals.worker_count > 0:
+            print(self._totals.report())
+
+
+class PlanPlayback:
+    """Plays plan files recorded with Workload(plan_dir=...) back, one
+    PlanWorker per file, all started together."""
+
+    def __init__(
+        self,
+        plans: list[str],
+        duration: int,
+        node_factory: Callable[..., _stormweaver.LoggedSQL],
+        max_reconnect_attempts: int = 5,
+        worker_name_prefix: str = "",
+    ) -> None:
+        if not plans:
+            raise ValueError("plans must not be empty")
+        if duration <= 0:
+            raise ValueError("duration must be > 0")
+        self.plans = plans
+        self.duration = duration
+        self.node_factory = node_factory
+        self.max_reconnect_attempts = max_reconnect_attempts
+        # worker names are spdlog logger names, see Workload
+        self.worker_name_prefix = worker_name_prefix
+        self._runs = 0
+        self._live: list[_stormweaver.PlanWorker] = []
+        try:
+            self._factory_wants_name = (
+                len(inspect.signature(node_factory).parameters) >= 1
+            )
+        except (ValueError, TypeError):  # fmt: skip
+            self._factory_wants_name = False
+
+    def run(self) -> list[_stormweaver.WorkerStatistics]:
+        """Play every plan to its end or for `duration` seconds."""
+        self._runs += 1
+        params = _stormweaver.WorkloadParams()
+        params.max_reconnect_attempts = self.max_reconnect_attempts
+        # plans are parsed here, before any worker starts sending
+        workers: list[_stormweaver.PlanWorker] = []
+        names: list[str] = []
+        for i, path in enumerate(self.plans):
+            name = f"{self.worker_name_prefix}play-{self._runs}-{i + 1}"
+            names.append(name)
+            connector = (
+                (lambda n=name: self.node_factory(n))
+                if self._factory_wants_name
+                else self.node_factory
+            )
+            workers.append(_stormweaver.PlanWorker(name, connector, params, path))
+
+        self._live = workers
+        try:
+            for w in workers:
+                w.run_thread(self.duration)
+        except BaseException:
+            for w in workers:
+                w.stop()
+            raise
+        finally:
+            for w in workers:
+                w.join()
+            self._live = []
+
+        stats = [w.statistics() for w in workers]
+        log_dir = swlog.log_dir()
+        if log_dir is not None:
+            stats_csv.append_stats(
+                log_dir, self._runs, list(zip(names, stats, strict=True))
+            )
+        return stats
+
+    def stop(self) -> None:
+        """End a run() in progress, from another thread."""
+        for w in self._live:
+            w.stop()
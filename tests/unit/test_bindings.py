@@ -1,3 +1,9 @@
+import copy
+import json
+import threading
+import time
+import urllib.request
+
 import pytest
 import stormweaver as sw
 
@@ -39,6 +45,28 @@ def test_registry_insert_remove():
     assert not reg.has("noop")
 
 
+def test_custom_table_sql_compiles_at_registration():
+    reg = sw.ActionRegistry()
+    reg.make_custom_table_sql("upd", "UPDATE {table} SET {int_col:table} = 1", 5)
+    assert reg.has("upd")
+    with pytest.raises(ValueError):
+        reg.make_custom_table_sql("bad", "SELECT * FROM {tabel}", 5)
+    assert not reg.has("bad")
+
+
+def test_load_grammar_registers_one_action_per_rule(tmp_path):
+    grammar = tmp_path / "grammar.sql"
+    grammar.write_text(
+        "# comment\nSELECT T1_INT_1 FROM T1\nDROP TABLE T1\nSELECT T1_INT_1 FROM T1\n"
+    )
+    reg = sw.ActionRegistry()
+    assert reg.load_grammar(str(grammar), prefix="g_") == 2
+    assert reg.has("g_2")
+    assert reg.has("g_3")
+    with pytest.raises(ValueError):
+        reg.load_grammar(str(tmp_path / "missing.sql"))
+
+
 def test_factory_ref_survives_registry_gc():
     import gc
 
@@ -77,6 +105,30 @@ def test_dml_config_roundtrip():
     assert cfg.dml.lock_weights.none == 1
     assert cfg.dml.lock_weights.for_update == 1
     assert cfg.dml.lock_weights.for_share == 1
+    assert cfg.dml.pk_reservoir_prob == 90
+    assert cfg.dml.fk_scan_prob == 0
+    assert cfg.dml.bulk_load_rows == 10000
+    assert cfg.dml.update_access.kind == "uniform"
+    cfg.dml.update_access.kind = "zipfian"
+    cfg.dml.update_access.theta = 1.2
+    assert cfg.dml.update_access.kind == "zipfian"
+    assert cfg.dml.update_access.theta == 1.2
+    with pytest.raises(ValueError):
+        cfg.dml.delete_access.kind = "gaussian"
+
+
+def test_run_context_shares_state():
+    ctx = sw.RunContext()
+    assert ctx.actions.keys.capacity == 10000
+    ctx.actions.keys = sw.KeyReservoir(16)
+    assert ctx.actions.keys.capacity == 16
+    assert ctx.actions.keys.size(1) == 0
+    assert ctx.actions.distinct_plans == 0
+    # a copy shares the reservoir, and keeps its own cycle objects
+    cycle = copy.copy(ctx)
+    assert cycle.actions.keys.capacity == 16
+    cycle.start_barrier = sw.StartBarrier(1)
+    assert ctx.start_barrier is None
     cfg.dml.update_min = 2
     cfg.dml.update_max = 5
     cfg.dml.lock_weights.none = 0
@@ -94,6 +146,342 @@ def test_connect_mysql_exists_and_fails_cleanly():
         sw.connect_mysql(host="127.0.0.1", port=1, log_name="mysql-nope")
 
 
+def test_connect_sim_needs_no_server():
+    params = sw.SimParams()
+    params.flavor = "mysql"
+    params.select_rows = 2
+    params.conflict_rate = 0.0
+    conn = sw.connect_sim(sw.SimServer(params), log_name="sim-bindings")
+    res = conn.execute("SELECT a FROM t")
+    assert res.success()
+    assert len(res.rows()) == 2
+
+    params.conflict_rate = 1.0
+    conn = sw.connect_sim(sw.SimServer(params), log_name="sim-bindings")
+    assert conn.execute("UPDATE t SET a = 1").error_class == "conflict"
+
+    with pytest.raises(ValueError):
+        params.flavor = "oracle"
+
+
+def test_worker_resumes_from_rng_checkpoint():
+    server = sw.SimServer(sw.SimParams())
+    params = sw.WorkloadParams()
+    params.seed = 42
+
+    def connect(name):
+        return lambda: sw.connect_sim(server, log_name=name)
+
+    first = sw.Worker("ckpt-a", connect("ckpt-a"), params, sw.Metadata())
+    line = first.rng_checkpoint()
+    assert json.loads(line)["actions"] == first.action_count == 0
+
+    params.resume_from = line
+    resumed = sw.Worker("ckpt-b", connect("ckpt-b"), params, sw.Metadata())
+    assert json.loads(resumed.rng_checkpoint())["rng"] == json.loads(line)["rng"]
+
+    params.resume_from = "{}"
+    with pytest.raises(ValueError):
+        sw.Worker("ckpt-c", connect("ckpt-c"), params, sw.Metadata())
+
+
+def test_worker_plan_records_and_plays_back(tmp_path):
+    server = sw.SimServer(sw.SimParams())
+    params = sw.WorkloadParams()
+    params.seed = 3
+    params.max_actions = 20
+    params.plan_dir = str(tmp_path)
+    gen = sw.RandomWorker(
+        "plan-gen",
+        lambda: sw.connect_sim(server, log_name="plan-gen"),
+        params,
+        sw.Metadata(),
+        sw.default_action_registry(),
+    )
+    gen.create_random_tables(2)
+    gen.run_thread(60)
+    gen.join()
+    assert gen.action_count == 20
+
+    play = sw.PlanWorker(
+        "plan-play",
+        lambda: sw.connect_sim(server, log_name="plan-play"),
+        sw.WorkloadParams(),
+        str(tmp_path / "plan-gen.plan.jsonl"),
+    )
+    play.run_thread(60)
+    play.join()
+    assert play.statistics().total_action_count() == play.plan_size > 0
+
+    with pytest.raises(ValueError):
+        sw.PlanWorker(
+            "plan-bad",
+            lambda: sw.connect_sim(server, log_name="plan-bad"),
+            params,
+            str(tmp_path / "none"),
+        )
+
+
+def test_deterministic_workload_takes_turns():
+    server = sw.SimServer(sw.SimParams())
+    wl = sw.Workload(
+        workers=2,
+        duration=60,
+        registry=sw.default_action_registry(),
+        metadata=sw.Metadata(),
+        node_factory=lambda name: sw.connect_sim(server, log_name=name),
+        seed=5,
+        max_actions=20,
+        worker_name_prefix="turns-",
+        worker_setup=lambda worker, idx: worker.create_random_tables(1),
+        deterministic=True,
+    )
+    wl.run()
+    turns = wl.turn_scheduler
+    assert turns.participants == 2
+    assert turns.turns > 0
+    assert turns.stalls == 0
+
+    with pytest.raises(ValueError):
+        sw.TurnScheduler(1, 0)
+
+
+def test_workload_stops_mid_statement():
+    # every statement would take 10s
+    params = sw.SimParams()
+    params.latency_median_us = 10_000_000
+    params.latency_sigma = 0
+    server = sw.SimServer(params)
+    wl = sw.Workload(
+        workers=2,
+        duration=60,
+        registry=sw.default_action_registry(),
+        metadata=sw.Metadata(),
+        node_factory=lambda name: sw.connect_sim(server, log_name=name),
+        worker_name_prefix="ctl-",
+    )
+    with pytest.raises(ValueError):
+        wl.set_rate(-1)
+    with pytest.raises(ValueError):
+        wl.set_weight("no_such_action", 1)
+    wl.set_rate(50)
+
+    runner = threading.Thread(target=wl.run)
+    start = time.monotonic()
+    runner.start()
+    time.sleep(0.2)
+    wl.stop()
+    runner.join(timeout=10)
+    assert not runner.is_alive()
+    assert time.monotonic() - start < 5
+
+
+def test_watchdog_cancels_overdue_statements():
+    params = sw.SimParams()
+    params.latency_median_us = 10_000_000
+    params.latency_sigma = 0
+    conn = sw.connect_sim(sw.SimServer(params), log_name="watchdog")
+    watchdog = sw.StatementWatchdog()
+    conn.set_watchdog(watchdog, timeout_ms=100)
+
+    start = time.monotonic()
+    res = conn.execute("SELECT 1")
+    assert time.monotonic() - start < 5
+    assert res.error_class == "timeout"
+    assert watchdog.cancels == 1
+
+
+def test_workers_recover_through_the_connection_manager():
+    params = sw.SimParams()
+    params.seed = 3
+    params.server_gone_rate = 0.02
+    server = sw.SimServer(params)
+    wl = sw.Workload(
+        workers=2,
+        duration=60,
+        registry=sw.default_action_registry(),
+        metadata=sw.Metadata(),
+        node_factory=lambda name: sw.connect_sim(server, log_name=name),
+        max_actions=200,
+        worker_name_prefix="recover-",
+        worker_setup=lambda worker, idx: worker.create_random_tables(1),
+        spare_connections=2,
+        reconnect_timeout=10,
+    )
+    wl.run()
+    manager = wl.connection_manager
+    assert manager.outages > 0
+    assert manager.failed_attempts >= manager.outages
+    assert manager.last_downtime_seconds > 0
+
+    with pytest.raises(ValueError):
+        sw.Workload(
+            workers=1,
+            duration=1,
+            registry=sw.default_action_registry(),
+            metadata=sw.Metadata(),
+            node_factory=lambda name: sw.connect_sim(server, log_name=name),
+            spare_connections=-1,
+        )
+
+
+def test_workload_phases_ramp_up():
+    params = sw.SimParams()
+    params.sleep = False
+    server = sw.SimServer(params)
+    wl = sw.Workload(
+        workers=2,
+        duration=60,
+        registry=sw.default_action_registry(),
+        metadata=sw.Metadata(),
+        node_factory=lambda name: sw.connect_sim(server, log_name=name),
+        worker_name_prefix="phases-",
+        worker_setup=lambda worker, idx: worker.create_random_tables(1),
+        phases=[(0.2, 1, 100), sw.Phase(0.2, 2, rate=100)],
+    )
+    start = time.monotonic()
+    wl.run()
+    assert time.monotonic() - start < 30
+    summary = wl.phase_summary()
+    assert [row["workers"] for row in summary] == [1, 2]
+    assert all(row["actions"] > 0 for row in summary)
+
+    def make(**kwargs):
+        return sw.Workload(
+            workers=2,
+            duration=1,
+            registry=sw.default_action_registry(),
+            metadata=sw.Metadata(),
+            node_factory=lambda name: sw.connect_sim(server, log_name=name),
+            **kwargs,
+        )
+
+    with pytest.raises(ValueError):
+        make(phases=[(1, 3, 0)])
+    with pytest.raises(ValueError):
+        make(phases=[(0, 1, 0)])
+    with pytest.raises(ValueError):
+        sw.StartBarrier(0)
+
+
+def test_latency_percentiles():
+    server = sw.SimServer(sw.SimParams())
+    worker = sw.RandomWorker(
+        "percentiles",
+        lambda: sw.connect_sim(server, log_name="percentiles"),
+        sw.WorkloadParams(),
+        sw.Metadata(),
+        sw.default_action_registry(),
+    )
+    worker.create_random_tables(1)
+    worker.run_thread(1)
+    worker.join()
+    stats = worker.statistics()
+    timings = [
+        stats.action_stats(name).execution_timing for name in stats.action_names()
+    ]
+    timing = max(timings, key=lambda t: t.count)
+    assert timing.min_ms() <= timing.percentile_ms(50) <= timing.percentile_ms(99)
+    assert timing.percentile_ms(99) <= timing.max_ms()
+    assert "p99=" in stats.report()
+
+    with pytest.raises(ValueError):
+        sw.set_latency_precision(0)
+
+
+def test_live_intervals_during_a_run():
+    params = sw.SimParams()
+    params.sleep = False
+    server = sw.SimServer(params)
+    wl = sw.Workload(
+        workers=2,
+        duration=2,
+        registry=sw.default_action_registry(),
+        metadata=sw.Metadata(),
+        node_factory=lambda name: sw.connect_sim(server, log_name=name),
+        worker_name_prefix="live-",
+        worker_setup=lambda worker, idx: worker.create_random_tables(1),
+        rate=200,
+        live_interval=0.2,
+    )
+    seen = []
+    runner = threading.Thread(target=wl.run)
+    runner.start()
+    while runner.is_alive():
+        seen.extend(wl.live_intervals(5))
+        time.sleep(0.1)
+    runner.join()
+    # published while the workers still ran
+    assert seen
+    rows = wl.live_intervals(0)
+    assert [row["interval"] for row in rows] == sorted(
+        {row["interval"] for row in rows}
+    )
+    assert max(row["workers"] for row in rows) == 2
+    assert sum(row["actions"] for row in rows) == sum(
+        stats.total_action_count() for stats in wl.worker_statistics()
+    )
+    assert all(row["p50_ms"] <= row["p99_ms"] for row in rows)
+
+    with pytest.raises(ValueError):
+        sw.IntervalCollector(interval_ms=0)
+
+
+def test_metrics_export_during_a_run(tmp_path):
+    params = sw.SimParams()
+    params.sleep = False
+    server = sw.SimServer(params)
+    textfile = tmp_path / "stormweaver.prom"
+    wl = sw.Workload(
+        workers=2,
+        duration=1,
+        registry=sw.default_action_registry(),
+        metadata=sw.Metadata(),
+        node_factory=lambda name: sw.connect_sim(server, log_name=name),
+        worker_name_prefix="metrics-",
+        worker_setup=lambda worker, idx: worker.create_random_tables(1),
+        rate=200,
+        live_interval=0.2,
+        metrics_file=str(textfile),
+        metrics_port=0,
+        metrics_period=0.2,
+    )
+    assert wl.metrics is not None
+    assert wl.metrics.port != 0
+    wl.run()
+    actions = sum(stats.total_action_count() for stats in wl.worker_statistics())
+    with urllib.request.urlopen(
+        f"http://127.0.0.1:{wl.metrics.port}/metrics"
+    ) as response:
+        assert response.headers["Content-Type"].startswith(
+            "application/openmetrics-text"
+        )
+        scraped = response.read().decode()
+    assert f"stormweaver_action_duration_seconds_count {actions}\n" in scraped
+    assert scraped.endswith("# EOF\n")
+
+    wl.metrics.stop()
+    text = textfile.read_text()
+    assert f"stormweaver_action_duration_seconds_count {actions}\n" in text
+    assert "stormweaver_statements_in_flight 0\n" in text
+    assert "# TYPE stormweaver_actions_total counter\n" in text
+    assert "# EOF" not in text
+    assert wl.metrics.render(textfile_format=True).startswith(
+        "# TYPE stormweaver_actions_total counter\n"
+    )
+
+    with pytest.raises(ValueError):
+        sw.Workload(
+            workers=1,
+            duration=1,
+            registry=sw.default_action_registry(),
+            metadata=sw.Metadata(),
+            node_factory=lambda: None,
+            live_interval=0,
+            metrics_port=0,
+        )
+
+
 def test_worker_exposes_checksums():
     assert callable(getattr(sw.Worker, "calculate_database_checksums", None))
 
@@ -107,6 +495,8 @@ def test_statistics_bindings_exposed():
     assert hasattr(core.ActionStatistics, "action_error_names")
     assert hasattr(core.ActionStatistics, "sql_error_codes")
     assert callable(getattr(core.TimingStatistics, "histogram", None))
+    assert callable(getattr(core.TimingStatistics, "percentile_ms", None))
+    assert callable(getattr(core.WorkerStatistics, "reconnect_timing", None))
     assert hasattr(core, "TransactionStatistics")
     for field in (
         "committed",
@@ -25,6 +25,9 @@ class FakeTiming:
     def histogram(self):
         return self._hist
 
+    def percentile_ms(self, p):
+        return self._max * p / 100
+
     def has_data(self):
         return self.count > 0
 
@@ -77,6 +80,24 @@ class FakeStats:
         return FakeTxn()
 
 
+@dataclass
+class FakeInterval:
+    interval: int = 3
+    workers: int = 2
+    successes: int = 8
+    action_failures: int = 1
+    sql_failures: int = 0
+    other_failures: int = 0
+    conflicts: int = 1
+    reconnects: int = 0
+
+    def actions(self):
+        return 10
+
+    def percentile_ms(self, p):
+        return p / 10
+
+
 def _read(path):
     with open(path, newline="") as f:
         return list(csv.DictReader(f))
@@ -91,6 +112,8 @@ def test_writes_all_files(tmp_path):
     assert stats[0]["action"] == "select_all"
     assert stats[0]["success"] == "10"
     assert stats[0]["conflict"] == "3"
+    assert stats[0]["exec_p50_ms"] == "1.000"
+    assert stats[0]["sql_p999_ms"] == "1.998"
 
     hists = _read(tmp_path / "histograms.csv")
     assert hists[0]["stmt_kind"] == "select"
@@ -181,3 +204,68 @@ def test_io_error_does_not_raise(tmp_path, caplog):
         r.name == "stormweaver.stats_csv" and r.levelno == logging.WARNING
         for r in caplog.records
     )
+
+
+def test_appends_intervals(tmp_path):
+    rows = [stats_csv.interval_row(FakeInterval(interval=i), 0.5) for i in (3, 4)]
+    stats_csv.append_intervals(tmp_path, rows[:1])
+    stats_csv.append_intervals(tmp_path, rows[1:])
+    written = _read(tmp_path / "timeseries.csv")
+    assert list(written[0]) == stats_csv.INTERVAL_HEADER
+    assert [row["interval"] for row in written] == ["3", "4"]
+    assert written[0]["start_s"] == "1.5"
+    assert written[0]["actions_per_sec"] == "20.0"
+    assert written[0]["p99_ms"] == "9.9"
+
+
+class FakeWorkerTotal(FakeStats):
+    def total_action_count(self):
+        return 40
+
+    def total_success_count(self):
+        return 30
+
+    def total_failure_count(self):
+        return 10
+
+    def transaction_stats(self):
+        return FakeTxnTotal()
+
+    def reconnect_timing(self):
+        return FakeTiming(count=2)
+
+
+class FakeTxnTotal(FakeTxn):
+    def total(self):
+        return 8
+
+
+class FakeWorkload:
+    worker_count = 4
+
+    def total(self):
+        return FakeWorkerTotal()
+
+    def duration_seconds(self):
+        return 20.0
+
+    def actions_per_sec(self):
+        return 2.0
+
+    def execution_timing(self):
+        return FakeTiming()
+
+
+def test_appends_summary(tmp_path):
+    stats_csv.append_summary(tmp_path, 1, FakeWorkload())
+    stats_csv.append_summary(tmp_path, "all", FakeWorkload())
+    rows = _read(tmp_path / "summary.csv")
+    assert list(rows[0]) == stats_csv.SUMMARY_HEADER
+    assert [r["cycle"] for r in rows] == ["1", "all"]
+    assert rows[0]["workers"] == "4"
+    assert rows[0]["actions"] == "40"
+    assert rows[0]["success_rate"] == "75.00"
+    assert rows[0]["actions_per_sec"] == "2.00"
+    assert rows[0]["transactions"] == "8"
+    assert rows[0]["reconnects"] == "2"
+    assert rows[0]["exec_p50_ms"] == "1.000"